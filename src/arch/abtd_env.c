@@ -10,8 +10,14 @@
 #define ABTD_KEY_TABLE_DEFAULT_SIZE 4
 #define ABTD_THREAD_DEFAULT_STACKSIZE 16384
 #define ABTD_SCHED_DEFAULT_STACKSIZE (4 * 1024 * 1024)
+#define ABTD_COPY_DEFAULT_STACKSIZE (1024 * 1024)
 #define ABTD_SCHED_EVENT_FREQ 50
 #define ABTD_SCHED_SLEEP_NSEC 100
+#define ABTD_XSTREAM_BARRIER_SPINS 8192
+#define ABTD_XSTREAM_BARRIER_RADIX 8
+#define ABTD_MUTEX_QUEUED_SPINS 1024
+#define ABTD_EXT_WAIT_SPINS 4096
+#define ABTD_WAIT_SPIN_NSEC 1000
 
 #define ABTD_OS_PAGE_SIZE (4 * 1024)
 #define ABTD_HUGE_PAGE_SIZE (2 * 1024 * 1024)
@@ -131,6 +137,49 @@ void ABTD_env_init(ABTI_global *p_global)
         p_global->sched_stacksize = ABTD_SCHED_DEFAULT_STACKSIZE;
     }
 
+#ifdef ABT_CONFIG_USE_FCONTEXT
+    /* Size of stacks shared by stack-copying ULTs */
+    env = getenv("ABT_COPY_STACKSIZE");
+    if (env == NULL)
+        env = getenv("ABT_ENV_COPY_STACKSIZE");
+    if (env != NULL) {
+        p_global->copy_stacksize = (size_t)atol(env);
+        ABTI_ASSERT(p_global->copy_stacksize >= 512);
+    } else {
+        p_global->copy_stacksize = ABTD_COPY_DEFAULT_STACKSIZE;
+    }
+    /* Stack size must be a multiple of cacheline size. */
+    p_global->copy_stacksize =
+        (p_global->copy_stacksize + ABT_CONFIG_STATIC_CACHELINE_SIZE - 1) &
+        (~(ABT_CONFIG_STATIC_CACHELINE_SIZE - 1));
+#endif
+
+    /* Whether ULTs preserve the FPU control state by default or not.  It is
+     * enabled by default. */
+    p_global->thread_preserve_fpu = ABT_TRUE;
+    env = getenv("ABT_THREAD_PRESERVE_FPU");
+    if (env == NULL)
+        env = getenv("ABT_ENV_THREAD_PRESERVE_FPU");
+    if (env != NULL) {
+        if (strcmp(env, "0") == 0 || strcasecmp(env, "no") == 0 ||
+            strcasecmp(env, "n") == 0) {
+            p_global->thread_preserve_fpu = ABT_FALSE;
+        }
+    }
+
+    /* Whether ULT stacks are painted to measure their usage or not.  It is
+     * disabled by default. */
+    p_global->stack_paint = ABT_FALSE;
+    env = getenv("ABT_STACK_PAINT");
+    if (env == NULL)
+        env = getenv("ABT_ENV_STACK_PAINT");
+    if (env != NULL) {
+        if (strcmp(env, "1") == 0 || strcasecmp(env, "yes") == 0 ||
+            strcasecmp(env, "y") == 0) {
+            p_global->stack_paint = ABT_TRUE;
+        }
+    }
+
     /* Default frequency for event checking by the scheduler */
     env = getenv("ABT_SCHED_EVENT_FREQ");
     if (env == NULL)
@@ -174,6 +223,68 @@ void ABTD_env_init(ABTI_global *p_global)
         p_global->mutex_max_wakeups = 1;
     }
 
+    env = getenv("ABT_MUTEX_QUEUED_SPINS");
+    if (env == NULL)
+        env = getenv("ABT_ENV_MUTEX_QUEUED_SPINS");
+    if (env != NULL) {
+        p_global->mutex_queued_spins = (uint32_t)atoi(env);
+    } else {
+        p_global->mutex_queued_spins = ABTD_MUTEX_QUEUED_SPINS;
+    }
+
+    /* Barriers with at least this many waiters wake up the waiters in a tree
+     * manner.  0 disables tree barriers. */
+    env = getenv("ABT_BARRIER_TREE_THRESHOLD");
+    if (env == NULL)
+        env = getenv("ABT_ENV_BARRIER_TREE_THRESHOLD");
+    if (env != NULL) {
+        p_global->barrier_tree_threshold = (uint32_t)atoi(env);
+    } else {
+        p_global->barrier_tree_threshold = 32;
+    }
+
+    /* ES barriers: how many times a waiter checks the barrier before it
+     * sleeps, and how many ESs arrive at each node of the arrival tree.  A
+     * radix less than 2 makes all the ESs arrive at a single counter. */
+    env = getenv("ABT_XSTREAM_BARRIER_SPINS");
+    if (env == NULL)
+        env = getenv("ABT_ENV_XSTREAM_BARRIER_SPINS");
+    if (env != NULL) {
+        p_global->xstream_barrier_spins = (uint32_t)atoi(env);
+    } else {
+        p_global->xstream_barrier_spins = ABTD_XSTREAM_BARRIER_SPINS;
+    }
+
+    env = getenv("ABT_XSTREAM_BARRIER_RADIX");
+    if (env == NULL)
+        env = getenv("ABT_ENV_XSTREAM_BARRIER_RADIX");
+    if (env != NULL) {
+        p_global->xstream_barrier_radix = (uint32_t)atoi(env);
+    } else {
+        p_global->xstream_barrier_radix = ABTD_XSTREAM_BARRIER_RADIX;
+    }
+
+    /* External threads that wait in synchronization spin this many times
+     * before they sleep. */
+    env = getenv("ABT_EXT_WAIT_SPINS");
+    if (env == NULL)
+        env = getenv("ABT_ENV_EXT_WAIT_SPINS");
+    if (env != NULL) {
+        p_global->ext_wait_spins = (uint32_t)atoi(env);
+    } else {
+        p_global->ext_wait_spins = ABTD_EXT_WAIT_SPINS;
+    }
+
+    /* Max. spin window of ULTs waiting on eventuals, futures, and joins */
+    env = getenv("ABT_WAIT_SPIN_NSEC");
+    if (env == NULL)
+        env = getenv("ABT_ENV_WAIT_SPIN_NSEC");
+    if (env != NULL) {
+        p_global->wait_spin_nsec = (uint32_t)atoi(env);
+    } else {
+        p_global->wait_spin_nsec = ABTD_WAIT_SPIN_NSEC;
+    }
+
     /* OS page size */
     env = getenv("ABT_OS_PAGE_SIZE");
     if (env == NULL)
@@ -301,6 +412,32 @@ void ABTD_env_init(ABTI_global *p_global)
     } else {
         p_global->mem_lp_alloc = lp_alloc;
     }
+
+    /* Whether stacks and descriptors freed by an ES are returned to the ES
+     * that allocated them or not.  It is disabled by default. */
+    p_global->mem_remote_return = ABT_FALSE;
+    env = getenv("ABT_MEM_REMOTE_RETURN");
+    if (env == NULL)
+        env = getenv("ABT_ENV_MEM_REMOTE_RETURN");
+    if (env != NULL) {
+        if (strcmp(env, "1") == 0 || strcasecmp(env, "yes") == 0 ||
+            strcasecmp(env, "y") == 0) {
+            p_global->mem_remote_return = ABT_TRUE;
+        }
+    }
+
+    /* Whether the memory pools stop allocating memory once ABT_reserve() is
+     * called.  It is disabled by default. */
+    p_global->mem_no_alloc = ABT_FALSE;
+    env = getenv("ABT_MEM_NO_ALLOC");
+    if (env == NULL)
+        env = getenv("ABT_ENV_MEM_NO_ALLOC");
+    if (env != NULL) {
+        if (strcmp(env, "1") == 0 || strcasecmp(env, "yes") == 0 ||
+            strcasecmp(env, "y") == 0) {
+            p_global->mem_no_alloc = ABT_TRUE;
+        }
+    }
 #endif
 
     /* Whether to print the configuration on ABT_init() */
@@ -0,0 +1,83 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include "abti.h"
+
+#ifdef ABT_CONFIG_USE_LINUX_FUTEX
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <time.h>
+
+/* The system call is issued directly so that it does not depend on the futex
+ * support of the C library. */
+
+void ABTD_futex_wait(ABTD_atomic_uint32 *p_futex, uint32_t val)
+{
+    /* Returns immediately if *p_futex is not val.  A spurious wakeup is fine
+     * since the caller checks the value again. */
+    syscall(SYS_futex, &p_futex->val, FUTEX_WAIT_PRIVATE, val, NULL, NULL, 0);
+}
+
+void ABTD_futex_timedwait(ABTD_atomic_uint32 *p_futex, uint32_t val,
+                          double sec)
+{
+    /* The timeout of FUTEX_WAIT is relative. */
+    struct timespec timeout;
+    timeout.tv_sec = (time_t)sec;
+    timeout.tv_nsec = (long)((sec - (double)timeout.tv_sec) * 1.0e9);
+    syscall(SYS_futex, &p_futex->val, FUTEX_WAIT_PRIVATE, val, &timeout, NULL,
+            0);
+}
+
+void ABTD_futex_broadcast(ABTD_atomic_uint32 *p_futex)
+{
+    syscall(SYS_futex, &p_futex->val, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL,
+            0);
+}
+
+#else /* ABT_CONFIG_USE_LINUX_FUTEX */
+#include <sys/time.h>
+
+/* Without futex, all the waiters sleep on a single condition variable.  The
+ * waker changes the value before taking the lock, so a wakeup is not lost. */
+static pthread_mutex_t g_futex_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_futex_cond = PTHREAD_COND_INITIALIZER;
+
+void ABTD_futex_wait(ABTD_atomic_uint32 *p_futex, uint32_t val)
+{
+    pthread_mutex_lock(&g_futex_lock);
+    if (ABTD_atomic_acquire_load_uint32(p_futex) == val) {
+        pthread_cond_wait(&g_futex_cond, &g_futex_lock);
+    }
+    pthread_mutex_unlock(&g_futex_lock);
+}
+
+void ABTD_futex_timedwait(ABTD_atomic_uint32 *p_futex, uint32_t val,
+                          double sec)
+{
+    /* The timeout of pthread_cond_timedwait() is absolute. */
+    struct timeval now;
+    struct timespec abstime;
+    gettimeofday(&now, NULL);
+    double tar_sec = (double)now.tv_sec + (double)now.tv_usec * 1.0e-6 + sec;
+    abstime.tv_sec = (time_t)tar_sec;
+    abstime.tv_nsec = (long)((tar_sec - (double)abstime.tv_sec) * 1.0e9);
+    pthread_mutex_lock(&g_futex_lock);
+    if (ABTD_atomic_acquire_load_uint32(p_futex) == val) {
+        pthread_cond_timedwait(&g_futex_cond, &g_futex_lock, &abstime);
+    }
+    pthread_mutex_unlock(&g_futex_lock);
+}
+
+void ABTD_futex_broadcast(ABTD_atomic_uint32 *p_futex)
+{
+    (void)p_futex;
+    pthread_mutex_lock(&g_futex_lock);
+    pthread_cond_broadcast(&g_futex_cond);
+    pthread_mutex_unlock(&g_futex_lock);
+}
+
+#endif /* !ABT_CONFIG_USE_LINUX_FUTEX */
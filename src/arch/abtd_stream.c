@@ -119,3 +119,68 @@ int ABTD_xstream_context_set_self(ABTD_xstream_context *p_ctx)
     p_ctx->native_thread = pthread_self();
     return abt_errno;
 }
+
+int ABTD_xstream_barrier_init(uint32_t num_waiters, uint32_t radix,
+                              uint32_t num_spins,
+                              ABTD_xstream_barrier *p_barrier)
+{
+    uint32_t num_leaves, num_nodes, level_size, offset, i;
+    ABTD_xstream_barrier_node *p_nodes;
+
+    if (num_waiters == 0)
+        return ABT_ERR_XSTREAM_BARRIER;
+    /* If radix is less than 2 or not less than the number of waiters, all the
+     * waiters arrive at a single node. */
+    if (radix < 2 || radix >= num_waiters)
+        radix = num_waiters;
+    num_leaves = (num_waiters + radix - 1) / radix;
+    num_nodes = 0;
+    for (level_size = num_leaves; level_size > 1;
+         level_size = (level_size + radix - 1) / radix) {
+        num_nodes += level_size;
+    }
+    num_nodes += 1; /* Root */
+
+    p_nodes = (ABTD_xstream_barrier_node *)
+        ABTU_memalign(ABT_CONFIG_STATIC_CACHELINE_SIZE,
+                      sizeof(ABTD_xstream_barrier_node) * num_nodes);
+    /* Leaves take the waiters. */
+    for (i = 0; i < num_leaves; i++) {
+        ABTD_atomic_relaxed_store_uint32(&p_nodes[i].count, 0);
+        p_nodes[i].num_arrivals = (i + 1 < num_leaves)
+                                      ? radix
+                                      : num_waiters - radix * (num_leaves - 1);
+    }
+    /* Each upper node takes the last arrivals of up to radix children. */
+    offset = 0;
+    for (level_size = num_leaves; level_size > 1;
+         level_size = (level_size + radix - 1) / radix) {
+        uint32_t parent_offset = offset + level_size;
+        uint32_t num_parents = (level_size + radix - 1) / radix;
+        for (i = 0; i < num_parents; i++) {
+            uint32_t idx = parent_offset + i;
+            ABTD_atomic_relaxed_store_uint32(&p_nodes[idx].count, 0);
+            p_nodes[idx].num_arrivals = (i + 1 < num_parents)
+                                            ? radix
+                                            : level_size - radix * i;
+        }
+        for (i = 0; i < level_size; i++) {
+            p_nodes[offset + i].parent = parent_offset + i / radix;
+        }
+        offset = parent_offset;
+    }
+    p_nodes[num_nodes - 1].parent = UINT32_MAX;
+
+    ABTD_atomic_relaxed_store_uint32(&p_barrier->state, 0);
+    p_barrier->radix = radix;
+    p_barrier->num_leaves = num_leaves;
+    p_barrier->num_nodes = num_nodes;
+    p_barrier->num_spins = num_spins;
+    p_barrier->p_nodes = p_nodes;
+    return ABT_SUCCESS;
+}
+
+void ABTD_xstream_barrier_destroy(ABTD_xstream_barrier *p_barrier)
+{
+    ABTU_free(p_barrier->p_nodes);
+}
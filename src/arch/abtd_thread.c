@@ -13,10 +13,16 @@ void ABTD_thread_func_wrapper(void *p_arg)
     ABTD_thread_context *p_ctx = (ABTD_thread_context *)p_arg;
     ABTI_thread *p_thread = ABTI_thread_context_get_thread(p_ctx);
     ABTI_xstream *p_local_xstream = p_thread->unit_def.p_last_xstream;
-    ABTI_tool_event_thread_run(p_local_xstream, p_thread,
-                               p_local_xstream->p_unit,
+    ABTI_unit *p_prev = p_local_xstream->p_unit;
+    ABTI_tool_event_thread_run(p_local_xstream, p_thread, p_prev,
                                p_thread->unit_def.p_parent);
     p_local_xstream->p_unit = &p_thread->unit_def;
+    /* If this ULT has been created in the work-first manner, the creator
+     * must be pushed to its pool now. */
+    if (ABTU_unlikely(
+            ABTD_atomic_relaxed_load_uint32(&p_thread->unit_def.request) &
+            ABTI_UNIT_REQ_WORK_FIRST))
+        ABTI_thread_release_creator(p_local_xstream, p_thread, p_prev);
 
     p_thread->unit_def.f_unit(p_thread->unit_def.p_arg);
 
@@ -42,9 +48,16 @@ static inline void ABTD_thread_terminate(ABTI_xstream *p_local_xstream,
         /* If p_link is set, it means that other ULT has called the join. */
         ABTI_thread *p_joiner = ABTI_thread_context_get_thread(p_link);
         if (p_thread->unit_def.p_last_xstream ==
-            p_joiner->unit_def.p_last_xstream) {
+                p_joiner->unit_def.p_last_xstream &&
+            !ABTI_thread_is_stack_copy(p_thread) &&
+            !ABTI_thread_is_stack_copy(p_joiner)) {
             /* Only when the current ULT is on the same ES as p_joiner's,
-             * we can jump to the joiner ULT. */
+             * we can jump to the joiner ULT.  Stack-copying ULTs must go
+             * through the scheduler. */
+            if (gp_ABTI_global->stack_paint)
+                ABTI_thread_record_stack_usage(p_thread);
+            if (p_thread->unit_def.p_completion)
+                ABTI_thread_run_completion_cb(p_thread);
             ABTD_atomic_release_store_int(&p_thread->unit_def.state,
                                           ABTI_UNIT_STATE_TERMINATED);
             LOG_DEBUG("[U%" PRIu64 ":E%d] terminated\n",
@@ -5,6 +5,17 @@
 
 #include "abti.h"
 
+/* The phase bit of tree_counter.  The other bits count arrivals. */
+#define ABTI_BARRIER_TREE_PHASE ((uint32_t)1 << 31)
+/* Each waiter of a tree barrier wakes up at most this many waiters. */
+#define ABTI_BARRIER_TREE_RADIX 4
+/* A parent marks the slot of a child that has not registered itself yet. */
+#define ABTI_BARRIER_SLOT_WOKEN ((void *)1)
+
+static void ABTI_barrier_init_tree(ABTI_barrier *p_barrier);
+static int ABTI_barrier_tree_wait(ABTI_xstream **pp_local_xstream,
+                                  ABTI_barrier *p_barrier);
+
 /** @defgroup BARRIER Barrier
  * This group is for Barrier.
  */
@@ -28,7 +39,12 @@ int ABT_barrier_create(uint32_t num_waiters, ABT_barrier *newbarrier)
     int abt_errno = ABT_SUCCESS;
     ABTI_barrier *p_newbarrier;
 
-    p_newbarrier = (ABTI_barrier *)ABTU_malloc(sizeof(ABTI_barrier));
+    ABTI_STATIC_ASSERT(sizeof(ABTI_barrier) <= ABTI_MEM_POOL_DESC_SIZE);
+    p_newbarrier = (ABTI_barrier *)ABTI_mem_alloc_sync();
+    if (p_newbarrier == NULL) {
+        *newbarrier = ABT_BARRIER_NULL;
+        return ABT_ERR_MEM;
+    }
 
     ABTI_spinlock_clear(&p_newbarrier->lock);
     p_newbarrier->num_waiters = num_waiters;
@@ -37,6 +53,8 @@ int ABT_barrier_create(uint32_t num_waiters, ABT_barrier *newbarrier)
         (ABTI_thread **)ABTU_malloc(num_waiters * sizeof(ABTI_thread *));
     p_newbarrier->waiter_type =
         (ABT_unit_type *)ABTU_malloc(num_waiters * sizeof(ABT_unit_type));
+    p_newbarrier->p_slots = NULL;
+    ABTI_barrier_init_tree(p_newbarrier);
 
     /* Return value */
     *newbarrier = ABTI_barrier_get_handle(p_newbarrier);
@@ -64,6 +82,8 @@ int ABT_barrier_reinit(ABT_barrier barrier, uint32_t num_waiters)
     ABTI_CHECK_NULL_BARRIER_PTR(p_barrier);
 
     ABTI_ASSERT(p_barrier->counter == 0);
+    ABTI_ASSERT((ABTD_atomic_relaxed_load_uint32(&p_barrier->tree_counter) &
+                 ~ABTI_BARRIER_TREE_PHASE) == 0);
 
     /* Only when num_waiters is different from p_barrier->num_waiters, we
      * change p_barrier. */
@@ -80,6 +100,7 @@ int ABT_barrier_reinit(ABT_barrier barrier, uint32_t num_waiters)
         p_barrier->waiter_type =
             (ABT_unit_type *)ABTU_malloc(num_waiters * sizeof(ABT_unit_type));
     }
+    ABTI_barrier_init_tree(p_barrier);
 
 fn_exit:
     return abt_errno;
@@ -117,7 +138,9 @@ int ABT_barrier_free(ABT_barrier *barrier)
 
     ABTU_free(p_barrier->waiters);
     ABTU_free(p_barrier->waiter_type);
-    ABTU_free(p_barrier);
+    if (p_barrier->p_slots)
+        ABTU_free(p_barrier->p_slots);
+    ABTI_mem_free_sync(p_barrier);
 
     /* Return value */
     *barrier = ABT_BARRIER_NULL;
@@ -137,6 +160,11 @@ fn_fail:
  * The ULT calling \c ABT_barrier_wait() waits on the barrier until all the
  * ULTs reach the barrier.
  *
+ * If the number of waiters is at least \c ABT_BARRIER_TREE_THRESHOLD (32 by
+ * default), the waiters are woken up in a tree manner: the last waiter wakes
+ * up a few waiters, each of which wakes up a few more, and so on.  The wake-up
+ * is then spread over the ESs that run the waiters.
+ *
  * @param[in] barrier  handle to the barrier
  * @return Error code
  * @retval ABT_SUCCESS on success
@@ -149,6 +177,12 @@ int ABT_barrier_wait(ABT_barrier barrier)
     ABTI_CHECK_NULL_BARRIER_PTR(p_barrier);
     uint32_t pos;
 
+    if (p_barrier->p_slots) {
+        abt_errno = ABTI_barrier_tree_wait(&p_local_xstream, p_barrier);
+        ABTI_CHECK_ERROR(abt_errno);
+        goto fn_exit;
+    }
+
     ABTI_spinlock_acquire(&p_barrier->lock);
 
     ABTI_ASSERT(p_barrier->counter < p_barrier->num_waiters);
@@ -158,7 +192,7 @@ int ABT_barrier_wait(ABT_barrier barrier)
     if (p_barrier->counter < p_barrier->num_waiters) {
         ABTI_thread *p_thread;
         ABT_unit_type type;
-        ABTD_atomic_int32 ext_signal = ABTD_ATOMIC_INT32_STATIC_INITIALIZER(0);
+        ABTI_ext_waiter ext_waiter;
 
         if (p_local_xstream != NULL) {
             ABTI_unit *p_self = p_local_xstream->p_unit;
@@ -168,9 +202,8 @@ int ABT_barrier_wait(ABT_barrier barrier)
             type = ABT_UNIT_TYPE_THREAD;
         } else {
             /* external thread */
-            /* Check size if ext_signal can be stored in p_thread. */
-            ABTI_STATIC_ASSERT(sizeof(ext_signal) <= sizeof(p_thread));
-            p_thread = (ABTI_thread *)&ext_signal;
+            ABTI_ext_waiter_init(&ext_waiter);
+            p_thread = (ABTI_thread *)&ext_waiter;
             type = ABT_UNIT_TYPE_EXT;
         }
 
@@ -190,10 +223,8 @@ int ABT_barrier_wait(ABT_barrier barrier)
             ABTI_thread_suspend(&p_local_xstream, p_thread,
                                 ABT_SYNC_EVENT_TYPE_BARRIER, (void *)p_barrier);
         } else {
-            /* External thread is waiting here polling ext_signal. */
-            /* FIXME: need a better implementation */
-            while (!ABTD_atomic_acquire_load_int32(&ext_signal))
-                ;
+            /* External thread is waiting here. */
+            ABTI_ext_waiter_wait(&ext_waiter);
         }
     } else {
         /* Signal all the waiting ULTs */
@@ -204,8 +235,7 @@ int ABT_barrier_wait(ABT_barrier barrier)
                 ABTI_thread_set_ready(p_local_xstream, p_thread);
             } else {
                 /* When p_cur is an external thread */
-                ABTD_atomic_int32 *p_ext_signal = (ABTD_atomic_int32 *)p_thread;
-                ABTD_atomic_release_store_int32(p_ext_signal, 1);
+                ABTI_ext_waiter_signal((ABTI_ext_waiter *)p_thread);
             }
 
             p_barrier->waiters[i] = NULL;
@@ -253,3 +283,110 @@ fn_fail:
     HANDLE_ERROR_WITH_CODE("ABT_barrier_get_num_waiters", abt_errno);
     goto fn_exit;
 }
+
+/*****************************************************************************/
+/* Internal static functions                                                 */
+/*****************************************************************************/
+
+static void ABTI_barrier_init_tree(ABTI_barrier *p_barrier)
+{
+    uint32_t num_waiters = p_barrier->num_waiters;
+    uint32_t threshold = gp_ABTI_global->barrier_tree_threshold;
+
+    if (p_barrier->p_slots) {
+        ABTU_free(p_barrier->p_slots);
+        p_barrier->p_slots = NULL;
+    }
+    ABTD_atomic_relaxed_store_uint32(&p_barrier->tree_counter, 0);
+    if (threshold == 0 || num_waiters < threshold || num_waiters < 2)
+        return;
+    /* Waiters of the next phase use the other set of slots, so a waiter of
+     * this phase can still wake up its children after others arrive at the
+     * barrier again. */
+    p_barrier->p_slots = (ABTI_barrier_slot *)ABTU_calloc(
+        2 * num_waiters, sizeof(ABTI_barrier_slot));
+}
+
+/* Waiters obtain their positions with an atomic increment.  The last one
+ * becomes the root of the wake-up tree, whose node v >= 1 is the waiter at
+ * position v - 1 and wakes up nodes v * RADIX + 1 to v * RADIX + RADIX.
+ * Waiters and parents update the slots with CAS, so a parent never waits
+ * for a child that has arrived but has not registered itself yet. */
+static int ABTI_barrier_tree_wait(ABTI_xstream **pp_local_xstream,
+                                  ABTI_barrier *p_barrier)
+{
+    uint32_t num_waiters = p_barrier->num_waiters;
+    ABTI_thread *p_thread = NULL;
+    ABTI_ext_waiter ext_waiter;
+    uint32_t val, pos, node, child;
+
+    if (*pp_local_xstream != NULL) {
+        /* Tasklets cannot wait on a barrier. */
+        ABTI_unit *p_self = (*pp_local_xstream)->p_unit;
+        if (!ABTI_unit_type_is_thread(p_self->type))
+            return ABT_ERR_BARRIER;
+        p_thread = ABTI_unit_get_thread(p_self);
+    }
+
+    val = ABTD_atomic_fetch_add_uint32(&p_barrier->tree_counter, 1);
+    pos = val & ~ABTI_BARRIER_TREE_PHASE;
+    ABTI_ASSERT(pos < num_waiters);
+    ABTI_barrier_slot *p_slots =
+        &p_barrier->p_slots[(val & ABTI_BARRIER_TREE_PHASE) ? num_waiters : 0];
+
+    if (pos == num_waiters - 1) {
+        /* Start the next phase.  Nobody arrives until it is woken up. */
+        ABTD_atomic_release_store_uint32(&p_barrier->tree_counter,
+                                         (val & ABTI_BARRIER_TREE_PHASE) ^
+                                             ABTI_BARRIER_TREE_PHASE);
+        node = 0;
+    } else {
+        ABTI_barrier_slot *p_slot = &p_slots[pos];
+        if (p_thread) {
+            /* Change the ULT's state to BLOCKED before it can be woken up. */
+            ABTI_thread_set_blocked(p_thread);
+            p_slot->type = ABT_UNIT_TYPE_THREAD;
+            if (ABTD_atomic_bool_cas_strong_ptr(&p_slot->p_waiter, NULL,
+                                                (void *)p_thread)) {
+                ABTI_thread_suspend(pp_local_xstream, p_thread,
+                                    ABT_SYNC_EVENT_TYPE_BARRIER,
+                                    (void *)p_barrier);
+            } else {
+                ABTI_thread_cancel_blocked(p_thread);
+                ABTD_atomic_relaxed_store_ptr(&p_slot->p_waiter, NULL);
+            }
+        } else {
+            ABTI_ext_waiter_init(&ext_waiter);
+            p_slot->type = ABT_UNIT_TYPE_EXT;
+            if (ABTD_atomic_bool_cas_strong_ptr(&p_slot->p_waiter, NULL,
+                                                (void *)&ext_waiter)) {
+                /* External thread is waiting here. */
+                ABTI_ext_waiter_wait(&ext_waiter);
+            } else {
+                ABTD_atomic_relaxed_store_ptr(&p_slot->p_waiter, NULL);
+            }
+        }
+        node = pos + 1;
+    }
+
+    /* Wake up the children. */
+    for (child = node * ABTI_BARRIER_TREE_RADIX + 1;
+         child <= node * ABTI_BARRIER_TREE_RADIX + ABTI_BARRIER_TREE_RADIX &&
+         child < num_waiters;
+         child++) {
+        ABTI_barrier_slot *p_slot = &p_slots[child - 1];
+        void *p_waiter =
+            ABTD_atomic_val_cas_strong_ptr(&p_slot->p_waiter, NULL,
+                                           ABTI_BARRIER_SLOT_WOKEN);
+        if (p_waiter == NULL)
+            continue;
+        ABT_unit_type type = p_slot->type;
+        ABTD_atomic_relaxed_store_ptr(&p_slot->p_waiter, NULL);
+        if (type == ABT_UNIT_TYPE_THREAD) {
+            ABTI_thread_set_ready(*pp_local_xstream, (ABTI_thread *)p_waiter);
+        } else {
+            ABTI_ext_waiter_signal((ABTI_ext_waiter *)p_waiter);
+        }
+    }
+    return ABT_SUCCESS;
+}
@@ -28,8 +28,13 @@ int ABT_cond_create(ABT_cond *newcond)
     int abt_errno = ABT_SUCCESS;
     ABTI_cond *p_newcond;
 
-    p_newcond = (ABTI_cond *)ABTU_malloc(sizeof(ABTI_cond));
-    ABTI_cond_init(p_newcond);
+    ABTI_STATIC_ASSERT(sizeof(ABTI_cond) <= ABTI_MEM_POOL_DESC_SIZE);
+    p_newcond = (ABTI_cond *)ABTI_mem_alloc_sync();
+    if (p_newcond == NULL) {
+        abt_errno = ABT_ERR_MEM;
+    } else {
+        ABTI_cond_init(p_newcond);
+    }
 
     /* Return value */
     *newcond = ABTI_cond_get_handle(p_newcond);
@@ -59,7 +64,7 @@ int ABT_cond_free(ABT_cond *cond)
     ABTI_CHECK_TRUE(p_cond->num_waiters == 0, ABT_ERR_COND);
 
     ABTI_cond_fini(p_cond);
-    ABTU_free(p_cond);
+    ABTI_mem_free_sync(p_cond);
 
     /* Return value */
     *cond = ABT_COND_NULL;
@@ -119,9 +124,8 @@ static inline double convert_timespec_to_sec(const struct timespec *p_ts)
 
 static inline void remove_unit(ABTI_cond *p_cond, ABTI_unit *p_unit)
 {
-    if (p_unit->p_next == NULL)
-        return;
-
+    /* The lock must be taken even if p_unit has been dequeued since the
+     * signaler may still be waking up p_unit. */
     ABTI_spinlock_acquire(&p_cond->lock);
 
     if (p_unit->p_next == NULL) {
@@ -185,9 +189,11 @@ int ABT_cond_timedwait(ABT_cond cond, ABT_mutex mutex,
 
     double tar_time = convert_timespec_to_sec(abstime);
 
-    ABTI_unit *p_unit = (ABTI_unit *)ABTU_calloc(1, sizeof(ABTI_unit));
-    p_unit->type = ABTI_UNIT_TYPE_EXT;
-    ABTD_atomic_relaxed_store_int(&p_unit->state, ABTI_UNIT_STATE_BLOCKED);
+    /* ULTs also wait on an external waiter, which can be taken out of the
+     * queue on timeout. */
+    ABTI_ext_waiter ext_waiter;
+    ABTI_ext_waiter_init(&ext_waiter);
+    ABTI_unit *p_unit = &ext_waiter.unit;
 
     ABTI_spinlock_acquire(&p_cond->lock);
 
@@ -198,7 +204,6 @@ int ABT_cond_timedwait(ABT_cond cond, ABT_mutex mutex,
         if (result == ABT_FALSE) {
             ABTI_spinlock_release(&p_cond->lock);
             abt_errno = ABT_ERR_INV_MUTEX;
-            ABTU_free(p_unit);
             goto fn_fail;
         }
     }
@@ -223,25 +228,27 @@ int ABT_cond_timedwait(ABT_cond cond, ABT_mutex mutex,
     /* Unlock the mutex that the calling ULT is holding */
     ABTI_mutex_unlock(p_local_xstream, p_mutex);
 
-    while (ABTD_atomic_acquire_load_int(&p_unit->state) !=
-           ABTI_UNIT_STATE_READY) {
-        double cur_time = ABTI_get_wtime();
-        if (cur_time >= tar_time) {
+#ifndef ABT_CONFIG_DISABLE_EXT_THREAD
+    if (!ABTI_unit_type_is_thread(ABTI_self_get_type(p_local_xstream))) {
+        if (!ABTI_ext_waiter_timedwait(&ext_waiter, tar_time)) {
             remove_unit(p_cond, p_unit);
             abt_errno = ABT_ERR_COND_TIMEDOUT;
-            break;
-        }
-#ifndef ABT_CONFIG_DISABLE_EXT_THREAD
-        if (!ABTI_unit_type_is_thread(ABTI_self_get_type(p_local_xstream))) {
-            ABTD_atomic_pause();
-            continue;
         }
+    } else
 #endif
-        ABTI_thread_yield(&p_local_xstream,
-                          ABTI_unit_get_thread(p_local_xstream->p_unit),
-                          ABT_SYNC_EVENT_TYPE_COND, (void *)p_cond);
+    {
+        while (!ABTI_ext_waiter_is_ready(&ext_waiter)) {
+            double cur_time = ABTI_get_wtime();
+            if (cur_time >= tar_time) {
+                remove_unit(p_cond, p_unit);
+                abt_errno = ABT_ERR_COND_TIMEDOUT;
+                break;
+            }
+            ABTI_thread_yield(&p_local_xstream,
+                              ABTI_unit_get_thread(p_local_xstream->p_unit),
+                              ABT_SYNC_EVENT_TYPE_COND, (void *)p_cond);
+        }
     }
-    ABTU_free(p_unit);
 
     /* Lock the mutex again */
     ABTI_mutex_lock(&p_local_xstream, p_mutex);
@@ -283,6 +290,7 @@ int ABT_cond_signal(ABT_cond cond)
     }
 
     /* Wake up the first waiting ULT */
+    ABTI_mutex *p_mutex = p_cond->p_waiter_mutex;
     ABTI_unit *p_unit = p_cond->p_head;
 
     p_cond->num_waiters--;
@@ -299,11 +307,13 @@ int ABT_cond_signal(ABT_cond cond)
     p_unit->p_next = NULL;
 
     if (ABTI_unit_type_is_thread(p_unit->type)) {
+        /* The ULT waits on the mutex if it is locked (wait morphing). */
         ABTI_thread *p_thread = ABTI_unit_get_thread(p_unit);
-        ABTI_thread_set_ready(p_local_xstream, p_thread);
+        if (!ABTI_mutex_add_waiter(p_mutex, p_thread))
+            ABTI_thread_set_ready(p_local_xstream, p_thread);
     } else {
         /* When the head is an external thread */
-        ABTD_atomic_release_store_int(&p_unit->state, ABTI_UNIT_STATE_READY);
+        ABTI_ext_waiter_signal(ABTI_ext_waiter_get_ptr(p_unit));
     }
 
     ABTI_spinlock_release(&p_cond->lock);
@@ -325,6 +335,12 @@ fn_fail:
  * This routine shall have no effect if no ULTs are currently blocked on the
  * condition variable.
  *
+ * If the mutex associated with the waiters is locked (e.g., by the caller),
+ * the waiting ULTs may be moved to the waiter queue of the mutex instead of
+ * being resumed immediately, and they are resumed one by one as the mutex is
+ * released.  This is not done for mutexes that do not have a waiter queue
+ * (i.e., when Argobots is configured with the simple mutex, the default).
+ *
  * @param[in] cond   handle to the condition variable
  * @return Error code
  * @retval ABT_SUCCESS on success
@@ -74,14 +74,21 @@ int ABT_error_get_str(int err, char *str, size_t *len)
                                      "ABT_ERR_FUTURE",
                                      "ABT_ERR_BARRIER",
                                      "ABT_ERR_TIMER",
-                                     "ABT_ERR_EVENT",
                                      "ABT_ERR_MIGRATION_TARGET",
                                      "ABT_ERR_MIGRATION_NA",
                                      "ABT_ERR_MISSING_JOIN",
-                                     "ABT_ERR_FEATURE_NA" };
+                                     "ABT_ERR_FEATURE_NA",
+                                     "ABT_ERR_INV_TOOL_CONTEXT",
+                                     "ABT_ERR_INV_GROUP",
+                                     "ABT_ERR_GROUP",
+                                     "ABT_ERR_INV_RWLOCK_ATTR",
+                                     "ABT_ERR_INV_SEM",
+                                     "ABT_ERR_SEM",
+                                     "ABT_ERR_SEM_UNAVAILABLE",
+                                     "ABT_ERR_SEM_TIMEDOUT" };
 
     int abt_errno = ABT_SUCCESS;
-    ABTI_CHECK_TRUE(err >= ABT_SUCCESS && err <= ABT_ERR_FEATURE_NA,
+    ABTI_CHECK_TRUE(err >= ABT_SUCCESS && err <= ABT_ERR_SEM_TIMEDOUT,
                     ABT_ERR_OTHER);
     if (str)
         ABTU_strcpy(str, err_str[err]);
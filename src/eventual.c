@@ -34,11 +34,28 @@ int ABT_eventual_create(int nbytes, ABT_eventual *neweventual)
     int abt_errno = ABT_SUCCESS;
     ABTI_eventual *p_eventual;
 
-    p_eventual = (ABTI_eventual *)ABTU_malloc(sizeof(ABTI_eventual));
+    ABTI_STATIC_ASSERT(sizeof(ABTI_eventual) <= ABTI_MEM_POOL_DESC_SIZE);
+    p_eventual = (ABTI_eventual *)ABTI_mem_alloc_sync();
+    if (p_eventual == NULL) {
+        abt_errno = ABT_ERR_MEM;
+        *neweventual = ABT_EVENTUAL_NULL;
+        return abt_errno;
+    }
     ABTI_spinlock_clear(&p_eventual->lock);
-    p_eventual->ready = ABT_FALSE;
+    ABTD_atomic_relaxed_store_int(&p_eventual->ready, ABT_FALSE);
+    ABTI_spin_wait_init(&p_eventual->spin, ABTI_global_get_wait_spin_nsec());
     p_eventual->nbytes = nbytes;
-    p_eventual->value = (nbytes == 0) ? NULL : ABTU_malloc(nbytes);
+    if (nbytes == 0) {
+        p_eventual->value = NULL;
+    } else if (ABTI_MEM_DESC_EXTRA_OFFSET(sizeof(ABTI_eventual)) + nbytes <=
+               ABTI_MEM_POOL_DESC_SIZE) {
+        /* A small value is stored in the same descriptor. */
+        p_eventual->value =
+            ((char *)p_eventual) +
+            ABTI_MEM_DESC_EXTRA_OFFSET(sizeof(ABTI_eventual));
+    } else {
+        p_eventual->value = ABTU_malloc(nbytes);
+    }
     p_eventual->p_head = NULL;
     p_eventual->p_tail = NULL;
 
@@ -70,9 +87,13 @@ int ABT_eventual_free(ABT_eventual *eventual)
      * freed here. */
     ABTI_spinlock_acquire(&p_eventual->lock);
 
-    if (p_eventual->value)
+    if (p_eventual->value &&
+        p_eventual->value !=
+            ((char *)p_eventual) +
+                ABTI_MEM_DESC_EXTRA_OFFSET(sizeof(ABTI_eventual))) {
         ABTU_free(p_eventual->value);
-    ABTU_free(p_eventual);
+    }
+    ABTI_mem_free_sync(p_eventual);
 
     *eventual = ABT_EVENTUAL_NULL;
 
@@ -107,11 +128,21 @@ int ABT_eventual_wait(ABT_eventual eventual, void **value)
     ABTI_xstream *p_local_xstream = ABTI_local_get_xstream();
     ABTI_eventual *p_eventual = ABTI_eventual_get_ptr(eventual);
     ABTI_CHECK_NULL_EVENTUAL_PTR(p_eventual);
+    double spin_start;
+
+    /* A ready eventual can be read without taking the lock since the value is
+     * written before ready is set with release semantics. */
+    if (ABTD_atomic_acquire_load_int(&p_eventual->ready) != ABT_FALSE)
+        goto fn_ready;
+    if (ABTI_spin_wait_begin(&p_eventual->spin, p_local_xstream,
+                             &p_eventual->ready, ABT_TRUE, &spin_start))
+        goto fn_ready;
 
     ABTI_spinlock_acquire(&p_eventual->lock);
-    if (p_eventual->ready == ABT_FALSE) {
+    if (ABTD_atomic_relaxed_load_int(&p_eventual->ready) == ABT_FALSE) {
         ABTI_thread *p_current;
         ABTI_unit *p_unit;
+        ABTI_ext_waiter ext_waiter;
 
         if (p_local_xstream != NULL) {
             p_unit = p_local_xstream->p_unit;
@@ -121,11 +152,8 @@ int ABT_eventual_wait(ABT_eventual eventual, void **value)
         } else {
             /* external thread */
             p_current = NULL;
-            p_unit = (ABTI_unit *)ABTU_calloc(1, sizeof(ABTI_unit));
-            p_unit->type = ABTI_UNIT_TYPE_EXT;
-            /* use state for synchronization */
-            ABTD_atomic_relaxed_store_int(&p_unit->state,
-                                          ABTI_UNIT_STATE_BLOCKED);
+            ABTI_ext_waiter_init(&ext_waiter);
+            p_unit = &ext_waiter.unit;
         }
 
         p_unit->p_next = NULL;
@@ -146,19 +174,19 @@ int ABT_eventual_wait(ABT_eventual eventual, void **value)
             ABTI_thread_suspend(&p_local_xstream, p_current,
                                 ABT_SYNC_EVENT_TYPE_EVENTUAL,
                                 (void *)p_eventual);
+            ABTI_spin_wait_end(&p_eventual->spin, spin_start);
 
         } else {
             ABTI_spinlock_release(&p_eventual->lock);
 
             /* External thread is waiting here. */
-            while (ABTD_atomic_acquire_load_int(&p_unit->state) !=
-                   ABTI_UNIT_STATE_READY)
-                ;
-            ABTU_free(p_unit);
+            ABTI_ext_waiter_wait(&ext_waiter);
         }
     } else {
         ABTI_spinlock_release(&p_eventual->lock);
     }
+
+fn_ready:
     if (value)
         *value = p_eventual->value;
 
@@ -192,13 +220,11 @@ int ABT_eventual_test(ABT_eventual eventual, void **value, int *is_ready)
     ABTI_CHECK_NULL_EVENTUAL_PTR(p_eventual);
     int flag = ABT_FALSE;
 
-    ABTI_spinlock_acquire(&p_eventual->lock);
-    if (p_eventual->ready != ABT_FALSE) {
+    if (ABTD_atomic_acquire_load_int(&p_eventual->ready) != ABT_FALSE) {
         if (value)
             *value = p_eventual->value;
         flag = ABT_TRUE;
     }
-    ABTI_spinlock_release(&p_eventual->lock);
 
     *is_ready = flag;
 
@@ -237,9 +263,9 @@ int ABT_eventual_set(ABT_eventual eventual, void *value, int nbytes)
 
     ABTI_spinlock_acquire(&p_eventual->lock);
 
-    p_eventual->ready = ABT_TRUE;
     if (p_eventual->value)
         memcpy(p_eventual->value, value, nbytes);
+    ABTD_atomic_release_store_int(&p_eventual->ready, ABT_TRUE);
 
     if (p_eventual->p_head == NULL) {
         ABTI_spinlock_release(&p_eventual->lock);
@@ -258,8 +284,7 @@ int ABT_eventual_set(ABT_eventual eventual, void *value, int nbytes)
             ABTI_thread_set_ready(p_local_xstream, p_thread);
         } else {
             /* When the head is an external thread */
-            ABTD_atomic_release_store_int(&p_unit->state,
-                                          ABTI_UNIT_STATE_READY);
+            ABTI_ext_waiter_signal(ABTI_ext_waiter_get_ptr(p_unit));
         }
 
         /* Next ULT */
@@ -302,7 +327,41 @@ int ABT_eventual_reset(ABT_eventual eventual)
     ABTI_CHECK_NULL_EVENTUAL_PTR(p_eventual);
 
     ABTI_spinlock_acquire(&p_eventual->lock);
-    p_eventual->ready = ABT_FALSE;
+    ABTD_atomic_relaxed_store_int(&p_eventual->ready, ABT_FALSE);
+    ABTI_spinlock_release(&p_eventual->lock);
+
+fn_exit:
+    return abt_errno;
+
+fn_fail:
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
+}
+
+/**
+ * @ingroup EVENTUAL
+ * @brief   Set the maximum spin time of waiters on the target eventual.
+ *
+ * \c ABT_eventual_set_wait_spin_nsec() sets how long a ULT calling
+ * \c ABT_eventual_wait() on \c eventual may spin at most before it suspends.
+ * The spin time adapts to recent wait durations on \c eventual within this
+ * limit, so waits that end shortly after they start avoid context switches.
+ * \c max_nsec of zero disables spinning.  The default value is set by
+ * \c ABT_WAIT_SPIN_NSEC.
+ *
+ * @param[in] eventual  handle to the target eventual
+ * @param[in] max_nsec  maximum spin time in nanoseconds
+ * @return Error code
+ * @retval ABT_SUCCESS on success
+ */
+int ABT_eventual_set_wait_spin_nsec(ABT_eventual eventual, uint32_t max_nsec)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_eventual *p_eventual = ABTI_eventual_get_ptr(eventual);
+    ABTI_CHECK_NULL_EVENTUAL_PTR(p_eventual);
+
+    ABTI_spinlock_acquire(&p_eventual->lock);
+    ABTI_spin_wait_init(&p_eventual->spin, max_nsec);
     ABTI_spinlock_release(&p_eventual->lock);
 
 fn_exit:
@@ -59,11 +59,31 @@ int ABT_future_create(uint32_t compartments, void (*cb_func)(void **arg),
     int abt_errno = ABT_SUCCESS;
     ABTI_future *p_future;
 
-    p_future = (ABTI_future *)ABTU_malloc(sizeof(ABTI_future));
+    ABTI_STATIC_ASSERT(sizeof(ABTI_future) <= ABTI_MEM_POOL_DESC_SIZE);
+    p_future = (ABTI_future *)ABTI_mem_alloc_sync();
+    if (p_future == NULL) {
+        abt_errno = ABT_ERR_MEM;
+        *newfuture = ABT_FUTURE_NULL;
+        return abt_errno;
+    }
     ABTI_spinlock_clear(&p_future->lock);
+    ABTD_atomic_relaxed_store_uint32(&p_future->num_claimed, 0);
     ABTD_atomic_relaxed_store_uint32(&p_future->counter, 0);
+    /* A future without compartments is ready from the beginning. */
+    ABTD_atomic_relaxed_store_int(&p_future->ready,
+                                  compartments == 0 ? ABT_TRUE : ABT_FALSE);
+    ABTI_spin_wait_init(&p_future->spin, ABTI_global_get_wait_spin_nsec());
     p_future->compartments = compartments;
-    p_future->array = ABTU_malloc(compartments * sizeof(void *));
+    if (ABTI_MEM_DESC_EXTRA_OFFSET(sizeof(ABTI_future)) +
+            compartments * sizeof(void *) <=
+        ABTI_MEM_POOL_DESC_SIZE) {
+        /* A small array is stored in the same descriptor. */
+        p_future->array =
+            (void **)(((char *)p_future) +
+                      ABTI_MEM_DESC_EXTRA_OFFSET(sizeof(ABTI_future)));
+    } else {
+        p_future->array = ABTU_malloc(compartments * sizeof(void *));
+    }
     p_future->p_callback = cb_func;
     p_future->p_head = NULL;
     p_future->p_tail = NULL;
@@ -96,8 +116,11 @@ int ABT_future_free(ABT_future *future)
      * freed here. */
     ABTI_spinlock_acquire(&p_future->lock);
 
-    ABTU_free(p_future->array);
-    ABTU_free(p_future);
+    if ((char *)p_future->array !=
+        ((char *)p_future) + ABTI_MEM_DESC_EXTRA_OFFSET(sizeof(ABTI_future))) {
+        ABTU_free(p_future->array);
+    }
+    ABTI_mem_free_sync(p_future);
 
     *future = ABT_FUTURE_NULL;
 
@@ -130,12 +153,19 @@ int ABT_future_wait(ABT_future future)
     ABTI_xstream *p_local_xstream = ABTI_local_get_xstream();
     ABTI_future *p_future = ABTI_future_get_ptr(future);
     ABTI_CHECK_NULL_FUTURE_PTR(p_future);
+    double spin_start;
+
+    if (ABTD_atomic_acquire_load_int(&p_future->ready) != ABT_FALSE)
+        goto fn_exit;
+    if (ABTI_spin_wait_begin(&p_future->spin, p_local_xstream,
+                             &p_future->ready, ABT_TRUE, &spin_start))
+        goto fn_exit;
 
     ABTI_spinlock_acquire(&p_future->lock);
-    if (ABTD_atomic_relaxed_load_uint32(&p_future->counter) <
-        p_future->compartments) {
+    if (ABTD_atomic_relaxed_load_int(&p_future->ready) == ABT_FALSE) {
         ABTI_thread *p_current;
         ABTI_unit *p_unit;
+        ABTI_ext_waiter ext_waiter;
 
         if (p_local_xstream != NULL) {
             p_unit = p_local_xstream->p_unit;
@@ -150,11 +180,8 @@ int ABT_future_wait(ABT_future future)
         } else {
             /* external thread */
             p_current = NULL;
-            p_unit = (ABTI_unit *)ABTU_calloc(1, sizeof(ABTI_unit));
-            p_unit->type = ABTI_UNIT_TYPE_EXT;
-            /* use state for synchronization */
-            ABTD_atomic_relaxed_store_int(&p_unit->state,
-                                          ABTI_UNIT_STATE_BLOCKED);
+            ABTI_ext_waiter_init(&ext_waiter);
+            p_unit = &ext_waiter.unit;
         }
 
         p_unit->p_next = NULL;
@@ -174,15 +201,13 @@ int ABT_future_wait(ABT_future future)
             /* Suspend the current ULT */
             ABTI_thread_suspend(&p_local_xstream, p_current,
                                 ABT_SYNC_EVENT_TYPE_FUTURE, (void *)p_future);
+            ABTI_spin_wait_end(&p_future->spin, spin_start);
 
         } else {
             ABTI_spinlock_release(&p_future->lock);
 
             /* External thread is waiting here. */
-            while (ABTD_atomic_acquire_load_int(&p_unit->state) !=
-                   ABTI_UNIT_STATE_READY)
-                ;
-            ABTU_free(p_unit);
+            ABTI_ext_waiter_wait(&ext_waiter);
         }
     } else {
         ABTI_spinlock_release(&p_future->lock);
@@ -214,8 +239,9 @@ int ABT_future_test(ABT_future future, ABT_bool *flag)
     ABTI_future *p_future = ABTI_future_get_ptr(future);
     ABTI_CHECK_NULL_FUTURE_PTR(p_future);
 
-    uint32_t counter = ABTD_atomic_acquire_load_uint32(&p_future->counter);
-    *flag = (counter == p_future->compartments) ? ABT_TRUE : ABT_FALSE;
+    *flag = ABTD_atomic_acquire_load_int(&p_future->ready) != ABT_FALSE
+                ? ABT_TRUE
+                : ABT_FALSE;
 
 fn_exit:
     return abt_errno;
@@ -236,6 +262,10 @@ fn_fail:
  * routine will store the pointer passed by parameter \c value and increase
  * the internal counter.
  *
+ * Setters claim their compartments with atomic operations, so concurrent
+ * \c ABT_future_set calls do not serialize on the future.  Only the last
+ * setter, which runs the callback and wakes up the waiters, takes the lock.
+ *
  * @param[in] future  handle to the future
  * @param[in] value   pointer to the memory buffer containing the data that
  *                    will be pointed by one compartment of the future
@@ -249,24 +279,28 @@ int ABT_future_set(ABT_future future, void *value)
     ABTI_future *p_future = ABTI_future_get_ptr(future);
     ABTI_CHECK_NULL_FUTURE_PTR(p_future);
 
-    ABTI_spinlock_acquire(&p_future->lock);
-
-    int counter = ABTD_atomic_relaxed_load_uint32(&p_future->counter);
+    uint32_t index = ABTD_atomic_fetch_add_uint32(&p_future->num_claimed, 1);
 #ifndef ABT_CONFIG_DISABLE_ERROR_CHECK
-    if (counter >= p_future->compartments) {
+    if (index >= p_future->compartments) {
+        ABTD_atomic_fetch_sub_uint32(&p_future->num_claimed, 1);
         abt_errno = ABT_ERR_FUTURE;
-        ABTI_spinlock_release(&p_future->lock);
         goto fn_fail;
     }
 #endif
-    p_future->array[counter] = value;
-    counter++;
-    ABTD_atomic_release_store_uint32(&p_future->counter, counter);
+    p_future->array[index] = value;
 
+    /* counter is incremented after the compartment is written.  The setter
+     * that completes the future observes all the other compartments since
+     * the increments form a release sequence. */
+    uint32_t counter = ABTD_atomic_fetch_add_uint32(&p_future->counter, 1) + 1;
     if (counter == p_future->compartments) {
         if (p_future->p_callback != NULL)
             (*p_future->p_callback)(p_future->array);
 
+        /* The lock serializes this wake-up with waiters that have checked
+         * ready and are enqueueing themselves. */
+        ABTI_spinlock_acquire(&p_future->lock);
+        ABTD_atomic_release_store_int(&p_future->ready, ABT_TRUE);
         if (p_future->p_head == NULL) {
             ABTI_spinlock_release(&p_future->lock);
             goto fn_exit;
@@ -284,8 +318,7 @@ int ABT_future_set(ABT_future future, void *value)
                 ABTI_thread_set_ready(p_local_xstream, p_thread);
             } else {
                 /* When the head is an external thread */
-                ABTD_atomic_release_store_int(&p_unit->state,
-                                              ABTI_UNIT_STATE_READY);
+                ABTI_ext_waiter_signal(ABTI_ext_waiter_get_ptr(p_unit));
             }
 
             /* Next ULT */
@@ -297,10 +330,9 @@ int ABT_future_set(ABT_future future, void *value)
         }
         p_future->p_head = NULL;
         p_future->p_tail = NULL;
+        ABTI_spinlock_release(&p_future->lock);
     }
 
-    ABTI_spinlock_release(&p_future->lock);
-
 fn_exit:
     return abt_errno;
 
@@ -328,7 +360,45 @@ int ABT_future_reset(ABT_future future)
     ABTI_CHECK_NULL_FUTURE_PTR(p_future);
 
     ABTI_spinlock_acquire(&p_future->lock);
-    ABTD_atomic_release_store_uint32(&p_future->counter, 0);
+    ABTD_atomic_relaxed_store_uint32(&p_future->num_claimed, 0);
+    ABTD_atomic_relaxed_store_uint32(&p_future->counter, 0);
+    ABTD_atomic_release_store_int(&p_future->ready, p_future->compartments == 0
+                                                      ? ABT_TRUE
+                                                      : ABT_FALSE);
+    ABTI_spinlock_release(&p_future->lock);
+
+fn_exit:
+    return abt_errno;
+
+fn_fail:
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
+}
+
+/**
+ * @ingroup FUTURE
+ * @brief   Set the maximum spin time of waiters on the target future.
+ *
+ * \c ABT_future_set_wait_spin_nsec() sets how long a ULT calling
+ * \c ABT_future_wait() on \c future may spin at most before it suspends.  The
+ * spin time adapts to recent wait durations on \c future within this limit,
+ * so waits that end shortly after they start avoid context switches.
+ * \c max_nsec of zero disables spinning.  The default value is set by
+ * \c ABT_WAIT_SPIN_NSEC.
+ *
+ * @param[in] future    handle to the target future
+ * @param[in] max_nsec  maximum spin time in nanoseconds
+ * @return Error code
+ * @retval ABT_SUCCESS on success
+ */
+int ABT_future_set_wait_spin_nsec(ABT_future future, uint32_t max_nsec)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_future *p_future = ABTI_future_get_ptr(future);
+    ABTI_CHECK_NULL_FUTURE_PTR(p_future);
+
+    ABTI_spinlock_acquire(&p_future->lock);
+    ABTI_spin_wait_init(&p_future->spin, max_nsec);
     ABTI_spinlock_release(&p_future->lock);
 
 fn_exit:
@@ -58,6 +58,10 @@ int ABT_init(int argc, char **argv)
 
     /* Initialize memory pool */
     ABTI_mem_init(gp_ABTI_global);
+#ifdef ABT_CONFIG_USE_FCONTEXT
+    ABTI_copy_stack_init(gp_ABTI_global);
+#endif
+    ABTI_stack_usage_init(gp_ABTI_global);
 
     /* Initialize IDs */
     ABTI_thread_reset_id();
@@ -80,6 +84,12 @@ int ABT_init(int argc, char **argv)
                                      0);
 #endif
 
+#ifndef ABT_CONFIG_DISABLE_EXT_THREAD
+    /* Initialize the futex of external joiners */
+    ABTD_atomic_relaxed_store_uint32(&gp_ABTI_global->num_ext_joiners, 0);
+    ABTD_atomic_relaxed_store_uint32(&gp_ABTI_global->ext_join_seq, 0);
+#endif
+
     /* Initialize the ES array */
     gp_ABTI_global->p_xstreams =
         (ABTI_xstream **)ABTU_calloc(gp_ABTI_global->max_xstreams,
@@ -224,6 +234,10 @@ int ABT_finalize(void)
 
     /* Finalize the memory pool */
     ABTI_mem_finalize(gp_ABTI_global);
+#ifdef ABT_CONFIG_USE_FCONTEXT
+    ABTI_copy_stack_finalize(gp_ABTI_global);
+#endif
+    ABTI_stack_usage_finalize(gp_ABTI_global);
 
     /* Restore the affinity */
     if (gp_ABTI_global->set_affinity == ABT_TRUE) {
@@ -268,6 +282,114 @@ int ABT_initialized(void)
     return abt_errno;
 }
 
+/**
+ * @ingroup ENV
+ * @brief   Set the memory allocator used by Argobots.
+ *
+ * \c ABT_set_allocator() sets the memory allocator that Argobots uses for all
+ * of its internal memory, including ULT stacks, descriptors of work units and
+ * synchronization objects, and pages of the memory pool.  \c malloc_f,
+ * \c memalign_f, and \c free_f of \c allocator must be set.  If
+ * \c alloc_largepage_f and \c free_largepage_f are set, the memory pool
+ * allocates its pages with them instead of the method specified by
+ * \c ABT_MEM_LP_ALLOC.  If \c allocator is \c NULL, the default allocator
+ * (i.e., libc) is restored.  \c allocator is copied, so the caller can free
+ * it after this routine returns.
+ *
+ * \c ABT_set_allocator() can be called only when Argobots is not initialized
+ * (i.e., before \c ABT_init() or after \c ABT_finalize()) because memory
+ * must be freed by the allocator that allocated it.  Note that \c ABT_timer
+ * always uses libc since it is available without initialization.
+ *
+ * @param[in] allocator  memory allocator
+ * @return Error code
+ * @retval ABT_SUCCESS   on success
+ * @retval ABT_ERR_OTHER if Argobots is initialized or \c allocator is invalid
+ */
+int ABT_set_allocator(const ABT_allocator *allocator)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_spinlock_acquire(&g_ABTI_init_lock);
+    if (g_ABTI_num_inits != 0) {
+        abt_errno = ABT_ERR_OTHER;
+        goto fn_fail;
+    }
+    if (allocator) {
+        if (!allocator->malloc_f || !allocator->memalign_f ||
+            !allocator->free_f ||
+            !allocator->alloc_largepage_f != !allocator->free_largepage_f) {
+            abt_errno = ABT_ERR_OTHER;
+            goto fn_fail;
+        }
+        g_ABTU_allocator.malloc_f = allocator->malloc_f;
+        g_ABTU_allocator.memalign_f = allocator->memalign_f;
+        g_ABTU_allocator.free_f = allocator->free_f;
+        g_ABTU_allocator.alloc_largepage_f = allocator->alloc_largepage_f;
+        g_ABTU_allocator.free_largepage_f = allocator->free_largepage_f;
+        g_ABTU_allocator.arg = allocator->arg;
+    } else {
+        memset(&g_ABTU_allocator, 0, sizeof(ABTU_allocator));
+    }
+
+fn_exit:
+    ABTI_spinlock_release(&g_ABTI_init_lock);
+    return abt_errno;
+
+fn_fail:
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
+}
+
+/**
+ * @ingroup ENV
+ * @brief   Reserve memory for work units and synchronization objects.
+ *
+ * \c ABT_reserve() makes the memory pools allocate memory for at least
+ * \c num_threads ULTs, \c num_tasks tasklets, and \c num_sync_objects
+ * synchronization objects (e.g., \c ABT_mutex and \c ABT_eventual) in
+ * advance.  The memory that the memory pools already hold counts toward the
+ * reservation.  ULTs that are created with a non-default stack size or a
+ * user-provided stack do not use the reserved memory.
+ *
+ * Synchronization objects created after this routine is called are allocated
+ * from the memory pools, so they must be freed before \c ABT_finalize().
+ *
+ * If \c ABT_MEM_NO_ALLOC is enabled, the memory pools do not allocate memory
+ * after this routine is called; routines that create ULTs, tasklets, or
+ * synchronization objects return \c ABT_ERR_MEM instead of allocating
+ * memory once the reserved memory is exhausted.  Since each execution stream
+ * caches a part of the reserved memory, execution streams should be created
+ * before calling this routine.  \c ABT_info_query_mem_stats() reports how
+ * much memory has been reserved and how many allocations have failed.
+ *
+ * @param[in] num_threads       number of ULTs
+ * @param[in] num_tasks         number of tasklets
+ * @param[in] num_sync_objects  number of synchronization objects
+ * @return Error code
+ * @retval ABT_SUCCESS        on success
+ * @retval ABT_ERR_FEATURE_NA if the memory pool is disabled
+ */
+int ABT_reserve(int num_threads, int num_tasks, int num_sync_objects)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_CHECK_INITIALIZED();
+    ABTI_CHECK_TRUE(num_threads >= 0 && num_tasks >= 0 && num_sync_objects >= 0,
+                    ABT_ERR_OTHER);
+
+    /* A ULT uses a stack and a tasklet and a synchronization object use a
+     * descriptor. */
+    abt_errno = ABTI_mem_reserve(gp_ABTI_global, (size_t)num_threads,
+                                 (size_t)num_tasks + (size_t)num_sync_objects);
+    ABTI_CHECK_ERROR(abt_errno);
+
+fn_exit:
+    return abt_errno;
+
+fn_fail:
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
+}
+
 /* If new_size is equal to zero, we double max_xstreams.
  * NOTE: This function currently cannot decrease max_xstreams.
  */
@@ -0,0 +1,350 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include "abti.h"
+
+static void ABTI_group_unit_done(ABTI_group *p_group);
+static void ABTI_group_thread_done(ABT_thread thread, void *cb_arg);
+static void ABTI_group_task_done(ABT_task task, void *cb_arg);
+
+/** @defgroup GROUP Group
+ * This group is for Group.
+ *
+ * A group tracks work units created by \c ABT_group_thread_create() and
+ * \c ABT_group_task_create() with a single counter so that their creator can
+ * wait for all of them at once with \c ABT_group_wait().  Unlike
+ * \c ABT_thread_join_many(), the waiter is suspended at most once and is woken
+ * up by the last work unit that finishes.  Work units in a group are unnamed;
+ * they are freed by the runtime when they finish.  A work unit of a group can
+ * add more work units to the same group or wait on its own nested groups.
+ */
+
+/**
+ * @ingroup GROUP
+ * @brief   Create a new group.
+ *
+ * \c ABT_group_create() creates a new empty group and returns its handle
+ * through \c newgroup.
+ * If an error occurs in this routine, a non-zero error code will be returned
+ * and \c newgroup will be set to \c ABT_GROUP_NULL.
+ *
+ * @param[out] newgroup  handle to a new group
+ * @return Error code
+ * @retval ABT_SUCCESS on success
+ */
+int ABT_group_create(ABT_group *newgroup)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_group *p_newgroup;
+
+    ABTI_STATIC_ASSERT(sizeof(ABTI_group) <= ABTI_MEM_POOL_DESC_SIZE);
+    p_newgroup = (ABTI_group *)ABTI_mem_alloc_sync();
+    if (p_newgroup == NULL) {
+        *newgroup = ABT_GROUP_NULL;
+        return ABT_ERR_MEM;
+    }
+    ABTD_atomic_relaxed_store_uint64(&p_newgroup->state, 0);
+    ABTD_atomic_relaxed_store_ptr(&p_newgroup->p_waiter, NULL);
+
+    /* Return value */
+    *newgroup = ABTI_group_get_handle(p_newgroup);
+
+    return abt_errno;
+}
+
+/**
+ * @ingroup GROUP
+ * @brief   Free the group.
+ *
+ * \c ABT_group_free() deallocates the memory used for the group object
+ * associated with the handle \c group. If it is successfully processed,
+ * \c group is set to \c ABT_GROUP_NULL.  The group must not have outstanding
+ * work units.
+ *
+ * @param[in,out] group  handle to the group
+ * @return Error code
+ * @retval ABT_SUCCESS on success
+ * @retval ABT_ERR_GROUP work units of \c group have not finished
+ */
+int ABT_group_free(ABT_group *group)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_group *p_group = ABTI_group_get_ptr(*group);
+    ABTI_CHECK_NULL_GROUP_PTR(p_group);
+    ABTI_CHECK_TRUE(ABTD_atomic_acquire_load_uint64(&p_group->state) == 0,
+                    ABT_ERR_GROUP);
+
+    ABTI_mem_free_sync(p_group);
+
+    /* Return value */
+    *group = ABT_GROUP_NULL;
+
+fn_exit:
+    return abt_errno;
+
+fn_fail:
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
+}
+
+/**
+ * @ingroup GROUP
+ * @brief   Create a new ULT in the group.
+ *
+ * \c ABT_group_thread_create() creates an unnamed ULT that belongs to the
+ * group \c group and pushes it into \c pool.  \c attr is used as in
+ * \c ABT_thread_create() except that its completion callback is ignored since
+ * the group uses the completion of the ULT.
+ *
+ * @param[in] group        handle to the group
+ * @param[in] pool         handle to the associated pool
+ * @param[in] thread_func  function to be executed by a new ULT
+ * @param[in] arg          argument for thread_func
+ * @param[in] attr         thread attribute. If it is ABT_THREAD_ATTR_NULL,
+ *                         the default attribute is used.
+ * @return Error code
+ * @retval ABT_SUCCESS on success
+ */
+int ABT_group_thread_create(ABT_group group, ABT_pool pool,
+                            void (*thread_func)(void *), void *arg,
+                            ABT_thread_attr attr)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_xstream *p_local_xstream = ABTI_local_get_xstream();
+    ABTI_group *p_group = ABTI_group_get_ptr(group);
+    ABTI_CHECK_NULL_GROUP_PTR(p_group);
+    ABTI_pool *p_pool = ABTI_pool_get_ptr(pool);
+    ABTI_CHECK_NULL_POOL_PTR(p_pool);
+
+    ABTI_thread_attr group_attr;
+    ABTI_thread_attr *p_attr = ABTI_thread_attr_get_ptr(attr);
+    if (p_attr) {
+        group_attr = *p_attr;
+    } else {
+        ABTI_thread_attr_init(&group_attr, NULL,
+                              ABTI_global_get_thread_stacksize(),
+                              ABTI_STACK_TYPE_MEMPOOL, ABT_TRUE);
+        group_attr.preserve_fpu = gp_ABTI_global->thread_preserve_fpu;
+    }
+    group_attr.f_completion_cb = ABTI_group_thread_done;
+    group_attr.p_completion_cb_arg = (void *)p_group;
+
+    /* The counter must be incremented before the ULT can finish. */
+    ABTD_atomic_fetch_add_uint64(&p_group->state, ABTI_GROUP_UNIT);
+    abt_errno = ABTI_thread_create(p_local_xstream, p_pool, thread_func, arg,
+                                   &group_attr, NULL);
+    if (abt_errno != ABT_SUCCESS) {
+        ABTI_group_unit_done(p_group);
+        goto fn_fail;
+    }
+
+fn_exit:
+    return abt_errno;
+
+fn_fail:
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
+}
+
+/**
+ * @ingroup GROUP
+ * @brief   Create a new tasklet in the group.
+ *
+ * \c ABT_group_task_create() creates an unnamed tasklet that belongs to the
+ * group \c group and pushes it into \c pool.
+ *
+ * @param[in] group      handle to the group
+ * @param[in] pool       handle to the associated pool
+ * @param[in] task_func  function to be executed by a new tasklet
+ * @param[in] arg        argument for task_func
+ * @return Error code
+ * @retval ABT_SUCCESS on success
+ */
+int ABT_group_task_create(ABT_group group, ABT_pool pool,
+                          void (*task_func)(void *), void *arg)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_xstream *p_local_xstream = ABTI_local_get_xstream();
+    ABTI_task *p_newtask;
+    ABTI_group *p_group = ABTI_group_get_ptr(group);
+    ABTI_CHECK_NULL_GROUP_PTR(p_group);
+    ABTI_pool *p_pool = ABTI_pool_get_ptr(pool);
+    ABTI_CHECK_NULL_POOL_PTR(p_pool);
+
+    /* The counter must be incremented before the tasklet can finish. */
+    ABTD_atomic_fetch_add_uint64(&p_group->state, ABTI_GROUP_UNIT);
+    abt_errno = ABTI_task_create(p_local_xstream, p_pool, task_func, arg, 0,
+                                 ABTI_group_task_done, (void *)p_group, NULL, 0,
+                                 &p_newtask);
+    if (abt_errno != ABT_SUCCESS) {
+        ABTI_group_unit_done(p_group);
+        goto fn_fail;
+    }
+
+fn_exit:
+    return abt_errno;
+
+fn_fail:
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
+}
+
+/**
+ * @ingroup GROUP
+ * @brief   Wait for all the work units in the group.
+ *
+ * \c ABT_group_wait() blocks the caller until all the work units in the group
+ * \c group have finished, including those added while waiting.  If any work
+ * unit has not finished, the caller ULT is suspended once and resumed by the
+ * last finishing work unit.  An external thread spins for a while and then
+ * sleeps instead.  Only one caller can wait on a group at a time, and a
+ * tasklet cannot wait.  The group can be reused after this routine returns.
+ *
+ * @param[in] group  handle to the group
+ * @return Error code
+ * @retval ABT_SUCCESS on success
+ * @retval ABT_ERR_GROUP the caller is a tasklet or another caller is waiting
+ */
+int ABT_group_wait(ABT_group group)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_xstream *p_local_xstream = ABTI_local_get_xstream();
+    ABTI_group *p_group = ABTI_group_get_ptr(group);
+    ABTI_CHECK_NULL_GROUP_PTR(p_group);
+
+    uint64_t state = ABTD_atomic_acquire_load_uint64(&p_group->state);
+    if (state == 0)
+        goto fn_exit;
+    ABTI_CHECK_TRUE(!(state & ABTI_GROUP_WAITER), ABT_ERR_GROUP);
+
+    ABTI_thread *p_current;
+    ABTI_unit *p_unit;
+    ABTI_ext_waiter ext_waiter;
+    if (p_local_xstream != NULL) {
+        p_unit = p_local_xstream->p_unit;
+        ABTI_CHECK_TRUE(ABTI_unit_type_is_thread(p_unit->type), ABT_ERR_GROUP);
+        p_current = ABTI_unit_get_thread(p_unit);
+        /* The last work unit may wake up this ULT as soon as the flag is set,
+         * so the ULT must be blocked in advance. */
+        ABTI_thread_set_blocked(p_current);
+    } else {
+        /* external thread */
+        p_current = NULL;
+        ABTI_ext_waiter_init(&ext_waiter);
+        p_unit = &ext_waiter.unit;
+    }
+
+    /* Only the caller that takes the waiter slot can set the flag, so another
+     * caller cannot overwrite the registered waiter. */
+    if (!ABTD_atomic_bool_cas_strong_ptr(&p_group->p_waiter, NULL, p_unit)) {
+        if (p_current)
+            ABTI_thread_cancel_blocked(p_current);
+        ABTI_CHECK_TRUE(ABTD_atomic_acquire_load_uint64(&p_group->state) == 0,
+                        ABT_ERR_GROUP);
+        goto fn_exit;
+    }
+
+    /* Register the waiter unless all the work units have finished.  Once the
+     * flag is set, the last work unit will wake up the waiter.  The flag can
+     * be still set by the previous waiter that is being woken up. */
+    while (1) {
+        if (state == 0 || (state & ABTI_GROUP_WAITER)) {
+            ABTD_atomic_release_store_ptr(&p_group->p_waiter, NULL);
+            if (p_current)
+                ABTI_thread_cancel_blocked(p_current);
+            ABTI_CHECK_TRUE(state == 0, ABT_ERR_GROUP);
+            goto fn_exit;
+        }
+        if (ABTD_atomic_bool_cas_strong_uint64(&p_group->state, state,
+                                               state | ABTI_GROUP_WAITER))
+            break;
+        state = ABTD_atomic_acquire_load_uint64(&p_group->state);
+    }
+
+    if (p_current) {
+        ABTI_thread_suspend(&p_local_xstream, p_current,
+                            ABT_SYNC_EVENT_TYPE_GROUP, (void *)p_group);
+    } else {
+        /* External thread is waiting here. */
+        ABTI_ext_waiter_wait(&ext_waiter);
+    }
+
+fn_exit:
+    return abt_errno;
+
+fn_fail:
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
+}
+
+/**
+ * @ingroup GROUP
+ * @brief   Get the number of outstanding work units in the group.
+ *
+ * \c ABT_group_get_num_units() returns the number of work units in the group
+ * \c group that have not finished through \c num_units.
+ *
+ * @param[in]  group      handle to the group
+ * @param[out] num_units  number of outstanding work units
+ * @return Error code
+ * @retval ABT_SUCCESS on success
+ */
+int ABT_group_get_num_units(ABT_group group, size_t *num_units)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_group *p_group = ABTI_group_get_ptr(group);
+    ABTI_CHECK_NULL_GROUP_PTR(p_group);
+
+    *num_units = (size_t)(ABTD_atomic_acquire_load_uint64(&p_group->state) /
+                          ABTI_GROUP_UNIT);
+
+fn_exit:
+    return abt_errno;
+
+fn_fail:
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
+}
+
+/*****************************************************************************/
+/* Internal static functions                                                 */
+/*****************************************************************************/
+
+static void ABTI_group_unit_done(ABTI_group *p_group)
+{
+    uint64_t state =
+        ABTD_atomic_fetch_sub_uint64(&p_group->state, ABTI_GROUP_UNIT);
+    if (state != (ABTI_GROUP_UNIT | ABTI_GROUP_WAITER)) {
+        /* Either other work units are running or nobody is waiting.  p_group
+         * must not be touched anymore since the waiter may free it. */
+        return;
+    }
+
+    /* This is the last work unit and the waiter is blocked, so p_group is
+     * still valid.  Clear the slot and the flag first so that the waiter can
+     * reuse the group after being woken up. */
+    ABTI_unit *p_waiter =
+        (ABTI_unit *)ABTD_atomic_relaxed_load_ptr(&p_group->p_waiter);
+    ABTD_atomic_relaxed_store_ptr(&p_group->p_waiter, NULL);
+    ABTD_atomic_fetch_sub_uint64(&p_group->state, ABTI_GROUP_WAITER);
+    if (p_waiter->type == ABTI_UNIT_TYPE_EXT) {
+        ABTI_ext_waiter_signal(ABTI_ext_waiter_get_ptr(p_waiter));
+    } else {
+        ABTI_thread_set_ready(ABTI_local_get_xstream(),
+                              ABTI_unit_get_thread(p_waiter));
+    }
+}
+
+static void ABTI_group_thread_done(ABT_thread thread, void *cb_arg)
+{
+    ABTI_UNUSED(thread);
+    ABTI_group_unit_done((ABTI_group *)cb_arg);
+}
+
+static void ABTI_group_task_done(ABT_task task, void *cb_arg)
+{
+    ABTI_UNUSED(task);
+    ABTI_group_unit_done((ABTI_group *)cb_arg);
+}
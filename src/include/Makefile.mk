@@ -18,9 +18,11 @@ noinst_HEADERS = \
 	include/abti_cond.h \
 	include/abti_config.h \
 	include/abti_error.h \
+	include/abti_ext_waiter.h \
 	include/abti_eventual.h \
 	include/abti_future.h \
 	include/abti_global.h \
+	include/abti_group.h \
 	include/abti_key.h \
 	include/abti_local.h \
 	include/abti_log.h \
@@ -29,9 +31,12 @@ noinst_HEADERS = \
 	include/abti_mutex.h \
 	include/abti_mutex_attr.h \
 	include/abti_rwlock.h \
+	include/abti_rwlock_attr.h \
 	include/abti_pool.h \
 	include/abti_sched.h \
 	include/abti_self.h \
+	include/abti_sem.h \
+	include/abti_spin_wait.h \
 	include/abti_spinlock.h \
 	include/abti_stream.h \
 	include/abti_sync_lifo.h \
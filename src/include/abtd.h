@@ -27,11 +27,24 @@ typedef struct ABTD_xstream_context {
     pthread_cond_t state_cond;
 } ABTD_xstream_context;
 typedef pthread_mutex_t ABTD_xstream_mutex;
-#ifdef HAVE_PTHREAD_BARRIER_INIT
-typedef pthread_barrier_t ABTD_xstream_barrier;
-#else
-typedef void *ABTD_xstream_barrier;
-#endif
+
+/* A node of the arrival tree of an ES barrier */
+typedef struct ABTD_xstream_barrier_node {
+    ABTD_atomic_uint32 count; /* # of arrivals in the current phase */
+    uint32_t num_arrivals;    /* # of arrivals that complete this node */
+    uint32_t parent;          /* Index of the parent node (root: UINT32_MAX) */
+    char pad[ABT_CONFIG_STATIC_CACHELINE_SIZE - sizeof(ABTD_atomic_uint32) -
+             2 * sizeof(uint32_t)];
+} ABTD_xstream_barrier_node;
+
+typedef struct ABTD_xstream_barrier {
+    ABTD_atomic_uint32 state; /* Sense (bit 0) and sleeper flag (bit 1) */
+    uint32_t radix;           /* Arity of the arrival tree */
+    uint32_t num_leaves;      /* # of leaf nodes */
+    uint32_t num_nodes;       /* # of nodes (the root is the last one) */
+    uint32_t num_spins;       /* # of spins before sleeping */
+    ABTD_xstream_barrier_node *p_nodes;
+} ABTD_xstream_barrier;
 
 /* ES Storage Qualifier */
 #define ABTD_XSTREAM_LOCAL __thread
@@ -56,6 +69,18 @@ int ABTD_affinity_set_cpuset(ABTD_xstream_context *p_ctx, int cpuset_size,
 int ABTD_affinity_get_cpuset(ABTD_xstream_context *p_ctx, int cpuset_size,
                              int *p_cpuset, int *p_num_cpus);
 
+/* Futex */
+void ABTD_futex_wait(ABTD_atomic_uint32 *p_futex, uint32_t val);
+void ABTD_futex_timedwait(ABTD_atomic_uint32 *p_futex, uint32_t val,
+                          double sec);
+void ABTD_futex_broadcast(ABTD_atomic_uint32 *p_futex);
+
+/* ES Barrier */
+int ABTD_xstream_barrier_init(uint32_t num_waiters, uint32_t radix,
+                              uint32_t num_spins,
+                              ABTD_xstream_barrier *p_barrier);
+void ABTD_xstream_barrier_destroy(ABTD_xstream_barrier *p_barrier);
+
 #include "abtd_stream.h"
 
 /* ULT Context */
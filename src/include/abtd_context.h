@@ -13,6 +13,12 @@
 #include <ucontext.h>
 #endif
 
+#if defined(ABT_CONFIG_USE_FCONTEXT) && ABTD_FCONTEXT_PRESERVE_FPU &&         \
+    defined(ABTD_FCONTEXT_HAVE_FPU_VARIANTS)
+/* Each context chooses whether its FPU control state is preserved or not. */
+#define ABTD_THREAD_CONTEXT_SELECT_FPU 1
+#endif
+
 typedef struct ABTD_thread_context ABTD_thread_context;
 
 typedef struct ABTD_thread_context_atomic_ptr {
@@ -47,6 +53,9 @@ struct ABTD_thread_context {
     void *p_ctx;                           /* actual context of fcontext, or a
                                             * pointer to uctx */
     ABTD_thread_context_atomic_ptr p_link; /* pointer to scheduler context */
+#ifdef ABTD_THREAD_CONTEXT_SELECT_FPU
+    ABT_bool preserve_fpu; /* whether the FPU control state is preserved */
+#endif
 #ifndef ABT_CONFIG_USE_FCONTEXT
     ucontext_t uctx;               /* ucontext entity pointed by p_ctx */
     void (*f_uctx_thread)(void *); /* root function called by ucontext */
@@ -60,6 +69,10 @@ static void ABTD_thread_context_jump(ABTD_thread_context *p_old,
                                      ABTD_thread_context *p_new, void *arg);
 static void ABTD_thread_context_take(ABTD_thread_context *p_old,
                                      ABTD_thread_context *p_new, void *arg);
+static void ABTD_thread_context_set_preserve_fpu(ABTD_thread_context *p_ctx,
+                                                 ABT_bool preserve_fpu);
+static ABT_bool
+ABTD_thread_context_get_preserve_fpu(ABTD_thread_context *p_ctx);
 #if ABT_CONFIG_THREAD_TYPE == ABT_THREAD_TYPE_DYNAMIC_PROMOTION
 static void ABTD_thread_context_init_and_call(ABTD_thread_context *p_ctx,
                                               void *sp,
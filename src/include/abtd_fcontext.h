@@ -18,6 +18,17 @@ fcontext_t make_fcontext(void *sp, size_t size,
                          void (*thread_func)(void *)) ABT_API_PRIVATE;
 void *jump_fcontext(fcontext_t *old, fcontext_t new, void *arg) ABT_API_PRIVATE;
 void *take_fcontext(fcontext_t *old, fcontext_t new, void *arg) ABT_API_PRIVATE;
+#ifdef ABTD_THREAD_CONTEXT_SELECT_FPU
+/* Variants that skip saving and/or restoring the FPU control state. */
+void *jump_fcontext_save_fpu(fcontext_t *old, fcontext_t new,
+                             void *arg) ABT_API_PRIVATE;
+void *jump_fcontext_restore_fpu(fcontext_t *old, fcontext_t new,
+                                void *arg) ABT_API_PRIVATE;
+void *jump_fcontext_no_fpu(fcontext_t *old, fcontext_t new,
+                           void *arg) ABT_API_PRIVATE;
+void *take_fcontext_no_fpu(fcontext_t *old, fcontext_t new,
+                           void *arg) ABT_API_PRIVATE;
+#endif
 #if ABT_CONFIG_THREAD_TYPE == ABT_THREAD_TYPE_DYNAMIC_PROMOTION
 void init_and_call_fcontext(void *p_arg, void (*f_thread)(void *),
                             void *p_stacktop, fcontext_t *old);
@@ -34,16 +45,67 @@ static inline void ABTD_thread_context_jump(ABTD_thread_context *p_old,
                                             ABTD_thread_context *p_new,
                                             void *arg)
 {
+#ifdef ABTD_THREAD_CONTEXT_SELECT_FPU
+    /* The FPU control state is saved when leaving a context that preserves it
+     * and restored when entering such a context, so contexts that do not
+     * preserve it never affect those that do. */
+    if (p_old->preserve_fpu) {
+        if (p_new->preserve_fpu) {
+            jump_fcontext(&p_old->p_ctx, p_new->p_ctx, arg);
+        } else {
+            jump_fcontext_save_fpu(&p_old->p_ctx, p_new->p_ctx, arg);
+        }
+    } else {
+        if (p_new->preserve_fpu) {
+            jump_fcontext_restore_fpu(&p_old->p_ctx, p_new->p_ctx, arg);
+        } else {
+            jump_fcontext_no_fpu(&p_old->p_ctx, p_new->p_ctx, arg);
+        }
+    }
+#else
     jump_fcontext(&p_old->p_ctx, p_new->p_ctx, arg);
+#endif
 }
 
 static inline void ABTD_thread_context_take(ABTD_thread_context *p_old,
                                             ABTD_thread_context *p_new,
                                             void *arg)
 {
+#ifdef ABTD_THREAD_CONTEXT_SELECT_FPU
+    if (!p_new->preserve_fpu) {
+        take_fcontext_no_fpu(&p_old->p_ctx, p_new->p_ctx, arg);
+        return;
+    }
+#endif
     take_fcontext(&p_old->p_ctx, p_new->p_ctx, arg);
 }
 
+static inline void
+ABTD_thread_context_set_preserve_fpu(ABTD_thread_context *p_ctx,
+                                     ABT_bool preserve_fpu)
+{
+#ifdef ABTD_THREAD_CONTEXT_SELECT_FPU
+    p_ctx->preserve_fpu = preserve_fpu;
+#endif
+}
+
+static inline ABT_bool
+ABTD_thread_context_get_preserve_fpu(ABTD_thread_context *p_ctx)
+{
+#ifdef ABTD_THREAD_CONTEXT_SELECT_FPU
+    return p_ctx->preserve_fpu;
+#else
+    return ABT_TRUE;
+#endif
+}
+
+/* Return the stack pointer saved in a suspended context. */
+static inline void *
+ABTD_thread_context_get_stack_pointer(const ABTD_thread_context *p_ctx)
+{
+    return p_ctx->p_ctx;
+}
+
 #if ABT_CONFIG_THREAD_TYPE == ABT_THREAD_TYPE_DYNAMIC_PROMOTION
 static inline void
 ABTD_thread_context_init_and_call(ABTD_thread_context *p_ctx, void *sp,
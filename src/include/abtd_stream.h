@@ -6,24 +6,79 @@
 #ifndef ABTD_STREAM_H_INCLUDED
 #define ABTD_STREAM_H_INCLUDED
 
-#ifdef HAVE_PTHREAD_BARRIER_INIT
-static inline int ABTD_xstream_barrier_init(uint32_t num_waiters,
-                                            ABTD_xstream_barrier *p_barrier)
-{
-    int ret = pthread_barrier_init(p_barrier, NULL, num_waiters);
-    return (ret == 0) ? ABT_SUCCESS : ABT_ERR_XSTREAM_BARRIER;
-}
+#define ABTD_XSTREAM_BARRIER_SENSE 0x1
+#define ABTD_XSTREAM_BARRIER_SLEEPING 0x2
 
-static inline int ABTD_xstream_barrier_destroy(ABTD_xstream_barrier *p_barrier)
+/* Returns ABT_TRUE if the caller completes the phase. */
+static inline ABT_bool
+ABTD_xstream_barrier_arrive(ABTD_xstream_barrier *p_barrier, int hint)
 {
-    int ret = pthread_barrier_destroy(p_barrier);
-    return (ret == 0) ? ABT_SUCCESS : ABT_ERR_XSTREAM_BARRIER;
+    ABTD_xstream_barrier_node *p_nodes = p_barrier->p_nodes;
+    /* Neighboring ESs, which are likely to run on nearby cores, arrive at the
+     * same leaf. */
+    uint32_t idx = ((uint32_t)hint / p_barrier->radix) % p_barrier->num_leaves;
+    uint32_t count;
+    while (1) {
+        count = ABTD_atomic_fetch_add_uint32(&p_nodes[idx].count, 1);
+        if (count < p_nodes[idx].num_arrivals)
+            break;
+        /* This leaf is full.  The total capacity of the leaves is the number
+         * of waiters, so one of the other leaves has room for the caller. */
+        idx = (idx + 1 == p_barrier->num_leaves) ? 0 : idx + 1;
+    }
+    while (count + 1 == p_nodes[idx].num_arrivals) {
+        /* The caller is the last one of this node. */
+        idx = p_nodes[idx].parent;
+        if (idx == UINT32_MAX)
+            return ABT_TRUE;
+        count = ABTD_atomic_fetch_add_uint32(&p_nodes[idx].count, 1);
+    }
+    return ABT_FALSE;
 }
 
-static inline int ABTD_xstream_barrier_wait(ABTD_xstream_barrier *p_barrier)
+static inline void ABTD_xstream_barrier_wait(ABTD_xstream_barrier *p_barrier,
+                                             int hint)
 {
-    return pthread_barrier_wait(p_barrier);
+    /* The sense cannot change until the caller arrives. */
+    uint32_t sense = ABTD_atomic_acquire_load_uint32(&p_barrier->state) &
+                     ABTD_XSTREAM_BARRIER_SENSE;
+    if (ABTD_xstream_barrier_arrive(p_barrier, hint)) {
+        /* Nobody arrives until the sense changes, so the counters can be
+         * reset without atomic operations. */
+        uint32_t i;
+        for (i = 0; i < p_barrier->num_nodes; i++) {
+            ABTD_atomic_relaxed_store_uint32(&p_barrier->p_nodes[i].count, 0);
+        }
+        uint32_t old_state =
+            ABTD_atomic_exchange_uint32(&p_barrier->state,
+                                        sense ^ ABTD_XSTREAM_BARRIER_SENSE);
+        if (old_state & ABTD_XSTREAM_BARRIER_SLEEPING)
+            ABTD_futex_broadcast(&p_barrier->state);
+        return;
+    }
+
+    /* Spin for a while since a phase is often short. */
+    uint32_t i, state;
+    for (i = 0; i < p_barrier->num_spins; i++) {
+        state = ABTD_atomic_acquire_load_uint32(&p_barrier->state);
+        if ((state & ABTD_XSTREAM_BARRIER_SENSE) != sense)
+            return;
+        ABTD_atomic_pause();
+    }
+    /* Sleep until the last waiter changes the sense. */
+    while (1) {
+        state = ABTD_atomic_acquire_load_uint32(&p_barrier->state);
+        if ((state & ABTD_XSTREAM_BARRIER_SENSE) != sense)
+            return;
+        if (!(state & ABTD_XSTREAM_BARRIER_SLEEPING)) {
+            uint32_t new_state = state | ABTD_XSTREAM_BARRIER_SLEEPING;
+            if (!ABTD_atomic_bool_cas_strong_uint32(&p_barrier->state, state,
+                                                    new_state))
+                continue;
+            state = new_state;
+        }
+        ABTD_futex_wait(&p_barrier->state, state);
+    }
 }
-#endif
 
 #endif /* ABTD_STREAM_H_INCLUDED */
@@ -58,15 +58,18 @@ static inline int ABTD_thread_context_init(ABTD_thread_context *p_link,
     ABTD_atomic_relaxed_store_thread_context_ptr(&p_newctx->p_link, p_link);
     return abt_errno;
 }
+#endif
 
 static inline int ABTD_thread_context_arm_thread(size_t stacksize,
                                                  void *p_stack,
                                                  ABTD_thread_context *p_newctx)
 {
     /* This function *arms* the dynamic promotion thread (initialized by
-     * ABTD_thread_context_init) as if it were created by
+     * ABTD_thread_context_init) or the stack-copying thread (initialized by
+     * ABTD_thread_context_invalidate) as if it were created by
      * ABTD_thread_context_create; this function fully creates the context
-     * so that the thread can be run by ABTD_thread_context_jump. */
+     * so that the thread can be run by ABTD_thread_context_jump.  p_link is
+     * not modified. */
     int abt_errno = ABT_SUCCESS;
     /* ABTD_thread_context_make uses the top address of stack.
        Note that the parameter, p_stack, points to the bottom of stack. */
@@ -75,7 +78,6 @@ static inline int ABTD_thread_context_arm_thread(size_t stacksize,
                              ABTD_thread_func_wrapper);
     return abt_errno;
 }
-#endif
 
 /* Currently, nothing to do */
 #define ABTD_thread_context_free(p_ctx)
@@ -66,6 +66,19 @@ static inline void ABTD_thread_context_take(ABTD_thread_context *p_old,
     /* Unreachable. */
 }
 
+static inline void
+ABTD_thread_context_set_preserve_fpu(ABTD_thread_context *p_ctx,
+                                     ABT_bool preserve_fpu)
+{
+    /* swapcontext() always preserves the FPU control state. */
+}
+
+static inline ABT_bool
+ABTD_thread_context_get_preserve_fpu(ABTD_thread_context *p_ctx)
+{
+    return ABT_TRUE;
+}
+
 #if ABT_CONFIG_THREAD_TYPE == ABT_THREAD_TYPE_DYNAMIC_PROMOTION
 #error "ABTD_thread_context_make_and_call is not implemented."
 #endif
@@ -38,6 +38,7 @@
 #define ABTI_UNIT_REQ_BLOCK (1 << 5)
 #define ABTI_UNIT_REQ_ORPHAN (1 << 6)
 #define ABTI_UNIT_REQ_NOPUSH (1 << 7)
+#define ABTI_UNIT_REQ_WORK_FIRST (1 << 8)
 #define ABTI_UNIT_REQ_STOP (ABTI_UNIT_REQ_EXIT | ABTI_UNIT_REQ_TERMINATE)
 #define ABTI_UNIT_REQ_NON_YIELD                                                \
     (ABTI_UNIT_REQ_EXIT | ABTI_UNIT_REQ_CANCEL | ABTI_UNIT_REQ_MIGRATE |       \
@@ -46,6 +47,8 @@
 
 #define ABTI_THREAD_INIT_ID 0xFFFFFFFFFFFFFFFF
 #define ABTI_TASK_INIT_ID 0xFFFFFFFFFFFFFFFF
+/* Number of IDs that an ES reserves from the global counter at once */
+#define ABTI_UNIT_ID_BLOCK_SIZE 1024
 
 #define ABTI_INDENT 4
 
@@ -80,7 +83,8 @@ enum ABTI_unit_state {
 
 enum ABTI_mutex_attr_val {
     ABTI_MUTEX_ATTR_NONE = 0,
-    ABTI_MUTEX_ATTR_RECURSIVE = 1 << 0
+    ABTI_MUTEX_ATTR_RECURSIVE = 1 << 0,
+    ABTI_MUTEX_ATTR_QUEUED_SPIN = 1 << 1
 };
 
 enum ABTI_stack_type {
@@ -88,6 +92,7 @@ enum ABTI_stack_type {
     ABTI_STACK_TYPE_MALLOC,      /* Stack allocated by malloc in Argobots */
     ABTI_STACK_TYPE_USER,        /* Stack given by a user */
     ABTI_STACK_TYPE_MAIN,        /* Stack of a main ULT. */
+    ABTI_STACK_TYPE_COPY,        /* Shared stack; copied out on suspension */
 };
 
 /* Macro functions */
@@ -97,6 +102,11 @@ enum ABTI_stack_type {
 typedef struct ABTI_global ABTI_global;
 typedef struct ABTI_local_func ABTI_local_func;
 typedef struct ABTI_xstream ABTI_xstream;
+typedef struct ABTI_mem_ext_pool ABTI_mem_ext_pool;
+typedef struct ABTI_copy_stack ABTI_copy_stack;
+typedef struct ABTI_thread_stack_copy ABTI_thread_stack_copy;
+typedef struct ABTI_stack_usage_hist ABTI_stack_usage_hist;
+typedef struct ABTI_stack_usage_class ABTI_stack_usage_class;
 typedef enum ABTI_xstream_type ABTI_xstream_type;
 typedef struct ABTI_sched ABTI_sched;
 typedef char *ABTI_sched_config;
@@ -105,6 +115,7 @@ typedef void *ABTI_sched_id;       /* Scheduler id */
 typedef uintptr_t ABTI_sched_kind; /* Scheduler kind */
 typedef struct ABTI_pool ABTI_pool;
 typedef struct ABTI_unit ABTI_unit;
+typedef struct ABTI_unit_completion ABTI_unit_completion;
 typedef struct ABTI_thread_attr ABTI_thread_attr;
 typedef struct ABTI_thread ABTI_thread;
 typedef enum ABTI_stack_type ABTI_stack_type;
@@ -118,11 +129,20 @@ typedef struct ABTI_ktelem ABTI_ktelem;
 typedef struct ABTI_ktable ABTI_ktable;
 typedef struct ABTI_mutex_attr ABTI_mutex_attr;
 typedef struct ABTI_mutex ABTI_mutex;
+typedef struct ABTI_mutex_qnode ABTI_mutex_qnode;
 typedef struct ABTI_cond ABTI_cond;
+typedef struct ABTI_rwlock_attr ABTI_rwlock_attr;
+typedef struct ABTI_rwlock_indicator ABTI_rwlock_indicator;
 typedef struct ABTI_rwlock ABTI_rwlock;
 typedef struct ABTI_eventual ABTI_eventual;
 typedef struct ABTI_future ABTI_future;
+typedef struct ABTI_barrier_slot ABTI_barrier_slot;
+typedef struct ABTI_ext_waiter ABTI_ext_waiter;
+typedef struct ABTI_spin_wait ABTI_spin_wait;
 typedef struct ABTI_barrier ABTI_barrier;
+typedef struct ABTI_group ABTI_group;
+typedef struct ABTI_sem_waiter ABTI_sem_waiter;
+typedef struct ABTI_sem ABTI_sem;
 typedef struct ABTI_timer ABTI_timer;
 #ifndef ABT_CONFIG_DISABLE_TOOL_INTERFACE
 typedef struct ABTI_tool_context ABTI_tool_context;
@@ -134,6 +154,8 @@ typedef struct ABTI_native_thread_id_opaque *ABTI_native_thread_id;
 /* ID associated with work unit (i.e., ULTs, tasklets, and external threads) */
 struct ABTI_unit_id_opaque;
 typedef struct ABTI_unit_id_opaque *ABTI_unit_id;
+/* Push units to a pool at once.  Only built-in pools provide it. */
+typedef void (*ABTI_pool_push_many_fn)(ABT_pool, const ABT_unit *, size_t);
 
 /* Architecture-Dependent Definitions */
 #include "abtd.h"
@@ -161,6 +183,14 @@ struct ABTI_mutex {
     ABTI_thread_htable *p_htable; /* a set of queues */
     ABTI_thread *p_handover;      /* next ULT for the mutex handover */
     ABTI_thread *p_giver;         /* current ULT that hands over the mutex */
+    ABTD_atomic_ptr p_qtail;      /* tail of spinning waiters
+                                   * (ABTI_mutex_qnode *) */
+};
+
+/* A waiter in the queued spin phase of a mutex, placed on its stack */
+struct ABTI_mutex_qnode {
+    ABTD_atomic_ptr p_next;  /* next waiter (ABTI_mutex_qnode *) */
+    ABTD_atomic_int is_head; /* set when this waiter may poll the mutex */
 };
 
 struct ABTI_global {
@@ -182,29 +212,61 @@ struct ABTI_global {
     long sched_sleep_nsec;      /* Default nanoseconds for scheduler sleep */
     ABTI_thread *p_thread_main; /* ULT of the main function */
 
-    uint32_t mutex_max_handovers; /* Default max. # of local handovers */
-    uint32_t mutex_max_wakeups;   /* Default max. # of wakeups */
-    uint32_t os_page_size;        /* OS page size */
-    uint32_t huge_page_size;      /* Huge page size */
+    uint32_t mutex_max_handovers;    /* Default max. # of local handovers */
+    uint32_t mutex_max_wakeups;      /* Default max. # of wakeups */
+    uint32_t mutex_queued_spins;     /* Max. # of polls in the queued spin
+                                      * phase of mutexes */
+    uint32_t barrier_tree_threshold; /* Min. # of waiters of tree barriers */
+    uint32_t xstream_barrier_spins;  /* # of spins before ES barriers sleep */
+    uint32_t xstream_barrier_radix;  /* Arity of arrival trees of ES barriers */
+    uint32_t ext_wait_spins;         /* # of spins before external threads
+                                      * sleep in synchronization */
+    uint32_t wait_spin_nsec;         /* Default max. spin window of waiting
+                                      * ULTs (in nanoseconds) */
+#ifndef ABT_CONFIG_DISABLE_EXT_THREAD
+    ABTD_atomic_uint32 num_ext_joiners; /* # of sleeping external joiners */
+    ABTD_atomic_uint32 ext_join_seq;    /* Futex of external joiners */
+#endif
+    uint32_t os_page_size;           /* OS page size */
+    uint32_t huge_page_size;         /* Huge page size */
 #ifdef ABT_CONFIG_USE_MEM_POOL
     uint32_t mem_page_size;  /* Page size for memory allocation */
     uint32_t mem_sp_size;    /* Stack page size */
     uint32_t mem_max_stacks; /* Max. # of stacks kept in each ES */
     uint32_t mem_max_descs;  /* Max. # of descriptors kept in each ES */
     int mem_lp_alloc;        /* How to allocate large pages */
+    ABT_bool mem_remote_return; /* Whether to return remotely freed memory to
+                                 * the ES that allocated it */
+    ABT_bool mem_no_alloc; /* Whether to stop allocating memory for the memory
+                            * pools after ABT_reserve() */
+    ABT_bool mem_sync_in_pool; /* Whether synchronization objects are allocated
+                                * from the descriptor pool */
 
     ABTI_mem_pool_global_pool mem_pool_stack; /* Pool of stack (default size) */
     ABTI_mem_pool_global_pool mem_pool_desc;  /* Pool of descriptors that can
                                                * store ABTI_task. */
 #ifndef ABT_CONFIG_DISABLE_EXT_THREAD
-    /* They are used for external threads. */
-    ABTI_spinlock mem_pool_stack_lock;
-    ABTI_mem_pool_local_pool mem_pool_stack_ext;
-    ABTI_spinlock mem_pool_desc_lock;
-    ABTI_mem_pool_local_pool mem_pool_desc_ext;
+    /* Local pools of external threads, which are created lazily and returned
+     * to the global pools when the external threads exit. */
+    uint64_t mem_ext_pool_gen;          /* Generation of this ABT_init() */
+    pthread_key_t mem_ext_pool_key;     /* Key to destroy them at exit */
+    ABTI_spinlock mem_ext_pools_lock;   /* Lock protecting p_mem_ext_pools */
+    ABTI_mem_ext_pool *p_mem_ext_pools; /* List of live local pools */
 #endif
 #endif
 
+#ifdef ABT_CONFIG_USE_FCONTEXT
+    size_t copy_stacksize;          /* Size of shared stacks (in bytes) */
+    ABTI_spinlock copy_stacks_lock; /* Lock protecting p_copy_stacks */
+    ABTI_copy_stack *p_copy_stacks; /* List of all the shared stacks */
+#endif
+
+    ABT_bool thread_preserve_fpu; /* Default FPU preservation of ULTs */
+
+    ABT_bool stack_paint;                  /* Whether stacks are painted */
+    ABTI_spinlock stack_usage_lock;        /* Lock to add a usage class */
+    ABTD_atomic_ptr p_stack_usage_classes; /* List of ABTI_stack_usage_class */
+
     ABT_bool print_config; /* Whether to print config on ABT_init */
 
 #ifndef ABT_CONFIG_DISABLE_TOOL_INTERFACE
@@ -243,13 +305,30 @@ struct ABTI_xstream {
 
     __attribute__((aligned(ABT_CONFIG_STATIC_CACHELINE_SIZE)))
     ABTI_unit *p_unit; /* Current running ULT/tasklet */
+    /* Blocks of ULT/tasklet IDs reserved by this ES: [next, end) */
+    ABT_unit_id thread_id_next;
+    ABT_unit_id thread_id_end;
+    ABT_unit_id task_id_next;
+    ABT_unit_id task_id_end;
 
 #ifdef ABT_CONFIG_USE_MEM_POOL
     ABTI_mem_pool_local_pool mem_pool_stack;
     ABTI_mem_pool_local_pool mem_pool_desc;
 #endif
+#ifdef ABT_CONFIG_USE_FCONTEXT
+    ABTI_copy_stack *p_copy_stack; /* Shared stack for stack-copying ULTs */
+#endif
 };
 
+#if defined(ABT_CONFIG_USE_MEM_POOL) && !defined(ABT_CONFIG_DISABLE_EXT_THREAD)
+struct ABTI_mem_ext_pool {
+    ABTI_mem_pool_local_pool mem_pool_stack;
+    ABTI_mem_pool_local_pool mem_pool_desc;
+    ABTI_mem_ext_pool *p_prev; /* Previous in ABTI_global's list */
+    ABTI_mem_ext_pool *p_next; /* Next in ABTI_global's list */
+};
+#endif
+
 struct ABTI_sched {
     ABTI_sched_used used;       /* To know if it is used and how */
     ABT_bool automatic;         /* To know if automatic data free */
@@ -272,6 +351,22 @@ struct ABTI_sched {
 #endif
 };
 
+struct ABTI_stack_usage_hist {
+    ABTD_atomic_uint64 num_threads;
+    ABTD_atomic_uint64 total_usage;
+    ABTD_atomic_uint64 max_usage;
+    ABTD_atomic_uint64 bins[ABT_STACK_USAGE_NUM_BINS];
+};
+
+/* Stack usage of ULTs whose stacks have the same type and size.  Classes are
+ * only added, so the list can be traversed without the lock. */
+struct ABTI_stack_usage_class {
+    ABTI_stack_type stacktype;      /* MEMPOOL (runtime-allocated) or USER */
+    size_t stacksize;               /* Stack size (in bytes) */
+    ABTI_stack_usage_hist hist;     /* Histogram */
+    ABTI_stack_usage_class *p_next; /* Next in ABTI_global's list */
+};
+
 struct ABTI_pool {
     ABT_pool_access access; /* Access mode */
     ABT_bool automatic;     /* To know if automatic data free */
@@ -288,6 +383,9 @@ struct ABTI_pool {
     void *data;                       /* Specific data */
     uint64_t id;                      /* ID */
 
+    /* Stack usage of ULTs that have terminated in this pool */
+    ABTI_stack_usage_hist stack_usage;
+
     /* Functions to manage units */
     ABT_unit_get_type_fn u_get_type;
     ABT_unit_get_thread_fn u_get_thread;
@@ -301,10 +399,12 @@ struct ABTI_pool {
     ABT_pool_init_fn p_init;
     ABT_pool_get_size_fn p_get_size;
     ABT_pool_push_fn p_push;
+    ABTI_pool_push_many_fn p_push_many; /* NULL if not supported */
     ABT_pool_pop_fn p_pop;
     ABT_pool_pop_wait_fn p_pop_wait;
     ABT_pool_pop_timedwait_fn p_pop_timedwait;
     ABT_pool_remove_fn p_remove;
+    ABT_pool_remove_fn p_try_remove; /* NULL if not supported */
     ABT_pool_free_fn p_free;
     ABT_pool_print_all_fn p_print_all;
 };
@@ -319,6 +419,9 @@ struct ABTI_unit {
     ABTI_unit *p_parent;          /* Parent unit */
     void (*f_unit)(void *);       /* Work unit function */
     void *p_arg;                  /* Work unit function argument */
+    void *p_payload;              /* Argument data copied at creation */
+    /* Completion callback, which is NULL if not set */
+    ABTI_unit_completion *p_completion;
     ABTD_atomic_int state;        /* State (ABTI_unit_state) */
     ABTD_atomic_uint32 request;   /* Request */
     ABTI_pool *p_pool;            /* Associated pool */
@@ -330,10 +433,34 @@ struct ABTI_unit {
 #endif
 };
 
+struct ABTI_ext_waiter {
+    ABTI_unit unit;           /* Unit of type ABTI_UNIT_TYPE_EXT */
+    ABTD_atomic_uint32 state; /* ABTI_EXT_WAITER_XXX */
+};
+
+struct ABTI_spin_wait {
+    uint32_t max_nsec;              /* Max. spin window.  0 disables spin */
+    ABTD_atomic_uint32 window_nsec; /* Current spin window */
+};
+
+/* A completion callback is rarely used, so it is kept out of the unit to keep
+ * descriptors small. */
+struct ABTI_unit_completion {
+    void (*f_thread_cb)(ABT_thread, void *); /* Callback of a ULT */
+    void (*f_task_cb)(ABT_task, void *);     /* Callback of a tasklet */
+    void *p_cb_arg;                          /* Callback function argument */
+};
+
 struct ABTI_thread_attr {
     void *p_stack;             /* Stack address */
     size_t stacksize;          /* Stack size (in bytes) */
     ABTI_stack_type stacktype; /* Stack type */
+    ABT_bool preserve_fpu;     /* Whether the FPU control state is preserved */
+    ABT_bool work_first;       /* Whether the creator switches to the ULT */
+    uint32_t join_spin_nsec;   /* Max. spin window of joiners */
+    /* Completion callback and its argument */
+    void (*f_completion_cb)(ABT_thread, void *);
+    void *p_completion_cb_arg;
 #ifndef ABT_CONFIG_DISABLE_MIGRATION
     ABT_bool migratable;              /* Migratability */
     void (*f_cb)(ABT_thread, void *); /* Callback function */
@@ -347,6 +474,7 @@ struct ABTI_thread {
 #ifndef ABT_CONFIG_DISABLE_STACKABLE_SCHED
     ABTI_sched *p_sched; /* Scheduler */
 #endif
+    ABTI_spin_wait join_spin;  /* Spin-then-suspend of joiners */
     void *p_stack;             /* Stack address */
     size_t stacksize;          /* Stack size (in bytes) */
     ABTI_stack_type stacktype; /* Stack type */
@@ -358,6 +486,28 @@ struct ABTI_thread {
 #endif
 };
 
+#ifdef ABT_CONFIG_USE_FCONTEXT
+/* A stack shared by stack-copying ULTs.  Since a suspended ULT must be resumed
+ * at the same stack address, each ULT keeps using the shared stack on which it
+ * has started, even if another ES resumes it. */
+struct ABTI_copy_stack {
+    void *p_stack;              /* Stack address */
+    size_t stacksize;           /* Stack size (in bytes) */
+    ABTD_atomic_ptr p_occupant; /* ULT running on this stack (ABTI_thread *) */
+    ABTI_xstream *p_xstream;    /* ES using this stack, or NULL */
+    ABTI_copy_stack *p_next;    /* Next in ABTI_global's list */
+};
+
+/* Placed right after ABTI_thread of a stack-copying ULT. */
+struct ABTI_thread_stack_copy {
+    ABTI_copy_stack *p_copy_stack; /* Shared stack, or NULL if not started */
+    ABT_bool is_started;           /* Whether the context has been created */
+    void *p_buf;                   /* Saved part of the stack */
+    size_t used;                   /* Size of the saved part (in bytes) */
+    size_t capacity;               /* Size of p_buf (in bytes) */
+};
+#endif
+
 struct ABTI_task {
     ABTI_unit unit_def; /* Internal unit definition */
 };
@@ -386,22 +536,36 @@ struct ABTI_ktable {
 
 struct ABTI_cond {
     ABTI_spinlock lock;
+    uint32_t num_waiters;
     ABTI_mutex *p_waiter_mutex;
-    size_t num_waiters;
     ABTI_unit *p_head; /* Head of waiters */
     ABTI_unit *p_tail; /* Tail of waiters */
 };
 
+struct ABTI_rwlock_attr {
+    ABT_bool read_mostly; /* ABT_TRUE if readers use per-ES indicators */
+};
+
+struct ABTI_rwlock_indicator {
+    ABTD_atomic_uint32 count; /* # of readers that entered via this slot */
+    char pad[ABT_CONFIG_STATIC_CACHELINE_SIZE - sizeof(ABTD_atomic_uint32)];
+};
+
 struct ABTI_rwlock {
     ABTI_mutex mutex;
     ABTI_cond cond;
-    size_t reader_count;
+    uint32_t reader_count;
     int write_flag;
+    /* The following are used only in the read-mostly mode. */
+    int num_indicators;                  /* 0 if not read-mostly */
+    ABTD_atomic_int rm_state;            /* ABTI_RWLOCK_{READER_BIAS,...} */
+    ABTI_rwlock_indicator *p_indicators; /* per-ES reader indicators */
 };
 
 struct ABTI_eventual {
     ABTI_spinlock lock;
-    ABT_bool ready;
+    ABTD_atomic_int ready; /* ABT_TRUE after value is set */
+    ABTI_spin_wait spin;   /* Spin-then-suspend of waiters */
     void *value;
     int nbytes;
     ABTI_unit *p_head; /* Head of waiters */
@@ -410,7 +574,10 @@ struct ABTI_eventual {
 
 struct ABTI_future {
     ABTI_spinlock lock;
-    ABTD_atomic_uint32 counter;
+    ABTD_atomic_uint32 num_claimed; /* Number of claimed compartments */
+    ABTD_atomic_uint32 counter;     /* Number of set compartments */
+    ABTD_atomic_int ready; /* ABT_TRUE after the callback is called */
+    ABTI_spin_wait spin;   /* Spin-then-suspend of waiters */
     uint32_t compartments;
     void **array;
     void (*p_callback)(void **arg);
@@ -418,12 +585,50 @@ struct ABTI_future {
     ABTI_unit *p_tail; /* Tail of waiters */
 };
 
+/* A waiter of a tree barrier.  p_waiter is ABTI_thread * or a pointer to an
+ * ABTD_atomic_int32 signal of an external thread, depending on type. */
+struct ABTI_barrier_slot {
+    ABTD_atomic_ptr p_waiter;
+    ABT_unit_type type;
+};
+
 struct ABTI_barrier {
     uint32_t num_waiters;
     volatile uint32_t counter;
     ABTI_thread **waiters;
     ABT_unit_type *waiter_type;
     ABTI_spinlock lock;
+    /* The following are used only by a tree barrier. */
+    ABTD_atomic_uint32 tree_counter; /* Phase bit and # of arrivals */
+    ABTI_barrier_slot *p_slots;      /* Two sets of num_waiters slots */
+};
+
+/* The lowest bit of state is set while a waiter is registered.  The other bits
+ * count outstanding work units. */
+#define ABTI_GROUP_WAITER ((uint64_t)1)
+#define ABTI_GROUP_UNIT ((uint64_t)2)
+
+struct ABTI_group {
+    ABTD_atomic_uint64 state;
+    ABTD_atomic_ptr p_waiter; /* ABTI_unit * of the only waiter.  It is set
+                               * before ABTI_GROUP_WAITER. */
+};
+
+/* A waiter of a semaphore.  p_unit is NULL if the waiter polls granted
+ * instead of being woken up. */
+struct ABTI_sem_waiter {
+    ABTI_unit *p_unit;       /* Waiting ULT or external thread */
+    ABTI_sem_waiter *p_next; /* Next waiter in FIFO order */
+    uint32_t num;            /* # of requested permits */
+    ABTD_atomic_int granted; /* ABT_TRUE after the permits are handed */
+};
+
+struct ABTI_sem {
+    ABTI_spinlock lock;             /* Protects the waiter queue */
+    ABTD_atomic_uint32 count;       /* # of available permits */
+    ABTD_atomic_uint32 num_waiters; /* # of queued waiters */
+    ABTI_sem_waiter *p_head;        /* Head of waiters */
+    ABTI_sem_waiter *p_tail;        /* Tail of waiters */
 };
 
 struct ABTI_timer {
@@ -447,6 +652,12 @@ extern ABTI_local_func gp_ABTI_local_func;
 
 /* ES Local Data */
 extern ABTD_XSTREAM_LOCAL ABTI_xstream *lp_ABTI_xstream;
+#if defined(ABT_CONFIG_USE_MEM_POOL) && !defined(ABT_CONFIG_DISABLE_EXT_THREAD)
+/* Local pools of an external thread, which are valid only if
+ * lp_ABTI_mem_ext_pool_gen matches gp_ABTI_global->mem_ext_pool_gen. */
+extern ABTD_XSTREAM_LOCAL ABTI_mem_ext_pool *lp_ABTI_mem_ext_pool;
+extern ABTD_XSTREAM_LOCAL uint64_t lp_ABTI_mem_ext_pool_gen;
+#endif
 
 /* Global */
 void ABTI_global_update_max_xstreams(int new_size);
@@ -517,6 +728,7 @@ int ABTI_pool_create_basic(ABT_pool_kind kind, ABT_pool_access access,
                            ABT_bool automatic, ABTI_pool **pp_newpool);
 void ABTI_pool_free(ABTI_pool *p_pool);
 int ABTI_pool_get_fifo_def(ABT_pool_access access, ABT_pool_def *p_def);
+ABTI_pool_push_many_fn ABTI_pool_get_fifo_push_many(ABT_pool_access access);
 int ABTI_pool_get_fifo_wait_def(ABT_pool_access access, ABT_pool_def *p_def);
 #ifndef ABT_CONFIG_DISABLE_POOL_CONSUMER_CHECK
 int ABTI_pool_set_consumer(ABTI_pool *p_pool,
@@ -551,6 +763,9 @@ void ABTI_thread_free_main(ABTI_xstream *p_local_xstream,
 void ABTI_thread_free_main_sched(ABTI_xstream *p_local_xstream,
                                  ABTI_thread *p_thread);
 int ABTI_thread_set_blocked(ABTI_thread *p_thread);
+void ABTI_thread_cancel_blocked(ABTI_thread *p_thread);
+void ABTI_thread_release_creator(ABTI_xstream *p_local_xstream,
+                                 ABTI_thread *p_thread, ABTI_unit *p_creator);
 void ABTI_thread_suspend(ABTI_xstream **pp_local_xstream, ABTI_thread *p_thread,
                          ABT_sync_event_type sync_event_type, void *p_sync);
 int ABTI_thread_set_ready(ABTI_xstream *p_local_xstream, ABTI_thread *p_thread);
@@ -561,6 +776,33 @@ ABT_unit_id ABTI_thread_get_id(ABTI_thread *p_thread);
 ABT_unit_id ABTI_thread_self_id(ABTI_xstream *p_local_xstream);
 int ABTI_thread_get_xstream_rank(ABTI_thread *p_thread);
 int ABTI_thread_self_xstream_rank(ABTI_xstream *p_local_xstream);
+void ABTI_thread_run_completion_cb(ABTI_thread *p_thread);
+
+/* Stack-copying ULTs */
+#ifdef ABT_CONFIG_USE_FCONTEXT
+void ABTI_copy_stack_init(ABTI_global *p_global);
+void ABTI_copy_stack_finalize(ABTI_global *p_global);
+void ABTI_copy_stack_detach(ABTI_xstream *p_xstream);
+ABT_bool ABTI_copy_stack_acquire(ABTI_xstream *p_local_xstream,
+                                 ABTI_thread *p_thread);
+void ABTI_copy_stack_release(ABTI_thread *p_thread, ABT_bool is_finished);
+#endif
+
+/* Stack usage */
+void ABTI_stack_usage_init(ABTI_global *p_global);
+void ABTI_stack_usage_finalize(ABTI_global *p_global);
+void ABTI_stack_usage_hist_init(ABTI_stack_usage_hist *p_hist);
+void ABTI_stack_usage_hist_get(ABTI_stack_usage_hist *p_hist,
+                               ABT_stack_usage_hist *hist);
+void ABTI_stack_usage_hist_print(ABTI_stack_usage_hist *p_hist, FILE *p_os,
+                                 int indent);
+ABTI_stack_usage_hist *ABTI_stack_usage_get_hist(ABTI_stack_type stacktype,
+                                                 size_t stacksize,
+                                                 ABT_bool create);
+void ABTI_stack_usage_print(FILE *p_os);
+void ABTI_thread_paint_stack(ABTI_thread *p_thread);
+size_t ABTI_thread_get_stack_usage(ABTI_thread *p_thread);
+void ABTI_thread_record_stack_usage(ABTI_thread *p_thread);
 
 /* ULT Attributes */
 void ABTI_thread_attr_print(ABTI_thread_attr *p_attr, FILE *p_os, int indent);
@@ -590,10 +832,15 @@ ABT_bool ABTI_thread_htable_switch_low(ABTI_xstream **pp_local_xstream,
                                        void *p_sync);
 
 /* Tasklet */
+int ABTI_task_create(ABTI_xstream *p_local_xstream, ABTI_pool *p_pool,
+                     void (*task_func)(void *), void *arg, size_t payload_size,
+                     void (*cb_func)(ABT_task, void *), void *cb_arg,
+                     ABTI_sched *p_sched, int refcount, ABTI_task **pp_newtask);
 void ABTI_task_free(ABTI_xstream *p_local_xstream, ABTI_task *p_task);
 void ABTI_task_print(ABTI_task *p_task, FILE *p_os, int indent);
 void ABTI_task_reset_id(void);
 ABT_unit_id ABTI_task_get_id(ABTI_task *p_task);
+void ABTI_task_run_completion_cb(ABTI_task *p_task);
 
 /* Key */
 void ABTI_ktable_free(ABTI_xstream *p_local_xstream, ABTI_ktable *p_ktable);
@@ -603,6 +850,7 @@ void ABTI_mutex_wait(ABTI_xstream **pp_local_xstream, ABTI_mutex *p_mutex,
                      int val);
 void ABTI_mutex_wait_low(ABTI_xstream **pp_local_xstream, ABTI_mutex *p_mutex,
                          int val);
+ABT_bool ABTI_mutex_add_waiter(ABTI_mutex *p_mutex, ABTI_thread *p_thread);
 void ABTI_mutex_wake_se(ABTI_mutex *p_mutex, int num);
 void ABTI_mutex_wake_de(ABTI_xstream *p_local_xstream, ABTI_mutex *p_mutex);
 
@@ -621,6 +869,9 @@ void ABTI_info_check_print_all_thread_stacks(void);
 #include "abti_sched.h"
 #include "abti_config.h"
 #include "abti_unit.h"
+#include "abti_timer.h"
+#include "abti_ext_waiter.h"
+#include "abti_spin_wait.h"
 #include "abti_stream.h"
 #include "abti_self.h"
 #include "abti_tool.h"
@@ -631,10 +882,12 @@ void ABTI_info_check_print_all_thread_stacks(void);
 #include "abti_mutex_attr.h"
 #include "abti_cond.h"
 #include "abti_rwlock.h"
+#include "abti_rwlock_attr.h"
 #include "abti_eventual.h"
 #include "abti_future.h"
 #include "abti_barrier.h"
-#include "abti_timer.h"
+#include "abti_group.h"
+#include "abti_sem.h"
 #include "abti_mem.h"
 #include "abti_key.h"
 
@@ -65,6 +65,7 @@ static inline int ABTI_cond_wait(ABTI_xstream **pp_local_xstream,
     ABTI_xstream *p_local_xstream = *pp_local_xstream;
     ABTI_thread *p_thread;
     ABTI_unit *p_unit;
+    ABTI_ext_waiter ext_waiter;
 
     if (p_local_xstream != NULL) {
         ABTI_unit *p_self = p_local_xstream->p_unit;
@@ -74,10 +75,8 @@ static inline int ABTI_cond_wait(ABTI_xstream **pp_local_xstream,
     } else {
         /* external thread */
         p_thread = NULL;
-        p_unit = (ABTI_unit *)ABTU_calloc(1, sizeof(ABTI_unit));
-        p_unit->type = ABTI_UNIT_TYPE_EXT;
-        /* use state for synchronization */
-        ABTD_atomic_relaxed_store_int(&p_unit->state, ABTI_UNIT_STATE_BLOCKED);
+        ABTI_ext_waiter_init(&ext_waiter);
+        p_unit = &ext_waiter.unit;
     }
 
     ABTI_spinlock_acquire(&p_cond->lock);
@@ -88,8 +87,6 @@ static inline int ABTI_cond_wait(ABTI_xstream **pp_local_xstream,
         ABT_bool result = ABTI_mutex_equal(p_cond->p_waiter_mutex, p_mutex);
         if (result == ABT_FALSE) {
             ABTI_spinlock_release(&p_cond->lock);
-            if (p_thread)
-                ABTU_free(p_unit);
             abt_errno = ABT_ERR_INV_MUTEX;
             goto fn_fail;
         }
@@ -129,14 +126,20 @@ static inline int ABTI_cond_wait(ABTI_xstream **pp_local_xstream,
         ABTI_mutex_unlock(p_local_xstream, p_mutex);
 
         /* External thread is waiting here. */
-        while (ABTD_atomic_acquire_load_int(&p_unit->state) !=
-               ABTI_UNIT_STATE_READY)
-            ;
-        ABTU_free(p_unit);
+        ABTI_ext_waiter_wait(&ext_waiter);
     }
 
     /* Lock the mutex again */
-    ABTI_mutex_lock(pp_local_xstream, p_mutex);
+#ifndef ABT_CONFIG_USE_SIMPLE_MUTEX
+    if (p_thread) {
+        /* The signaler may have moved this ULT to the waiter queue of the
+         * mutex instead of waking it up (wait morphing). */
+        ABTI_mutex_lock_resume(pp_local_xstream, p_mutex);
+    } else
+#endif
+    {
+        ABTI_mutex_lock(pp_local_xstream, p_mutex);
+    }
 
 fn_exit:
     return abt_errno;
@@ -156,7 +159,10 @@ static inline void ABTI_cond_broadcast(ABTI_xstream *p_local_xstream,
         return;
     }
 
-    /* Wake up all waiting ULTs */
+    /* Wake up all waiting ULTs.  ULTs are moved to the waiter queue of the
+     * mutex if possible so that they are woken up one by one as the mutex is
+     * released. */
+    ABTI_mutex *p_mutex = p_cond->p_waiter_mutex;
     ABTI_unit *p_head = p_cond->p_head;
     ABTI_unit *p_unit = p_head;
     while (1) {
@@ -167,11 +173,11 @@ static inline void ABTI_cond_broadcast(ABTI_xstream *p_local_xstream,
 
         if (ABTI_unit_type_is_thread(p_unit->type)) {
             ABTI_thread *p_thread = ABTI_unit_get_thread(p_unit);
-            ABTI_thread_set_ready(p_local_xstream, p_thread);
+            if (!ABTI_mutex_add_waiter(p_mutex, p_thread))
+                ABTI_thread_set_ready(p_local_xstream, p_thread);
         } else {
             /* When the head is an external thread */
-            ABTD_atomic_release_store_int(&p_unit->state,
-                                          ABTI_UNIT_STATE_READY);
+            ABTI_ext_waiter_signal(ABTI_ext_waiter_get_ptr(p_unit));
         }
 
         /* Next ULT */
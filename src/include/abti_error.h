@@ -170,6 +170,14 @@
         }                                                                      \
     } while (0)
 
+#define ABTI_CHECK_NULL_RWLOCK_ATTR_PTR(p)                                     \
+    do {                                                                       \
+        if (ABTI_IS_ERROR_CHECK_ENABLED && p == (ABTI_rwlock_attr *)NULL) {    \
+            abt_errno = ABT_ERR_INV_RWLOCK_ATTR;                               \
+            goto fn_fail;                                                      \
+        }                                                                      \
+    } while (0)
+
 #define ABTI_CHECK_NULL_FUTURE_PTR(p)                                          \
     do {                                                                       \
         if (ABTI_IS_ERROR_CHECK_ENABLED && p == (ABTI_future *)NULL) {         \
@@ -194,6 +202,22 @@
         }                                                                      \
     } while (0)
 
+#define ABTI_CHECK_NULL_GROUP_PTR(p)                                           \
+    do {                                                                       \
+        if (ABTI_IS_ERROR_CHECK_ENABLED && p == (ABTI_group *)NULL) {          \
+            abt_errno = ABT_ERR_INV_GROUP;                                     \
+            goto fn_fail;                                                      \
+        }                                                                      \
+    } while (0)
+
+#define ABTI_CHECK_NULL_SEM_PTR(p)                                             \
+    do {                                                                       \
+        if (ABTI_IS_ERROR_CHECK_ENABLED && p == (ABTI_sem *)NULL) {            \
+            abt_errno = ABT_ERR_INV_SEM;                                       \
+            goto fn_fail;                                                      \
+        }                                                                      \
+    } while (0)
+
 #define ABTI_CHECK_NULL_XSTREAM_BARRIER_PTR(p)                                 \
     do {                                                                       \
         if (ABTI_IS_ERROR_CHECK_ENABLED &&                                     \
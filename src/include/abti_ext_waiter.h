@@ -0,0 +1,127 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#ifndef ABTI_EXT_WAITER_H_INCLUDED
+#define ABTI_EXT_WAITER_H_INCLUDED
+
+/* An external thread cannot be suspended, so it waits on an ABTI_ext_waiter
+ * instead.  It spins for a while and then sleeps on a futex.  The waker issues
+ * a futex wakeup only when the waiter is sleeping.  The unit of the waiter is
+ * linked to the waiter lists of synchronization objects in the same way as
+ * that of a ULT. */
+
+#define ABTI_EXT_WAITER_WAITING 0
+#define ABTI_EXT_WAITER_SLEEPING 1
+#define ABTI_EXT_WAITER_READY 2
+
+static inline void ABTI_ext_waiter_init(ABTI_ext_waiter *p_waiter)
+{
+    memset(&p_waiter->unit, 0, sizeof(ABTI_unit));
+    p_waiter->unit.type = ABTI_UNIT_TYPE_EXT;
+    ABTD_atomic_relaxed_store_uint32(&p_waiter->state,
+                                     ABTI_EXT_WAITER_WAITING);
+}
+
+static inline ABTI_ext_waiter *ABTI_ext_waiter_get_ptr(ABTI_unit *p_unit)
+{
+    ABTI_ASSERT(p_unit->type == ABTI_UNIT_TYPE_EXT);
+    return (ABTI_ext_waiter *)p_unit;
+}
+
+static inline ABT_bool ABTI_ext_waiter_is_ready(ABTI_ext_waiter *p_waiter)
+{
+    return (ABTD_atomic_acquire_load_uint32(&p_waiter->state) ==
+            ABTI_EXT_WAITER_READY)
+               ? ABT_TRUE
+               : ABT_FALSE;
+}
+
+/* Returns ABT_TRUE if the waiter is woken up before the sleep would start.
+ * Otherwise, p_waiter is marked as sleeping. */
+static inline ABT_bool ABTI_ext_waiter_spin(ABTI_ext_waiter *p_waiter)
+{
+    uint32_t i;
+    for (i = 0; i < gp_ABTI_global->ext_wait_spins; i++) {
+        if (ABTI_ext_waiter_is_ready(p_waiter))
+            return ABT_TRUE;
+        ABTD_atomic_pause();
+    }
+    return ABTD_atomic_bool_cas_strong_uint32(&p_waiter->state,
+                                              ABTI_EXT_WAITER_WAITING,
+                                              ABTI_EXT_WAITER_SLEEPING)
+               ? ABT_FALSE
+               : ABT_TRUE;
+}
+
+static inline void ABTI_ext_waiter_wait(ABTI_ext_waiter *p_waiter)
+{
+    if (ABTI_ext_waiter_spin(p_waiter))
+        return;
+    while (!ABTI_ext_waiter_is_ready(p_waiter)) {
+        ABTD_futex_wait(&p_waiter->state, ABTI_EXT_WAITER_SLEEPING);
+    }
+}
+
+/* Returns ABT_FALSE if tar_time (obtained by ABTI_get_wtime()) passes before
+ * the waiter is woken up. */
+static inline ABT_bool ABTI_ext_waiter_timedwait(ABTI_ext_waiter *p_waiter,
+                                                 double tar_time)
+{
+    if (ABTI_ext_waiter_spin(p_waiter))
+        return ABT_TRUE;
+    while (!ABTI_ext_waiter_is_ready(p_waiter)) {
+        double sec = tar_time - ABTI_get_wtime();
+        if (sec <= 0.0)
+            return ABT_FALSE;
+        ABTD_futex_timedwait(&p_waiter->state, ABTI_EXT_WAITER_SLEEPING, sec);
+    }
+    return ABT_TRUE;
+}
+
+/* p_waiter may be freed as soon as the state becomes READY, so the futex
+ * wakeup does not touch it. */
+static inline void ABTI_ext_waiter_signal(ABTI_ext_waiter *p_waiter)
+{
+    if (ABTD_atomic_exchange_uint32(&p_waiter->state, ABTI_EXT_WAITER_READY) ==
+        ABTI_EXT_WAITER_SLEEPING) {
+        ABTD_futex_broadcast(&p_waiter->state);
+    }
+}
+
+#ifndef ABT_CONFIG_DISABLE_EXT_THREAD
+/* External threads that join work units share a single futex since the work
+ * units do not know their external joiners.  A work unit that terminates
+ * wakes them up only if some of them are sleeping. */
+static inline void ABTI_ext_waiter_join(ABTI_unit *p_unit)
+{
+    uint32_t i, seq;
+    for (i = 0; i < gp_ABTI_global->ext_wait_spins; i++) {
+        if (ABTD_atomic_acquire_load_int(&p_unit->state) ==
+            ABTI_UNIT_STATE_TERMINATED)
+            return;
+        ABTD_atomic_pause();
+    }
+    ABTD_atomic_fetch_add_uint32(&gp_ABTI_global->num_ext_joiners, 1);
+    while (1) {
+        seq = ABTD_atomic_acquire_load_uint32(&gp_ABTI_global->ext_join_seq);
+        if (ABTD_atomic_acquire_load_int(&p_unit->state) ==
+            ABTI_UNIT_STATE_TERMINATED)
+            break;
+        ABTD_futex_wait(&gp_ABTI_global->ext_join_seq, seq);
+    }
+    ABTD_atomic_fetch_sub_uint32(&gp_ABTI_global->num_ext_joiners, 1);
+}
+
+/* Called after a work unit becomes TERMINATED with an atomic exchange. */
+static inline void ABTI_ext_waiter_wake_joiners(void)
+{
+    if (ABTD_atomic_acquire_load_uint32(&gp_ABTI_global->num_ext_joiners)) {
+        ABTD_atomic_fetch_add_uint32(&gp_ABTI_global->ext_join_seq, 1);
+        ABTD_futex_broadcast(&gp_ABTI_global->ext_join_seq);
+    }
+}
+#endif
+
+#endif /* ABTI_EXT_WAITER_H_INCLUDED */
@@ -43,4 +43,14 @@ static inline uint32_t ABTI_global_get_mutex_max_wakeups(void)
     return gp_ABTI_global->mutex_max_wakeups;
 }
 
+static inline uint32_t ABTI_global_get_mutex_queued_spins(void)
+{
+    return gp_ABTI_global->mutex_queued_spins;
+}
+
+static inline uint32_t ABTI_global_get_wait_spin_nsec(void)
+{
+    return gp_ABTI_global->wait_spin_nsec;
+}
+
 #endif /* ABTI_GLOBAL_H_INCLUDED */
@@ -0,0 +1,42 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#ifndef ABTI_GROUP_H_INCLUDED
+#define ABTI_GROUP_H_INCLUDED
+
+/* Inlined functions for Group */
+
+/* Group */
+static inline ABTI_group *ABTI_group_get_ptr(ABT_group group)
+{
+#ifndef ABT_CONFIG_DISABLE_ERROR_CHECK
+    ABTI_group *p_group;
+    if (group == ABT_GROUP_NULL) {
+        p_group = NULL;
+    } else {
+        p_group = (ABTI_group *)group;
+    }
+    return p_group;
+#else
+    return (ABTI_group *)group;
+#endif
+}
+
+static inline ABT_group ABTI_group_get_handle(ABTI_group *p_group)
+{
+#ifndef ABT_CONFIG_DISABLE_ERROR_CHECK
+    ABT_group h_group;
+    if (p_group == NULL) {
+        h_group = ABT_GROUP_NULL;
+    } else {
+        h_group = (ABT_group)p_group;
+    }
+    return h_group;
+#else
+    return (ABT_group)p_group;
+#endif
+}
+
+#endif /* ABTI_GROUP_H_INCLUDED */
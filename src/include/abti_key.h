@@ -96,9 +96,13 @@ ABTI_ktable_ensure_allocation(ABTI_xstream *p_local_xstream,
         (~(ABTU_MAX_ALIGNMENT - 1));
     /* Since only one ES can access the memory pool on creation, this uses an
      * unsafe memory pool without taking a lock. */
+    void *p_mem = NULL;
     if (ABTU_likely(ktable_size <= ABTI_KTABLE_DESC_SIZE)) {
+        /* The memory pool returns NULL if ABT_reserve() has been exhausted. */
+        p_mem = ABTI_mem_alloc_desc(p_local_xstream);
+    }
+    if (ABTU_likely(p_mem)) {
         /* Use memory pool. */
-        void *p_mem = ABTI_mem_alloc_desc(p_local_xstream);
         ABTI_ktable_mem_header *p_header = (ABTI_ktable_mem_header *)p_mem;
         p_ktable =
             (ABTI_ktable *)(((char *)p_mem) + sizeof(ABTI_ktable_mem_header));
@@ -109,7 +113,7 @@ ABTI_ktable_ensure_allocation(ABTI_xstream *p_local_xstream,
         p_ktable->extra_mem_size = ABTI_KTABLE_DESC_SIZE - ktable_size;
     } else {
         /* Use malloc() */
-        void *p_mem = ABTU_malloc(ktable_size + sizeof(ABTI_ktable_mem_header));
+        p_mem = ABTU_malloc(ktable_size + sizeof(ABTI_ktable_mem_header));
         ABTI_ktable_mem_header *p_header = (ABTI_ktable_mem_header *)p_mem;
         p_ktable =
             (ABTI_ktable *)(((char *)p_mem) + sizeof(ABTI_ktable_mem_header));
@@ -138,9 +142,14 @@ static inline void *ABTI_ktable_alloc_elem(ABTI_xstream *p_local_xstream,
         p_ktable->p_extra_mem = (void *)(((char *)p_ret) + size);
         p_ktable->extra_mem_size = extra_mem_size - size;
         return p_ret;
-    } else if (ABTU_likely(size <= ABTI_KTABLE_DESC_SIZE)) {
+    }
+    void *p_mem = NULL;
+    if (ABTU_likely(size <= ABTI_KTABLE_DESC_SIZE)) {
+        /* The memory pool returns NULL if ABT_reserve() has been exhausted. */
+        p_mem = ABTI_mem_alloc_desc(p_local_xstream);
+    }
+    if (ABTU_likely(p_mem)) {
         /* Use memory pool. */
-        void *p_mem = ABTI_mem_alloc_desc(p_local_xstream);
         ABTI_ktable_mem_header *p_header = (ABTI_ktable_mem_header *)p_mem;
         p_header->p_next = (ABTI_ktable_mem_header *)p_ktable->p_used_mem;
         p_header->is_from_mempool = ABT_TRUE;
@@ -151,7 +160,7 @@ static inline void *ABTI_ktable_alloc_elem(ABTI_xstream *p_local_xstream,
         return p_mem;
     } else {
         /* Use malloc() */
-        void *p_mem = ABTU_malloc(size + sizeof(ABTI_ktable_mem_header));
+        p_mem = ABTU_malloc(size + sizeof(ABTI_ktable_mem_header));
         ABTI_ktable_mem_header *p_header = (ABTI_ktable_mem_header *)p_mem;
         p_header->p_next = (ABTI_ktable_mem_header *)p_ktable->p_used_mem;
         p_header->is_from_mempool = ABT_FALSE;
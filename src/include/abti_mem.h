@@ -9,8 +9,7 @@
 /* Memory allocation */
 
 /* Round desc_size up to the cacheline size.  The last four bytes will be
- * used to determine whether the descriptor is allocated externally (i.e.,
- * malloc()) or taken from a memory pool. */
+ * used to store the owner ID of the descriptor. */
 #define ABTI_MEM_POOL_DESC_SIZE                                                \
     (((sizeof(ABTI_task) + 4 + ABT_CONFIG_STATIC_CACHELINE_SIZE - 1) &         \
       (~(ABT_CONFIG_STATIC_CACHELINE_SIZE - 1))) -                             \
@@ -28,10 +27,49 @@ void ABTI_mem_init(ABTI_global *p_global);
 void ABTI_mem_init_local(ABTI_xstream *p_local_xstream);
 void ABTI_mem_finalize(ABTI_global *p_global);
 void ABTI_mem_finalize_local(ABTI_xstream *p_local_xstream);
+void ABTI_mem_get_stats(ABTI_xstream *p_xstream, ABT_mem_stats *p_stats);
+int ABTI_mem_reserve(ABTI_global *p_global, size_t num_stacks,
+                     size_t num_descs);
 int ABTI_mem_check_lp_alloc(int lp_alloc);
+#if defined(ABT_CONFIG_USE_MEM_POOL) && !defined(ABT_CONFIG_DISABLE_EXT_THREAD)
+ABTI_mem_ext_pool *ABTI_mem_create_ext_pool(void);
+#endif
 
 /* Inline functions */
 #ifdef ABT_CONFIG_USE_MEM_POOL
+#ifndef ABT_CONFIG_DISABLE_EXT_THREAD
+/* Return the local pools of the calling external thread.  They are created
+ * when the external thread needs them for the first time after ABT_init(). */
+static inline ABTI_mem_ext_pool *ABTI_mem_get_ext_pool(void)
+{
+    if (ABTU_likely(lp_ABTI_mem_ext_pool_gen ==
+                    gp_ABTI_global->mem_ext_pool_gen)) {
+        return lp_ABTI_mem_ext_pool;
+    }
+    return ABTI_mem_create_ext_pool();
+}
+#endif
+
+static inline ABTI_mem_pool_local_pool *
+ABTI_mem_get_stack_pool(ABTI_xstream *p_local_xstream)
+{
+#ifndef ABT_CONFIG_DISABLE_EXT_THREAD
+    if (p_local_xstream == NULL)
+        return &ABTI_mem_get_ext_pool()->mem_pool_stack;
+#endif
+    return &p_local_xstream->mem_pool_stack;
+}
+
+static inline ABTI_mem_pool_local_pool *
+ABTI_mem_get_desc_pool(ABTI_xstream *p_local_xstream)
+{
+#ifndef ABT_CONFIG_DISABLE_EXT_THREAD
+    if (p_local_xstream == NULL)
+        return &ABTI_mem_get_ext_pool()->mem_pool_desc;
+#endif
+    return &p_local_xstream->mem_pool_desc;
+}
+
 static inline void
 ABTI_mem_alloc_thread_mempool_impl(ABTI_mem_pool_local_pool *p_mem_pool_stack,
                                    size_t stacksize, ABTI_thread **pp_thread,
@@ -40,6 +78,11 @@ ABTI_mem_alloc_thread_mempool_impl(ABTI_mem_pool_local_pool *p_mem_pool_stack,
     /* stacksize must be a multiple of ABT_CONFIG_STATIC_CACHELINE_SIZE. */
     ABTI_ASSERT((stacksize & (ABT_CONFIG_STATIC_CACHELINE_SIZE - 1)) == 0);
     char *p_thread = (char *)ABTI_mem_pool_alloc(p_mem_pool_stack);
+    if (ABTU_unlikely(!p_thread)) {
+        /* The memory pool has run out of the reserved memory. */
+        *pp_thread = NULL;
+        return;
+    }
     *pp_stack = (void *)(((char *)p_thread) - stacksize);
     *pp_thread = (ABTI_thread *)p_thread;
 }
@@ -54,6 +97,11 @@ static inline void ABTI_mem_alloc_thread_malloc_impl(size_t stacksize,
         (stacksize + ABT_CONFIG_STATIC_CACHELINE_SIZE - 1) &
         (~(ABT_CONFIG_STATIC_CACHELINE_SIZE - 1));
     char *p_stack = (char *)ABTU_malloc(alloc_stacksize + sizeof(ABTI_thread));
+#ifdef ABT_CONFIG_USE_MEM_POOL
+    ABTD_atomic_fetch_add_uint64(&gp_ABTI_global->mem_pool_stack
+                                      .num_malloc_fallbacks,
+                                 1);
+#endif
     *pp_stack = (void *)p_stack;
     *pp_thread = (ABTI_thread *)(p_stack + alloc_stacksize);
 }
@@ -64,23 +112,16 @@ ABTI_mem_alloc_thread_default(ABTI_xstream *p_local_xstream)
     size_t stacksize = ABTI_global_get_thread_stacksize();
     ABTI_thread *p_thread;
     void *p_stack;
-#ifndef ABT_CONFIG_DISABLE_EXT_THREAD
-    /* If an external thread allocates a stack, we use ABTU_malloc. */
-    if (p_local_xstream == NULL) {
-        ABTI_mem_alloc_thread_malloc_impl(stacksize, &p_thread, &p_stack);
-        p_thread->stacktype = ABTI_STACK_TYPE_MALLOC;
-    } else
-#endif
-    {
 #ifdef ABT_CONFIG_USE_MEM_POOL
-        ABTI_mem_alloc_thread_mempool_impl(&p_local_xstream->mem_pool_stack,
-                                           stacksize, &p_thread, &p_stack);
-        p_thread->stacktype = ABTI_STACK_TYPE_MEMPOOL;
+    ABTI_mem_alloc_thread_mempool_impl(ABTI_mem_get_stack_pool(p_local_xstream),
+                                       stacksize, &p_thread, &p_stack);
+    if (ABTU_unlikely(!p_thread))
+        return NULL;
+    p_thread->stacktype = ABTI_STACK_TYPE_MEMPOOL;
 #else
-        ABTI_mem_alloc_thread_malloc_impl(stacksize, &p_thread, &p_stack);
-        p_thread->stacktype = ABTI_STACK_TYPE_MALLOC;
+    ABTI_mem_alloc_thread_malloc_impl(stacksize, &p_thread, &p_stack);
+    p_thread->stacktype = ABTI_STACK_TYPE_MALLOC;
 #endif
-    }
     /* Initialize members of ABTI_thread_attr. */
     p_thread->p_stack = p_stack;
     p_thread->stacksize = stacksize;
@@ -101,18 +142,11 @@ ABTI_mem_alloc_thread_mempool(ABTI_xstream *p_local_xstream,
     size_t stacksize = ABTI_global_get_thread_stacksize();
     ABTI_thread *p_thread;
     void *p_stack;
-#ifndef ABT_CONFIG_DISABLE_EXT_THREAD
-    /* If an external thread allocates a stack, we use ABTU_malloc. */
-    if (p_local_xstream == NULL) {
-        ABTI_mem_alloc_thread_malloc_impl(stacksize, &p_thread, &p_stack);
-        p_thread->stacktype = ABTI_STACK_TYPE_MALLOC;
-    } else
-#endif
-    {
-        ABTI_mem_alloc_thread_mempool_impl(&p_local_xstream->mem_pool_stack,
-                                           stacksize, &p_thread, &p_stack);
-        p_thread->stacktype = ABTI_STACK_TYPE_MEMPOOL;
-    }
+    ABTI_mem_alloc_thread_mempool_impl(ABTI_mem_get_stack_pool(p_local_xstream),
+                                       stacksize, &p_thread, &p_stack);
+    if (ABTU_unlikely(!p_thread))
+        return NULL;
+    p_thread->stacktype = ABTI_STACK_TYPE_MEMPOOL;
     /* Copy members of p_attr. */
     p_thread->p_stack = p_stack;
     p_thread->stacksize = stacksize;
@@ -163,6 +197,34 @@ static inline ABTI_thread *ABTI_mem_alloc_thread_user(ABTI_thread_attr *p_attr)
     return p_thread;
 }
 
+#ifdef ABT_CONFIG_USE_FCONTEXT
+static inline ABTI_thread *ABTI_mem_alloc_thread_copy(ABTI_thread_attr *p_attr)
+{
+    /* A shared stack is bound when the ULT runs for the first time.  The state
+     * of stack copying is placed right after ABTI_thread. */
+    ABTI_thread *p_thread = (ABTI_thread *)ABTU_malloc(
+        sizeof(ABTI_thread) + sizeof(ABTI_thread_stack_copy));
+    if (ABTU_unlikely(!p_thread))
+        return NULL;
+    ABTI_thread_stack_copy *p_copy = (ABTI_thread_stack_copy *)(p_thread + 1);
+    p_copy->p_copy_stack = NULL;
+    p_copy->is_started = ABT_FALSE;
+    p_copy->p_buf = NULL;
+    p_copy->used = 0;
+    p_copy->capacity = 0;
+    /* Copy members of p_attr. */
+    p_thread->stacktype = ABTI_STACK_TYPE_COPY;
+    p_thread->stacksize = p_attr->stacksize;
+    p_thread->p_stack = NULL;
+#ifndef ABT_CONFIG_DISABLE_MIGRATION
+    p_thread->unit_def.migratable = p_attr->migratable;
+    p_thread->f_migration_cb = p_attr->f_cb;
+    p_thread->p_migration_cb_arg = p_attr->p_cb_arg;
+#endif
+    return p_thread;
+}
+#endif
+
 static inline ABTI_thread *ABTI_mem_alloc_thread_main(ABTI_thread_attr *p_attr)
 {
     /* Stack of the currently running Pthreads is used. */
@@ -196,6 +258,10 @@ static inline ABTI_thread *ABTI_mem_alloc_thread(ABTI_xstream *p_local_xstream,
         return ABTI_mem_alloc_thread_malloc(p_attr);
     } else if (stacktype == ABTI_STACK_TYPE_USER) {
         return ABTI_mem_alloc_thread_user(p_attr);
+#ifdef ABT_CONFIG_USE_FCONTEXT
+    } else if (stacktype == ABTI_STACK_TYPE_COPY) {
+        return ABTI_mem_alloc_thread_copy(p_attr);
+#endif
     } else {
         ABTI_ASSERT(stacktype == ABTI_STACK_TYPE_MAIN);
         return ABTI_mem_alloc_thread_main(p_attr);
@@ -210,16 +276,7 @@ static inline void ABTI_mem_free_thread(ABTI_xstream *p_local_xstream,
     if (p_thread->stacktype == ABTI_STACK_TYPE_MEMPOOL) {
         ABTI_VALGRIND_UNREGISTER_STACK(p_thread->p_stack);
         /* Came from a memory pool. */
-#ifndef ABT_CONFIG_DISABLE_EXT_THREAD
-        if (p_local_xstream == NULL) {
-            /* Return a stack to the global pool. */
-            ABTI_spinlock_acquire(&gp_ABTI_global->mem_pool_stack_lock);
-            ABTI_mem_pool_free(&gp_ABTI_global->mem_pool_stack_ext, p_thread);
-            ABTI_spinlock_release(&gp_ABTI_global->mem_pool_stack_lock);
-            return;
-        }
-#endif
-        ABTI_mem_pool_free(&p_local_xstream->mem_pool_stack, p_thread);
+        ABTI_mem_pool_free(ABTI_mem_get_stack_pool(p_local_xstream), p_thread);
     } else
 #endif
         if (p_thread->stacktype == ABTI_STACK_TYPE_MALLOC) {
@@ -230,30 +287,48 @@ static inline void ABTI_mem_free_thread(ABTI_xstream *p_local_xstream,
         if (p_thread->stacktype == ABTI_STACK_TYPE_USER) {
             ABTI_VALGRIND_UNREGISTER_STACK(p_thread->p_stack);
         }
+#ifdef ABT_CONFIG_USE_FCONTEXT
+        if (p_thread->stacktype == ABTI_STACK_TYPE_COPY) {
+            /* Free the saved part of the stack. */
+            void *p_buf = ((ABTI_thread_stack_copy *)(p_thread + 1))->p_buf;
+            if (p_buf)
+                ABTU_free(p_buf);
+        }
+#endif
         ABTU_free(p_thread);
     }
 }
 
+/* Allocate num ULTs with the same attribute in one go.  The local memory pool
+ * serves them from its buckets without synchronization in most cases.  Either
+ * all or none of them are allocated. */
+static inline ABT_bool ABTI_mem_alloc_thread_many(ABTI_xstream *p_local_xstream,
+                                                  ABTI_thread_attr *p_attr,
+                                                  size_t num,
+                                                  ABTI_thread **pp_threads)
+{
+    size_t i;
+    for (i = 0; i < num; i++) {
+        pp_threads[i] = ABTI_mem_alloc_thread(p_local_xstream, p_attr);
+        if (ABTU_unlikely(!pp_threads[i])) {
+            while (i-- > 0)
+                ABTI_mem_free_thread(p_local_xstream, pp_threads[i]);
+            return ABT_FALSE;
+        }
+    }
+    return ABT_TRUE;
+}
+
+/* This returns NULL if the memory pool may not allocate memory after
+ * ABT_reserve() and the reserved descriptors have been exhausted. */
 static inline void *ABTI_mem_alloc_desc(ABTI_xstream *p_local_xstream)
 {
 #ifndef ABT_CONFIG_USE_MEM_POOL
     return ABTU_malloc(ABTI_MEM_POOL_DESC_SIZE);
 #else
-    void *p_desc;
-#ifndef ABT_CONFIG_DISABLE_EXT_THREAD
-    if (p_local_xstream == NULL) {
-        /* For external threads */
-        p_desc = ABTU_malloc(ABTI_MEM_POOL_DESC_SIZE);
-        *(uint32_t *)(((char *)p_desc) + ABTI_MEM_POOL_DESC_SIZE) = 1;
-        return p_desc;
-    }
-#endif
-
-    /* Find the page that has an empty block */
-    p_desc = ABTI_mem_pool_alloc(&p_local_xstream->mem_pool_desc);
-    /* To distinguish it from a malloc'ed case, assign non-NULL value. */
-    *(uint32_t *)(((char *)p_desc) + ABTI_MEM_POOL_DESC_SIZE) = 0;
-    return p_desc;
+    /* Find the page that has an empty block.  The memory pool sets the owner
+     * ID. */
+    return ABTI_mem_pool_alloc(ABTI_mem_get_desc_pool(p_local_xstream));
 #endif
 }
 
@@ -263,21 +338,51 @@ static inline void ABTI_mem_free_desc(ABTI_xstream *p_local_xstream,
 #ifndef ABT_CONFIG_USE_MEM_POOL
     ABTU_free(p_desc);
 #else
-#ifndef ABT_CONFIG_DISABLE_EXT_THREAD
-    if (*(uint32_t *)(((char *)p_desc) + ABTI_MEM_POOL_DESC_SIZE)) {
-        /* This was allocated by an external thread. */
-        ABTU_free(p_desc);
-        return;
-    } else if (!p_local_xstream) {
-        /* Return a stack and a descriptor to their global pools. */
-        ABTI_spinlock_acquire(&gp_ABTI_global->mem_pool_desc_lock);
-        ABTI_mem_pool_free(&gp_ABTI_global->mem_pool_desc_ext, p_desc);
-        ABTI_spinlock_release(&gp_ABTI_global->mem_pool_desc_lock);
+    ABTI_mem_pool_free(ABTI_mem_get_desc_pool(p_local_xstream), p_desc);
+#endif
+}
+
+/* Synchronization objects are allocated from the descriptor pool after
+ * ABT_reserve() so that they can use the reserved memory.  Otherwise, they are
+ * allocated by malloc() so that they can be freed even after ABT_finalize().
+ * Either way, a synchronization object has the size of a descriptor, and a
+ * small buffer of it can be placed at this offset in the same memory. */
+#define ABTI_MEM_DESC_EXTRA_OFFSET(obj_size)                                   \
+    (((obj_size) + ABTU_MAX_ALIGNMENT - 1) & (~(ABTU_MAX_ALIGNMENT - 1)))
+
+#ifdef ABT_CONFIG_USE_MEM_POOL
+/* The owner ID slot of a synchronization object allocated by malloc(), which
+ * no descriptor in the pool has. */
+#define ABTI_MEM_SYNC_OWNER_MALLOC ((uint32_t)-2)
+#endif
+
+static inline void *ABTI_mem_alloc_sync(void)
+{
+#ifdef ABT_CONFIG_USE_MEM_POOL
+    ABTI_global *p_global = gp_ABTI_global;
+    if (p_global && p_global->mem_sync_in_pool)
+        return ABTI_mem_alloc_desc(ABTI_local_get_xstream());
+    char *p_sync = (char *)ABTU_malloc(ABTI_MEM_POOL_DESC_SIZE + 4);
+    *(uint32_t *)(p_sync + ABTI_MEM_POOL_DESC_SIZE) =
+        ABTI_MEM_SYNC_OWNER_MALLOC;
+    return (void *)p_sync;
+#else
+    return ABTU_malloc(ABTI_MEM_POOL_DESC_SIZE);
+#endif
+}
+
+/* A synchronization object allocated from the descriptor pool must be freed
+ * before ABT_finalize() since the pool releases its memory. */
+static inline void ABTI_mem_free_sync(void *p_sync)
+{
+#ifdef ABT_CONFIG_USE_MEM_POOL
+    if (*(uint32_t *)(((char *)p_sync) + ABTI_MEM_POOL_DESC_SIZE) !=
+        ABTI_MEM_SYNC_OWNER_MALLOC) {
+        ABTI_mem_free_desc(ABTI_local_get_xstream(), p_sync);
         return;
     }
 #endif
-    ABTI_mem_pool_free(&p_local_xstream->mem_pool_desc, p_desc);
-#endif
+    ABTU_free(p_sync);
 }
 
 static inline ABTI_task *ABTI_mem_alloc_task(ABTI_xstream *p_local_xstream)
@@ -291,4 +396,91 @@ static inline void ABTI_mem_free_task(ABTI_xstream *p_local_xstream,
     ABTI_mem_free_desc(p_local_xstream, (void *)p_task);
 }
 
+/* Allocate num tasklets in one go.  Either all or none of them are allocated.
+ */
+static inline ABT_bool ABTI_mem_alloc_task_many(ABTI_xstream *p_local_xstream,
+                                                size_t num,
+                                                ABTI_task **pp_tasks)
+{
+    size_t i;
+    for (i = 0; i < num; i++) {
+        pp_tasks[i] = ABTI_mem_alloc_task(p_local_xstream);
+        if (ABTU_unlikely(!pp_tasks[i])) {
+            while (i-- > 0)
+                ABTI_mem_free_task(p_local_xstream, pp_tasks[i]);
+            return ABT_FALSE;
+        }
+    }
+    return ABT_TRUE;
+}
+
+/* The payload of a work unit (see ABT_thread_create_with_payload()) is copied
+ * to the spare area of its descriptor if it fits.  Otherwise, another
+ * descriptor is allocated for it, which is still cheaper than malloc(). */
+static inline void *ABTI_mem_get_task_spare(ABTI_task *p_task,
+                                            size_t *p_size)
+{
+    size_t offset = ABTI_MEM_DESC_EXTRA_OFFSET(sizeof(ABTI_task));
+    *p_size = offset < ABTI_MEM_POOL_DESC_SIZE
+                  ? ABTI_MEM_POOL_DESC_SIZE - offset
+                  : 0;
+    return (void *)(((char *)p_task) + offset);
+}
+
+static inline void *ABTI_mem_get_thread_spare(ABTI_thread *p_thread,
+                                              size_t *p_size)
+{
+    /* Only a block of the stack pool may have a spare area, which is placed
+     * after ABTI_thread and the owner ID. */
+    size_t offset =
+        ABTI_MEM_DESC_EXTRA_OFFSET(sizeof(ABTI_thread) + sizeof(uint32_t));
+    *p_size = 0;
+#ifdef ABT_CONFIG_USE_MEM_POOL
+    if (p_thread->stacktype == ABTI_STACK_TYPE_MEMPOOL) {
+        size_t used = p_thread->stacksize + offset;
+        size_t block_size = gp_ABTI_global->mem_pool_stack.header_size;
+        if (used < block_size)
+            *p_size = block_size - used;
+    }
+#endif
+    return (void *)(((char *)p_thread) + offset);
+}
+
+/* Returns NULL if memory cannot be allocated (see ABT_reserve()). */
+static inline void *ABTI_mem_alloc_payload(ABTI_xstream *p_local_xstream,
+                                           void *p_spare, size_t spare_size,
+                                           const void *payload, size_t size)
+{
+    ABTI_STATIC_ASSERT(ABT_PAYLOAD_MAX_SIZE <= ABTI_MEM_POOL_DESC_SIZE);
+    void *p_payload =
+        size <= spare_size ? p_spare : ABTI_mem_alloc_desc(p_local_xstream);
+    if (ABTU_likely(p_payload))
+        memcpy(p_payload, payload, size);
+    return p_payload;
+}
+
+static inline void ABTI_mem_free_payload(ABTI_xstream *p_local_xstream,
+                                         void *p_payload, void *p_spare)
+{
+    if (p_payload && p_payload != p_spare)
+        ABTI_mem_free_desc(p_local_xstream, p_payload);
+}
+
+/* A completion callback of a work unit is also stored in a descriptor. */
+static inline ABTI_unit_completion *
+ABTI_mem_alloc_completion(ABTI_xstream *p_local_xstream)
+{
+    ABTI_STATIC_ASSERT(sizeof(ABTI_unit_completion) <=
+                       ABTI_MEM_POOL_DESC_SIZE);
+    return (ABTI_unit_completion *)ABTI_mem_alloc_desc(p_local_xstream);
+}
+
+static inline void
+ABTI_mem_free_completion(ABTI_xstream *p_local_xstream,
+                         ABTI_unit_completion *p_completion)
+{
+    if (p_completion)
+        ABTI_mem_free_desc(p_local_xstream, (void *)p_completion);
+}
+
 #endif /* ABTI_MEM_H_INCLUDED */
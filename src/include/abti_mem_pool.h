@@ -22,6 +22,24 @@ typedef struct ABTI_mem_pool_header {
     ABTI_mem_pool_header_bucket_info bucket_info;
 } ABTI_mem_pool_header;
 
+/* Owner ID of a local pool that does not own any memory block. */
+#define ABTI_MEM_POOL_OWNER_NONE ((uint32_t)-1)
+
+/*
+ * A return queue of each owner.  When the remote return is enabled, a memory
+ * block freed by a local pool that does not own the block is pushed to the
+ * return queue of its owner, and the owner takes it back when its local pool
+ * runs out of headers.  The queue is a push-only lock-free LIFO; the owner
+ * takes all the headers at once by exchanging the head, so it does not have an
+ * ABA problem.
+ */
+typedef struct ABTI_mem_pool_return_queue {
+    ABTD_atomic_ptr p_head; /* List of headers connected via p_next */
+    ABTD_atomic_int in_use; /* Whether a local pool owns this queue or not */
+    char pad[ABT_CONFIG_STATIC_CACHELINE_SIZE - sizeof(ABTD_atomic_ptr) -
+             sizeof(ABTD_atomic_int)];
+} ABTI_mem_pool_return_queue;
+
 typedef struct ABTI_mem_pool_page {
     ABTI_sync_lifo_element lifo_elem;
     struct ABTI_mem_pool_page *p_next_empty_page;
@@ -53,11 +71,19 @@ typedef struct ABTI_mem_pool_global_pool {
     size_t header_offset;       /* Offset of ABTI_mem_pool_header from the top
                                  * of the memory segment; i.e., the pool returns
                                  * p_header_memory_top + offset. */
+    size_t owner_offset;        /* Offset of the owner ID (uint32_t) from the
+                                 * header. */
     int num_headers_per_bucket; /* Number of headers per bucket. */
     int num_lp_type_requests;   /* Number of requests for large page allocation.
                                  */
     ABTU_MEM_LARGEPAGE_TYPE
     lp_type_requests[4]; /* Requests for large page allocation */
+    ABT_bool remote_return; /* Whether remotely freed headers are returned to
+                             * their owners or not. */
+    uint32_t num_return_queues;                /* Number of owner IDs. */
+    ABTI_mem_pool_return_queue *return_queues; /* Indexed by owner ID. */
+    ABTD_atomic_int no_alloc; /* If nonzero, local pools cannot get buckets
+                               * that need new pages (see ABT_reserve()). */
     __attribute__((aligned(ABT_CONFIG_STATIC_CACHELINE_SIZE)))
     ABTI_sync_lifo bucket_lifo; /* LIFO of available buckets. */
     __attribute__((aligned(ABT_CONFIG_STATIC_CACHELINE_SIZE)))
@@ -70,6 +96,18 @@ typedef struct ABTI_mem_pool_global_pool {
      * is stored in partial_bucket.bucket_info.num_headers. */
     ABTI_spinlock partial_bucket_lock;
     ABTI_mem_pool_header *partial_bucket;
+    __attribute__((aligned(ABT_CONFIG_STATIC_CACHELINE_SIZE)))
+    /* Statistics.  They are updated only in slow paths. */
+    ABTD_atomic_uint64 num_pages[5]; /* Indexed by ABTU_MEM_LARGEPAGE_TYPE */
+    ABTD_atomic_uint64 num_taken_buckets;
+    ABTD_atomic_uint64 num_returned_buckets;
+    ABTD_atomic_uint64 num_malloc_fallbacks;
+    ABTD_atomic_uint64 num_reserved;       /* Headers reserved by ABT_reserve */
+    ABTD_atomic_uint64 num_alloc_failures; /* Allocations refused by no_alloc */
+    /* Counters of local pools that have already been destroyed. */
+    ABTD_atomic_uint64 num_retired_allocs;
+    ABTD_atomic_uint64 num_retired_misses;
+    ABTD_atomic_uint64 num_retired_remote_frees;
 } ABTI_mem_pool_global_pool;
 
 /*
@@ -91,24 +129,48 @@ typedef struct ABTI_mem_pool_local_pool {
     size_t num_headers_per_bucket; /* Cached value to reduce dereference. It
                                       must be equal to
                                       p_global_pool->num_headers_per_bucket. */
+    size_t owner_offset; /* Cached value of p_global_pool->owner_offset. */
+    uint32_t owner;      /* Owner ID.  ABTI_MEM_POOL_OWNER_NONE if none. */
+    ABTI_mem_pool_return_queue *p_return_queue; /* NULL if the remote return
+                                                 * is disabled. */
     size_t bucket_index;
     ABTI_mem_pool_header *buckets[ABT_MEM_POOL_MAX_LOCAL_BUCKETS];
+    /* Statistics.  They are updated only by the owner of this local pool, so
+     * atomic operations are not used.  Readers may see slightly stale values.
+     */
+    uint64_t num_allocs;  /* Number of headers taken from this pool. */
+    uint64_t num_frees;   /* Number of headers returned to this pool. */
+    uint64_t num_misses;  /* Number of refills from the global pool. */
+    uint64_t num_returns; /* Number of buckets returned to the global pool. */
+    uint64_t num_remote_frees; /* Number of headers freed by this pool but
+                                * owned by others. */
 } ABTI_mem_pool_local_pool;
 
 void ABTI_mem_pool_init_global_pool(
     ABTI_mem_pool_global_pool *p_global_pool, int num_headers_per_bucket,
-    size_t header_size, size_t header_offset, size_t page_size,
-    const ABTU_MEM_LARGEPAGE_TYPE *lp_type_requests, int num_lp_type_requests,
-    size_t alignment_hint);
+    size_t header_size, size_t header_offset, size_t owner_offset,
+    size_t page_size, const ABTU_MEM_LARGEPAGE_TYPE *lp_type_requests,
+    int num_lp_type_requests, size_t alignment_hint, uint32_t num_owners,
+    ABT_bool remote_return);
 void ABTI_mem_pool_destroy_global_pool(
     ABTI_mem_pool_global_pool *p_global_pool);
 void ABTI_mem_pool_init_local_pool(ABTI_mem_pool_local_pool *p_local_pool,
-                                   ABTI_mem_pool_global_pool *p_global_pool);
+                                   ABTI_mem_pool_global_pool *p_global_pool,
+                                   ABT_bool is_owner);
 void ABTI_mem_pool_destroy_local_pool(ABTI_mem_pool_local_pool *p_local_pool);
 ABTI_mem_pool_header *
 ABTI_mem_pool_take_bucket(ABTI_mem_pool_global_pool *p_global_pool);
 void ABTI_mem_pool_return_bucket(ABTI_mem_pool_global_pool *p_global_pool,
                                  ABTI_mem_pool_header *bucket);
+void ABTI_mem_pool_reserve(ABTI_mem_pool_global_pool *p_global_pool,
+                           size_t num_headers, ABT_bool no_alloc);
+ABT_bool ABTI_mem_pool_free_remote(ABTI_mem_pool_local_pool *p_local_pool,
+                                   void *mem, uint32_t owner);
+void ABTI_mem_pool_take_returned(ABTI_mem_pool_local_pool *p_local_pool);
+void ABTI_mem_pool_get_global_stats(ABTI_mem_pool_global_pool *p_global_pool,
+                                    ABT_mem_pool_stats *p_stats);
+void ABTI_mem_pool_add_local_stats(ABTI_mem_pool_local_pool *p_local_pool,
+                                   ABT_mem_pool_stats *p_stats);
 
 static inline void *ABTI_mem_pool_alloc(ABTI_mem_pool_local_pool *p_local_pool)
 {
@@ -118,17 +180,41 @@ static inline void *ABTI_mem_pool_alloc(ABTI_mem_pool_local_pool *p_local_pool)
     /* At least one header is available in the current bucket, so it must be
      * larger than 0. */
     ABTI_ASSERT(num_headers_in_cur_bucket >= 1);
+    p_local_pool->num_allocs++;
     if (num_headers_in_cur_bucket == 1) {
         /*cur_bucket will be empty after allocation. */
         if (bucket_index == 0) {
+            ABTI_mem_pool_return_queue *p_return_queue =
+                p_local_pool->p_return_queue;
+            if (p_return_queue &&
+                ABTD_atomic_relaxed_load_ptr(&p_return_queue->p_head)) {
+                /* Others have returned headers owned by this pool.  Let's take
+                 * them back first and retry. */
+                p_local_pool->num_allocs--;
+                ABTI_mem_pool_take_returned(p_local_pool);
+                return ABTI_mem_pool_alloc(p_local_pool);
+            }
             /* cur_bucket is the last header in this pool.
              * Let's get some buckets from the global pool. */
             int i;
             for (i = 0; i < ABT_MEM_POOL_NUM_TAKE_BUCKETS; i++) {
-                p_local_pool->buckets[i] =
+                ABTI_mem_pool_header *p_bucket =
                     ABTI_mem_pool_take_bucket(p_local_pool->p_global_pool);
+                if (ABTU_unlikely(!p_bucket))
+                    break;
+                p_local_pool->buckets[i] = p_bucket;
             }
-            p_local_pool->bucket_index = ABT_MEM_POOL_NUM_TAKE_BUCKETS - 1;
+            if (ABTU_unlikely(i == 0)) {
+                /* The global pool is not allowed to allocate a new page.  The
+                 * last header is kept since a local pool may not be empty. */
+                p_local_pool->num_allocs--;
+                ABTD_atomic_fetch_add_uint64(&p_local_pool->p_global_pool
+                                                  ->num_alloc_failures,
+                                             1);
+                return NULL;
+            }
+            p_local_pool->num_misses++;
+            p_local_pool->bucket_index = i - 1;
         } else {
             p_local_pool->bucket_index = bucket_index - 1;
         }
@@ -139,6 +225,9 @@ static inline void *ABTI_mem_pool_alloc(ABTI_mem_pool_local_pool *p_local_pool)
         p_next->bucket_info.num_headers = num_headers_in_cur_bucket - 1;
         p_local_pool->buckets[bucket_index] = p_next;
     }
+    /* Record the owner of this header. */
+    *(uint32_t *)(((char *)cur_bucket) + p_local_pool->owner_offset) =
+        p_local_pool->owner;
     /* At least one header is available in the current bucket. */
     return (void *)cur_bucket;
 }
@@ -146,10 +235,17 @@ static inline void *ABTI_mem_pool_alloc(ABTI_mem_pool_local_pool *p_local_pool)
 static inline void ABTI_mem_pool_free(ABTI_mem_pool_local_pool *p_local_pool,
                                       void *mem)
 {
+    uint32_t owner =
+        *(uint32_t *)(((char *)mem) + p_local_pool->owner_offset);
+    if (ABTU_unlikely(owner != p_local_pool->owner)) {
+        if (ABTI_mem_pool_free_remote(p_local_pool, mem, owner))
+            return;
+    }
     /* At least one header is available in the current bucket. */
     size_t bucket_index = p_local_pool->bucket_index;
     ABTI_mem_pool_header *p_freed_header = (ABTI_mem_pool_header *)mem;
     ABTI_mem_pool_header *cur_bucket = p_local_pool->buckets[bucket_index];
+    p_local_pool->num_frees++;
     if (cur_bucket->bucket_info.num_headers ==
         p_local_pool->num_headers_per_bucket) {
         /* cur_bucket is full. */
@@ -160,6 +256,7 @@ static inline void ABTI_mem_pool_free(ABTI_mem_pool_local_pool *p_local_pool,
                 ABTI_mem_pool_return_bucket(p_local_pool->p_global_pool,
                                             p_local_pool->buckets[i]);
             }
+            p_local_pool->num_returns += ABT_MEM_POOL_NUM_RETURN_BUCKETS;
             for (i = ABT_MEM_POOL_NUM_RETURN_BUCKETS;
                  i < ABT_MEM_POOL_MAX_LOCAL_BUCKETS; i++) {
                 p_local_pool->buckets[i - ABT_MEM_POOL_NUM_RETURN_BUCKETS] =
@@ -42,6 +42,7 @@ static inline void ABTI_mutex_init(ABTI_mutex *p_mutex)
     p_mutex->attr.attrs = ABTI_MUTEX_ATTR_NONE;
     p_mutex->attr.max_handovers = ABTI_global_get_mutex_max_handovers();
     p_mutex->attr.max_wakeups = ABTI_global_get_mutex_max_wakeups();
+    ABTD_atomic_relaxed_store_ptr(&p_mutex->p_qtail, NULL);
 #ifndef ABT_CONFIG_USE_SIMPLE_MUTEX
     p_mutex->p_htable = ABTI_thread_htable_create(gp_ABTI_global->max_xstreams);
     p_mutex->p_handover = NULL;
@@ -58,8 +59,68 @@ static inline void ABTI_mutex_fini(ABTI_mutex *p_mutex)
 }
 #endif
 
+/* Queued spin phase of a mutex that has ABTI_MUTEX_ATTR_QUEUED_SPIN.  Waiters
+ * line up in an MCS-style queue and each of them spins on its own node, so
+ * only the head of the queue polls p_mutex->val.  The head passes its position
+ * to the next waiter when it acquires the mutex or after it polls the mutex
+ * ABT_MUTEX_QUEUED_SPINS times.  Returns ABT_TRUE if the mutex has been
+ * acquired. */
+static inline ABT_bool ABTI_mutex_spin_queued(ABTI_mutex *p_mutex)
+{
+    ABTI_mutex_qnode node, *p_prev, *p_next;
+    ABT_bool acquired = ABT_FALSE;
+    uint32_t i = 0, max_spins = ABTI_global_get_mutex_queued_spins();
+
+    ABTD_atomic_relaxed_store_ptr(&node.p_next, NULL);
+    ABTD_atomic_relaxed_store_int(&node.is_head, 0);
+    p_prev = (ABTI_mutex_qnode *)ABTD_atomic_exchange_ptr(&p_mutex->p_qtail,
+                                                          (void *)&node);
+    if (p_prev) {
+        ABTD_atomic_release_store_ptr(&p_prev->p_next, (void *)&node);
+        while (ABTD_atomic_acquire_load_int(&node.is_head) == 0)
+            ABTD_atomic_pause();
+    }
+
+    /* This waiter is the head.  Poll the mutex at least once. */
+    do {
+        if (ABTD_atomic_relaxed_load_uint32(&p_mutex->val) == 0 &&
+            ABTD_atomic_bool_cas_strong_uint32(&p_mutex->val, 0, 1)) {
+            acquired = ABT_TRUE;
+            break;
+        }
+        ABTD_atomic_pause();
+    } while (++i < max_spins);
+
+    /* Pass the head position to the next waiter if any. */
+    p_next = (ABTI_mutex_qnode *)ABTD_atomic_acquire_load_ptr(&node.p_next);
+    if (p_next == NULL) {
+        if (ABTD_atomic_bool_cas_strong_ptr(&p_mutex->p_qtail, (void *)&node,
+                                            NULL))
+            return acquired;
+        /* A new waiter has swapped the tail but not linked itself yet. */
+        while ((p_next = (ABTI_mutex_qnode *)ABTD_atomic_acquire_load_ptr(
+                    &node.p_next)) == NULL)
+            ABTD_atomic_pause();
+    }
+    ABTD_atomic_release_store_int(&p_next->is_head, 1);
+    return acquired;
+}
+
+static inline ABT_bool ABTI_mutex_try_spin_queued(ABTI_mutex *p_mutex)
+{
+    if (p_mutex->attr.attrs & ABTI_MUTEX_ATTR_QUEUED_SPIN)
+        return ABTI_mutex_spin_queued(p_mutex);
+    return ABT_FALSE;
+}
+
 static inline void ABTI_mutex_spinlock(ABTI_mutex *p_mutex)
 {
+    if (p_mutex->attr.attrs & ABTI_MUTEX_ATTR_QUEUED_SPIN) {
+        while (!ABTI_mutex_spin_queued(p_mutex))
+            ;
+        LOG_DEBUG("%p: spinlock\n", p_mutex);
+        return;
+    }
     /* ABTI_spinlock_ functions cannot be used since p_mutex->val can take
      * other values (i.e., not UNLOCKED nor LOCKED.) */
     while (!ABTD_atomic_bool_cas_weak_uint32(&p_mutex->val, 0, 1)) {
@@ -69,6 +130,54 @@ static inline void ABTI_mutex_spinlock(ABTI_mutex *p_mutex)
     LOG_DEBUG("%p: spinlock\n", p_mutex);
 }
 
+#ifndef ABT_CONFIG_USE_SIMPLE_MUTEX
+/* Acquire p_mutex after the calling ULT has been woken up from the waiter
+ * queue of p_mutex, either by ABTI_mutex_wake_de() or by a handover. */
+static inline void ABTI_mutex_lock_resume(ABTI_xstream **pp_local_xstream,
+                                          ABTI_mutex *p_mutex)
+{
+    while (1) {
+        /* If the mutex has been handed over to the current ULT from other ULT
+         * on the same ES, we don't need to change the mutex state. */
+        if (p_mutex->p_handover) {
+            ABTI_thread *p_self =
+                ABTI_unit_get_thread((*pp_local_xstream)->p_unit);
+            if (p_self == p_mutex->p_handover) {
+                p_mutex->p_handover = NULL;
+                ABTD_atomic_release_store_uint32(&p_mutex->val, 2);
+
+                /* Push the previous ULT to its pool.  p_giver is NULL if it has
+                 * yielded by itself. */
+                ABTI_thread *p_giver = p_mutex->p_giver;
+                if (p_giver) {
+                    ABTD_atomic_release_store_int(&p_giver->unit_def.state,
+                                                  ABTI_UNIT_STATE_READY);
+#ifdef ABT_CONFIG_DISABLE_POOL_PRODUCER_CHECK
+                    ABTI_pool_push(p_giver->unit_def.p_pool,
+                                   p_giver->unit_def.unit);
+#else
+                    /* A failed producer check is only reported since the
+                     * mutex has been acquired anyway. */
+                    int abt_errno =
+                        ABTI_pool_push(p_giver->unit_def.p_pool,
+                                       p_giver->unit_def.unit,
+                                       ABTI_self_get_native_thread_id(
+                                           *pp_local_xstream));
+                    if (abt_errno != ABT_SUCCESS)
+                        HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+#endif
+                }
+                return;
+            }
+        }
+
+        if (ABTD_atomic_exchange_uint32(&p_mutex->val, 2) == 0)
+            break;
+        ABTI_mutex_wait(pp_local_xstream, p_mutex, 2);
+    }
+}
+#endif
+
 static inline void ABTI_mutex_lock(ABTI_xstream **pp_local_xstream,
                                    ABTI_mutex *p_mutex)
 {
@@ -78,6 +187,8 @@ static inline void ABTI_mutex_lock(ABTI_xstream **pp_local_xstream,
     if (ABTI_unit_type_is_thread(type)) {
         LOG_DEBUG("%p: lock - try\n", p_mutex);
         while (!ABTD_atomic_bool_cas_weak_uint32(&p_mutex->val, 0, 1)) {
+            if (ABTI_mutex_try_spin_queued(p_mutex))
+                break;
             ABTI_thread_yield(pp_local_xstream,
                               ABTI_unit_get_thread(p_local_xstream->p_unit),
                               ABT_SYNC_EVENT_TYPE_MUTEX, (void *)p_mutex);
@@ -88,7 +199,6 @@ static inline void ABTI_mutex_lock(ABTI_xstream **pp_local_xstream,
         ABTI_mutex_spinlock(p_mutex);
     }
 #else
-    int abt_errno;
     ABTI_unit_type type = ABTI_self_get_type(*pp_local_xstream);
 
     /* Only ULTs can yield when the mutex has been locked. For others,
@@ -96,49 +206,20 @@ static inline void ABTI_mutex_lock(ABTI_xstream **pp_local_xstream,
     if (ABTI_unit_type_is_thread(type)) {
         LOG_DEBUG("%p: lock - try\n", p_mutex);
         int c;
-        if ((c = ABTD_atomic_val_cas_strong_uint32(&p_mutex->val, 0, 1)) != 0) {
+        c = ABTD_atomic_val_cas_strong_uint32(&p_mutex->val, 0, 1);
+        if (c != 0 && !ABTI_mutex_try_spin_queued(p_mutex)) {
             if (c != 2) {
                 c = ABTD_atomic_exchange_uint32(&p_mutex->val, 2);
             }
-            while (c != 0) {
+            if (c != 0) {
                 ABTI_mutex_wait(pp_local_xstream, p_mutex, 2);
-
-                /* If the mutex has been handed over to the current ULT from
-                 * other ULT on the same ES, we don't need to change the mutex
-                 * state. */
-                if (p_mutex->p_handover) {
-                    ABTI_thread *p_self =
-                        ABTI_unit_get_thread((*pp_local_xstream)->p_unit);
-                    if (p_self == p_mutex->p_handover) {
-                        p_mutex->p_handover = NULL;
-                        ABTD_atomic_release_store_uint32(&p_mutex->val, 2);
-
-                        /* Push the previous ULT to its pool */
-                        ABTI_thread *p_giver = p_mutex->p_giver;
-                        ABTD_atomic_release_store_int(&p_giver->unit_def.state,
-                                                      ABTI_UNIT_STATE_READY);
-                        ABTI_POOL_PUSH(p_giver->unit_def.p_pool,
-                                       p_giver->unit_def.unit,
-                                       ABTI_self_get_native_thread_id(
-                                           *pp_local_xstream));
-                        break;
-                    }
-                }
-
-                c = ABTD_atomic_exchange_uint32(&p_mutex->val, 2);
+                ABTI_mutex_lock_resume(pp_local_xstream, p_mutex);
             }
         }
         LOG_DEBUG("%p: lock - acquired\n", p_mutex);
     } else {
         ABTI_mutex_spinlock(p_mutex);
     }
-
-fn_exit:
-    return;
-
-fn_fail:
-    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
-    goto fn_exit;
 #endif
 }
 
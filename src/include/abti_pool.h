@@ -150,6 +150,26 @@ fn_fail:
 
 #endif /* ABT_CONFIG_DISABLE_POOL_PRODUCER_CHECK */
 
+/* Push units to a pool at once.  The caller must have set the producer of
+ * p_pool if the producer check is enabled (see ABTI_pool_set_producer()). */
+static inline void ABTI_pool_push_many(ABTI_pool *p_pool, const ABT_unit *units,
+                                       size_t num,
+                                       ABTI_native_thread_id producer_id)
+{
+    size_t i;
+#ifdef ABT_CONFIG_USE_DEBUG_LOG
+    for (i = 0; i < num; i++)
+        LOG_DEBUG_POOL_PUSH(p_pool, units[i], producer_id);
+#endif
+
+    if (p_pool->p_push_many) {
+        p_pool->p_push_many(ABTI_pool_get_handle(p_pool), units, num);
+    } else {
+        for (i = 0; i < num; i++)
+            p_pool->p_push(ABTI_pool_get_handle(p_pool), units[i]);
+    }
+}
+
 #ifdef ABT_CONFIG_DISABLE_POOL_CONSUMER_CHECK
 static inline int ABTI_pool_remove(ABTI_pool *p_pool, ABT_unit unit)
 {
@@ -11,6 +11,10 @@
 
 /* Inlined functions for RWLock */
 
+/* Bits of rm_state in the read-mostly mode */
+#define ABTI_RWLOCK_READER_BIAS 0x1 /* Readers may enter without the mutex. */
+#define ABTI_RWLOCK_WRITE_HELD 0x2  /* A writer has drained the readers. */
+
 static inline ABTI_rwlock *ABTI_rwlock_get_ptr(ABT_rwlock rwlock)
 {
 #ifndef ABT_CONFIG_DISABLE_ERROR_CHECK
@@ -47,12 +51,59 @@ static inline void ABTI_rwlock_init(ABTI_rwlock *p_rwlock)
     ABTI_cond_init(&p_rwlock->cond);
     p_rwlock->reader_count = 0;
     p_rwlock->write_flag = 0;
+    p_rwlock->num_indicators = 0;
+    p_rwlock->p_indicators = NULL;
+    ABTD_atomic_relaxed_store_int(&p_rwlock->rm_state, 0);
 }
 
 static inline void ABTI_rwlock_fini(ABTI_rwlock *p_rwlock)
 {
     ABTI_mutex_fini(&p_rwlock->mutex);
     ABTI_cond_fini(&p_rwlock->cond);
+    if (p_rwlock->p_indicators)
+        ABTU_free(p_rwlock->p_indicators);
+}
+
+/* In the read-mostly mode, a reader only increments the indicator of its ES
+ * as long as READER_BIAS is set.  A writer clears READER_BIAS and waits until
+ * the indicators sum up to zero.  Both sides update their own variable with
+ * a read-modify-write operation and then read the other's with an acquire
+ * load, so either the reader sees the cleared READER_BIAS or the writer sees
+ * the reader.  A ULT may leave on another ES than it entered on, so a single
+ * indicator can wrap around, but the sum is always the number of readers. */
+static inline ABTI_rwlock_indicator *
+ABTI_rwlock_get_indicator(ABTI_xstream *p_local_xstream, ABTI_rwlock *p_rwlock)
+{
+    /* External threads share the first indicator. */
+    int idx = p_local_xstream ? p_local_xstream->rank % p_rwlock->num_indicators
+                              : 0;
+    return &p_rwlock->p_indicators[idx];
+}
+
+static inline uint32_t ABTI_rwlock_get_num_readers(ABTI_rwlock *p_rwlock)
+{
+    uint32_t num_readers = 0;
+    int i;
+    for (i = 0; i < p_rwlock->num_indicators; i++) {
+        num_readers +=
+            ABTD_atomic_acquire_load_uint32(&p_rwlock->p_indicators[i].count);
+    }
+    return num_readers;
+}
+
+static inline void ABTI_rwlock_reader_exit(ABTI_xstream **pp_local_xstream,
+                                           ABTI_rwlock *p_rwlock)
+{
+    ABTI_rwlock_indicator *p_indicator =
+        ABTI_rwlock_get_indicator(*pp_local_xstream, p_rwlock);
+    ABTD_atomic_fetch_sub_uint32(&p_indicator->count, 1);
+    if (!(ABTD_atomic_acquire_load_int(&p_rwlock->rm_state) &
+          ABTI_RWLOCK_READER_BIAS)) {
+        /* A writer may be waiting for the readers to leave. */
+        ABTI_mutex_lock(pp_local_xstream, &p_rwlock->mutex);
+        ABTI_cond_broadcast(*pp_local_xstream, &p_rwlock->cond);
+        ABTI_mutex_unlock(*pp_local_xstream, &p_rwlock->mutex);
+    }
 }
 
 static inline int ABTI_rwlock_rdlock(ABTI_xstream **pp_local_xstream,
@@ -60,6 +111,33 @@ static inline int ABTI_rwlock_rdlock(ABTI_xstream **pp_local_xstream,
 {
     int abt_errno = ABT_SUCCESS;
 
+    if (p_rwlock->p_indicators) {
+        if (ABTD_atomic_acquire_load_int(&p_rwlock->rm_state) &
+            ABTI_RWLOCK_READER_BIAS) {
+            ABTI_rwlock_indicator *p_indicator =
+                ABTI_rwlock_get_indicator(*pp_local_xstream, p_rwlock);
+            ABTD_atomic_fetch_add_uint32(&p_indicator->count, 1);
+            if (ABTD_atomic_acquire_load_int(&p_rwlock->rm_state) &
+                ABTI_RWLOCK_READER_BIAS)
+                return ABT_SUCCESS;
+            /* A writer has revoked the fast path. */
+            ABTI_rwlock_reader_exit(pp_local_xstream, p_rwlock);
+        }
+
+        ABTI_mutex_lock(pp_local_xstream, &p_rwlock->mutex);
+        while (p_rwlock->write_flag && abt_errno == ABT_SUCCESS) {
+            abt_errno = ABTI_cond_wait(pp_local_xstream, &p_rwlock->cond,
+                                       &p_rwlock->mutex);
+        }
+        if (abt_errno == ABT_SUCCESS) {
+            ABTI_rwlock_indicator *p_indicator =
+                ABTI_rwlock_get_indicator(*pp_local_xstream, p_rwlock);
+            ABTD_atomic_fetch_add_uint32(&p_indicator->count, 1);
+        }
+        ABTI_mutex_unlock(*pp_local_xstream, &p_rwlock->mutex);
+        return abt_errno;
+    }
+
     ABTI_mutex_lock(pp_local_xstream, &p_rwlock->mutex);
 
     while (p_rwlock->write_flag && abt_errno == ABT_SUCCESS) {
@@ -81,6 +159,29 @@ static inline int ABTI_rwlock_wrlock(ABTI_xstream **pp_local_xstream,
     int abt_errno = ABT_SUCCESS;
     ABTI_mutex_lock(pp_local_xstream, &p_rwlock->mutex);
 
+    if (p_rwlock->p_indicators) {
+        while (p_rwlock->write_flag && abt_errno == ABT_SUCCESS) {
+            abt_errno = ABTI_cond_wait(pp_local_xstream, &p_rwlock->cond,
+                                       &p_rwlock->mutex);
+        }
+        if (abt_errno == ABT_SUCCESS) {
+            /* New readers take the mutex from now on.  Wait for the ones
+             * that are in the critical section. */
+            p_rwlock->write_flag = 1;
+            ABTD_atomic_exchange_int(&p_rwlock->rm_state, 0);
+            while (ABTI_rwlock_get_num_readers(p_rwlock) != 0 &&
+                   abt_errno == ABT_SUCCESS) {
+                abt_errno = ABTI_cond_wait(pp_local_xstream, &p_rwlock->cond,
+                                           &p_rwlock->mutex);
+            }
+            if (abt_errno == ABT_SUCCESS)
+                ABTD_atomic_relaxed_store_int(&p_rwlock->rm_state,
+                                              ABTI_RWLOCK_WRITE_HELD);
+        }
+        ABTI_mutex_unlock(*pp_local_xstream, &p_rwlock->mutex);
+        return abt_errno;
+    }
+
     while ((p_rwlock->write_flag || p_rwlock->reader_count) &&
            abt_errno == ABT_SUCCESS) {
         abt_errno =
@@ -98,6 +199,22 @@ static inline int ABTI_rwlock_wrlock(ABTI_xstream **pp_local_xstream,
 static inline void ABTI_rwlock_unlock(ABTI_xstream **pp_local_xstream,
                                       ABTI_rwlock *p_rwlock)
 {
+    if (p_rwlock->p_indicators) {
+        /* Readers never call this while WRITE_HELD is set. */
+        if (!(ABTD_atomic_relaxed_load_int(&p_rwlock->rm_state) &
+              ABTI_RWLOCK_WRITE_HELD)) {
+            ABTI_rwlock_reader_exit(pp_local_xstream, p_rwlock);
+            return;
+        }
+        ABTI_mutex_lock(pp_local_xstream, &p_rwlock->mutex);
+        p_rwlock->write_flag = 0;
+        ABTD_atomic_release_store_int(&p_rwlock->rm_state,
+                                      ABTI_RWLOCK_READER_BIAS);
+        ABTI_cond_broadcast(*pp_local_xstream, &p_rwlock->cond);
+        ABTI_mutex_unlock(*pp_local_xstream, &p_rwlock->mutex);
+        return;
+    }
+
     ABTI_mutex_lock(pp_local_xstream, &p_rwlock->mutex);
 
     if (p_rwlock->write_flag) {
@@ -0,0 +1,42 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#ifndef ABTI_RWLOCK_ATTR_H_INCLUDED
+#define ABTI_RWLOCK_ATTR_H_INCLUDED
+
+/* Inlined functions for rwlock attributes */
+
+static inline ABTI_rwlock_attr *ABTI_rwlock_attr_get_ptr(ABT_rwlock_attr attr)
+{
+#ifndef ABT_CONFIG_DISABLE_ERROR_CHECK
+    ABTI_rwlock_attr *p_attr;
+    if (attr == ABT_RWLOCK_ATTR_NULL) {
+        p_attr = NULL;
+    } else {
+        p_attr = (ABTI_rwlock_attr *)attr;
+    }
+    return p_attr;
+#else
+    return (ABTI_rwlock_attr *)attr;
+#endif
+}
+
+static inline ABT_rwlock_attr
+ABTI_rwlock_attr_get_handle(ABTI_rwlock_attr *p_attr)
+{
+#ifndef ABT_CONFIG_DISABLE_ERROR_CHECK
+    ABT_rwlock_attr h_attr;
+    if (p_attr == NULL) {
+        h_attr = ABT_RWLOCK_ATTR_NULL;
+    } else {
+        h_attr = (ABT_rwlock_attr)p_attr;
+    }
+    return h_attr;
+#else
+    return (ABT_rwlock_attr)p_attr;
+#endif
+}
+
+#endif /* ABTI_RWLOCK_ATTR_H_INCLUDED */
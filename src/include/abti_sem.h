@@ -0,0 +1,64 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#ifndef ABTI_SEM_H_INCLUDED
+#define ABTI_SEM_H_INCLUDED
+
+/* Inlined functions for Semaphore */
+
+static inline ABTI_sem *ABTI_sem_get_ptr(ABT_sem sem)
+{
+#ifndef ABT_CONFIG_DISABLE_ERROR_CHECK
+    ABTI_sem *p_sem;
+    if (sem == ABT_SEM_NULL) {
+        p_sem = NULL;
+    } else {
+        p_sem = (ABTI_sem *)sem;
+    }
+    return p_sem;
+#else
+    return (ABTI_sem *)sem;
+#endif
+}
+
+static inline ABT_sem ABTI_sem_get_handle(ABTI_sem *p_sem)
+{
+#ifndef ABT_CONFIG_DISABLE_ERROR_CHECK
+    ABT_sem h_sem;
+    if (p_sem == NULL) {
+        h_sem = ABT_SEM_NULL;
+    } else {
+        h_sem = (ABT_sem)p_sem;
+    }
+    return h_sem;
+#else
+    return (ABT_sem)p_sem;
+#endif
+}
+
+/* Take num permits if they are available.  This does not check waiters. */
+static inline ABT_bool ABTI_sem_take(ABTI_sem *p_sem, uint32_t num)
+{
+    uint32_t count = ABTD_atomic_acquire_load_uint32(&p_sem->count);
+    while (count >= num) {
+        uint32_t old = ABTD_atomic_val_cas_strong_uint32(&p_sem->count, count,
+                                                         count - num);
+        if (old == count)
+            return ABT_TRUE;
+        count = old;
+    }
+    return ABT_FALSE;
+}
+
+/* Fast path of acquisition.  Permits are not taken while others are queued so
+ * that waiters are served in FIFO order. */
+static inline ABT_bool ABTI_sem_try_acquire(ABTI_sem *p_sem, uint32_t num)
+{
+    if (ABTD_atomic_acquire_load_uint32(&p_sem->num_waiters) != 0)
+        return ABT_FALSE;
+    return ABTI_sem_take(p_sem, num);
+}
+
+#endif /* ABTI_SEM_H_INCLUDED */
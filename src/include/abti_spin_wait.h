@@ -0,0 +1,73 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#ifndef ABTI_SPIN_WAIT_H_INCLUDED
+#define ABTI_SPIN_WAIT_H_INCLUDED
+
+/* A ULT waiting on an eventual, a future, or a ULT to join spins for a short
+ * window before it suspends, so that a wait that ends within a few
+ * microseconds does not pay for a context switch out and back in.  Each object
+ * keeps its own window, which follows recent wait durations: a wait that ends
+ * within max_nsec moves the window toward twice its duration, and a longer
+ * wait shrinks the window.  A ULT does not spin while its pool has other work
+ * since suspending lets that work run. */
+
+static inline void ABTI_spin_wait_init(ABTI_spin_wait *p_spin,
+                                       uint32_t max_nsec)
+{
+    p_spin->max_nsec = max_nsec;
+    ABTD_atomic_relaxed_store_uint32(&p_spin->window_nsec, 0);
+}
+
+/* Update the window with the duration of a wait that started at start after
+ * the waiter resumes.  start is 0.0 if the wait was not measured. */
+static inline void ABTI_spin_wait_end(ABTI_spin_wait *p_spin, double start)
+{
+    if (start == 0.0)
+        return;
+    uint32_t max_nsec = p_spin->max_nsec;
+    double nsec = (ABTI_get_wtime() - start) * 1.0e9;
+    uint32_t sample = 0;
+    if (nsec <= (double)max_nsec) {
+        sample = (nsec * 2.0 < (double)max_nsec) ? (uint32_t)(nsec * 2.0)
+                                                  : max_nsec;
+    }
+    /* Concurrent waiters may lose updates, which is harmless. */
+    uint32_t window = ABTD_atomic_relaxed_load_uint32(&p_spin->window_nsec);
+    window = (uint32_t)(((uint64_t)window * 3 + sample) / 4);
+    ABTD_atomic_relaxed_store_uint32(&p_spin->window_nsec, window);
+}
+
+/* Spin until *p_val becomes val within the window.  Returns ABT_TRUE if it
+ * does.  Otherwise, the caller suspends and then passes *p_start to
+ * ABTI_spin_wait_end().  Only ULTs spin. */
+static inline ABT_bool ABTI_spin_wait_begin(ABTI_spin_wait *p_spin,
+                                            ABTI_xstream *p_local_xstream,
+                                            const ABTD_atomic_int *p_val,
+                                            int val, double *p_start)
+{
+    *p_start = 0.0;
+    if (p_spin->max_nsec == 0 || p_local_xstream == NULL ||
+        !ABTI_unit_type_is_thread(p_local_xstream->p_unit->type))
+        return ABT_FALSE;
+
+    double start = ABTI_get_wtime();
+    uint32_t window = ABTD_atomic_relaxed_load_uint32(&p_spin->window_nsec);
+    if (window != 0 &&
+        ABTI_pool_get_size(p_local_xstream->p_unit->p_pool) == 0) {
+        double end = start + window * 1.0e-9;
+        do {
+            if (ABTD_atomic_acquire_load_int(p_val) == val) {
+                ABTI_spin_wait_end(p_spin, start);
+                return ABT_TRUE;
+            }
+            ABTD_atomic_pause();
+        } while (ABTI_get_wtime() < end);
+    }
+    *p_start = start;
+    return ABT_FALSE;
+}
+
+#endif /* ABTI_SPIN_WAIT_H_INCLUDED */
@@ -28,6 +28,22 @@ static inline void ABTI_spinlock_acquire(ABTI_spinlock *p_lock)
     }
 }
 
+/* Same as ABTI_spinlock_acquire() but pauses between polls, doubling the
+ * number of pauses up to max_backoff while the lock is held by others. */
+static inline void ABTI_spinlock_acquire_backoff(ABTI_spinlock *p_lock,
+                                                 uint32_t max_backoff)
+{
+    uint32_t i, backoff = 1;
+    while (ABTD_atomic_test_and_set_bool(&p_lock->val)) {
+        while (ABTD_atomic_acquire_load_bool(&p_lock->val) != ABT_FALSE) {
+            for (i = 0; i < backoff; i++)
+                ABTD_atomic_pause();
+            if (backoff < max_backoff)
+                backoff <<= 1;
+        }
+    }
+}
+
 static inline void ABTI_spinlock_release(ABTI_spinlock *p_lock)
 {
     ABTD_atomic_release_clear_bool(&p_lock->val);
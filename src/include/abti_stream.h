@@ -74,11 +74,31 @@ static inline ABTI_pool *ABTI_xstream_get_main_pool(ABTI_xstream *p_xstream)
     return ABTI_pool_get_ptr(pool);
 }
 
+/* Set the state of p_unit, which can be joined, to TERMINATED.  p_unit must not
+ * be accessed after this call since its joiner may free it. */
+static inline void ABTI_xstream_set_terminated(ABTI_unit *p_unit)
+{
+#ifndef ABT_CONFIG_DISABLE_EXT_THREAD
+    /* The exchange orders the update before checking sleeping external
+     * joiners, which check the state after announcing themselves. */
+    ABTD_atomic_exchange_int(&p_unit->state, ABTI_UNIT_STATE_TERMINATED);
+    ABTI_ext_waiter_wake_joiners();
+#else
+    ABTD_atomic_release_store_int(&p_unit->state, ABTI_UNIT_STATE_TERMINATED);
+#endif
+}
+
 static inline void ABTI_xstream_terminate_thread(ABTI_xstream *p_local_xstream,
                                                  ABTI_thread *p_thread)
 {
     LOG_DEBUG("[U%" PRIu64 ":E%d] terminated\n", ABTI_thread_get_id(p_thread),
               p_thread->unit_def.p_last_xstream->rank);
+    if (gp_ABTI_global->stack_paint)
+        ABTI_thread_record_stack_usage(p_thread);
+    /* The callback must be called before the state is set to TERMINATED since
+     * a joiner may free p_thread right after that. */
+    if (p_thread->unit_def.p_completion)
+        ABTI_thread_run_completion_cb(p_thread);
     if (p_thread->unit_def.refcount == 0) {
 #ifndef ABT_CONFIG_DISABLE_STACKABLE_SCHED
         if (p_thread->p_sched) {
@@ -98,8 +118,7 @@ static inline void ABTI_xstream_terminate_thread(ABTI_xstream *p_local_xstream,
          * because the ULT can be freed on a different ES.  In other words, we
          * must not access any field of p_thead after changing the state to
          * TERMINATED. */
-        ABTD_atomic_release_store_int(&p_thread->unit_def.state,
-                                      ABTI_UNIT_STATE_TERMINATED);
+        ABTI_xstream_set_terminated(&p_thread->unit_def);
     }
 }
 
@@ -108,6 +127,8 @@ static inline void ABTI_xstream_terminate_task(ABTI_xstream *p_local_xstream,
 {
     LOG_DEBUG("[T%" PRIu64 ":E%d] terminated\n", ABTI_task_get_id(p_task),
               p_task->unit_def.p_last_xstream->rank);
+    if (p_task->unit_def.p_completion)
+        ABTI_task_run_completion_cb(p_task);
     if (p_task->unit_def.refcount == 0) {
         ABTD_atomic_release_store_int(&p_task->unit_def.state,
                                       ABTI_UNIT_STATE_TERMINATED);
@@ -117,8 +138,7 @@ static inline void ABTI_xstream_terminate_task(ABTI_xstream *p_local_xstream,
          * because the task can be freed on a different ES.  In other words, we
          * must not access any field of p_task after changing the state to
          * TERMINATED. */
-        ABTD_atomic_release_store_int(&p_task->unit_def.state,
-                                      ABTI_UNIT_STATE_TERMINATED);
+        ABTI_xstream_set_terminated(&p_task->unit_def);
     }
 }
 
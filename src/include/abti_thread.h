@@ -44,6 +44,45 @@ ABTI_thread_context_get_thread(ABTD_thread_context *p_ctx)
     return (ABTI_thread *)(((char *)p_ctx) - offsetof(ABTI_thread, ctx));
 }
 
+static inline ABT_bool ABTI_thread_is_stack_copy(ABTI_thread *p_thread)
+{
+#ifdef ABT_CONFIG_USE_FCONTEXT
+    return p_thread->stacktype == ABTI_STACK_TYPE_COPY ? ABT_TRUE : ABT_FALSE;
+#else
+    return ABT_FALSE;
+#endif
+}
+
+/* Whether the stack of p_thread has been painted by ABTI_thread_paint_stack()
+ * or not.  Only stacks of user ULTs that are not shared are painted. */
+static inline ABT_bool ABTI_thread_is_stack_painted(ABTI_thread *p_thread)
+{
+    if (!gp_ABTI_global->stack_paint ||
+        p_thread->unit_def.type != ABTI_UNIT_TYPE_THREAD_USER)
+        return ABT_FALSE;
+#ifndef ABT_CONFIG_DISABLE_STACKABLE_SCHED
+    if (p_thread->p_sched)
+        return ABT_FALSE;
+#endif
+    switch (p_thread->stacktype) {
+        case ABTI_STACK_TYPE_MEMPOOL:
+        case ABTI_STACK_TYPE_MALLOC:
+        case ABTI_STACK_TYPE_USER:
+            return p_thread->p_stack ? ABT_TRUE : ABT_FALSE;
+        default:
+            return ABT_FALSE;
+    }
+}
+
+#ifdef ABT_CONFIG_USE_FCONTEXT
+static inline ABTI_thread_stack_copy *
+ABTI_thread_get_stack_copy(ABTI_thread *p_thread)
+{
+    ABTI_ASSERT(p_thread->stacktype == ABTI_STACK_TYPE_COPY);
+    return (ABTI_thread_stack_copy *)(p_thread + 1);
+}
+#endif
+
 #if ABT_CONFIG_THREAD_TYPE == ABT_THREAD_TYPE_DYNAMIC_PROMOTION
 static inline ABT_bool ABTI_thread_is_dynamic_promoted(ABTI_thread *p_thread)
 {
@@ -144,6 +183,10 @@ static inline ABTI_thread *ABTI_thread_context_switch_to_sibling_internal(
     ABTI_xstream **pp_local_xstream, ABTI_thread *p_old, ABTI_thread *p_new,
     ABT_bool is_finish)
 {
+    /* A stack-copying ULT must be scheduled by its parent so that the shared
+     * stack is saved and restored. */
+    ABTI_ASSERT(!ABTI_thread_is_stack_copy(p_old) &&
+                !ABTI_thread_is_stack_copy(p_new));
 #if ABT_CONFIG_THREAD_TYPE == ABT_THREAD_TYPE_DYNAMIC_PROMOTION
     /* Dynamic promotion is unnecessary if p_old will be discarded. */
     if (!ABTI_thread_is_dynamic_promoted(p_old)) {
@@ -79,6 +79,11 @@ static inline void ABTI_thread_attr_init(ABTI_thread_attr *p_attr,
     p_attr->p_stack = p_stack;
     p_attr->stacksize = stacksize;
     p_attr->stacktype = stacktype;
+    p_attr->preserve_fpu = ABT_TRUE;
+    p_attr->work_first = ABT_FALSE;
+    p_attr->join_spin_nsec = ABTI_global_get_wait_spin_nsec();
+    p_attr->f_completion_cb = NULL;
+    p_attr->p_completion_cb_arg = NULL;
 #ifndef ABT_CONFIG_DISABLE_MIGRATION
     ABTI_thread_attr_init_migration(p_attr, migratable);
 #endif
@@ -12,10 +12,11 @@
 #include <lh_lock.h>
 #elif defined(HAVE_CLH_H)
 #include <clh.h>
-#else
-#define USE_PTHREAD_MUTEX
 #endif
 
+/* Max. # of pauses between two polls of the table lock */
+#define ABTI_THREAD_HTABLE_MAX_BACKOFF 64
+
 struct ABTI_thread_queue {
     ABTD_atomic_uint32 mutex; /* can be initialized by just assigning 0*/
     uint32_t num_handovers;
@@ -47,8 +48,6 @@ struct ABTI_thread_htable {
     lh_lock_t mutex;
 #elif defined(HAVE_CLH_H)
     clh_lock_t mutex;
-#elif defined(USE_PTHREAD_MUTEX)
-    pthread_mutex_t mutex;
 #else
     ABTI_spinlock mutex; /* To protect table */
 #endif
@@ -66,11 +65,12 @@ struct ABTI_thread_htable {
 #elif defined(HAVE_CLH_H)
 #define ABTI_THREAD_HTABLE_LOCK(m) clh_acquire(&m)
 #define ABTI_THREAD_HTABLE_UNLOCK(m) clh_release(&m)
-#elif defined(USE_PTHREAD_MUTEX)
-#define ABTI_THREAD_HTABLE_LOCK(m) pthread_mutex_lock(&m)
-#define ABTI_THREAD_HTABLE_UNLOCK(m) pthread_mutex_unlock(&m)
 #else
-#define ABTI_THREAD_HTABLE_LOCK(m) ABTI_spinlock_acquire(&m)
+/* The table lock is held only while a waiter is pushed or popped and is never
+ * held across a context switch, so contending ESs spin on it with exponential
+ * backoff instead of sleeping in the kernel. */
+#define ABTI_THREAD_HTABLE_LOCK(m)                                             \
+    ABTI_spinlock_acquire_backoff(&m, ABTI_THREAD_HTABLE_MAX_BACKOFF)
 #define ABTI_THREAD_HTABLE_UNLOCK(m) ABTI_spinlock_release(&m)
 #endif
 
@@ -78,7 +78,7 @@ static inline void ABTI_thread_queue_acquire_mutex(ABTI_thread_queue *p_queue)
 {
     while (!ABTD_atomic_bool_cas_weak_uint32(&p_queue->mutex, 0, 1)) {
         while (ABTD_atomic_acquire_load_uint32(&p_queue->mutex) != 0)
-            ;
+            ABTD_atomic_pause();
     }
 }
 
@@ -92,7 +92,7 @@ ABTI_thread_queue_acquire_low_mutex(ABTI_thread_queue *p_queue)
 {
     while (!ABTD_atomic_bool_cas_weak_uint32(&p_queue->low_mutex, 0, 1)) {
         while (ABTD_atomic_acquire_load_uint32(&p_queue->low_mutex) != 0)
-            ;
+            ABTD_atomic_pause();
     }
 }
 
@@ -32,10 +32,28 @@
          ? ABTU_alignof(long double)                                           \
          : ABTU_alignof(long long))
 
+/* Memory allocator.  If malloc_f is NULL, the libc allocator is used.  If
+ * alloc_largepage_f is NULL, large pages are allocated as requested by
+ * ABTU_alloc_largepage(). */
+typedef struct ABTU_allocator {
+    void *(*malloc_f)(size_t size, void *arg);
+    void *(*memalign_f)(size_t alignment, size_t size, void *arg);
+    void (*free_f)(void *ptr, void *arg);
+    void *(*alloc_largepage_f)(size_t size, size_t alignment_hint, void *arg);
+    void (*free_largepage_f)(void *ptr, size_t size, void *arg);
+    void *arg;
+} ABTU_allocator;
+
+extern ABTU_allocator g_ABTU_allocator;
+
 /* Utility Functions */
 
 static inline void *ABTU_memalign(size_t alignment, size_t size)
 {
+    if (ABTU_unlikely(g_ABTU_allocator.malloc_f)) {
+        return g_ABTU_allocator.memalign_f(alignment, size,
+                                           g_ABTU_allocator.arg);
+    }
     void *p_ptr;
     int ret = posix_memalign(&p_ptr, alignment, size);
     assert(ret == 0);
@@ -43,6 +61,10 @@ static inline void *ABTU_memalign(size_t alignment, size_t size)
 }
 static inline void ABTU_free(void *ptr)
 {
+    if (ABTU_unlikely(g_ABTU_allocator.malloc_f)) {
+        g_ABTU_allocator.free_f(ptr, g_ABTU_allocator.arg);
+        return;
+    }
     free(ptr);
 }
 
@@ -77,17 +99,29 @@ static inline void *ABTU_realloc(void *ptr, size_t old_size, size_t new_size)
 
 static inline void *ABTU_malloc(size_t size)
 {
+    if (ABTU_unlikely(g_ABTU_allocator.malloc_f))
+        return g_ABTU_allocator.malloc_f(size, g_ABTU_allocator.arg);
     return malloc(size);
 }
 
 static inline void *ABTU_calloc(size_t num, size_t size)
 {
+    if (ABTU_unlikely(g_ABTU_allocator.malloc_f)) {
+        void *ptr = ABTU_malloc(num * size);
+        memset(ptr, 0, num * size);
+        return ptr;
+    }
     return calloc(num, size);
 }
 
 static inline void *ABTU_realloc(void *ptr, size_t old_size, size_t new_size)
 {
-    (void)old_size;
+    if (ABTU_unlikely(g_ABTU_allocator.malloc_f)) {
+        void *new_ptr = ABTU_malloc(new_size);
+        memcpy(new_ptr, ptr, (old_size < new_size) ? old_size : new_size);
+        ABTU_free(ptr);
+        return new_ptr;
+    }
     return realloc(ptr, new_size);
 }
 
@@ -98,6 +132,7 @@ typedef enum ABTU_MEM_LARGEPAGE_TYPE {
     ABTU_MEM_LARGEPAGE_MEMALIGN, /* memalign() */
     ABTU_MEM_LARGEPAGE_MMAP,     /* normal private memory obtained by mmap() */
     ABTU_MEM_LARGEPAGE_MMAP_HUGEPAGE, /* hugepage obtained by mmap() */
+    ABTU_MEM_LARGEPAGE_USER, /* alloc_largepage_f of g_ABTU_allocator */
 } ABTU_MEM_LARGEPAGE_TYPE;
 
 /* Returns 1 if a given large page type is supported. */
@@ -100,6 +100,10 @@
  * - ABT_INFO_QUERY_KIND_ENABLED_TOOL
  *   \c val must be a pointer to a variable of the type ABT_bool.  ABT_TRUE is
  *   set to \c *val if the tool is enabled.  Otherwise, ABT_FALSE is set.
+ * - ABT_INFO_QUERY_KIND_ENABLED_STACK_PAINT
+ *   \c val must be a pointer to a variable of the type ABT_bool.  ABT_TRUE is
+ *   set to \c *val if ULT stacks are painted to measure their usage (see
+ *   \c ABT_STACK_PAINT).  Otherwise, ABT_FALSE is set.
  *
  * @param[in]  query_kind  query kind
  * @param[out] val         a pointer to a result
@@ -232,6 +236,9 @@ int ABT_info_query_config(ABT_info_query_kind query_kind, void *val)
             *((ABT_bool *)val) = ABT_FALSE;
 #endif
             break;
+        case ABT_INFO_QUERY_KIND_ENABLED_STACK_PAINT:
+            *((ABT_bool *)val) = gp_ABTI_global->stack_paint;
+            break;
         default:
             abt_errno = ABT_ERR_INV_QUERY_KIND;
             ABTI_CHECK_ERROR(abt_errno);
@@ -246,6 +253,167 @@ fn_fail:
     goto fn_exit;
 }
 
+/**
+ * @ingroup INFO
+ * @brief   Get statistics of the memory pools.
+ *
+ * \c ABT_info_query_mem_stats() writes statistics of the memory pools for ULT
+ * stacks and descriptors to \c stats.  If \c xstream is \c ABT_XSTREAM_NULL,
+ * the statistics of the whole runtime (i.e., global pools, local pools of all
+ * the ESs including those that have been freed, and memory allocated for
+ * external threads) are returned.  Otherwise, only the statistics of the local
+ * pools of \c xstream are returned.
+ *
+ * The counters are updated without atomic operations by each ES, so values
+ * that are being updated by other ESs might be slightly stale.  All the values
+ * are zero if the memory pool is disabled.
+ *
+ * @param[in]  xstream  handle to the target ES or \c ABT_XSTREAM_NULL
+ * @param[out] stats    memory pool statistics
+ * @return Error code
+ * @retval ABT_SUCCESS            on success
+ * @retval ABT_ERR_UNINITIALIZED  Argobots has not been initialized
+ */
+int ABT_info_query_mem_stats(ABT_xstream xstream, ABT_mem_stats *stats)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_CHECK_INITIALIZED();
+    ABTI_xstream *p_xstream = NULL;
+    if (xstream != ABT_XSTREAM_NULL) {
+        p_xstream = ABTI_xstream_get_ptr(xstream);
+        ABTI_CHECK_NULL_XSTREAM_PTR(p_xstream);
+    }
+
+    ABTI_mem_get_stats(p_xstream, stats);
+
+fn_exit:
+    return abt_errno;
+
+fn_fail:
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
+}
+
+/**
+ * @ingroup INFO
+ * @brief   Get the histogram of stack usage of ULTs in the pool.
+ *
+ * \c ABT_info_query_pool_stack_usage() writes the histogram of stack usage of
+ * ULTs that have terminated in \c pool to \c hist.  The stack usage of a ULT
+ * is recorded when it terminates if stack painting is enabled by
+ * \c ABT_STACK_PAINT.  ULTs whose stacks are not painted (e.g., schedulers and
+ * stack-copying ULTs) are not counted.
+ *
+ * @param[in]  pool  handle to the target pool
+ * @param[out] hist  histogram of stack usage
+ * @return Error code
+ * @retval ABT_SUCCESS            on success
+ * @retval ABT_ERR_FEATURE_NA     stack painting is disabled
+ * @retval ABT_ERR_UNINITIALIZED  Argobots has not been initialized
+ */
+int ABT_info_query_pool_stack_usage(ABT_pool pool, ABT_stack_usage_hist *hist)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_CHECK_INITIALIZED();
+    ABTI_pool *p_pool = ABTI_pool_get_ptr(pool);
+    ABTI_CHECK_NULL_POOL_PTR(p_pool);
+    if (!gp_ABTI_global->stack_paint) {
+        abt_errno = ABT_ERR_FEATURE_NA;
+        goto fn_fail;
+    }
+
+    ABTI_stack_usage_hist_get(&p_pool->stack_usage, hist);
+
+fn_exit:
+    return abt_errno;
+
+fn_fail:
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
+}
+
+/**
+ * @ingroup INFO
+ * @brief   Get the histogram of stack usage of ULTs created with the ULT
+ * attribute.
+ *
+ * \c ABT_info_query_thread_attr_stack_usage() writes the histogram of stack
+ * usage of terminated ULTs that have been created with \c attr to \c hist.
+ * ULTs are classified by their stack sizes and whether their stacks are given
+ * by the user or not, so ULT attributes that have the same stack settings
+ * share the same histogram.  If \c attr is \c ABT_THREAD_ATTR_NULL, the
+ * histogram of ULTs that have the default stack is returned.  See
+ * \c ABT_info_query_pool_stack_usage() for details.
+ *
+ * @param[in]  attr  handle to the ULT attribute or \c ABT_THREAD_ATTR_NULL
+ * @param[out] hist  histogram of stack usage
+ * @return Error code
+ * @retval ABT_SUCCESS            on success
+ * @retval ABT_ERR_FEATURE_NA     stack painting is disabled
+ * @retval ABT_ERR_UNINITIALIZED  Argobots has not been initialized
+ */
+int ABT_info_query_thread_attr_stack_usage(ABT_thread_attr attr,
+                                           ABT_stack_usage_hist *hist)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_CHECK_INITIALIZED();
+    ABTI_stack_type stacktype = ABTI_STACK_TYPE_MEMPOOL;
+    size_t stacksize = ABTI_global_get_thread_stacksize();
+    if (attr != ABT_THREAD_ATTR_NULL) {
+        ABTI_thread_attr *p_attr = ABTI_thread_attr_get_ptr(attr);
+        ABTI_CHECK_NULL_THREAD_ATTR_PTR(p_attr);
+        stacktype = p_attr->stacktype;
+        stacksize = p_attr->stacksize;
+    }
+    if (!gp_ABTI_global->stack_paint) {
+        abt_errno = ABT_ERR_FEATURE_NA;
+        goto fn_fail;
+    }
+
+    ABTI_stack_usage_hist *p_hist =
+        ABTI_stack_usage_get_hist(stacktype, stacksize, ABT_FALSE);
+    if (p_hist) {
+        ABTI_stack_usage_hist_get(p_hist, hist);
+    } else {
+        memset(hist, 0, sizeof(ABT_stack_usage_hist));
+    }
+
+fn_exit:
+    return abt_errno;
+
+fn_fail:
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
+}
+
+/**
+ * @ingroup INFO
+ * @brief   Write the stack usage of ULTs to the output stream.
+ *
+ * \c ABT_info_print_stack_usage() writes the histograms of stack usage of
+ * terminated ULTs, classified by their stack settings, to the given output
+ * stream \c fp.  See \c ABT_info_query_thread_attr_stack_usage() for details.
+ *
+ * @param[in] fp  output stream
+ * @return Error code
+ * @retval ABT_SUCCESS            on success
+ * @retval ABT_ERR_UNINITIALIZED  Argobots has not been initialized
+ */
+int ABT_info_print_stack_usage(FILE *fp)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_CHECK_INITIALIZED();
+
+    ABTI_stack_usage_print(fp);
+
+fn_exit:
+    return abt_errno;
+
+fn_fail:
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
+}
+
 /**
  * @ingroup INFO
  * @brief   Write the configuration information to the output stream.
@@ -830,8 +998,28 @@ int ABTI_info_print_config(FILE *fp)
             (unsigned)(p_global->thread_stacksize / 1024));
     fprintf(fp, " - scheduler stack size: %u KB\n",
             (unsigned)(p_global->sched_stacksize / 1024));
+#ifdef ABT_CONFIG_USE_FCONTEXT
+    fprintf(fp, " - shared stack size for stack-copying ULTs: %u KB\n",
+            (unsigned)(p_global->copy_stacksize / 1024));
+#endif
+    fprintf(fp, " - ULTs preserve FPU state by default: %s\n",
+            (p_global->thread_preserve_fpu == ABT_TRUE) ? "yes" : "no");
+    fprintf(fp, " - stack painting: %s\n",
+            (p_global->stack_paint == ABT_TRUE) ? "on" : "off");
     fprintf(fp, " - scheduler event check frequency: %u\n",
             p_global->sched_event_freq);
+    fprintf(fp, " - min. # of waiters of tree barriers: %u\n",
+            p_global->barrier_tree_threshold);
+    fprintf(fp, " - # of spins before ES barriers sleep: %u\n",
+            p_global->xstream_barrier_spins);
+    fprintf(fp, " - radix of ES barrier arrival trees: %u\n",
+            p_global->xstream_barrier_radix);
+    fprintf(fp, " - # of polls in the queued spin phase of mutexes: %u\n",
+            p_global->mutex_queued_spins);
+    fprintf(fp, " - # of spins before external threads sleep: %u\n",
+            p_global->ext_wait_spins);
+    fprintf(fp, " - max. spin window of waiting ULTs: %u nsec\n",
+            p_global->wait_spin_nsec);
 
     fprintf(fp, " - timer function: "
 #if defined(ABT_CONFIG_USE_CLOCK_GETTIME)
@@ -849,25 +1037,36 @@ int ABTI_info_print_config(FILE *fp)
             p_global->mem_page_size / 1024);
     fprintf(fp, " - stack page size: %u KB\n", p_global->mem_sp_size / 1024);
     fprintf(fp, " - max. # of stacks per ES: %u\n", p_global->mem_max_stacks);
-    switch (p_global->mem_lp_alloc) {
-        case ABTI_MEM_LP_MALLOC:
-            fprintf(fp, " - large page allocation: malloc\n");
-            break;
-        case ABTI_MEM_LP_MMAP_RP:
-            fprintf(fp, " - large page allocation: mmap regular pages\n");
-            break;
-        case ABTI_MEM_LP_MMAP_HP_RP:
-            fprintf(fp, " - large page allocation: mmap huge pages + "
-                        "regular pages\n");
-            break;
-        case ABTI_MEM_LP_MMAP_HP_THP:
-            fprintf(fp, " - large page allocation: mmap huge pages + THPs\n");
-            break;
-        case ABTI_MEM_LP_THP:
-            fprintf(fp, " - large page allocation: THPs\n");
-            break;
+    if (g_ABTU_allocator.alloc_largepage_f) {
+        fprintf(fp, " - large page allocation: user-defined allocator\n");
+    } else {
+        switch (p_global->mem_lp_alloc) {
+            case ABTI_MEM_LP_MALLOC:
+                fprintf(fp, " - large page allocation: malloc\n");
+                break;
+            case ABTI_MEM_LP_MMAP_RP:
+                fprintf(fp, " - large page allocation: mmap regular pages\n");
+                break;
+            case ABTI_MEM_LP_MMAP_HP_RP:
+                fprintf(fp, " - large page allocation: mmap huge pages + "
+                            "regular pages\n");
+                break;
+            case ABTI_MEM_LP_MMAP_HP_THP:
+                fprintf(fp,
+                        " - large page allocation: mmap huge pages + THPs\n");
+                break;
+            case ABTI_MEM_LP_THP:
+                fprintf(fp, " - large page allocation: THPs\n");
+                break;
+        }
     }
+    fprintf(fp, " - return remotely freed memory: %s\n",
+            (p_global->mem_remote_return == ABT_TRUE) ? "on" : "off");
+    fprintf(fp, " - no allocation after ABT_reserve(): %s\n",
+            (p_global->mem_no_alloc == ABT_TRUE) ? "on" : "off");
 #endif /* ABT_CONFIG_USE_MEM_POOL */
+    fprintf(fp, "Memory allocator: %s\n",
+            g_ABTU_allocator.malloc_f ? "user-defined" : "libc");
 
     fflush(fp);
 
@@ -4,7 +4,9 @@
 #
 
 abt_sources += \
+	mem/copy_stack.c \
 	mem/malloc.c \
 	mem/mem_pool.c \
+	mem/stack_usage.c \
 	mem/valgrind.c
 
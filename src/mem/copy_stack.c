@@ -0,0 +1,146 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include "abti.h"
+
+#ifdef ABT_CONFIG_USE_FCONTEXT
+
+/* Stack-copying ULTs run on a stack shared by ULTs of each ES.  When such a ULT
+ * is suspended, the used part of the shared stack is copied to a heap buffer
+ * that fits the actual usage, and it is copied back when the ULT is resumed.
+ * Since the saved stack contains pointers to itself, the ULT must be resumed at
+ * the same address, so it keeps using the shared stack on which it has started
+ * even after it is scheduled by another ES.  If the shared stack is occupied by
+ * another ULT, the scheduler pushes the ULT back to its pool.
+ *
+ * Shared stacks are never freed until ABT_finalize() since suspended ULTs may
+ * still refer to them.  Stacks of freed ESs are reused by new ESs. */
+
+static ABTI_copy_stack *copy_stack_get(ABTI_xstream *p_local_xstream);
+
+void ABTI_copy_stack_init(ABTI_global *p_global)
+{
+    ABTI_spinlock_clear(&p_global->copy_stacks_lock);
+    p_global->p_copy_stacks = NULL;
+}
+
+void ABTI_copy_stack_finalize(ABTI_global *p_global)
+{
+    ABTI_copy_stack *p_copy_stack = p_global->p_copy_stacks;
+    while (p_copy_stack) {
+        ABTI_copy_stack *p_next = p_copy_stack->p_next;
+        ABTI_ASSERT(!ABTD_atomic_relaxed_load_ptr(&p_copy_stack->p_occupant));
+        ABTU_free(p_copy_stack->p_stack);
+        ABTU_free(p_copy_stack);
+        p_copy_stack = p_next;
+    }
+    p_global->p_copy_stacks = NULL;
+}
+
+void ABTI_copy_stack_detach(ABTI_xstream *p_xstream)
+{
+    ABTI_copy_stack *p_copy_stack = p_xstream->p_copy_stack;
+    if (p_copy_stack) {
+        ABTI_spinlock_acquire(&gp_ABTI_global->copy_stacks_lock);
+        p_copy_stack->p_xstream = NULL;
+        ABTI_spinlock_release(&gp_ABTI_global->copy_stacks_lock);
+        p_xstream->p_copy_stack = NULL;
+    }
+}
+
+/* Returns ABT_FALSE if p_thread cannot run now because its shared stack is
+ * used by another ULT.  Otherwise, the context of p_thread is made runnable. */
+ABT_bool ABTI_copy_stack_acquire(ABTI_xstream *p_local_xstream,
+                                 ABTI_thread *p_thread)
+{
+    ABTI_thread_stack_copy *p_copy = ABTI_thread_get_stack_copy(p_thread);
+    ABTI_copy_stack *p_copy_stack = p_copy->p_copy_stack;
+    if (!p_copy_stack) {
+        /* The first execution.  Bind the shared stack of this ES. */
+        p_copy_stack = copy_stack_get(p_local_xstream);
+        p_copy->p_copy_stack = p_copy_stack;
+        p_thread->p_stack = p_copy_stack->p_stack;
+        p_thread->stacksize = p_copy_stack->stacksize;
+    }
+    if (!ABTD_atomic_bool_cas_strong_ptr(&p_copy_stack->p_occupant, NULL,
+                                         (void *)p_thread)) {
+        return ABT_FALSE;
+    }
+    if (!p_copy->is_started) {
+        ABTD_thread_context_arm_thread(p_thread->stacksize, p_thread->p_stack,
+                                       &p_thread->ctx);
+        p_copy->is_started = ABT_TRUE;
+    } else {
+        /* Restore the saved part of the stack. */
+        char *p_stacktop = ((char *)p_thread->p_stack) + p_thread->stacksize;
+        memcpy(p_stacktop - p_copy->used, p_copy->p_buf, p_copy->used);
+    }
+    return ABT_TRUE;
+}
+
+/* Releases the shared stack after p_thread has been suspended.  The used part
+ * of the stack is saved unless p_thread has finished. */
+void ABTI_copy_stack_release(ABTI_thread *p_thread, ABT_bool is_finished)
+{
+    ABTI_thread_stack_copy *p_copy = ABTI_thread_get_stack_copy(p_thread);
+    ABTI_copy_stack *p_copy_stack = p_copy->p_copy_stack;
+    ABTI_ASSERT(ABTD_atomic_relaxed_load_ptr(&p_copy_stack->p_occupant) ==
+                (void *)p_thread);
+    if (!is_finished) {
+        char *p_stacktop = ((char *)p_thread->p_stack) + p_thread->stacksize;
+        char *p_sp =
+            (char *)ABTD_thread_context_get_stack_pointer(&p_thread->ctx);
+        ABTI_ASSERT((char *)p_thread->p_stack <= p_sp && p_sp <= p_stacktop);
+        size_t used = p_stacktop - p_sp;
+        /* Reallocate the buffer if it is too small or much larger than
+         * necessary. */
+        if (used > p_copy->capacity || used < p_copy->capacity / 4) {
+            size_t capacity = (used + ABT_CONFIG_STATIC_CACHELINE_SIZE - 1) &
+                              (~(ABT_CONFIG_STATIC_CACHELINE_SIZE - 1));
+            if (p_copy->p_buf)
+                ABTU_free(p_copy->p_buf);
+            p_copy->p_buf = capacity ? ABTU_malloc(capacity) : NULL;
+            p_copy->capacity = capacity;
+        }
+        memcpy(p_copy->p_buf, p_sp, used);
+        p_copy->used = used;
+    }
+    ABTD_atomic_release_store_ptr(&p_copy_stack->p_occupant, NULL);
+}
+
+/*****************************************************************************/
+/* Internal static functions                                                 */
+/*****************************************************************************/
+
+static ABTI_copy_stack *copy_stack_get(ABTI_xstream *p_local_xstream)
+{
+    ABTI_copy_stack *p_copy_stack = p_local_xstream->p_copy_stack;
+    if (p_copy_stack)
+        return p_copy_stack;
+
+    /* Reuse a shared stack that is not used by any ES if any. */
+    ABTI_global *p_global = gp_ABTI_global;
+    ABTI_spinlock_acquire(&p_global->copy_stacks_lock);
+    for (p_copy_stack = p_global->p_copy_stacks; p_copy_stack;
+         p_copy_stack = p_copy_stack->p_next) {
+        if (!p_copy_stack->p_xstream)
+            break;
+    }
+    if (!p_copy_stack) {
+        size_t stacksize = p_global->copy_stacksize;
+        p_copy_stack = (ABTI_copy_stack *)ABTU_malloc(sizeof(ABTI_copy_stack));
+        p_copy_stack->p_stack = ABTU_malloc(stacksize);
+        p_copy_stack->stacksize = stacksize;
+        ABTD_atomic_relaxed_store_ptr(&p_copy_stack->p_occupant, NULL);
+        p_copy_stack->p_next = p_global->p_copy_stacks;
+        p_global->p_copy_stacks = p_copy_stack;
+    }
+    p_copy_stack->p_xstream = p_local_xstream;
+    ABTI_spinlock_release(&p_global->copy_stacks_lock);
+    p_local_xstream->p_copy_stack = p_copy_stack;
+    return p_copy_stack;
+}
+
+#endif /* ABT_CONFIG_USE_FCONTEXT */
@@ -6,6 +6,18 @@
 #include "abti.h"
 
 #ifdef ABT_CONFIG_USE_MEM_POOL
+#ifndef ABT_CONFIG_DISABLE_EXT_THREAD
+ABTD_XSTREAM_LOCAL ABTI_mem_ext_pool *lp_ABTI_mem_ext_pool = NULL;
+ABTD_XSTREAM_LOCAL uint64_t lp_ABTI_mem_ext_pool_gen = 0;
+/* Incremented by every ABT_init() so that external threads do not use local
+ * pools that the previous ABT_finalize() has freed. */
+static uint64_t g_mem_ext_pool_gen = 0;
+
+static void mem_destroy_ext_pool(ABTI_global *p_global,
+                                 ABTI_mem_ext_pool *p_ext_pool);
+static void mem_ext_pool_destructor(void *arg);
+#endif
+
 /* Currently the total memory allocated for stacks and task block pages is not
  * shrunk to avoid the thrashing overhead except that ESs are terminated or
  * ABT_finalize is called.  When an ES terminates its execution, stacks and
@@ -47,9 +59,11 @@ void ABTI_mem_init(ABTI_global *p_global)
     size_t thread_stacksize = p_global->thread_stacksize;
     ABTI_ASSERT((thread_stacksize & (ABT_CONFIG_STATIC_CACHELINE_SIZE - 1)) ==
                 0);
-    size_t stacksize = (thread_stacksize + sizeof(ABTI_thread) +
-                        ABT_CONFIG_STATIC_CACHELINE_SIZE - 1) &
-                       (~(ABT_CONFIG_STATIC_CACHELINE_SIZE - 1));
+    /* ABTI_thread is followed by the owner ID of the stack. */
+    size_t stacksize =
+        (thread_stacksize + sizeof(ABTI_thread) + sizeof(uint32_t) +
+         ABT_CONFIG_STATIC_CACHELINE_SIZE - 1) &
+        (~(ABT_CONFIG_STATIC_CACHELINE_SIZE - 1));
     if ((stacksize & (2 * ABT_CONFIG_STATIC_CACHELINE_SIZE - 1)) == 0) {
         /* Avoid a multiple of 2 * cacheline size to avoid cache bank conflict.
          */
@@ -59,42 +73,53 @@ void ABTI_mem_init(ABTI_global *p_global)
                                    p_global->mem_max_stacks /
                                        ABT_MEM_POOL_MAX_LOCAL_BUCKETS,
                                    stacksize, thread_stacksize,
-                                   p_global->mem_sp_size, requested_types,
-                                   num_requested_types,
-                                   gp_ABTI_global->mem_page_size);
-    /* The last four bytes will be used to store a mempool flag */
+                                   sizeof(ABTI_thread), p_global->mem_sp_size,
+                                   requested_types, num_requested_types,
+                                   gp_ABTI_global->mem_page_size,
+                                   p_global->max_xstreams,
+                                   p_global->mem_remote_return);
+    /* Synchronization objects use malloc() until ABT_reserve() is called. */
+    p_global->mem_sync_in_pool = ABT_FALSE;
+    /* The last four bytes will be used to store the owner ID. */
     ABTI_STATIC_ASSERT(((ABTI_MEM_POOL_DESC_SIZE + 4) &
                         (ABT_CONFIG_STATIC_CACHELINE_SIZE - 1)) == 0);
     ABTI_mem_pool_init_global_pool(&p_global->mem_pool_desc,
                                    p_global->mem_max_descs /
                                        ABT_MEM_POOL_MAX_LOCAL_BUCKETS,
                                    ABTI_MEM_POOL_DESC_SIZE + 4, 0,
+                                   ABTI_MEM_POOL_DESC_SIZE,
                                    p_global->mem_page_size, requested_types,
                                    num_requested_types,
-                                   gp_ABTI_global->mem_page_size);
+                                   gp_ABTI_global->mem_page_size,
+                                   p_global->max_xstreams,
+                                   p_global->mem_remote_return);
 #ifndef ABT_CONFIG_DISABLE_EXT_THREAD
-    ABTI_spinlock_clear(&p_global->mem_pool_stack_lock);
-    ABTI_mem_pool_init_local_pool(&p_global->mem_pool_stack_ext,
-                                  &p_global->mem_pool_stack);
-    ABTI_spinlock_clear(&p_global->mem_pool_desc_lock);
-    ABTI_mem_pool_init_local_pool(&p_global->mem_pool_desc_ext,
-                                  &p_global->mem_pool_desc);
+    p_global->mem_ext_pool_gen = ++g_mem_ext_pool_gen;
+    int ret = pthread_key_create(&p_global->mem_ext_pool_key,
+                                 mem_ext_pool_destructor);
+    ABTI_ASSERT(ret == 0);
+    ABTI_spinlock_clear(&p_global->mem_ext_pools_lock);
+    p_global->p_mem_ext_pools = NULL;
 #endif
 }
 
 void ABTI_mem_init_local(ABTI_xstream *p_local_xstream)
 {
     ABTI_mem_pool_init_local_pool(&p_local_xstream->mem_pool_stack,
-                                  &gp_ABTI_global->mem_pool_stack);
+                                  &gp_ABTI_global->mem_pool_stack, ABT_TRUE);
     ABTI_mem_pool_init_local_pool(&p_local_xstream->mem_pool_desc,
-                                  &gp_ABTI_global->mem_pool_desc);
+                                  &gp_ABTI_global->mem_pool_desc, ABT_TRUE);
 }
 
 void ABTI_mem_finalize(ABTI_global *p_global)
 {
 #ifndef ABT_CONFIG_DISABLE_EXT_THREAD
-    ABTI_mem_pool_destroy_local_pool(&p_global->mem_pool_stack_ext);
-    ABTI_mem_pool_destroy_local_pool(&p_global->mem_pool_desc_ext);
+    /* Local pools of external threads that are still alive are destroyed
+     * here. */
+    pthread_key_delete(p_global->mem_ext_pool_key);
+    while (p_global->p_mem_ext_pools) {
+        mem_destroy_ext_pool(p_global, p_global->p_mem_ext_pools);
+    }
 #endif
     ABTI_mem_pool_destroy_global_pool(&p_global->mem_pool_stack);
     ABTI_mem_pool_destroy_global_pool(&p_global->mem_pool_desc);
@@ -102,8 +127,131 @@ void ABTI_mem_finalize(ABTI_global *p_global)
 
 void ABTI_mem_finalize_local(ABTI_xstream *p_local_xstream)
 {
+    /* xstreams_lock is taken so that ABTI_mem_get_stats() does not count the
+     * statistics of these local pools twice. */
+    ABTI_spinlock_acquire(&gp_ABTI_global->xstreams_lock);
     ABTI_mem_pool_destroy_local_pool(&p_local_xstream->mem_pool_stack);
     ABTI_mem_pool_destroy_local_pool(&p_local_xstream->mem_pool_desc);
+    ABTI_spinlock_release(&gp_ABTI_global->xstreams_lock);
+}
+
+#ifndef ABT_CONFIG_DISABLE_EXT_THREAD
+ABTI_mem_ext_pool *ABTI_mem_create_ext_pool(void)
+{
+    ABTI_global *p_global = gp_ABTI_global;
+    ABTI_mem_ext_pool *p_ext_pool =
+        (ABTI_mem_ext_pool *)ABTU_malloc(sizeof(ABTI_mem_ext_pool));
+    /* External threads do not own stacks and descriptors. */
+    ABTI_mem_pool_init_local_pool(&p_ext_pool->mem_pool_stack,
+                                  &p_global->mem_pool_stack, ABT_FALSE);
+    ABTI_mem_pool_init_local_pool(&p_ext_pool->mem_pool_desc,
+                                  &p_global->mem_pool_desc, ABT_FALSE);
+
+    ABTI_spinlock_acquire(&p_global->mem_ext_pools_lock);
+    p_ext_pool->p_prev = NULL;
+    p_ext_pool->p_next = p_global->p_mem_ext_pools;
+    if (p_global->p_mem_ext_pools)
+        p_global->p_mem_ext_pools->p_prev = p_ext_pool;
+    p_global->p_mem_ext_pools = p_ext_pool;
+    ABTI_spinlock_release(&p_global->mem_ext_pools_lock);
+
+    /* If the destructor cannot be registered, this local pool is destroyed by
+     * ABT_finalize(). */
+    pthread_setspecific(p_global->mem_ext_pool_key, (void *)p_ext_pool);
+    lp_ABTI_mem_ext_pool = p_ext_pool;
+    lp_ABTI_mem_ext_pool_gen = p_global->mem_ext_pool_gen;
+    return p_ext_pool;
+}
+
+/* The caller must not hold mem_ext_pools_lock. */
+static void mem_destroy_ext_pool(ABTI_global *p_global,
+                                 ABTI_mem_ext_pool *p_ext_pool)
+{
+    /* mem_ext_pools_lock is taken so that ABTI_mem_get_stats() does not count
+     * the statistics of these local pools twice. */
+    ABTI_spinlock_acquire(&p_global->mem_ext_pools_lock);
+    if (p_ext_pool->p_prev) {
+        p_ext_pool->p_prev->p_next = p_ext_pool->p_next;
+    } else {
+        p_global->p_mem_ext_pools = p_ext_pool->p_next;
+    }
+    if (p_ext_pool->p_next)
+        p_ext_pool->p_next->p_prev = p_ext_pool->p_prev;
+    ABTI_mem_pool_destroy_local_pool(&p_ext_pool->mem_pool_stack);
+    ABTI_mem_pool_destroy_local_pool(&p_ext_pool->mem_pool_desc);
+    ABTI_spinlock_release(&p_global->mem_ext_pools_lock);
+    ABTU_free(p_ext_pool);
+}
+
+/* Called when an external thread that has local pools exits. */
+static void mem_ext_pool_destructor(void *arg)
+{
+    ABTI_mem_ext_pool *p_ext_pool = (ABTI_mem_ext_pool *)arg;
+    ABTI_global *p_global = gp_ABTI_global;
+    lp_ABTI_mem_ext_pool = NULL;
+    lp_ABTI_mem_ext_pool_gen = 0;
+    if (p_global)
+        mem_destroy_ext_pool(p_global, p_ext_pool);
+}
+#endif
+
+int ABTI_mem_reserve(ABTI_global *p_global, size_t num_stacks,
+                     size_t num_descs)
+{
+    ABTI_mem_pool_reserve(&p_global->mem_pool_stack, num_stacks,
+                          p_global->mem_no_alloc);
+    ABTI_mem_pool_reserve(&p_global->mem_pool_desc, num_descs,
+                          p_global->mem_no_alloc);
+    p_global->mem_sync_in_pool = ABT_TRUE;
+    return ABT_SUCCESS;
+}
+
+static void mem_add_local_counters(ABTI_mem_pool_local_pool *p_local_pool,
+                                   ABT_mem_pool_stats *p_stats)
+{
+    ABT_mem_pool_stats local_stats;
+    memset(&local_stats, 0, sizeof(ABT_mem_pool_stats));
+    ABTI_mem_pool_add_local_stats(p_local_pool, &local_stats);
+    p_stats->num_local_hits += local_stats.num_local_hits;
+    p_stats->num_local_misses += local_stats.num_local_misses;
+    p_stats->num_remote_frees += local_stats.num_remote_frees;
+}
+
+void ABTI_mem_get_stats(ABTI_xstream *p_xstream, ABT_mem_stats *p_stats)
+{
+    if (p_xstream) {
+        memset(p_stats, 0, sizeof(ABT_mem_stats));
+        ABTI_mem_pool_add_local_stats(&p_xstream->mem_pool_stack,
+                                      &p_stats->stack);
+        ABTI_mem_pool_add_local_stats(&p_xstream->mem_pool_desc,
+                                      &p_stats->desc);
+        return;
+    }
+
+    ABTI_global *p_global = gp_ABTI_global;
+    ABTI_mem_pool_get_global_stats(&p_global->mem_pool_stack, &p_stats->stack);
+    ABTI_mem_pool_get_global_stats(&p_global->mem_pool_desc, &p_stats->desc);
+    /* Local pools hold the remaining counters. */
+    ABTI_spinlock_acquire(&p_global->xstreams_lock);
+    int i;
+    for (i = 0; i < p_global->max_xstreams; i++) {
+        ABTI_xstream *p_cur = p_global->p_xstreams[i];
+        if (!p_cur)
+            continue;
+        mem_add_local_counters(&p_cur->mem_pool_stack, &p_stats->stack);
+        mem_add_local_counters(&p_cur->mem_pool_desc, &p_stats->desc);
+    }
+    ABTI_spinlock_release(&p_global->xstreams_lock);
+#ifndef ABT_CONFIG_DISABLE_EXT_THREAD
+    ABTI_spinlock_acquire(&p_global->mem_ext_pools_lock);
+    ABTI_mem_ext_pool *p_ext_pool = p_global->p_mem_ext_pools;
+    while (p_ext_pool) {
+        mem_add_local_counters(&p_ext_pool->mem_pool_stack, &p_stats->stack);
+        mem_add_local_counters(&p_ext_pool->mem_pool_desc, &p_stats->desc);
+        p_ext_pool = p_ext_pool->p_next;
+    }
+    ABTI_spinlock_release(&p_global->mem_ext_pools_lock);
+#endif
 }
 
 int ABTI_mem_check_lp_alloc(int lp_alloc)
@@ -173,4 +321,16 @@ void ABTI_mem_finalize_local(ABTI_xstream *p_local_xstream)
 {
 }
 
+void ABTI_mem_get_stats(ABTI_xstream *p_xstream, ABT_mem_stats *p_stats)
+{
+    memset(p_stats, 0, sizeof(ABT_mem_stats));
+}
+
+int ABTI_mem_reserve(ABTI_global *p_global, size_t num_stacks,
+                     size_t num_descs)
+{
+    /* Nothing can be reserved without the memory pool. */
+    return ABT_ERR_FEATURE_NA;
+}
+
 #endif /* !ABT_CONFIG_USE_MEM_POOL */
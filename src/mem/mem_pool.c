@@ -6,6 +6,10 @@
 #include "abti.h"
 #include <stddef.h>
 
+static ABTI_mem_pool_header *
+mem_pool_take_bucket(ABTI_mem_pool_global_pool *p_global_pool,
+                     ABT_bool allow_alloc);
+
 static inline ABTI_mem_pool_page *
 ABTI_mem_pool_lifo_elem_to_page(ABTI_sync_lifo_element *lifo_elem)
 {
@@ -25,14 +29,19 @@ ABTI_mem_pool_lifo_elem_to_header(ABTI_sync_lifo_element *lifo_elem)
 
 void ABTI_mem_pool_init_global_pool(
     ABTI_mem_pool_global_pool *p_global_pool, int num_headers_per_bucket,
-    size_t header_size, size_t header_offset, size_t page_size,
-    const ABTU_MEM_LARGEPAGE_TYPE *lp_type_requests, int num_lp_type_requests,
-    size_t alignment_hint)
+    size_t header_size, size_t header_offset, size_t owner_offset,
+    size_t page_size, const ABTU_MEM_LARGEPAGE_TYPE *lp_type_requests,
+    int num_lp_type_requests, size_t alignment_hint, uint32_t num_owners,
+    ABT_bool remote_return)
 {
     p_global_pool->num_headers_per_bucket = num_headers_per_bucket;
     ABTI_ASSERT(header_offset + sizeof(ABTI_mem_pool_header) <= header_size);
+    ABTI_ASSERT(owner_offset >= sizeof(ABTI_mem_pool_header) &&
+                header_offset + owner_offset + sizeof(uint32_t) <=
+                    header_size);
     p_global_pool->header_size = header_size;
     p_global_pool->header_offset = header_offset;
+    p_global_pool->owner_offset = owner_offset;
     p_global_pool->page_size = page_size;
 
     /* Note that lp_type_requests is a constant-sized array */
@@ -49,6 +58,37 @@ void ABTI_mem_pool_init_global_pool(
     ABTI_sync_lifo_init(&p_global_pool->bucket_lifo);
     ABTI_spinlock_clear(&p_global_pool->partial_bucket_lock);
     p_global_pool->partial_bucket = NULL;
+
+    size_t i;
+    for (i = 0; i < sizeof(p_global_pool->num_pages) /
+                        sizeof(p_global_pool->num_pages[0]);
+         i++) {
+        ABTD_atomic_relaxed_store_uint64(&p_global_pool->num_pages[i], 0);
+    }
+    ABTD_atomic_relaxed_store_uint64(&p_global_pool->num_taken_buckets, 0);
+    ABTD_atomic_relaxed_store_uint64(&p_global_pool->num_returned_buckets, 0);
+    ABTD_atomic_relaxed_store_uint64(&p_global_pool->num_malloc_fallbacks, 0);
+    ABTD_atomic_relaxed_store_uint64(&p_global_pool->num_reserved, 0);
+    ABTD_atomic_relaxed_store_uint64(&p_global_pool->num_alloc_failures, 0);
+    ABTD_atomic_relaxed_store_uint64(&p_global_pool->num_retired_allocs, 0);
+    ABTD_atomic_relaxed_store_uint64(&p_global_pool->num_retired_misses, 0);
+    ABTD_atomic_relaxed_store_uint64(&p_global_pool->num_retired_remote_frees,
+                                     0);
+
+    /* Each owner ID has a return queue even if the remote return is disabled
+     * since the owner ID is also used for statistics. */
+    p_global_pool->remote_return = remote_return;
+    ABTD_atomic_relaxed_store_int(&p_global_pool->no_alloc, 0);
+    p_global_pool->num_return_queues = num_owners;
+    p_global_pool->return_queues = (ABTI_mem_pool_return_queue *)
+        ABTU_memalign(ABT_CONFIG_STATIC_CACHELINE_SIZE,
+                      sizeof(ABTI_mem_pool_return_queue) * num_owners);
+    for (i = 0; i < num_owners; i++) {
+        ABTD_atomic_relaxed_store_ptr(&p_global_pool->return_queues[i].p_head,
+                                      NULL);
+        ABTD_atomic_relaxed_store_int(&p_global_pool->return_queues[i].in_use,
+                                      0);
+    }
 }
 
 void ABTI_mem_pool_destroy_global_pool(ABTI_mem_pool_global_pool *p_global_pool)
@@ -72,22 +112,77 @@ void ABTI_mem_pool_destroy_global_pool(ABTI_mem_pool_global_pool *p_global_pool)
     }
     ABTI_sync_lifo_destroy(&p_global_pool->bucket_lifo);
     ABTI_sync_lifo_destroy(&p_global_pool->mem_page_lifo);
+    /* Headers in the return queues are also from memory pages. */
+    ABTU_free(p_global_pool->return_queues);
 }
 
 void ABTI_mem_pool_init_local_pool(ABTI_mem_pool_local_pool *p_local_pool,
-                                   ABTI_mem_pool_global_pool *p_global_pool)
+                                   ABTI_mem_pool_global_pool *p_global_pool,
+                                   ABT_bool is_owner)
 {
     p_local_pool->p_global_pool = p_global_pool;
     p_local_pool->num_headers_per_bucket =
         p_global_pool->num_headers_per_bucket;
+    p_local_pool->owner_offset = p_global_pool->owner_offset;
+    p_local_pool->owner = ABTI_MEM_POOL_OWNER_NONE;
+    p_local_pool->p_return_queue = NULL;
+    if (is_owner) {
+        /* Find an unused owner ID.  If all the IDs are used, this local pool
+         * does not own headers; headers freed by this pool are not returned to
+         * their owners. */
+        uint32_t i;
+        for (i = 0; i < p_global_pool->num_return_queues; i++) {
+            ABTI_mem_pool_return_queue *p_return_queue =
+                &p_global_pool->return_queues[i];
+            if (ABTD_atomic_relaxed_load_int(&p_return_queue->in_use) == 0 &&
+                ABTD_atomic_bool_cas_strong_int(&p_return_queue->in_use, 0,
+                                                1)) {
+                p_local_pool->owner = i;
+                if (p_global_pool->remote_return)
+                    p_local_pool->p_return_queue = p_return_queue;
+                break;
+            }
+        }
+    }
     /* There must be always at least one header in the local pool.
      * Let's take one bucket. */
-    p_local_pool->buckets[0] = ABTI_mem_pool_take_bucket(p_global_pool);
+    p_local_pool->buckets[0] = mem_pool_take_bucket(p_global_pool, ABT_TRUE);
     p_local_pool->bucket_index = 0;
+    p_local_pool->num_allocs = 0;
+    p_local_pool->num_frees = 0;
+    p_local_pool->num_misses = 0;
+    p_local_pool->num_returns = 0;
+    p_local_pool->num_remote_frees = 0;
 }
 
 void ABTI_mem_pool_destroy_local_pool(ABTI_mem_pool_local_pool *p_local_pool)
 {
+    if (p_local_pool->p_return_queue) {
+        /* Take back the returned headers so that they are not left behind. */
+        if (ABTD_atomic_acquire_load_ptr(&p_local_pool->p_return_queue->p_head))
+            ABTI_mem_pool_take_returned(p_local_pool);
+    }
+    if (p_local_pool->owner != ABTI_MEM_POOL_OWNER_NONE) {
+        /* Release the owner ID.  Headers that are still owned by this ID will
+         * be returned to the next owner of this ID. */
+        ABTD_atomic_release_store_int(&p_local_pool->p_global_pool
+                                           ->return_queues[p_local_pool->owner]
+                                           .in_use,
+                                      0);
+    }
+    /* Keep the statistics of this local pool. */
+    ABTD_atomic_fetch_add_uint64(&p_local_pool->p_global_pool
+                                      ->num_retired_allocs,
+                                 p_local_pool->num_allocs);
+    ABTD_atomic_fetch_add_uint64(&p_local_pool->p_global_pool
+                                      ->num_retired_misses,
+                                 p_local_pool->num_misses);
+    ABTD_atomic_fetch_add_uint64(&p_local_pool->p_global_pool
+                                      ->num_retired_remote_frees,
+                                 p_local_pool->num_remote_frees);
+    p_local_pool->num_allocs = 0;
+    p_local_pool->num_misses = 0;
+    p_local_pool->num_remote_frees = 0;
     /* Return the remaining buckets to the global pool. */
     int bucket_index = p_local_pool->bucket_index;
     int i;
@@ -153,6 +248,18 @@ void ABTI_mem_pool_destroy_local_pool(ABTI_mem_pool_local_pool *p_local_pool)
 
 ABTI_mem_pool_header *
 ABTI_mem_pool_take_bucket(ABTI_mem_pool_global_pool *p_global_pool)
+{
+    ABT_bool allow_alloc =
+        ABTD_atomic_relaxed_load_int(&p_global_pool->no_alloc) ? ABT_FALSE
+                                                               : ABT_TRUE;
+    return mem_pool_take_bucket(p_global_pool, allow_alloc);
+}
+
+/* If allow_alloc is ABT_FALSE, this function returns NULL instead of creating
+ * a bucket from pages. */
+static ABTI_mem_pool_header *
+mem_pool_take_bucket(ABTI_mem_pool_global_pool *p_global_pool,
+                     ABT_bool allow_alloc)
 {
     /* Try to get a bucket. */
     ABTI_sync_lifo_element *p_popped_bucket_lifo_elem =
@@ -163,7 +270,10 @@ ABTI_mem_pool_take_bucket(ABTI_mem_pool_global_pool *p_global_pool)
         ABTI_mem_pool_header *popped_bucket =
             ABTI_mem_pool_lifo_elem_to_header(p_popped_bucket_lifo_elem);
         popped_bucket->bucket_info.num_headers = num_headers_per_bucket;
+        ABTD_atomic_fetch_add_uint64(&p_global_pool->num_taken_buckets, 1);
         return popped_bucket;
+    } else if (!allow_alloc) {
+        return NULL;
     } else {
         /* Allocate headers by myself */
         const size_t header_size = p_global_pool->header_size;
@@ -189,6 +299,8 @@ ABTI_mem_pool_take_bucket(ABTI_mem_pool_global_pool *p_global_pool)
                                          p_global_pool->num_lp_type_requests,
                                          &lp_type);
                 ABTI_ASSERT(p_alloc_mem);
+                ABTD_atomic_fetch_add_uint64(&p_global_pool->num_pages[lp_type],
+                                             1);
                 p_page =
                     (ABTI_mem_pool_page *)(((char *)p_alloc_mem) + page_size -
                                            sizeof(ABTI_mem_pool_page));
@@ -248,6 +360,8 @@ ABTI_mem_pool_take_bucket(ABTI_mem_pool_global_pool *p_global_pool)
             num_headers += num_provided;
             if (num_headers == num_headers_per_bucket) {
                 p_head->bucket_info.num_headers = num_headers_per_bucket;
+                ABTD_atomic_fetch_add_uint64(&p_global_pool->num_taken_buckets,
+                                             1);
                 return p_head;
             }
         }
@@ -260,4 +374,128 @@ void ABTI_mem_pool_return_bucket(ABTI_mem_pool_global_pool *p_global_pool,
     /* Simply return that bucket to the pool */
     ABTI_sync_lifo_push(&p_global_pool->bucket_lifo,
                         &bucket->bucket_info.lifo_elem);
+    ABTD_atomic_fetch_add_uint64(&p_global_pool->num_returned_buckets, 1);
+}
+
+void ABTI_mem_pool_reserve(ABTI_mem_pool_global_pool *p_global_pool,
+                           size_t num_headers, ABT_bool no_alloc)
+{
+    const size_t num_headers_per_bucket = p_global_pool->num_headers_per_bucket;
+    size_t num_buckets =
+        (num_headers + num_headers_per_bucket - 1) / num_headers_per_bucket;
+    size_t i;
+    /* Take buckets at once so that the global pool creates buckets from pages
+     * if it does not have enough buckets.  Then, return all of them. */
+    ABTI_mem_pool_header **buckets = (ABTI_mem_pool_header **)ABTU_malloc(
+        sizeof(ABTI_mem_pool_header *) * num_buckets);
+    for (i = 0; i < num_buckets; i++) {
+        buckets[i] = mem_pool_take_bucket(p_global_pool, ABT_TRUE);
+    }
+    for (i = 0; i < num_buckets; i++) {
+        ABTI_mem_pool_return_bucket(p_global_pool, buckets[i]);
+    }
+    ABTU_free(buckets);
+    ABTD_atomic_fetch_add_uint64(&p_global_pool->num_reserved,
+                                 num_buckets * num_headers_per_bucket);
+    if (no_alloc)
+        ABTD_atomic_relaxed_store_int(&p_global_pool->no_alloc, 1);
+}
+
+ABT_bool ABTI_mem_pool_free_remote(ABTI_mem_pool_local_pool *p_local_pool,
+                                   void *mem, uint32_t owner)
+{
+    ABTI_mem_pool_global_pool *p_global_pool = p_local_pool->p_global_pool;
+    p_local_pool->num_remote_frees++;
+    if (!p_global_pool->remote_return ||
+        owner >= p_global_pool->num_return_queues)
+        return ABT_FALSE;
+    /* Push the header to the return queue of its owner.  Since the owner takes
+     * all the headers at once, there is no ABA problem. */
+    ABTD_atomic_ptr *p_head = &p_global_pool->return_queues[owner].p_head;
+    ABTI_mem_pool_header *p_header = (ABTI_mem_pool_header *)mem;
+    void *p_cur_head;
+    do {
+        p_cur_head = ABTD_atomic_acquire_load_ptr(p_head);
+        p_header->p_next = (ABTI_mem_pool_header *)p_cur_head;
+    } while (!ABTD_atomic_bool_cas_weak_ptr(p_head, p_cur_head, p_header));
+    return ABT_TRUE;
+}
+
+void ABTI_mem_pool_take_returned(ABTI_mem_pool_local_pool *p_local_pool)
+{
+    ABTI_mem_pool_header *p_header = (ABTI_mem_pool_header *)
+        ABTD_atomic_exchange_ptr(&p_local_pool->p_return_queue->p_head, NULL);
+    while (p_header) {
+        ABTI_mem_pool_header *p_next = p_header->p_next;
+        /* The owner of this header is this local pool. */
+        ABTI_mem_pool_free(p_local_pool, p_header);
+        p_header = p_next;
+    }
+}
+
+void ABTI_mem_pool_get_global_stats(ABTI_mem_pool_global_pool *p_global_pool,
+                                    ABT_mem_pool_stats *p_stats)
+{
+    const size_t page_size = p_global_pool->page_size;
+    uint64_t num_allocs, num_misses, num_taken, num_returned;
+    memset(p_stats, 0, sizeof(ABT_mem_pool_stats));
+    p_stats->num_pages_malloc = ABTD_atomic_relaxed_load_uint64(
+        &p_global_pool->num_pages[ABTU_MEM_LARGEPAGE_MALLOC]);
+    p_stats->num_pages_memalign = ABTD_atomic_relaxed_load_uint64(
+        &p_global_pool->num_pages[ABTU_MEM_LARGEPAGE_MEMALIGN]);
+    p_stats->num_pages_mmap = ABTD_atomic_relaxed_load_uint64(
+        &p_global_pool->num_pages[ABTU_MEM_LARGEPAGE_MMAP]);
+    p_stats->num_pages_mmap_hugepage = ABTD_atomic_relaxed_load_uint64(
+        &p_global_pool->num_pages[ABTU_MEM_LARGEPAGE_MMAP_HUGEPAGE]);
+    p_stats->num_pages_user = ABTD_atomic_relaxed_load_uint64(
+        &p_global_pool->num_pages[ABTU_MEM_LARGEPAGE_USER]);
+    p_stats->num_bytes =
+        (p_stats->num_pages_malloc + p_stats->num_pages_memalign +
+         p_stats->num_pages_mmap + p_stats->num_pages_mmap_hugepage +
+         p_stats->num_pages_user) *
+        page_size;
+    num_taken =
+        ABTD_atomic_relaxed_load_uint64(&p_global_pool->num_taken_buckets);
+    num_returned =
+        ABTD_atomic_relaxed_load_uint64(&p_global_pool->num_returned_buckets);
+    p_stats->num_buckets_in_flight =
+        num_taken > num_returned ? num_taken - num_returned : 0;
+    num_allocs =
+        ABTD_atomic_relaxed_load_uint64(&p_global_pool->num_retired_allocs);
+    num_misses =
+        ABTD_atomic_relaxed_load_uint64(&p_global_pool->num_retired_misses);
+    p_stats->num_local_hits = num_allocs - num_misses;
+    p_stats->num_local_misses = num_misses;
+    p_stats->num_remote_frees = ABTD_atomic_relaxed_load_uint64(
+        &p_global_pool->num_retired_remote_frees);
+    p_stats->num_malloc_fallbacks =
+        ABTD_atomic_relaxed_load_uint64(&p_global_pool->num_malloc_fallbacks);
+    p_stats->num_reserved =
+        ABTD_atomic_relaxed_load_uint64(&p_global_pool->num_reserved);
+    p_stats->num_alloc_failures =
+        ABTD_atomic_relaxed_load_uint64(&p_global_pool->num_alloc_failures);
+}
+
+void ABTI_mem_pool_add_local_stats(ABTI_mem_pool_local_pool *p_local_pool,
+                                   ABT_mem_pool_stats *p_stats)
+{
+    /* The owner may update these counters concurrently, so take a snapshot
+     * first and keep the derived numbers consistent with it. */
+    uint64_t num_allocs = *(volatile uint64_t *)&p_local_pool->num_allocs;
+    uint64_t num_frees = *(volatile uint64_t *)&p_local_pool->num_frees;
+    uint64_t num_misses = *(volatile uint64_t *)&p_local_pool->num_misses;
+    uint64_t num_returns = *(volatile uint64_t *)&p_local_pool->num_returns;
+    uint64_t num_buckets =
+        1 + num_misses * ABT_MEM_POOL_NUM_TAKE_BUCKETS - num_returns;
+    uint64_t num_headers =
+        num_buckets * p_local_pool->num_headers_per_bucket + num_frees -
+        num_allocs;
+
+    p_stats->num_bytes +=
+        num_headers * p_local_pool->p_global_pool->header_size;
+    p_stats->num_buckets_in_flight += num_buckets;
+    p_stats->num_local_hits += num_allocs - num_misses;
+    p_stats->num_local_misses += num_misses;
+    p_stats->num_remote_frees +=
+        *(volatile uint64_t *)&p_local_pool->num_remote_frees;
 }
@@ -0,0 +1,235 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include "abti.h"
+
+/* If ABT_STACK_PAINT is enabled, the whole stack of a user ULT is filled with
+ * a pattern when the ULT is created or revived.  Since a stack grows downward,
+ * the stack usage (i.e., the high-water mark) is the distance from the top of
+ * the stack to the lowest byte that has been overwritten.  The usage is
+ * recorded to histograms of the pool and the stack class (a pair of the stack
+ * type and the stack size, which ULT attributes decide) when the ULT
+ * terminates. */
+
+#define ABTI_STACK_PAINT_BYTE 0xA5
+#define ABTI_STACK_PAINT_WORD 0xA5A5A5A5A5A5A5A5ull
+
+static inline ABTI_stack_type stack_usage_get_class_type(ABTI_stack_type type)
+{
+    /* ULT attributes do not distinguish stacks taken from the memory pool and
+     * those allocated by malloc(). */
+    return type == ABTI_STACK_TYPE_USER ? ABTI_STACK_TYPE_USER
+                                        : ABTI_STACK_TYPE_MEMPOOL;
+}
+
+static inline int stack_usage_get_bin(size_t usage)
+{
+    int bin = 0;
+    size_t limit = 512;
+    while (usage > limit && bin < ABT_STACK_USAGE_NUM_BINS - 1) {
+        limit <<= 1;
+        bin++;
+    }
+    return bin;
+}
+
+static void stack_usage_hist_add(ABTI_stack_usage_hist *p_hist, size_t usage)
+{
+    ABTD_atomic_fetch_add_uint64(&p_hist->num_threads, 1);
+    ABTD_atomic_fetch_add_uint64(&p_hist->total_usage, usage);
+    ABTD_atomic_fetch_add_uint64(&p_hist->bins[stack_usage_get_bin(usage)], 1);
+    uint64_t max_usage = ABTD_atomic_relaxed_load_uint64(&p_hist->max_usage);
+    while (usage > max_usage &&
+           !ABTD_atomic_bool_cas_weak_uint64(&p_hist->max_usage, max_usage,
+                                             usage)) {
+        max_usage = ABTD_atomic_relaxed_load_uint64(&p_hist->max_usage);
+    }
+}
+
+void ABTI_stack_usage_init(ABTI_global *p_global)
+{
+    ABTI_spinlock_clear(&p_global->stack_usage_lock);
+    ABTD_atomic_relaxed_store_ptr(&p_global->p_stack_usage_classes, NULL);
+}
+
+void ABTI_stack_usage_finalize(ABTI_global *p_global)
+{
+    ABTI_stack_usage_class *p_class = (ABTI_stack_usage_class *)
+        ABTD_atomic_relaxed_load_ptr(&p_global->p_stack_usage_classes);
+    while (p_class) {
+        ABTI_stack_usage_class *p_next = p_class->p_next;
+        ABTU_free(p_class);
+        p_class = p_next;
+    }
+    ABTD_atomic_relaxed_store_ptr(&p_global->p_stack_usage_classes, NULL);
+}
+
+void ABTI_stack_usage_hist_init(ABTI_stack_usage_hist *p_hist)
+{
+    int i;
+    ABTD_atomic_relaxed_store_uint64(&p_hist->num_threads, 0);
+    ABTD_atomic_relaxed_store_uint64(&p_hist->total_usage, 0);
+    ABTD_atomic_relaxed_store_uint64(&p_hist->max_usage, 0);
+    for (i = 0; i < ABT_STACK_USAGE_NUM_BINS; i++)
+        ABTD_atomic_relaxed_store_uint64(&p_hist->bins[i], 0);
+}
+
+void ABTI_stack_usage_hist_get(ABTI_stack_usage_hist *p_hist,
+                               ABT_stack_usage_hist *hist)
+{
+    int i;
+    hist->num_threads = ABTD_atomic_relaxed_load_uint64(&p_hist->num_threads);
+    hist->total_usage = ABTD_atomic_relaxed_load_uint64(&p_hist->total_usage);
+    hist->max_usage = ABTD_atomic_relaxed_load_uint64(&p_hist->max_usage);
+    for (i = 0; i < ABT_STACK_USAGE_NUM_BINS; i++)
+        hist->bins[i] = ABTD_atomic_relaxed_load_uint64(&p_hist->bins[i]);
+}
+
+void ABTI_stack_usage_hist_print(ABTI_stack_usage_hist *p_hist, FILE *p_os,
+                                 int indent)
+{
+    char *prefix = ABTU_get_indent_str(indent);
+    ABT_stack_usage_hist hist;
+    int i;
+
+    ABTI_stack_usage_hist_get(p_hist, &hist);
+    fprintf(p_os,
+            "%s# of ULTs     : %" PRIu64 "\n"
+            "%savg. usage    : %" PRIu64 " bytes\n"
+            "%smax. usage    : %" PRIu64 " bytes\n",
+            prefix, hist.num_threads, prefix,
+            hist.num_threads ? hist.total_usage / hist.num_threads : 0, prefix,
+            hist.max_usage);
+    for (i = 0; i < ABT_STACK_USAGE_NUM_BINS; i++) {
+        if (hist.bins[i] == 0)
+            continue;
+        if (i == ABT_STACK_USAGE_NUM_BINS - 1) {
+            fprintf(p_os, "%s  > %8zu B : %" PRIu64 "\n", prefix,
+                    (size_t)256 << i, hist.bins[i]);
+        } else {
+            fprintf(p_os, "%s  <= %7zu B : %" PRIu64 "\n", prefix,
+                    (size_t)512 << i, hist.bins[i]);
+        }
+    }
+    ABTU_free(prefix);
+}
+
+/* Returns the histogram of ULTs whose stacks have the given type and size.  If
+ * there is no such histogram, a new one is added if create is ABT_TRUE.
+ * Otherwise, NULL is returned. */
+ABTI_stack_usage_hist *ABTI_stack_usage_get_hist(ABTI_stack_type stacktype,
+                                                 size_t stacksize,
+                                                 ABT_bool create)
+{
+    ABTI_global *p_global = gp_ABTI_global;
+    ABTI_stack_usage_class *p_head, *p_class;
+    stacktype = stack_usage_get_class_type(stacktype);
+
+    p_head = (ABTI_stack_usage_class *)ABTD_atomic_acquire_load_ptr(
+        &p_global->p_stack_usage_classes);
+    for (p_class = p_head; p_class; p_class = p_class->p_next) {
+        if (p_class->stacktype == stacktype && p_class->stacksize == stacksize)
+            return &p_class->hist;
+    }
+    if (!create)
+        return NULL;
+
+    ABTI_spinlock_acquire(&p_global->stack_usage_lock);
+    /* Check classes that have been added after p_head was read. */
+    for (p_class = (ABTI_stack_usage_class *)ABTD_atomic_relaxed_load_ptr(
+             &p_global->p_stack_usage_classes);
+         p_class != p_head; p_class = p_class->p_next) {
+        if (p_class->stacktype == stacktype && p_class->stacksize == stacksize)
+            break;
+    }
+    if (p_class == p_head) {
+        p_class = (ABTI_stack_usage_class *)ABTU_malloc(
+            sizeof(ABTI_stack_usage_class));
+        p_class->stacktype = stacktype;
+        p_class->stacksize = stacksize;
+        ABTI_stack_usage_hist_init(&p_class->hist);
+        p_class->p_next = (ABTI_stack_usage_class *)
+            ABTD_atomic_relaxed_load_ptr(&p_global->p_stack_usage_classes);
+        ABTD_atomic_release_store_ptr(&p_global->p_stack_usage_classes,
+                                      (void *)p_class);
+    }
+    ABTI_spinlock_release(&p_global->stack_usage_lock);
+    return &p_class->hist;
+}
+
+void ABTI_stack_usage_print(FILE *p_os)
+{
+    ABTI_stack_usage_class *p_class;
+
+    if (!gp_ABTI_global->stack_paint) {
+        fprintf(p_os, "Stack painting is disabled (see ABT_STACK_PAINT).\n");
+        goto fn_exit;
+    }
+    fprintf(p_os, "== ULT STACK USAGE ==\n");
+    for (p_class = (ABTI_stack_usage_class *)ABTD_atomic_acquire_load_ptr(
+             &gp_ABTI_global->p_stack_usage_classes);
+         p_class; p_class = p_class->p_next) {
+        fprintf(p_os, "stack size: %zu bytes (%s)\n", p_class->stacksize,
+                p_class->stacktype == ABTI_STACK_TYPE_USER ? "user"
+                                                           : "Argobots");
+        ABTI_stack_usage_hist_print(&p_class->hist, p_os, 2);
+    }
+
+fn_exit:
+    fflush(p_os);
+}
+
+void ABTI_thread_paint_stack(ABTI_thread *p_thread)
+{
+    switch (p_thread->stacktype) {
+        case ABTI_STACK_TYPE_MEMPOOL:
+        case ABTI_STACK_TYPE_MALLOC:
+        case ABTI_STACK_TYPE_USER:
+            if (p_thread->p_stack) {
+                memset(p_thread->p_stack, ABTI_STACK_PAINT_BYTE,
+                       p_thread->stacksize);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/* Returns the high-water mark of the painted stack of p_thread.  If p_thread
+ * is running, the result may be slightly stale. */
+size_t ABTI_thread_get_stack_usage(ABTI_thread *p_thread)
+{
+    const unsigned char *p = (const unsigned char *)p_thread->p_stack;
+    const unsigned char *p_end = p + p_thread->stacksize;
+
+    /* A user-given stack might not be aligned. */
+    while (p < p_end && ((uintptr_t)p & (sizeof(uint64_t) - 1))) {
+        if (*p != ABTI_STACK_PAINT_BYTE)
+            return p_end - p;
+        p++;
+    }
+    while (p + sizeof(uint64_t) <= p_end &&
+           *(const uint64_t *)p == ABTI_STACK_PAINT_WORD) {
+        p += sizeof(uint64_t);
+    }
+    while (p < p_end && *p == ABTI_STACK_PAINT_BYTE)
+        p++;
+    return p_end - p;
+}
+
+/* Records the stack usage of p_thread, which is terminating. */
+void ABTI_thread_record_stack_usage(ABTI_thread *p_thread)
+{
+    if (!ABTI_thread_is_stack_painted(p_thread))
+        return;
+    size_t usage = ABTI_thread_get_stack_usage(p_thread);
+    ABTI_pool *p_pool = p_thread->unit_def.p_pool;
+    if (p_pool)
+        stack_usage_hist_add(&p_pool->stack_usage, usage);
+    stack_usage_hist_add(ABTI_stack_usage_get_hist(p_thread->stacktype,
+                                                   p_thread->stacksize,
+                                                   ABT_TRUE),
+                         usage);
+}
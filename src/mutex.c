@@ -37,8 +37,14 @@ int ABT_mutex_create(ABT_mutex *newmutex)
     int abt_errno = ABT_SUCCESS;
     ABTI_mutex *p_newmutex;
 
-    p_newmutex = (ABTI_mutex *)ABTU_calloc(1, sizeof(ABTI_mutex));
-    ABTI_mutex_init(p_newmutex);
+    ABTI_STATIC_ASSERT(sizeof(ABTI_mutex) <= ABTI_MEM_POOL_DESC_SIZE);
+    p_newmutex = (ABTI_mutex *)ABTI_mem_alloc_sync();
+    if (p_newmutex == NULL) {
+        abt_errno = ABT_ERR_MEM;
+    } else {
+        memset(p_newmutex, 0, sizeof(ABTI_mutex));
+        ABTI_mutex_init(p_newmutex);
+    }
 
     /* Return value */
     *newmutex = ABTI_mutex_get_handle(p_newmutex);
@@ -69,7 +75,13 @@ int ABT_mutex_create_with_attr(ABT_mutex_attr attr, ABT_mutex *newmutex)
     ABTI_CHECK_NULL_MUTEX_ATTR_PTR(p_attr);
     ABTI_mutex *p_newmutex;
 
-    p_newmutex = (ABTI_mutex *)ABTU_malloc(sizeof(ABTI_mutex));
+    ABTI_STATIC_ASSERT(sizeof(ABTI_mutex) <= ABTI_MEM_POOL_DESC_SIZE);
+    p_newmutex = (ABTI_mutex *)ABTI_mem_alloc_sync();
+    if (ABTU_unlikely(p_newmutex == NULL)) {
+        abt_errno = ABT_ERR_MEM;
+        goto fn_fail;
+    }
+    memset(p_newmutex, 0, sizeof(ABTI_mutex));
     ABTI_mutex_init(p_newmutex);
     ABTI_mutex_attr_copy(&p_newmutex->attr, p_attr);
 
@@ -107,7 +119,7 @@ int ABT_mutex_free(ABT_mutex *mutex)
     ABTI_CHECK_NULL_MUTEX_PTR(p_mutex);
 
     ABTI_mutex_fini(p_mutex);
-    ABTU_free(p_mutex);
+    ABTI_mem_free_sync(p_mutex);
 
     /* Return value */
     *mutex = ABT_MUTEX_NULL;
@@ -182,6 +194,8 @@ static inline void ABTI_mutex_lock_low(ABTI_xstream **pp_local_xstream,
     if (ABTI_unit_type_is_thread(type)) {
         LOG_DEBUG("%p: lock_low - try\n", p_mutex);
         while (!ABTD_atomic_bool_cas_weak_uint32(&p_mutex->val, 0, 1)) {
+            if (ABTI_mutex_try_spin_queued(p_mutex))
+                break;
             ABTI_thread_yield(pp_local_xstream,
                               ABTI_unit_get_thread(p_local_xstream->p_unit),
                               ABT_SYNC_EVENT_TYPE_MUTEX, (void *)p_mutex);
@@ -220,7 +234,8 @@ static inline void ABTI_mutex_lock_low(ABTI_xstream **pp_local_xstream,
             }
         }
 
-        if ((c = ABTD_atomic_val_cas_strong_uint32(&p_mutex->val, 0, 1)) != 0) {
+        c = ABTD_atomic_val_cas_strong_uint32(&p_mutex->val, 0, 1);
+        if (c != 0 && !ABTI_mutex_try_spin_queued(p_mutex)) {
             if (c != 2) {
                 c = ABTD_atomic_exchange_uint32(&p_mutex->val, 2);
             }
@@ -236,14 +251,18 @@ static inline void ABTI_mutex_lock_low(ABTI_xstream **pp_local_xstream,
                         p_mutex->p_handover = NULL;
                         ABTD_atomic_release_store_uint32(&p_mutex->val, 2);
 
-                        /* Push the previous ULT to its pool */
+                        /* Push the previous ULT to its pool.  p_giver is
+                         * NULL if it has yielded by itself. */
                         ABTI_thread *p_giver = p_mutex->p_giver;
-                        ABTD_atomic_release_store_int(&p_giver->unit_def.state,
-                                                      ABTI_UNIT_STATE_READY);
-                        ABTI_POOL_PUSH(p_giver->unit_def.p_pool,
-                                       p_giver->unit_def.unit,
-                                       ABTI_self_get_native_thread_id(
-                                           *pp_local_xstream));
+                        if (p_giver) {
+                            ABTD_atomic_release_store_int(
+                                &p_giver->unit_def.state,
+                                ABTI_UNIT_STATE_READY);
+                            ABTI_POOL_PUSH(p_giver->unit_def.p_pool,
+                                           p_giver->unit_def.unit,
+                                           ABTI_self_get_native_thread_id(
+                                               *pp_local_xstream));
+                        }
                         break;
                     }
                 }
@@ -562,6 +581,18 @@ handover:
 
     /* We are handing over the mutex */
     p_mutex->p_handover = p_next;
+    if (ABTI_thread_is_stack_copy(p_thread) ||
+        ABTI_thread_is_stack_copy(p_next)) {
+        /* Stack-copying ULTs cannot be directly switched to, so p_next is
+         * resumed by the scheduler. */
+        p_mutex->p_giver = NULL;
+        LOG_DEBUG("%p: handover -> U%" PRIu64 "\n", p_mutex,
+                  ABTI_thread_get_id(p_next));
+        ABTI_thread_set_ready(p_local_xstream, p_next);
+        ABTI_thread_yield(pp_local_xstream, p_thread, ABT_SYNC_EVENT_TYPE_MUTEX,
+                          (void *)p_mutex);
+        return abt_errno;
+    }
     p_mutex->p_giver = p_thread;
 
     LOG_DEBUG("%p: handover -> U%" PRIu64 "\n", p_mutex,
@@ -756,6 +787,52 @@ void ABTI_mutex_wait_low(ABTI_xstream **pp_local_xstream, ABTI_mutex *p_mutex,
                         (void *)p_mutex);
 }
 
+/* Move p_thread, which has been blocked by the caller, to the waiter queue of
+ * p_mutex so that it is woken up when p_mutex is released.  This is used by
+ * condition variables to avoid waking up all the waiters at once only to make
+ * them block on the mutex again.  Returns ABT_FALSE if p_thread cannot wait on
+ * p_mutex (e.g., p_mutex is not locked), in which case the caller needs to wake
+ * up p_thread. */
+ABT_bool ABTI_mutex_add_waiter(ABTI_mutex *p_mutex, ABTI_thread *p_thread)
+{
+#ifdef ABT_CONFIG_USE_SIMPLE_MUTEX
+    /* The simple mutex does not have a waiter queue. */
+    return ABT_FALSE;
+#else
+    ABTI_thread_htable *p_htable = p_mutex->p_htable;
+    int rank = ABTI_thread_get_xstream_rank(p_thread);
+    if (rank < 0 || rank >= (int)p_htable->num_rows)
+        return ABT_FALSE;
+    ABTI_thread_queue *p_queue = &p_htable->queue[rank];
+
+    ABTI_THREAD_HTABLE_LOCK(p_htable->mutex);
+
+    /* The mutex must be marked as contended so that the owner wakes up a
+     * waiter when it unlocks the mutex. */
+    uint32_t val = ABTD_atomic_acquire_load_uint32(&p_mutex->val);
+    while (val == 1) {
+        if (ABTD_atomic_bool_cas_weak_uint32(&p_mutex->val, 1, 2)) {
+            val = 2;
+            break;
+        }
+        val = ABTD_atomic_acquire_load_uint32(&p_mutex->val);
+    }
+    if (val != 2) {
+        ABTI_THREAD_HTABLE_UNLOCK(p_htable->mutex);
+        return ABT_FALSE;
+    }
+
+    if (p_queue->p_h_next == NULL) {
+        ABTI_thread_htable_add_h_node(p_htable, p_queue);
+    }
+    p_thread->unit_def.p_next = NULL;
+    ABTI_thread_htable_push(p_htable, rank, p_thread);
+
+    ABTI_THREAD_HTABLE_UNLOCK(p_htable->mutex);
+    return ABT_TRUE;
+#endif
+}
+
 void ABTI_mutex_wake_de(ABTI_xstream *p_local_xstream, ABTI_mutex *p_mutex)
 {
     int n;
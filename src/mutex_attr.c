@@ -110,6 +110,49 @@ fn_fail:
     goto fn_exit;
 }
 
+/**
+ * @ingroup MUTEX_ATTR
+ * @brief   Set the queued-spin property in the attribute object.
+ *
+ * \c ABT_mutex_attr_set_queued_spin() sets the queued-spin property in the
+ * attribute object associated with handle \c attr.  When a mutex created with
+ * this property is locked, waiters first line up in a FIFO queue in which each
+ * waiter spins on its own queue node, and only the head of the queue polls the
+ * mutex.  This avoids having all the waiters on different ESs poll the same
+ * cache line.  The head passes its position to the next waiter when it
+ * acquires the mutex or after it polls the mutex \c ABT_MUTEX_QUEUED_SPINS
+ * times, in which case a ULT suspends as with the default mutex.  Since a
+ * spinning waiter occupies its ES, this property is beneficial when the mutex
+ * is held for a short time by work units on other ESs.  The priority of
+ * \c ABT_mutex_lock_low() and \c ABT_mutex_lock_high() applies to suspended
+ * waiters.
+ *
+ * @param[in] attr         handle to the target attribute object
+ * @param[in] queued_spin  boolean value for the queued-spin property
+ * @return Error code
+ * @retval ABT_SUCCESS on success
+ */
+int ABT_mutex_attr_set_queued_spin(ABT_mutex_attr attr, ABT_bool queued_spin)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_mutex_attr *p_attr = ABTI_mutex_attr_get_ptr(attr);
+    ABTI_CHECK_NULL_MUTEX_ATTR_PTR(p_attr);
+
+    /* Set the value */
+    if (queued_spin == ABT_TRUE) {
+        p_attr->attrs |= ABTI_MUTEX_ATTR_QUEUED_SPIN;
+    } else {
+        p_attr->attrs &= ~ABTI_MUTEX_ATTR_QUEUED_SPIN;
+    }
+
+fn_exit:
+    return abt_errno;
+
+fn_fail:
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
+}
+
 /*****************************************************************************/
 /* Private APIs                                                              */
 /*****************************************************************************/
@@ -13,6 +13,10 @@ static int pool_free(ABT_pool pool);
 static size_t pool_get_size(ABT_pool pool);
 static void pool_push_shared(ABT_pool pool, ABT_unit unit);
 static void pool_push_private(ABT_pool pool, ABT_unit unit);
+static void pool_push_many_shared(ABT_pool pool, const ABT_unit *units,
+                                  size_t num);
+static void pool_push_many_private(ABT_pool pool, const ABT_unit *units,
+                                   size_t num);
 static ABT_unit pool_pop_shared(ABT_pool pool);
 static ABT_unit pool_pop_private(ABT_pool pool);
 static ABT_unit pool_pop_wait(ABT_pool pool, double time_secs);
@@ -95,6 +99,14 @@ fn_fail:
     goto fn_exit;
 }
 
+/* Obtain the function to push multiple units to a FIFO pool */
+ABTI_pool_push_many_fn ABTI_pool_get_fifo_push_many(ABT_pool_access access)
+{
+    if (access == ABT_POOL_ACCESS_PRIV)
+        return pool_push_many_private;
+    return pool_push_many_shared;
+}
+
 /* Pool functions */
 
 int pool_init(ABT_pool pool, ABT_pool_config config)
@@ -192,6 +204,69 @@ static void pool_push_private(ABT_pool pool, ABT_unit unit)
     ABTD_atomic_release_store_int(&p_unit->is_in_pool, 1);
 }
 
+/* Link units in order and append them to the list.  Only the last part needs
+ * to be protected in a shared pool. */
+static inline void pool_link_many(const ABT_unit *units, size_t num,
+                                  unit_t **pp_first, unit_t **pp_last)
+{
+    size_t i;
+    unit_t *p_first = (unit_t *)units[0];
+    unit_t *p_last = p_first;
+    ABTD_atomic_release_store_int(&p_first->is_in_pool, 1);
+    for (i = 1; i < num; i++) {
+        unit_t *p_unit = (unit_t *)units[i];
+        p_last->p_next = p_unit;
+        p_unit->p_prev = p_last;
+        ABTD_atomic_release_store_int(&p_unit->is_in_pool, 1);
+        p_last = p_unit;
+    }
+    *pp_first = p_first;
+    *pp_last = p_last;
+}
+
+static inline void pool_append_many(data_t *p_data, unit_t *p_first,
+                                    unit_t *p_last, size_t num)
+{
+    if (p_data->num_units == 0) {
+        p_data->p_head = p_first;
+    } else {
+        p_data->p_tail->p_next = p_first;
+        p_first->p_prev = p_data->p_tail;
+    }
+    p_data->p_tail = p_last;
+    p_last->p_next = p_data->p_head;
+    p_data->p_head->p_prev = p_last;
+    p_data->num_units += num;
+}
+
+static void pool_push_many_shared(ABT_pool pool, const ABT_unit *units,
+                                  size_t num)
+{
+    ABTI_pool *p_pool = ABTI_pool_get_ptr(pool);
+    data_t *p_data = pool_get_data_ptr(p_pool->data);
+    unit_t *p_first, *p_last;
+
+    if (num == 0)
+        return;
+    pool_link_many(units, num, &p_first, &p_last);
+    ABTI_spinlock_acquire(&p_data->mutex);
+    pool_append_many(p_data, p_first, p_last, num);
+    ABTI_spinlock_release(&p_data->mutex);
+}
+
+static void pool_push_many_private(ABT_pool pool, const ABT_unit *units,
+                                   size_t num)
+{
+    ABTI_pool *p_pool = ABTI_pool_get_ptr(pool);
+    data_t *p_data = pool_get_data_ptr(p_pool->data);
+    unit_t *p_first, *p_last;
+
+    if (num == 0)
+        return;
+    pool_link_many(units, num, &p_first, &p_last);
+    pool_append_many(p_data, p_first, p_last, num);
+}
+
 static ABT_unit pool_pop_wait(ABT_pool pool, double time_secs)
 {
     ABTI_pool *p_pool = ABTI_pool_get_ptr(pool);
@@ -353,6 +428,12 @@ static int pool_remove_shared(ABT_pool pool, ABT_unit unit)
                         ABT_ERR_POOL);
 
     ABTI_spinlock_acquire(&p_data->mutex);
+    /* Another ES may have popped p_unit in the meantime.  The caller can rely
+     * on this check to take p_unit atomically (see ABTI_thread_join()). */
+    if (ABTD_atomic_relaxed_load_int(&p_unit->is_in_pool) != 1) {
+        ABTI_spinlock_release(&p_data->mutex);
+        return ABT_ERR_POOL;
+    }
     if (p_data->num_units == 1) {
         p_data->p_head = NULL;
         p_data->p_tail = NULL;
@@ -280,6 +280,11 @@ static int pool_remove(ABT_pool pool, ABT_unit unit)
                         ABT_ERR_POOL);
 
     pthread_mutex_lock(&p_data->mutex);
+    /* Another ES may have popped p_unit in the meantime. */
+    if (ABTD_atomic_relaxed_load_int(&p_unit->is_in_pool) != 1) {
+        pthread_mutex_unlock(&p_data->mutex);
+        return ABT_ERR_POOL;
+    }
     if (p_data->num_units == 1) {
         p_data->p_head = NULL;
         p_data->p_tail = NULL;
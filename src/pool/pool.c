@@ -601,6 +601,7 @@ int ABTI_pool_create(ABT_pool_def *def, ABT_pool_config config,
     ABTD_atomic_release_store_int32(&p_pool->num_blocked, 0);
     ABTD_atomic_release_store_int32(&p_pool->num_migrations, 0);
     p_pool->data = NULL;
+    ABTI_stack_usage_hist_init(&p_pool->stack_usage);
 
     /* Set up the pool functions from def */
     p_pool->u_get_type = def->u_get_type;
@@ -613,10 +614,12 @@ int ABTI_pool_create(ABT_pool_def *def, ABT_pool_config config,
     p_pool->p_init = def->p_init;
     p_pool->p_get_size = def->p_get_size;
     p_pool->p_push = def->p_push;
+    p_pool->p_push_many = NULL;
     p_pool->p_pop = def->p_pop;
     p_pool->p_pop_wait = def->p_pop_wait;
     p_pool->p_pop_timedwait = def->p_pop_timedwait;
     p_pool->p_remove = def->p_remove;
+    p_pool->p_try_remove = NULL;
     p_pool->p_free = def->p_free;
     p_pool->p_print_all = def->p_print_all;
     p_pool->id = ABTI_pool_get_new_id();
@@ -662,6 +665,13 @@ int ABTI_pool_create_basic(ABT_pool_kind kind, ABT_pool_access access,
     abt_errno =
         ABTI_pool_create(&def, ABT_POOL_CONFIG_NULL, automatic, pp_newpool);
     ABTI_CHECK_ERROR(abt_errno);
+    if (kind == ABT_POOL_FIFO)
+        (*pp_newpool)->p_push_many = ABTI_pool_get_fifo_push_many(access);
+    /* p_remove() of the built-in shared pools checks under the lock whether
+     * the unit is still in the pool, so it can be used to take a unit that
+     * other ESs may pop in parallel. */
+    if (access != ABT_POOL_ACCESS_PRIV)
+        (*pp_newpool)->p_try_remove = (*pp_newpool)->p_remove;
 
 fn_exit:
     return abt_errno;
@@ -740,6 +750,10 @@ void ABTI_pool_print(ABTI_pool *p_pool, FILE *p_os, int indent)
             ABTD_atomic_acquire_load_int32(&p_pool->num_blocked), prefix,
             ABTD_atomic_acquire_load_int32(&p_pool->num_migrations), prefix,
             p_pool->data);
+    if (gp_ABTI_global->stack_paint) {
+        fprintf(p_os, "%sstack usage   :\n", prefix);
+        ABTI_stack_usage_hist_print(&p_pool->stack_usage, p_os, indent + 2);
+    }
 
 fn_exit:
     fflush(p_os);
@@ -28,7 +28,8 @@ int ABT_rwlock_create(ABT_rwlock *newrwlock)
     int abt_errno = ABT_SUCCESS;
     ABTI_rwlock *p_newrwlock;
 
-    p_newrwlock = (ABTI_rwlock *)ABTU_malloc(sizeof(ABTI_rwlock));
+    ABTI_STATIC_ASSERT(sizeof(ABTI_rwlock) <= ABTI_MEM_POOL_DESC_SIZE);
+    p_newrwlock = (ABTI_rwlock *)ABTI_mem_alloc_sync();
     if (p_newrwlock == NULL) {
         abt_errno = ABT_ERR_MEM;
     } else {
@@ -41,6 +42,60 @@ int ABT_rwlock_create(ABT_rwlock *newrwlock)
     return abt_errno;
 }
 
+/**
+ * @ingroup RWLOCK
+ * @brief   Create a new rwlock with attributes.
+ *
+ * \c ABT_rwlock_create_with_attr() creates a rwlock object with the
+ * attributes given by \c attr and returns its handle through \c newrwlock.
+ * If \c attr is \c ABT_RWLOCK_ATTR_NULL, the default attributes are used,
+ * which is the same as \c ABT_rwlock_create().  If an error occurs,
+ * \c newrwlock is set to \c ABT_RWLOCK_NULL.
+ *
+ * Only ULTs can use the rwlock, and tasklets must not use it.
+ *
+ * @param[in]  attr       handle to the rwlock attribute object
+ * @param[out] newrwlock  handle to a new rwlock
+ * @return Error code
+ * @retval ABT_SUCCESS on success
+ */
+int ABT_rwlock_create_with_attr(ABT_rwlock_attr attr, ABT_rwlock *newrwlock)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_rwlock_attr *p_attr = ABTI_rwlock_attr_get_ptr(attr);
+    ABTI_rwlock *p_newrwlock = NULL;
+
+    abt_errno = ABT_rwlock_create(newrwlock);
+    ABTI_CHECK_ERROR(abt_errno);
+    p_newrwlock = ABTI_rwlock_get_ptr(*newrwlock);
+
+    if (p_attr && p_attr->read_mostly) {
+        /* One cache line per ES.  ESs beyond this number share indicators. */
+        int num_indicators = gp_ABTI_global->max_xstreams;
+        size_t size = sizeof(ABTI_rwlock_indicator) * num_indicators;
+        ABTI_rwlock_indicator *p_indicators = (ABTI_rwlock_indicator *)
+            ABTU_memalign(ABT_CONFIG_STATIC_CACHELINE_SIZE, size);
+        ABTI_CHECK_TRUE(p_indicators != NULL, ABT_ERR_MEM);
+        memset(p_indicators, 0, size);
+        p_newrwlock->num_indicators = num_indicators;
+        p_newrwlock->p_indicators = p_indicators;
+        ABTD_atomic_release_store_int(&p_newrwlock->rm_state,
+                                      ABTI_RWLOCK_READER_BIAS);
+    }
+
+fn_exit:
+    return abt_errno;
+
+fn_fail:
+    if (p_newrwlock) {
+        ABTI_rwlock_fini(p_newrwlock);
+        ABTI_mem_free_sync(p_newrwlock);
+    }
+    *newrwlock = ABT_RWLOCK_NULL;
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
+}
+
 /**
  * @ingroup RWLOCK
  * @brief   Free the rwlock object.
@@ -64,7 +119,7 @@ int ABT_rwlock_free(ABT_rwlock *rwlock)
     ABTI_CHECK_NULL_RWLOCK_PTR(p_rwlock);
 
     ABTI_rwlock_fini(p_rwlock);
-    ABTU_free(p_rwlock);
+    ABTI_mem_free_sync(p_rwlock);
 
     /* Return value */
     *rwlock = ABT_RWLOCK_NULL;
@@ -0,0 +1,107 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include "abti.h"
+
+/** @defgroup RWLOCK_ATTR Readers Writer Lock Attributes
+ * Attributes are used to specify rwlock behavior that is different from the
+ * default.  When a rwlock is created with \c ABT_rwlock_create_with_attr(),
+ * attributes can be specified with an \c ABT_rwlock_attr object.
+ */
+
+/**
+ * @ingroup RWLOCK_ATTR
+ * @brief   Create a new rwlock attribute object.
+ *
+ * \c ABT_rwlock_attr_create() creates a rwlock attribute object with default
+ * attribute values.  The handle to the attribute object is returned through
+ * \c newattr. The attribute object can be used in more than one rwlock.
+ *
+ * @param[out] newattr  handle to a new attribute object
+ * @return Error code
+ * @retval ABT_SUCCESS on success
+ */
+int ABT_rwlock_attr_create(ABT_rwlock_attr *newattr)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_rwlock_attr *p_newattr;
+
+    p_newattr = (ABTI_rwlock_attr *)ABTU_malloc(sizeof(ABTI_rwlock_attr));
+
+    /* Default values */
+    p_newattr->read_mostly = ABT_FALSE;
+
+    /* Return value */
+    *newattr = ABTI_rwlock_attr_get_handle(p_newattr);
+
+    return abt_errno;
+}
+
+/**
+ * @ingroup RWLOCK_ATTR
+ * @brief   Free the rwlock attribute object.
+ *
+ * \c ABT_rwlock_attr_free() deallocates memory used for the rwlock attribute
+ * object.  If this function successfully returns, \c attr will be set to
+ * \c ABT_RWLOCK_ATTR_NULL.
+ *
+ * @param[in,out] attr  handle to the target attribute object
+ * @return Error code
+ * @retval ABT_SUCCESS on success
+ */
+int ABT_rwlock_attr_free(ABT_rwlock_attr *attr)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABT_rwlock_attr h_attr = *attr;
+    ABTI_rwlock_attr *p_attr = ABTI_rwlock_attr_get_ptr(h_attr);
+    ABTI_CHECK_NULL_RWLOCK_ATTR_PTR(p_attr);
+
+    /* Free the memory */
+    ABTU_free(p_attr);
+
+    /* Return value */
+    *attr = ABT_RWLOCK_ATTR_NULL;
+
+fn_exit:
+    return abt_errno;
+
+fn_fail:
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
+}
+
+/**
+ * @ingroup RWLOCK_ATTR
+ * @brief   Set the read-mostly property in the attribute object.
+ *
+ * \c ABT_rwlock_attr_set_read_mostly() sets the read-mostly property in the
+ * attribute object associated with handle \c attr.  A read-mostly rwlock lets
+ * readers enter and leave by updating a counter of their ES without taking an
+ * internal lock, so readers on different ESs do not contend with each other.
+ * In exchange, a writer needs to wait until all the readers on all the ESs
+ * leave, which makes \c ABT_rwlock_wrlock() more expensive.  Blocked readers
+ * and writers are suspended as with the default rwlock.
+ *
+ * @param[in] attr         handle to the target attribute object
+ * @param[in] read_mostly  boolean value for the read-mostly mode
+ * @return Error code
+ * @retval ABT_SUCCESS on success
+ */
+int ABT_rwlock_attr_set_read_mostly(ABT_rwlock_attr attr, ABT_bool read_mostly)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_rwlock_attr *p_attr = ABTI_rwlock_attr_get_ptr(attr);
+    ABTI_CHECK_NULL_RWLOCK_ATTR_PTR(p_attr);
+
+    /* Set the value */
+    p_attr->read_mostly = (read_mostly == ABT_TRUE) ? ABT_TRUE : ABT_FALSE;
+
+fn_exit:
+    return abt_errno;
+
+fn_fail:
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
+}
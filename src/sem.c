@@ -0,0 +1,439 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include "abti.h"
+
+static int sem_wait(ABTI_xstream **pp_local_xstream, ABTI_sem *p_sem,
+                    uint32_t num, ABT_bool is_timed, double tar_time);
+static void sem_grant(ABTI_xstream *p_local_xstream, ABTI_sem *p_sem);
+static ABT_bool sem_remove_waiter(ABTI_xstream *p_local_xstream,
+                                  ABTI_sem *p_sem, ABTI_sem_waiter *p_waiter);
+
+/** @defgroup SEM Semaphore
+ * This group is for Semaphore.
+ *
+ * A semaphore holds a number of permits.  \c ABT_sem_acquire() takes permits
+ * and \c ABT_sem_release() returns them.  Permits are taken with a single
+ * atomic operation when they are available and nobody is waiting.  Otherwise,
+ * the caller is queued and waits until the permits are handed to it: a ULT
+ * is suspended and an external thread spins for a while and then sleeps.
+ * Waiters are served in FIFO order, so a waiter requesting many permits is
+ * not overtaken by later requests for fewer permits.
+ */
+
+/**
+ * @ingroup SEM
+ * @brief   Create a new semaphore.
+ *
+ * \c ABT_sem_create() creates a new semaphore that initially holds \c value
+ * permits and returns its handle through \c newsem.
+ * If an error occurs in this routine, a non-zero error code will be returned
+ * and \c newsem will be set to \c ABT_SEM_NULL.
+ *
+ * @param[in]  value   initial number of permits
+ * @param[out] newsem  handle to a new semaphore
+ * @return Error code
+ * @retval ABT_SUCCESS on success
+ */
+int ABT_sem_create(uint32_t value, ABT_sem *newsem)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_sem *p_newsem;
+
+    ABTI_STATIC_ASSERT(sizeof(ABTI_sem) <= ABTI_MEM_POOL_DESC_SIZE);
+    p_newsem = (ABTI_sem *)ABTI_mem_alloc_sync();
+    if (p_newsem == NULL) {
+        *newsem = ABT_SEM_NULL;
+        return ABT_ERR_MEM;
+    }
+    ABTI_spinlock_clear(&p_newsem->lock);
+    ABTD_atomic_relaxed_store_uint32(&p_newsem->count, value);
+    ABTD_atomic_relaxed_store_uint32(&p_newsem->num_waiters, 0);
+    p_newsem->p_head = NULL;
+    p_newsem->p_tail = NULL;
+
+    /* Return value */
+    *newsem = ABTI_sem_get_handle(p_newsem);
+
+    return abt_errno;
+}
+
+/**
+ * @ingroup SEM
+ * @brief   Free the semaphore.
+ *
+ * \c ABT_sem_free() deallocates the memory used for the semaphore object
+ * associated with the handle \c sem. If it is successfully processed, \c sem
+ * is set to \c ABT_SEM_NULL.  No one may be waiting on the semaphore.
+ *
+ * @param[in,out] sem  handle to the semaphore
+ * @return Error code
+ * @retval ABT_SUCCESS on success
+ * @retval ABT_ERR_SEM someone is waiting on \c sem
+ */
+int ABT_sem_free(ABT_sem *sem)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_sem *p_sem = ABTI_sem_get_ptr(*sem);
+    ABTI_CHECK_NULL_SEM_PTR(p_sem);
+
+    /* The lock needs to be acquired since a releaser may still be handing
+     * permits to the last waiter.  It is not released if the semaphore is
+     * freed. */
+    ABTI_spinlock_acquire(&p_sem->lock);
+    if (ABTD_atomic_relaxed_load_uint32(&p_sem->num_waiters) != 0) {
+        ABTI_spinlock_release(&p_sem->lock);
+        abt_errno = ABT_ERR_SEM;
+        goto fn_fail;
+    }
+
+    ABTI_mem_free_sync(p_sem);
+
+    /* Return value */
+    *sem = ABT_SEM_NULL;
+
+fn_exit:
+    return abt_errno;
+
+fn_fail:
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
+}
+
+/**
+ * @ingroup SEM
+ * @brief   Acquire permits from the semaphore.
+ *
+ * \c ABT_sem_acquire() takes \c num permits from the semaphore \c sem.  If
+ * they are not available or other callers are waiting, the caller waits until
+ * \c num permits are handed to it.  A tasklet cannot wait.
+ *
+ * @param[in] sem  handle to the semaphore
+ * @param[in] num  number of permits
+ * @return Error code
+ * @retval ABT_SUCCESS on success
+ * @retval ABT_ERR_SEM the caller is a tasklet and has to wait
+ */
+int ABT_sem_acquire(ABT_sem sem, uint32_t num)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_xstream *p_local_xstream = ABTI_local_get_xstream();
+    ABTI_sem *p_sem = ABTI_sem_get_ptr(sem);
+    ABTI_CHECK_NULL_SEM_PTR(p_sem);
+
+    if (num == 0 || ABTI_sem_try_acquire(p_sem, num))
+        goto fn_exit;
+
+    abt_errno = sem_wait(&p_local_xstream, p_sem, num, ABT_FALSE, 0.0);
+    ABTI_CHECK_ERROR(abt_errno);
+
+fn_exit:
+    return abt_errno;
+
+fn_fail:
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
+}
+
+/**
+ * @ingroup SEM
+ * @brief   Acquire permits from the semaphore without waiting.
+ *
+ * \c ABT_sem_tryacquire() takes \c num permits from the semaphore \c sem if
+ * they are available and nobody is waiting on \c sem.  Otherwise, it returns
+ * \c ABT_ERR_SEM_UNAVAILABLE immediately without taking any permit.
+ *
+ * @param[in] sem  handle to the semaphore
+ * @param[in] num  number of permits
+ * @return Error code
+ * @retval ABT_SUCCESS              on success
+ * @retval ABT_ERR_SEM_UNAVAILABLE  permits are not available
+ */
+int ABT_sem_tryacquire(ABT_sem sem, uint32_t num)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_sem *p_sem = ABTI_sem_get_ptr(sem);
+    ABTI_CHECK_NULL_SEM_PTR(p_sem);
+
+    if (num != 0 && !ABTI_sem_try_acquire(p_sem, num))
+        abt_errno = ABT_ERR_SEM_UNAVAILABLE;
+
+fn_exit:
+    return abt_errno;
+
+fn_fail:
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
+}
+
+/**
+ * @ingroup SEM
+ * @brief   Acquire permits from the semaphore with a timeout.
+ *
+ * \c ABT_sem_timedacquire() works as \c ABT_sem_acquire() except that it gives
+ * up waiting when the absolute time specified by \c abstime passes.  In that
+ * case, no permit is taken and \c ABT_ERR_SEM_TIMEDOUT is returned.  A waiting
+ * ULT yields repeatedly instead of being suspended.
+ *
+ * @param[in] sem      handle to the semaphore
+ * @param[in] num      number of permits
+ * @param[in] abstime  absolute time for timeout
+ * @return Error code
+ * @retval ABT_SUCCESS           on success
+ * @retval ABT_ERR_SEM_TIMEDOUT  timeout
+ * @retval ABT_ERR_SEM           the caller is a tasklet and has to wait
+ */
+int ABT_sem_timedacquire(ABT_sem sem, uint32_t num,
+                         const struct timespec *abstime)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_xstream *p_local_xstream = ABTI_local_get_xstream();
+    ABTI_sem *p_sem = ABTI_sem_get_ptr(sem);
+    ABTI_CHECK_NULL_SEM_PTR(p_sem);
+
+    if (num == 0 || ABTI_sem_try_acquire(p_sem, num))
+        goto fn_exit;
+
+    double tar_time = ((double)abstime->tv_sec) + 1.0e-9 * abstime->tv_nsec;
+    abt_errno = sem_wait(&p_local_xstream, p_sem, num, ABT_TRUE, tar_time);
+    if (abt_errno == ABT_ERR_SEM_TIMEDOUT)
+        goto fn_exit;
+    ABTI_CHECK_ERROR(abt_errno);
+
+fn_exit:
+    return abt_errno;
+
+fn_fail:
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
+}
+
+/**
+ * @ingroup SEM
+ * @brief   Release permits to the semaphore.
+ *
+ * \c ABT_sem_release() returns \c num permits to the semaphore \c sem.  The
+ * permits are handed to waiters in FIFO order as long as the first waiter can
+ * be satisfied.
+ *
+ * @param[in] sem  handle to the semaphore
+ * @param[in] num  number of permits
+ * @return Error code
+ * @retval ABT_SUCCESS on success
+ * @retval ABT_ERR_SEM the number of permits would overflow
+ */
+int ABT_sem_release(ABT_sem sem, uint32_t num)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_sem *p_sem = ABTI_sem_get_ptr(sem);
+    ABTI_CHECK_NULL_SEM_PTR(p_sem);
+
+    uint32_t count = ABTD_atomic_relaxed_load_uint32(&p_sem->count);
+    while (1) {
+        ABTI_CHECK_TRUE(count <= UINT32_MAX - num, ABT_ERR_SEM);
+        uint32_t old = ABTD_atomic_val_cas_strong_uint32(&p_sem->count, count,
+                                                         count + num);
+        if (old == count)
+            break;
+        count = old;
+    }
+
+    /* A waiter increments num_waiters before checking count, so either it
+     * takes the released permits or it is found here. */
+    if (ABTD_atomic_acquire_load_uint32(&p_sem->num_waiters) != 0) {
+        ABTI_spinlock_acquire(&p_sem->lock);
+        sem_grant(ABTI_local_get_xstream(), p_sem);
+        ABTI_spinlock_release(&p_sem->lock);
+    }
+
+fn_exit:
+    return abt_errno;
+
+fn_fail:
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
+}
+
+/**
+ * @ingroup SEM
+ * @brief   Get the number of available permits of the semaphore.
+ *
+ * \c ABT_sem_get_value() returns the number of permits that the semaphore
+ * \c sem currently holds through \c value.  The value may be changed by other
+ * callers at any time.
+ *
+ * @param[in]  sem    handle to the semaphore
+ * @param[out] value  number of available permits
+ * @return Error code
+ * @retval ABT_SUCCESS on success
+ */
+int ABT_sem_get_value(ABT_sem sem, uint32_t *value)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_sem *p_sem = ABTI_sem_get_ptr(sem);
+    ABTI_CHECK_NULL_SEM_PTR(p_sem);
+
+    *value = ABTD_atomic_acquire_load_uint32(&p_sem->count);
+
+fn_exit:
+    return abt_errno;
+
+fn_fail:
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
+}
+
+/*****************************************************************************/
+/* Internal static functions                                                 */
+/*****************************************************************************/
+
+/* Queue the caller and wait until num permits are handed to it.  If is_timed
+ * is ABT_TRUE, the caller gives up at tar_time and ABT_ERR_SEM_TIMEDOUT is
+ * returned. */
+static int sem_wait(ABTI_xstream **pp_local_xstream, ABTI_sem *p_sem,
+                    uint32_t num, ABT_bool is_timed, double tar_time)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_xstream *p_local_xstream = *pp_local_xstream;
+    ABTI_thread *p_thread;
+    ABTI_sem_waiter *p_waiter, ext_node;
+    ABTI_ext_waiter ext_waiter;
+
+    if (p_local_xstream != NULL) {
+        ABTI_unit *p_self = p_local_xstream->p_unit;
+        ABTI_CHECK_TRUE(ABTI_unit_type_is_thread(p_self->type), ABT_ERR_SEM);
+        p_thread = ABTI_unit_get_thread(p_self);
+        /* The node is not placed on the stack of the ULT since releasers
+         * access it while the ULT is suspended, when the stack of a
+         * stack-copying ULT is used by another ULT. */
+        ABTI_STATIC_ASSERT(sizeof(ABTI_sem_waiter) <= ABTI_MEM_POOL_DESC_SIZE);
+        p_waiter = (ABTI_sem_waiter *)ABTI_mem_alloc_desc(p_local_xstream);
+        ABTI_CHECK_TRUE(p_waiter != NULL, ABT_ERR_MEM);
+        /* A ULT with a timeout polls granted. */
+        p_waiter->p_unit = is_timed ? NULL : &p_thread->unit_def;
+    } else {
+        /* external thread */
+        p_thread = NULL;
+        ABTI_ext_waiter_init(&ext_waiter);
+        p_waiter = &ext_node;
+        p_waiter->p_unit = &ext_waiter.unit;
+    }
+    p_waiter->p_next = NULL;
+    p_waiter->num = num;
+    ABTD_atomic_relaxed_store_int(&p_waiter->granted, ABT_FALSE);
+
+    ABTI_spinlock_acquire(&p_sem->lock);
+    ABTD_atomic_fetch_add_uint32(&p_sem->num_waiters, 1);
+    if (p_sem->p_head == NULL && ABTI_sem_take(p_sem, num)) {
+        /* The permits have been released in the meantime. */
+        ABTD_atomic_fetch_sub_uint32(&p_sem->num_waiters, 1);
+        ABTI_spinlock_release(&p_sem->lock);
+        goto fn_free;
+    }
+    if (p_sem->p_tail) {
+        p_sem->p_tail->p_next = p_waiter;
+    } else {
+        p_sem->p_head = p_waiter;
+    }
+    p_sem->p_tail = p_waiter;
+    if (p_thread && !is_timed)
+        ABTI_thread_set_blocked(p_thread);
+    ABTI_spinlock_release(&p_sem->lock);
+
+    if (!is_timed) {
+        if (p_thread) {
+            ABTI_thread_suspend(pp_local_xstream, p_thread,
+                                ABT_SYNC_EVENT_TYPE_SEM, (void *)p_sem);
+        } else {
+            /* External thread is waiting here. */
+            ABTI_ext_waiter_wait(&ext_waiter);
+        }
+    } else {
+        ABT_bool is_granted;
+        if (p_thread) {
+            while (!(is_granted =
+                         ABTD_atomic_acquire_load_int(&p_waiter->granted))) {
+                if (ABTI_get_wtime() >= tar_time)
+                    break;
+                ABTI_thread_yield(pp_local_xstream, p_thread,
+                                  ABT_SYNC_EVENT_TYPE_SEM, (void *)p_sem);
+            }
+        } else {
+            is_granted = ABTI_ext_waiter_timedwait(&ext_waiter, tar_time);
+        }
+        if (!is_granted &&
+            !sem_remove_waiter(*pp_local_xstream, p_sem, p_waiter))
+            abt_errno = ABT_ERR_SEM_TIMEDOUT;
+    }
+
+fn_free:
+    if (p_thread)
+        ABTI_mem_free_desc(*pp_local_xstream, p_waiter);
+
+fn_exit:
+    return abt_errno;
+
+fn_fail:
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
+}
+
+/* Hand available permits to waiters in FIFO order until the first waiter
+ * cannot be satisfied.  The caller must hold the lock. */
+static void sem_grant(ABTI_xstream *p_local_xstream, ABTI_sem *p_sem)
+{
+    ABTI_sem_waiter *p_waiter;
+    while ((p_waiter = p_sem->p_head) != NULL &&
+           ABTI_sem_take(p_sem, p_waiter->num)) {
+        ABTI_unit *p_unit = p_waiter->p_unit;
+        p_sem->p_head = p_waiter->p_next;
+        if (p_sem->p_head == NULL)
+            p_sem->p_tail = NULL;
+        ABTD_atomic_fetch_sub_uint32(&p_sem->num_waiters, 1);
+
+        /* A polling ULT may free p_waiter as soon as granted is set. */
+        ABTD_atomic_release_store_int(&p_waiter->granted, ABT_TRUE);
+        if (p_unit == NULL) {
+            continue;
+        } else if (p_unit->type == ABTI_UNIT_TYPE_EXT) {
+            ABTI_ext_waiter_signal(ABTI_ext_waiter_get_ptr(p_unit));
+        } else {
+            ABTI_thread_set_ready(p_local_xstream,
+                                  ABTI_unit_get_thread(p_unit));
+        }
+    }
+}
+
+/* Take a timed-out waiter out of the queue.  Returns ABT_TRUE if the permits
+ * have been handed to it in the meantime. */
+static ABT_bool sem_remove_waiter(ABTI_xstream *p_local_xstream,
+                                  ABTI_sem *p_sem, ABTI_sem_waiter *p_waiter)
+{
+    ABTI_spinlock_acquire(&p_sem->lock);
+    if (ABTD_atomic_acquire_load_int(&p_waiter->granted)) {
+        ABTI_spinlock_release(&p_sem->lock);
+        return ABT_TRUE;
+    }
+
+    ABTI_sem_waiter *p_prev = NULL, *p_cur = p_sem->p_head;
+    while (p_cur != p_waiter) {
+        p_prev = p_cur;
+        p_cur = p_cur->p_next;
+    }
+    if (p_prev) {
+        p_prev->p_next = p_waiter->p_next;
+    } else {
+        p_sem->p_head = p_waiter->p_next;
+    }
+    if (p_sem->p_tail == p_waiter)
+        p_sem->p_tail = p_prev;
+    ABTD_atomic_fetch_sub_uint32(&p_sem->num_waiters, 1);
+
+    /* The following waiters may be satisfied if p_waiter was the first. */
+    if (p_prev == NULL)
+        sem_grant(p_local_xstream, p_sem);
+    ABTI_spinlock_release(&p_sem->lock);
+    return ABT_FALSE;
+}
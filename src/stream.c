@@ -77,7 +77,14 @@ int ABTI_xstream_create(ABTI_sched *p_sched, ABTI_xstream **pp_xstream)
     ABTD_atomic_relaxed_store_uint32(&p_newxstream->request, 0);
     p_newxstream->p_req_arg = NULL;
     p_newxstream->p_unit = NULL;
+    p_newxstream->thread_id_next = 0;
+    p_newxstream->thread_id_end = 0;
+    p_newxstream->task_id_next = 0;
+    p_newxstream->task_id_end = 0;
     ABTI_mem_init_local(p_newxstream);
+#ifdef ABT_CONFIG_USE_FCONTEXT
+    p_newxstream->p_copy_stack = NULL;
+#endif
 
     /* Set the main scheduler */
     abt_errno = ABTI_xstream_init_main_sched(p_newxstream, p_sched);
@@ -218,7 +225,14 @@ int ABT_xstream_create_with_rank(ABT_sched sched, int rank,
     ABTD_atomic_relaxed_store_uint32(&p_newxstream->request, 0);
     p_newxstream->p_req_arg = NULL;
     p_newxstream->p_unit = NULL;
+    p_newxstream->thread_id_next = 0;
+    p_newxstream->thread_id_end = 0;
+    p_newxstream->task_id_next = 0;
+    p_newxstream->task_id_end = 0;
     ABTI_mem_init_local(p_newxstream);
+#ifdef ABT_CONFIG_USE_FCONTEXT
+    p_newxstream->p_copy_stack = NULL;
+#endif
 
     /* Set the main scheduler */
     abt_errno = ABTI_xstream_init_main_sched(p_newxstream, p_sched);
@@ -1326,6 +1340,10 @@ int ABTI_xstream_free(ABTI_xstream *p_local_xstream, ABTI_xstream *p_xstream)
 
     /* Clean up memory pool. */
     ABTI_mem_finalize_local(p_xstream);
+#ifdef ABT_CONFIG_USE_FCONTEXT
+    /* Suspended ULTs might still use the shared stack, so it is not freed. */
+    ABTI_copy_stack_detach(p_xstream);
+#endif
     /* Return rank for reuse. rank must be returned prior to other free
      * functions so that other xstreams cannot refer to this xstream via
      * global->p_xstreams. */
@@ -1442,6 +1460,16 @@ int ABTI_xstream_schedule_thread(ABTI_xstream **pp_local_xstream,
     }
 #endif
 
+#ifdef ABT_CONFIG_USE_FCONTEXT
+    if (ABTI_thread_is_stack_copy(p_thread) &&
+        !ABTI_copy_stack_acquire(p_local_xstream, p_thread)) {
+        /* Another ULT is using the shared stack.  Try it later. */
+        ABTI_POOL_ADD_THREAD(p_thread,
+                             ABTI_self_get_native_thread_id(p_local_xstream));
+        goto fn_exit;
+    }
+#endif
+
     /* Change the last ES */
     p_thread->unit_def.p_last_xstream = p_local_xstream;
 
@@ -1470,6 +1498,14 @@ int ABTI_xstream_schedule_thread(ABTI_xstream **pp_local_xstream,
      * be delayed. */
     uint32_t request =
         ABTD_atomic_acquire_load_uint32(&p_thread->unit_def.request);
+#ifdef ABT_CONFIG_USE_FCONTEXT
+    /* The shared stack must be saved before p_thread becomes runnable. */
+    if (ABTI_thread_is_stack_copy(p_thread)) {
+        ABTI_copy_stack_release(p_thread, (request & ABTI_UNIT_REQ_STOP)
+                                              ? ABT_TRUE
+                                              : ABT_FALSE);
+    }
+#endif
     if (request & ABTI_UNIT_REQ_STOP) {
         /* The ULT has completed its execution or it called the exit request. */
         LOG_DEBUG("[U%" PRIu64 ":E%d] %s\n", ABTI_thread_get_id(p_thread),
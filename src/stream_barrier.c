@@ -14,7 +14,6 @@ typedef struct {
     ABTD_xstream_barrier bar;
 } ABTI_xstream_barrier;
 
-#ifdef HAVE_PTHREAD_BARRIER_INIT
 static inline ABTI_xstream_barrier *
 ABTI_xstream_barrier_get_ptr(ABT_xstream_barrier barrier)
 {
@@ -46,7 +45,6 @@ ABTI_xstream_barrier_get_handle(ABTI_xstream_barrier *p_barrier)
     return (ABT_xstream_barrier)p_barrier;
 #endif
 }
-#endif
 
 /**
  * @ingroup ES_BARRIER
@@ -65,7 +63,6 @@ ABTI_xstream_barrier_get_handle(ABTI_xstream_barrier *p_barrier)
 int ABT_xstream_barrier_create(uint32_t num_waiters,
                                ABT_xstream_barrier *newbarrier)
 {
-#ifdef HAVE_PTHREAD_BARRIER_INIT
     int abt_errno = ABT_SUCCESS;
     ABTI_xstream_barrier *p_newbarrier;
 
@@ -73,8 +70,18 @@ int ABT_xstream_barrier_create(uint32_t num_waiters,
         (ABTI_xstream_barrier *)ABTU_malloc(sizeof(ABTI_xstream_barrier));
 
     p_newbarrier->num_waiters = num_waiters;
-    abt_errno = ABTD_xstream_barrier_init(num_waiters, &p_newbarrier->bar);
-    ABTI_CHECK_ERROR(abt_errno);
+    /* If there are more waiters than cores, spinning only delays the waiters
+     * that are not running. */
+    uint32_t num_spins = (num_waiters <= (uint32_t)gp_ABTI_global->num_cores)
+                             ? gp_ABTI_global->xstream_barrier_spins
+                             : 0;
+    abt_errno = ABTD_xstream_barrier_init(num_waiters,
+                                          gp_ABTI_global->xstream_barrier_radix,
+                                          num_spins, &p_newbarrier->bar);
+    if (abt_errno != ABT_SUCCESS) {
+        ABTU_free(p_newbarrier);
+        goto fn_fail;
+    }
 
     /* Return value */
     *newbarrier = ABTI_xstream_barrier_get_handle(p_newbarrier);
@@ -85,9 +92,6 @@ fn_exit:
 fn_fail:
     HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
     goto fn_exit;
-#else
-    return ABT_ERR_FEATURE_NA;
-#endif
 }
 
 /**
@@ -104,15 +108,12 @@ fn_fail:
  */
 int ABT_xstream_barrier_free(ABT_xstream_barrier *barrier)
 {
-#ifdef HAVE_PTHREAD_BARRIER_INIT
     int abt_errno = ABT_SUCCESS;
     ABT_xstream_barrier h_barrier = *barrier;
     ABTI_xstream_barrier *p_barrier = ABTI_xstream_barrier_get_ptr(h_barrier);
     ABTI_CHECK_NULL_XSTREAM_BARRIER_PTR(p_barrier);
 
-    abt_errno = ABTD_xstream_barrier_destroy(&p_barrier->bar);
-    ABTI_CHECK_ERROR(abt_errno);
-
+    ABTD_xstream_barrier_destroy(&p_barrier->bar);
     ABTU_free(p_barrier);
 
     /* Return value */
@@ -124,9 +125,6 @@ fn_exit:
 fn_fail:
     HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
     goto fn_exit;
-#else
-    return ABT_ERR_FEATURE_NA;
-#endif
 }
 
 /**
@@ -134,7 +132,10 @@ fn_fail:
  * @brief   Wait on the barrier.
  *
  * The work unit calling \c ABT_xstream_barrier_wait() waits on the barrier and
- * blocks the entire ES until all the participants reach the barrier.
+ * blocks the entire ES until all the participants reach the barrier.  A
+ * waiter spins for a while before it sleeps, so that a short phase does not
+ * involve the OS.  The spin count and the arity of the arrival tree can be
+ * set by \c ABT_XSTREAM_BARRIER_SPINS and \c ABT_XSTREAM_BARRIER_RADIX.
  *
  * @param[in] barrier  handle to the ES barrier
  * @return Error code
@@ -142,13 +143,15 @@ fn_fail:
  */
 int ABT_xstream_barrier_wait(ABT_xstream_barrier barrier)
 {
-#ifdef HAVE_PTHREAD_BARRIER_INIT
     int abt_errno = ABT_SUCCESS;
     ABTI_xstream_barrier *p_barrier = ABTI_xstream_barrier_get_ptr(barrier);
     ABTI_CHECK_NULL_XSTREAM_BARRIER_PTR(p_barrier);
 
     if (p_barrier->num_waiters > 1) {
-        ABTD_xstream_barrier_wait(&p_barrier->bar);
+        /* ESs with neighboring ranks arrive at the same node first. */
+        ABTI_xstream *p_local_xstream = ABTI_local_get_xstream();
+        int hint = p_local_xstream ? p_local_xstream->rank : 0;
+        ABTD_xstream_barrier_wait(&p_barrier->bar, hint);
     }
 
 fn_exit:
@@ -157,7 +160,4 @@ fn_exit:
 fn_fail:
     HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
     goto fn_exit;
-#else
-    return ABT_ERR_FEATURE_NA;
-#endif
 }
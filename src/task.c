@@ -5,13 +5,13 @@
 
 #include "abti.h"
 
-static int ABTI_task_create(ABTI_xstream *p_local_xstream, ABTI_pool *p_pool,
-                            void (*task_func)(void *), void *arg,
-                            ABTI_sched *p_sched, int refcount,
-                            ABTI_task **pp_newtask);
 static int ABTI_task_revive(ABTI_xstream *p_local_xstream, ABTI_pool *p_pool,
                             void (*task_func)(void *), void *arg,
                             ABTI_task *p_task);
+static int ABTI_task_create_many(ABTI_xstream *p_local_xstream, int num,
+                                 ABTI_pool **pp_pools,
+                                 void (**task_func_list)(void *),
+                                 void **arg_list, ABT_task *newtask_list);
 static inline uint64_t ABTI_task_get_new_id(void);
 
 /** @defgroup TASK Tasklet
@@ -51,8 +51,8 @@ int ABT_task_create(ABT_pool pool, void (*task_func)(void *), void *arg,
     ABTI_CHECK_NULL_POOL_PTR(p_pool);
 
     int refcount = (newtask != NULL) ? 1 : 0;
-    abt_errno = ABTI_task_create(p_local_xstream, p_pool, task_func, arg, NULL,
-                                 refcount, &p_newtask);
+    abt_errno = ABTI_task_create(p_local_xstream, p_pool, task_func, arg, 0,
+                                 NULL, NULL, NULL, refcount, &p_newtask);
     ABTI_CHECK_ERROR(abt_errno);
 
     /* Return value */
@@ -114,8 +114,123 @@ int ABT_task_create_on_xstream(ABT_xstream xstream, void (*task_func)(void *),
     /* TODO: need to consider the access type of target pool */
     ABTI_pool *p_pool = ABTI_xstream_get_main_pool(p_xstream);
     int refcount = (newtask != NULL) ? 1 : 0;
-    abt_errno = ABTI_task_create(p_local_xstream, p_pool, task_func, arg, NULL,
-                                 refcount, &p_newtask);
+    abt_errno = ABTI_task_create(p_local_xstream, p_pool, task_func, arg, 0,
+                                 NULL, NULL, NULL, refcount, &p_newtask);
+    ABTI_CHECK_ERROR(abt_errno);
+
+    /* Return value */
+    if (newtask)
+        *newtask = ABTI_task_get_handle(p_newtask);
+
+fn_exit:
+    return abt_errno;
+
+fn_fail:
+    if (newtask)
+        *newtask = ABT_TASK_NULL;
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
+}
+
+/**
+ * @ingroup TASK
+ * @brief   Create a new tasklet with a copy of its argument data.
+ *
+ * \c ABT_task_create_with_payload() works like \c ABT_task_create(), but
+ * \c size bytes pointed to by \c payload are copied to memory owned by the
+ * new tasklet, and \c task_func receives a pointer to the copy.  The copy is
+ * placed in the spare area of the tasklet descriptor if it fits, so the caller
+ * does not need to allocate and free an argument structure for each tasklet.
+ * The copy is aligned as \c malloc() memory and is valid until the tasklet is
+ * freed.  \c payload can be reused as soon as this routine returns.
+ *
+ * \c size must not be larger than \c ABT_PAYLOAD_MAX_SIZE.  If \c size is
+ * zero, \c task_func receives \c NULL.
+ *
+ * @param[in]  pool       handle to the associated pool
+ * @param[in]  task_func  function to be executed by a new tasklet
+ * @param[in]  payload    argument data for task_func
+ * @param[in]  size       size of the argument data in bytes
+ * @param[out] newtask    handle to a newly created tasklet
+ * @return Error code
+ * @retval ABT_SUCCESS   on success
+ * @retval ABT_ERR_OTHER \c size is larger than \c ABT_PAYLOAD_MAX_SIZE
+ */
+int ABT_task_create_with_payload(ABT_pool pool, void (*task_func)(void *),
+                                 const void *payload, size_t size,
+                                 ABT_task *newtask)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_xstream *p_local_xstream = ABTI_local_get_xstream();
+    ABTI_task *p_newtask;
+    ABTI_pool *p_pool = ABTI_pool_get_ptr(pool);
+    ABTI_CHECK_NULL_POOL_PTR(p_pool);
+    if (size > ABT_PAYLOAD_MAX_SIZE) {
+        abt_errno = ABT_ERR_OTHER;
+        goto fn_fail;
+    }
+
+    /* An empty payload is not copied, so task_func receives NULL. */
+    void *arg = size ? (void *)payload : NULL;
+    int refcount = (newtask != NULL) ? 1 : 0;
+    abt_errno = ABTI_task_create(p_local_xstream, p_pool, task_func, arg, size,
+                                 NULL, NULL, NULL, refcount, &p_newtask);
+    ABTI_CHECK_ERROR(abt_errno);
+
+    /* Return value */
+    if (newtask)
+        *newtask = ABTI_task_get_handle(p_newtask);
+
+fn_exit:
+    return abt_errno;
+
+fn_fail:
+    if (newtask)
+        *newtask = ABT_TASK_NULL;
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
+}
+
+/**
+ * @ingroup TASK
+ * @brief   Create a new tasklet with a completion callback.
+ *
+ * \c ABT_task_create_with_callback() works like \c ABT_task_create(), but
+ * \c cb_func is called with the handle of the new tasklet and \c cb_arg when
+ * the tasklet terminates.  \c cb_func is called on the ES that has run the
+ * tasklet, right after \c task_func returns (or the tasklet is canceled) and
+ * before the tasklet is regarded as terminated, so a joiner of the tasklet
+ * returns after \c cb_func returns.  \c cb_func may create work units, but it
+ * must not block or yield.
+ *
+ * If \c newtask is \c NULL, the unnamed tasklet is freed automatically after
+ * \c cb_func returns.  The handle given to \c cb_func is valid only until
+ * \c cb_func returns in this case.  A revived tasklet keeps its completion
+ * callback.  See also \c ABT_thread_attr_set_completion_callback().
+ *
+ * @param[in]  pool       handle to the associated pool
+ * @param[in]  task_func  function to be executed by a new tasklet
+ * @param[in]  arg        argument for task_func
+ * @param[in]  cb_func    completion callback function pointer
+ * @param[in]  cb_arg     argument for the callback function
+ * @param[out] newtask    handle to a newly created tasklet
+ * @return Error code
+ * @retval ABT_SUCCESS on success
+ */
+int ABT_task_create_with_callback(ABT_pool pool, void (*task_func)(void *),
+                                  void *arg,
+                                  void (*cb_func)(ABT_task task, void *cb_arg),
+                                  void *cb_arg, ABT_task *newtask)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_xstream *p_local_xstream = ABTI_local_get_xstream();
+    ABTI_task *p_newtask;
+    ABTI_pool *p_pool = ABTI_pool_get_ptr(pool);
+    ABTI_CHECK_NULL_POOL_PTR(p_pool);
+
+    int refcount = (newtask != NULL) ? 1 : 0;
+    abt_errno = ABTI_task_create(p_local_xstream, p_pool, task_func, arg, 0,
+                                 cb_func, cb_arg, NULL, refcount, &p_newtask);
     ABTI_CHECK_ERROR(abt_errno);
 
     /* Return value */
@@ -132,6 +247,65 @@ fn_fail:
     goto fn_exit;
 }
 
+/**
+ * @ingroup TASK
+ * @brief   Create a set of tasklets.
+ *
+ * \c ABT_task_create_many() creates \c num tasklets and returns their handles
+ * to \c newtask_list.  The \a i-th tasklet executes the \a i-th function of
+ * \c task_func_list with the \a i-th argument of \c arg_list and is pushed to
+ * the \a i-th pool of \c pool_list.  If \c arg_list is \c NULL, \c NULL is
+ * passed to all the tasklet functions.  When \c newtask_list is \c NULL,
+ * unnamed tasklets are created.
+ *
+ * The descriptors of all the tasklets are allocated at once, and the tasklets
+ * that share the same pool are pushed to it in a batch, which is cheaper than
+ * calling \c ABT_task_create() \c num times.  Either all or none of the
+ * tasklets are created; if this routine fails, no tasklet has been pushed and
+ * all the elements of \c newtask_list are set to \c ABT_TASK_NULL.
+ *
+ * @param[in]  num             the number of array elements
+ * @param[in]  pool_list       array of pool handles
+ * @param[in]  task_func_list  array of tasklet functions
+ * @param[in]  arg_list        array of arguments for each tasklet function
+ * @param[out] newtask_list    array of newly created tasklet handles
+ * @return Error code
+ * @retval ABT_SUCCESS on success
+ */
+int ABT_task_create_many(int num, ABT_pool *pool_list,
+                         void (**task_func_list)(void *), void **arg_list,
+                         ABT_task *newtask_list)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_xstream *p_local_xstream = ABTI_local_get_xstream();
+    ABTI_pool **pp_pools = NULL;
+    int i;
+
+    if (num <= 0)
+        goto fn_exit;
+
+    pp_pools = (ABTI_pool **)ABTU_malloc(num * sizeof(ABTI_pool *));
+    for (i = 0; i < num; i++) {
+        pp_pools[i] = ABTI_pool_get_ptr(pool_list[i]);
+        ABTI_CHECK_NULL_POOL_PTR(pp_pools[i]);
+    }
+    abt_errno = ABTI_task_create_many(p_local_xstream, num, pp_pools,
+                                      task_func_list, arg_list, newtask_list);
+    ABTI_CHECK_ERROR(abt_errno);
+
+fn_exit:
+    ABTU_free(pp_pools);
+    return abt_errno;
+
+fn_fail:
+    if (newtask_list) {
+        for (i = 0; i < num; i++)
+            newtask_list[i] = ABT_TASK_NULL;
+    }
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
+}
+
 /**
  * @ingroup TASK
  * @brief   Revive the tasklet.
@@ -200,8 +374,8 @@ int ABT_task_free(ABT_task *task)
            ABTI_UNIT_STATE_TERMINATED) {
 #ifndef ABT_CONFIG_DISABLE_EXT_THREAD
         if (!ABTI_unit_type_is_thread(ABTI_self_get_type(p_local_xstream))) {
-            ABTD_atomic_pause();
-            continue;
+            ABTI_ext_waiter_join(&p_task->unit_def);
+            break;
         }
 #endif
         ABTI_thread_yield(&p_local_xstream,
@@ -249,8 +423,8 @@ int ABT_task_join(ABT_task task)
            ABTI_UNIT_STATE_TERMINATED) {
 #ifndef ABT_CONFIG_DISABLE_EXT_THREAD
         if (!ABTI_unit_type_is_thread(ABTI_self_get_type(p_local_xstream))) {
-            ABTD_atomic_pause();
-            continue;
+            ABTI_ext_waiter_join(&p_task->unit_def);
+            break;
         }
 #endif
         ABTI_thread_yield(&p_local_xstream,
@@ -757,18 +931,43 @@ fn_fail:
 /* Private APIs                                                              */
 /*****************************************************************************/
 
-static int ABTI_task_create(ABTI_xstream *p_local_xstream, ABTI_pool *p_pool,
-                            void (*task_func)(void *), void *arg,
-                            ABTI_sched *p_sched, int refcount,
-                            ABTI_task **pp_newtask)
+/* Initialize a newly allocated tasklet descriptor.  If it fails, everything
+ * but the descriptor itself has been released. */
+static inline int ABTI_task_init(ABTI_xstream *p_local_xstream,
+                                 ABTI_task *p_newtask, ABTI_pool *p_pool,
+                                 void (*task_func)(void *), void *arg,
+                                 size_t payload_size,
+                                 void (*cb_func)(ABT_task, void *),
+                                 void *cb_arg, int refcount)
 {
-    int abt_errno = ABT_SUCCESS;
-    ABTI_task *p_newtask;
-    ABT_task h_newtask;
-    ABTI_CHECK_NULL_POOL_PTR(p_pool);
-
-    /* Allocate a task object */
-    p_newtask = ABTI_mem_alloc_task(p_local_xstream);
+    /* If payload_size is not zero, arg points to the argument data, which is
+     * copied to the descriptor. */
+    p_newtask->unit_def.p_payload = NULL;
+    if (payload_size) {
+        size_t spare_size;
+        void *p_spare = ABTI_mem_get_task_spare(p_newtask, &spare_size);
+        arg = ABTI_mem_alloc_payload(p_local_xstream, p_spare, spare_size, arg,
+                                     payload_size);
+        if (ABTU_unlikely(!arg))
+            return ABT_ERR_MEM;
+        p_newtask->unit_def.p_payload = arg;
+    }
+    p_newtask->unit_def.p_completion = NULL;
+    if (cb_func) {
+        ABTI_unit_completion *p_completion =
+            ABTI_mem_alloc_completion(p_local_xstream);
+        if (ABTU_unlikely(!p_completion)) {
+            size_t spare_size;
+            void *p_spare = ABTI_mem_get_task_spare(p_newtask, &spare_size);
+            ABTI_mem_free_payload(p_local_xstream,
+                                  p_newtask->unit_def.p_payload, p_spare);
+            return ABT_ERR_MEM;
+        }
+        p_completion->f_thread_cb = NULL;
+        p_completion->f_task_cb = cb_func;
+        p_completion->p_cb_arg = cb_arg;
+        p_newtask->unit_def.p_completion = p_completion;
+    }
 
     p_newtask->unit_def.p_last_xstream = NULL;
     p_newtask->unit_def.p_parent = NULL;
@@ -784,12 +983,50 @@ static int ABTI_task_create(ABTI_xstream *p_local_xstream, ABTI_pool *p_pool,
     p_newtask->unit_def.migratable = ABT_TRUE;
 #endif
     p_newtask->unit_def.id = ABTI_TASK_INIT_ID;
+    p_newtask->unit_def.type = ABTI_UNIT_TYPE_TASK;
+    return ABT_SUCCESS;
+}
+
+/* Release what ABTI_task_init() has set up except for the descriptor. */
+static inline void ABTI_task_fini(ABTI_xstream *p_local_xstream,
+                                  ABTI_task *p_task)
+{
+    /* Free the payload */
+    size_t spare_size;
+    void *p_spare = ABTI_mem_get_task_spare(p_task, &spare_size);
+    ABTI_mem_free_payload(p_local_xstream, p_task->unit_def.p_payload, p_spare);
+
+    /* Free the completion callback */
+    ABTI_mem_free_completion(p_local_xstream, p_task->unit_def.p_completion);
+}
+
+int ABTI_task_create(ABTI_xstream *p_local_xstream, ABTI_pool *p_pool,
+                     void (*task_func)(void *), void *arg, size_t payload_size,
+                     void (*cb_func)(ABT_task, void *), void *cb_arg,
+                     ABTI_sched *p_sched, int refcount, ABTI_task **pp_newtask)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_task *p_newtask;
+    ABT_task h_newtask;
+    ABTI_CHECK_NULL_POOL_PTR(p_pool);
+
+    /* Allocate a task object */
+    p_newtask = ABTI_mem_alloc_task(p_local_xstream);
+    if (ABTU_unlikely(!p_newtask)) {
+        /* The reserved memory has been exhausted (see ABT_reserve()). */
+        abt_errno = ABT_ERR_MEM;
+        goto fn_fail;
+    }
+    abt_errno = ABTI_task_init(p_local_xstream, p_newtask, p_pool, task_func,
+                               arg, payload_size, cb_func, cb_arg, refcount);
+    if (ABTU_unlikely(abt_errno != ABT_SUCCESS)) {
+        ABTI_mem_free_task(p_local_xstream, p_newtask);
+        goto fn_fail;
+    }
 
     /* Create a wrapper work unit */
     h_newtask = ABTI_task_get_handle(p_newtask);
-    p_newtask->unit_def.type = ABTI_UNIT_TYPE_TASK;
     p_newtask->unit_def.unit = p_pool->u_create_from_task(h_newtask);
-
     ABTI_tool_event_task_create(p_local_xstream, p_newtask,
                                 p_local_xstream ? p_local_xstream->p_unit
                                                 : NULL,
@@ -819,6 +1056,97 @@ fn_fail:
     goto fn_exit;
 }
 
+/* Create num tasklets at once.  Their descriptors are taken from the memory
+ * pool in one go and the tasklets are pushed to each pool in a batch.  Either
+ * all or none of the tasklets are created. */
+static int ABTI_task_create_many(ABTI_xstream *p_local_xstream, int num,
+                                 ABTI_pool **pp_pools,
+                                 void (**task_func_list)(void *),
+                                 void **arg_list, ABT_task *newtask_list)
+{
+    int abt_errno = ABT_SUCCESS;
+    int refcount = newtask_list ? 1 : 0;
+    int i, j, num_inits = 0;
+    ABT_bool is_allocated = ABT_FALSE;
+    ABTI_task **p_tasks;
+    ABT_unit *units, *batch;
+
+    p_tasks = (ABTI_task **)ABTU_malloc(num * sizeof(ABTI_task *));
+    units = (ABT_unit *)ABTU_malloc(num * 2 * sizeof(ABT_unit));
+    batch = units + num;
+
+    if (!ABTI_mem_alloc_task_many(p_local_xstream, num, p_tasks)) {
+        /* The reserved memory has been exhausted (see ABT_reserve()). */
+        abt_errno = ABT_ERR_MEM;
+        goto fn_fail;
+    }
+    is_allocated = ABT_TRUE;
+    for (i = 0; i < num; i++) {
+        void *arg = arg_list ? arg_list[i] : NULL;
+        abt_errno = ABTI_task_init(p_local_xstream, p_tasks[i], pp_pools[i],
+                                   task_func_list[i], arg, 0, NULL, NULL,
+                                   refcount);
+        if (ABTU_unlikely(abt_errno != ABT_SUCCESS))
+            goto fn_fail;
+        num_inits++;
+    }
+    ABTI_native_thread_id producer_id =
+        ABTI_self_get_native_thread_id(p_local_xstream);
+#ifndef ABT_CONFIG_DISABLE_POOL_PRODUCER_CHECK
+    /* Check the producer before any tasklet becomes visible to the others. */
+    for (i = 0; i < num; i++) {
+        abt_errno = ABTI_pool_set_producer(pp_pools[i], producer_id);
+        if (ABTU_unlikely(abt_errno != ABT_SUCCESS))
+            goto fn_fail;
+    }
+#endif
+
+    for (i = 0; i < num; i++) {
+        ABTI_task *p_newtask = p_tasks[i];
+        ABT_task h_newtask = ABTI_task_get_handle(p_newtask);
+        p_newtask->unit_def.unit = pp_pools[i]->u_create_from_task(h_newtask);
+        ABTI_tool_event_task_create(p_local_xstream, p_newtask,
+                                    p_local_xstream ? p_local_xstream->p_unit
+                                                    : NULL,
+                                    pp_pools[i]);
+        LOG_DEBUG("[T%" PRIu64 "] created\n", ABTI_task_get_id(p_newtask));
+        units[i] = p_newtask->unit_def.unit;
+        if (newtask_list)
+            newtask_list[i] = h_newtask;
+    }
+
+    /* Push the tasklets to each pool in a batch.  Unnamed tasklets may be
+     * freed as soon as they are pushed, so only their units are accessed. */
+    for (i = 0; i < num; i++) {
+        if (units[i] == ABT_UNIT_NULL)
+            continue;
+        size_t num_batch = 0;
+        for (j = i; j < num; j++) {
+            if (units[j] != ABT_UNIT_NULL && pp_pools[j] == pp_pools[i]) {
+                batch[num_batch++] = units[j];
+                units[j] = ABT_UNIT_NULL;
+            }
+        }
+        ABTI_pool_push_many(pp_pools[i], batch, num_batch, producer_id);
+    }
+
+fn_exit:
+    ABTU_free(p_tasks);
+    ABTU_free(units);
+    return abt_errno;
+
+fn_fail:
+    /* No tasklet has been pushed yet, so all of them can be released. */
+    if (is_allocated) {
+        for (i = 0; i < num_inits; i++)
+            ABTI_task_fini(p_local_xstream, p_tasks[i]);
+        for (i = 0; i < num; i++)
+            ABTI_mem_free_task(p_local_xstream, p_tasks[i]);
+    }
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
+}
+
 static int ABTI_task_revive(ABTI_xstream *p_local_xstream, ABTI_pool *p_pool,
                             void (*task_func)(void *), void *arg,
                             ABTI_task *p_task)
@@ -892,6 +1220,9 @@ void ABTI_task_free(ABTI_xstream *p_local_xstream, ABTI_task *p_task)
         ABTI_ktable_free(p_local_xstream, p_ktable);
     }
 
+    /* Free the payload and the completion callback */
+    ABTI_task_fini(p_local_xstream, p_task);
+
     ABTI_mem_free_task(p_local_xstream, p_task);
 }
 
@@ -965,11 +1296,30 @@ uint64_t ABTI_task_get_id(ABTI_task *p_task)
     return p_task->unit_def.id;
 }
 
+/* Called on the ES that ran p_task right after p_task terminates and before
+ * its state is set to TERMINATED. */
+void ABTI_task_run_completion_cb(ABTI_task *p_task)
+{
+    ABTI_unit_completion *p_completion = p_task->unit_def.p_completion;
+    p_completion->f_task_cb(ABTI_task_get_handle(p_task),
+                            p_completion->p_cb_arg);
+}
+
 /*****************************************************************************/
 /* Internal static functions                                                 */
 /*****************************************************************************/
 
 static inline ABT_unit_id ABTI_task_get_new_id(void)
 {
-    return ABTD_atomic_fetch_add_uint64(&g_task_id, 1);
+    /* See ABTI_thread_get_new_id(). */
+    ABTI_xstream *p_local_xstream = ABTI_local_get_xstream_uninlined();
+    if (p_local_xstream == NULL)
+        return ABTD_atomic_fetch_add_uint64(&g_task_id, 1);
+    if (p_local_xstream->task_id_next == p_local_xstream->task_id_end) {
+        p_local_xstream->task_id_next =
+            ABTD_atomic_fetch_add_uint64(&g_task_id, ABTI_UNIT_ID_BLOCK_SIZE);
+        p_local_xstream->task_id_end =
+            p_local_xstream->task_id_next + ABTI_UNIT_ID_BLOCK_SIZE;
+    }
+    return p_local_xstream->task_id_next++;
 }
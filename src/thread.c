@@ -8,10 +8,15 @@
 static inline int
 ABTI_thread_create_internal(ABTI_xstream *p_local_xstream, ABTI_pool *p_pool,
                             void (*thread_func)(void *), void *arg,
-                            ABTI_thread_attr *p_attr, ABTI_unit_type unit_type,
-                            ABTI_sched *p_sched, int refcount,
-                            ABTI_xstream *p_parent_xstream, ABT_bool push_pool,
-                            ABTI_thread **pp_newthread);
+                            size_t payload_size, ABTI_thread_attr *p_attr,
+                            ABTI_unit_type unit_type, ABTI_sched *p_sched,
+                            int refcount, ABTI_xstream *p_parent_xstream,
+                            ABT_bool push_pool, ABTI_thread **pp_newthread);
+static int ABTI_thread_create_many(ABTI_xstream *p_local_xstream, int num,
+                                   ABTI_pool **pp_pools,
+                                   void (**thread_func_list)(void *),
+                                   void **arg_list, ABTI_thread_attr *p_attr,
+                                   ABT_thread *newthread_list);
 static int ABTI_thread_revive(ABTI_xstream *p_local_xstream, ABTI_pool *p_pool,
                               void (*thread_func)(void *), void *arg,
                               ABTI_thread *p_thread);
@@ -63,12 +68,9 @@ int ABT_thread_create(ABT_pool pool, void (*thread_func)(void *), void *arg,
     ABTI_pool *p_pool = ABTI_pool_get_ptr(pool);
     ABTI_CHECK_NULL_POOL_PTR(p_pool);
 
-    int refcount = (newthread != NULL) ? 1 : 0;
-    abt_errno =
-        ABTI_thread_create_internal(p_local_xstream, p_pool, thread_func, arg,
-                                    ABTI_thread_attr_get_ptr(attr),
-                                    ABTI_UNIT_TYPE_THREAD_USER, NULL, refcount,
-                                    NULL, ABT_TRUE, &p_newthread);
+    abt_errno = ABTI_thread_create(p_local_xstream, p_pool, thread_func, arg,
+                                   ABTI_thread_attr_get_ptr(attr),
+                                   newthread ? &p_newthread : NULL);
 
     /* Return value */
     if (newthread)
@@ -137,9 +139,72 @@ int ABT_thread_create_on_xstream(ABT_xstream xstream,
 
     /* TODO: need to consider the access type of target pool */
     ABTI_pool *p_pool = ABTI_xstream_get_main_pool(p_xstream);
+    abt_errno = ABTI_thread_create(p_local_xstream, p_pool, thread_func, arg,
+                                   ABTI_thread_attr_get_ptr(attr),
+                                   newthread ? &p_newthread : NULL);
+    ABTI_CHECK_ERROR(abt_errno);
+
+    /* Return value */
+    if (newthread)
+        *newthread = ABTI_thread_get_handle(p_newthread);
+
+fn_exit:
+    return abt_errno;
+
+fn_fail:
+    if (newthread)
+        *newthread = ABT_THREAD_NULL;
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
+}
+
+/**
+ * @ingroup ULT
+ * @brief   Create a new ULT with a copy of its argument data.
+ *
+ * \c ABT_thread_create_with_payload() works like \c ABT_thread_create(), but
+ * \c size bytes pointed to by \c payload are copied to memory owned by the
+ * new ULT, and \c thread_func receives a pointer to the copy.  The copy is
+ * placed in the spare area of the ULT descriptor if it fits, so the caller
+ * does not need to allocate and free an argument structure for each ULT.  The
+ * copy is aligned as \c malloc() memory and is valid until the ULT is freed.
+ * \c payload can be reused as soon as this routine returns.
+ *
+ * \c size must not be larger than \c ABT_PAYLOAD_MAX_SIZE.  If \c size is
+ * zero, \c thread_func receives \c NULL.
+ *
+ * @param[in]  pool         handle to the associated pool
+ * @param[in]  thread_func  function to be executed by a new thread
+ * @param[in]  payload      argument data for thread_func
+ * @param[in]  size         size of the argument data in bytes
+ * @param[in]  attr         thread attribute. If it is ABT_THREAD_ATTR_NULL,
+ *                          the default attribute is used.
+ * @param[out] newthread    handle to a newly created thread
+ * @return Error code
+ * @retval ABT_SUCCESS   on success
+ * @retval ABT_ERR_OTHER \c size is larger than \c ABT_PAYLOAD_MAX_SIZE
+ */
+int ABT_thread_create_with_payload(ABT_pool pool, void (*thread_func)(void *),
+                                   const void *payload, size_t size,
+                                   ABT_thread_attr attr, ABT_thread *newthread)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_xstream *p_local_xstream = ABTI_local_get_xstream();
+    ABTI_thread *p_newthread;
+
+    ABTI_pool *p_pool = ABTI_pool_get_ptr(pool);
+    ABTI_CHECK_NULL_POOL_PTR(p_pool);
+    if (size > ABT_PAYLOAD_MAX_SIZE) {
+        abt_errno = ABT_ERR_OTHER;
+        goto fn_fail;
+    }
+
+    /* An empty payload is not copied, so thread_func receives NULL. */
+    void *arg = size ? (void *)payload : NULL;
     int refcount = (newthread != NULL) ? 1 : 0;
     abt_errno =
         ABTI_thread_create_internal(p_local_xstream, p_pool, thread_func, arg,
+                                    size,
                                     ABTI_thread_attr_get_ptr(attr),
                                     ABTI_UNIT_TYPE_THREAD_USER, NULL, refcount,
                                     NULL, ABT_TRUE, &p_newthread);
@@ -173,6 +238,12 @@ fn_fail:
  * user-provided stack, it will return an error. When \c newthread_list is NULL,
  * unnamed threads are created.
  *
+ * The descriptors and the stacks of all the ULTs are allocated at once, and
+ * the ULTs that share the same pool are pushed to it in a batch, which is
+ * cheaper than calling \c ABT_thread_create() \c num times.  Either all or
+ * none of the ULTs are created; if this routine fails, no ULT has been pushed
+ * and all the elements of \c newthread_list are set to \c ABT_THREAD_NULL.
+ *
  * @param[in] num               the number of array elements
  * @param[in] pool_list         array of pool handles
  * @param[in] thread_func_list  array of ULT functions
@@ -188,54 +259,37 @@ int ABT_thread_create_many(int num, ABT_pool *pool_list,
 {
     int abt_errno = ABT_SUCCESS;
     ABTI_xstream *p_local_xstream = ABTI_local_get_xstream();
+    ABTI_thread_attr *p_attr = ABTI_thread_attr_get_ptr(attr);
+    ABTI_pool **pp_pools = NULL;
     int i;
 
-    if (attr != ABT_THREAD_ATTR_NULL) {
-        if (ABTI_thread_attr_get_ptr(attr)->stacktype == ABTI_STACK_TYPE_USER) {
-            abt_errno = ABT_ERR_INV_THREAD_ATTR;
-            goto fn_fail;
-        }
+    if (p_attr && p_attr->stacktype == ABTI_STACK_TYPE_USER) {
+        abt_errno = ABT_ERR_INV_THREAD_ATTR;
+        goto fn_fail;
     }
+    if (num <= 0)
+        goto fn_exit;
 
-    if (newthread_list == NULL) {
-        for (i = 0; i < num; i++) {
-            ABT_pool pool = pool_list[i];
-            ABTI_pool *p_pool = ABTI_pool_get_ptr(pool);
-            ABTI_CHECK_NULL_POOL_PTR(p_pool);
-
-            void (*thread_f)(void *) = thread_func_list[i];
-            void *arg = arg_list ? arg_list[i] : NULL;
-            abt_errno =
-                ABTI_thread_create_internal(p_local_xstream, p_pool, thread_f,
-                                            arg, ABTI_thread_attr_get_ptr(attr),
-                                            ABTI_UNIT_TYPE_THREAD_USER, NULL, 0,
-                                            NULL, ABT_TRUE, NULL);
-            ABTI_CHECK_ERROR(abt_errno);
-        }
-    } else {
-        for (i = 0; i < num; i++) {
-            ABTI_thread *p_newthread;
-            ABT_pool pool = pool_list[i];
-            ABTI_pool *p_pool = ABTI_pool_get_ptr(pool);
-            ABTI_CHECK_NULL_POOL_PTR(p_pool);
-
-            void (*thread_f)(void *) = thread_func_list[i];
-            void *arg = arg_list ? arg_list[i] : NULL;
-            abt_errno =
-                ABTI_thread_create_internal(p_local_xstream, p_pool, thread_f,
-                                            arg, ABTI_thread_attr_get_ptr(attr),
-                                            ABTI_UNIT_TYPE_THREAD_USER, NULL, 1,
-                                            NULL, ABT_TRUE, &p_newthread);
-            newthread_list[i] = ABTI_thread_get_handle(p_newthread);
-            /* TODO: Release threads that have been already created. */
-            ABTI_CHECK_ERROR(abt_errno);
-        }
+    pp_pools = (ABTI_pool **)ABTU_malloc(num * sizeof(ABTI_pool *));
+    for (i = 0; i < num; i++) {
+        pp_pools[i] = ABTI_pool_get_ptr(pool_list[i]);
+        ABTI_CHECK_NULL_POOL_PTR(pp_pools[i]);
     }
+    abt_errno =
+        ABTI_thread_create_many(p_local_xstream, num, pp_pools,
+                                thread_func_list, arg_list, p_attr,
+                                newthread_list);
+    ABTI_CHECK_ERROR(abt_errno);
 
 fn_exit:
+    ABTU_free(pp_pools);
     return abt_errno;
 
 fn_fail:
+    if (newthread_list) {
+        for (i = 0; i < num; i++)
+            newthread_list[i] = ABT_THREAD_NULL;
+    }
     HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
     goto fn_exit;
 }
@@ -774,6 +828,14 @@ int ABT_thread_yield_to(ABT_thread thread)
         goto fn_exit;
     }
 
+    /* A stack-copying ULT must go through the scheduler, so just yield. */
+    if (ABTI_thread_is_stack_copy(p_cur_thread) ||
+        ABTI_thread_is_stack_copy(p_tar_thread)) {
+        ABTI_thread_yield(&p_local_xstream, p_cur_thread,
+                          ABT_SYNC_EVENT_TYPE_USER, NULL);
+        goto fn_exit;
+    }
+
     ABTD_atomic_release_store_int(&p_cur_thread->unit_def.state,
                                   ABTI_UNIT_STATE_READY);
 
@@ -1337,6 +1399,45 @@ fn_fail:
     goto fn_exit;
 }
 
+/**
+ * @ingroup ULT
+ * @brief   Get the stack usage of the ULT.
+ *
+ * \c ABT_thread_get_stack_usage() returns the maximum number of bytes of the
+ * stack that \c thread has used so far (i.e., the high-water mark).  This
+ * function requires stack painting, which is enabled by \c ABT_STACK_PAINT.
+ * Stacks of the main ULT, schedulers, and stack-copying ULTs are not painted.
+ * \c thread may be running or terminated; if it is running, the returned
+ * value might be slightly stale.
+ *
+ * @param[in]  thread  handle to the target ULT
+ * @param[out] usage   stack usage in bytes
+ * @return Error code
+ * @retval ABT_SUCCESS        on success
+ * @retval ABT_ERR_FEATURE_NA the stack of \c thread is not painted
+ */
+int ABT_thread_get_stack_usage(ABT_thread thread, size_t *usage)
+{
+    int abt_errno = ABT_SUCCESS;
+
+    ABTI_thread *p_thread = ABTI_thread_get_ptr(thread);
+    ABTI_CHECK_NULL_THREAD_PTR(p_thread);
+    if (!ABTI_thread_is_stack_painted(p_thread)) {
+        abt_errno = ABT_ERR_FEATURE_NA;
+        goto fn_fail;
+    }
+
+    /* Return value */
+    *usage = ABTI_thread_get_stack_usage(p_thread);
+
+fn_exit:
+    return abt_errno;
+
+fn_fail:
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
+}
+
 /**
  * @ingroup ULT
  * @brief   Get the ULT's id
@@ -1518,6 +1619,20 @@ int ABT_thread_get_attr(ABT_thread thread, ABT_thread_attr *attr)
     thread_attr.p_stack = p_thread->p_stack;
     thread_attr.stacksize = p_thread->stacksize;
     thread_attr.stacktype = p_thread->stacktype;
+    thread_attr.preserve_fpu =
+        ABTD_thread_context_get_preserve_fpu(&p_thread->ctx);
+    /* Work-first creation only affects how the ULT started. */
+    thread_attr.work_first = ABT_FALSE;
+    thread_attr.join_spin_nsec = p_thread->join_spin.max_nsec;
+    if (p_thread->unit_def.p_completion) {
+        thread_attr.f_completion_cb =
+            p_thread->unit_def.p_completion->f_thread_cb;
+        thread_attr.p_completion_cb_arg =
+            p_thread->unit_def.p_completion->p_cb_arg;
+    } else {
+        thread_attr.f_completion_cb = NULL;
+        thread_attr.p_completion_cb_arg = NULL;
+    }
 #ifndef ABT_CONFIG_DISABLE_MIGRATION
     thread_attr.migratable = p_thread->unit_def.migratable;
     thread_attr.f_cb = p_thread->f_migration_cb;
@@ -1539,28 +1654,63 @@ fn_fail:
 /* Private APIs                                                              */
 /*****************************************************************************/
 
-static inline int
-ABTI_thread_create_internal(ABTI_xstream *p_local_xstream, ABTI_pool *p_pool,
-                            void (*thread_func)(void *), void *arg,
-                            ABTI_thread_attr *p_attr, ABTI_unit_type unit_type,
-                            ABTI_sched *p_sched, int refcount,
-                            ABTI_xstream *p_parent_xstream, ABT_bool push_pool,
-                            ABTI_thread **pp_newthread)
+/* Initialize a newly allocated ULT descriptor.  If it fails, everything but
+ * the descriptor itself has been released. */
+static inline int ABTI_thread_init(ABTI_xstream *p_local_xstream,
+                                   ABTI_thread *p_newthread, ABTI_pool *p_pool,
+                                   void (*thread_func)(void *), void *arg,
+                                   size_t payload_size,
+                                   ABTI_thread_attr *p_attr,
+                                   ABTI_unit_type unit_type,
+                                   ABTI_sched *p_sched, int refcount)
 {
     int abt_errno = ABT_SUCCESS;
-    ABTI_thread *p_newthread;
-    ABT_thread h_newthread;
 
-    /* Allocate a ULT object and its stack, then create a thread context. */
-    p_newthread = ABTI_mem_alloc_thread(p_local_xstream, p_attr);
-    if ((unit_type == ABTI_UNIT_TYPE_THREAD_MAIN ||
-         unit_type == ABTI_UNIT_TYPE_THREAD_MAIN_SCHED) &&
-        p_newthread->p_stack == NULL) {
+    /* If payload_size is not zero, arg points to the argument data, which is
+     * copied to the descriptor. */
+    p_newthread->unit_def.p_payload = NULL;
+    if (payload_size) {
+        size_t spare_size;
+        void *p_spare = ABTI_mem_get_thread_spare(p_newthread, &spare_size);
+        arg = ABTI_mem_alloc_payload(p_local_xstream, p_spare, spare_size, arg,
+                                     payload_size);
+        if (ABTU_unlikely(!arg))
+            return ABT_ERR_MEM;
+        p_newthread->unit_def.p_payload = arg;
+    }
+    /* Only user ULTs can have a completion callback. */
+    p_newthread->unit_def.p_completion = NULL;
+    if (p_attr && p_attr->f_completion_cb &&
+        unit_type == ABTI_UNIT_TYPE_THREAD_USER && p_sched == NULL) {
+        ABTI_unit_completion *p_completion =
+            ABTI_mem_alloc_completion(p_local_xstream);
+        if (ABTU_unlikely(!p_completion)) {
+            size_t spare_size;
+            void *p_spare =
+                ABTI_mem_get_thread_spare(p_newthread, &spare_size);
+            ABTI_mem_free_payload(p_local_xstream,
+                                  p_newthread->unit_def.p_payload, p_spare);
+            return ABT_ERR_MEM;
+        }
+        p_completion->f_thread_cb = p_attr->f_completion_cb;
+        p_completion->f_task_cb = NULL;
+        p_completion->p_cb_arg = p_attr->p_completion_cb_arg;
+        p_newthread->unit_def.p_completion = p_completion;
+    }
+    if (((unit_type == ABTI_UNIT_TYPE_THREAD_MAIN ||
+          unit_type == ABTI_UNIT_TYPE_THREAD_MAIN_SCHED) &&
+         p_newthread->p_stack == NULL) ||
+        ABTI_thread_is_stack_copy(p_newthread)) {
         /* We don't need to initialize the context of 1. the main thread, and
          * 2. the main scheduler thread which runs on OS-level threads
-         * (p_stack == NULL). Invalidate the context here. */
+         * (p_stack == NULL). Invalidate the context here.  The context of a
+         * stack-copying ULT is created when it runs for the first time. */
         abt_errno = ABTD_thread_context_invalidate(&p_newthread->ctx);
     } else if (p_sched == NULL) {
+        /* The stack must be painted before the context is created on it. */
+        if (gp_ABTI_global->stack_paint &&
+            unit_type == ABTI_UNIT_TYPE_THREAD_USER)
+            ABTI_thread_paint_stack(p_newthread);
 #if ABT_CONFIG_THREAD_TYPE != ABT_THREAD_TYPE_DYNAMIC_PROMOTION
         size_t stack_size = p_newthread->stacksize;
         void *p_stack = p_newthread->p_stack;
@@ -1576,7 +1726,25 @@ ABTI_thread_create_internal(ABTI_xstream *p_local_xstream, ABTI_pool *p_pool,
         abt_errno = ABTD_thread_context_create(NULL, stack_size, p_stack,
                                                &p_newthread->ctx);
     }
-    ABTI_CHECK_ERROR(abt_errno);
+    if (ABTU_unlikely(abt_errno != ABT_SUCCESS)) {
+        size_t spare_size;
+        void *p_spare = ABTI_mem_get_thread_spare(p_newthread, &spare_size);
+        ABTI_mem_free_payload(p_local_xstream, p_newthread->unit_def.p_payload,
+                              p_spare);
+        ABTI_mem_free_completion(p_local_xstream,
+                                 p_newthread->unit_def.p_completion);
+        return abt_errno;
+    }
+    /* Only user ULTs can skip the FPU control state in context switches. */
+    ABT_bool preserve_fpu = ABT_TRUE;
+    if (unit_type == ABTI_UNIT_TYPE_THREAD_USER && p_sched == NULL) {
+        preserve_fpu = p_attr ? p_attr->preserve_fpu
+                              : gp_ABTI_global->thread_preserve_fpu;
+    }
+    ABTD_thread_context_set_preserve_fpu(&p_newthread->ctx, preserve_fpu);
+    ABTI_spin_wait_init(&p_newthread->join_spin,
+                        p_attr ? p_attr->join_spin_nsec
+                               : ABTI_global_get_wait_spin_nsec());
     p_newthread->unit_def.f_unit = thread_func;
     p_newthread->unit_def.p_arg = arg;
 
@@ -1597,6 +1765,53 @@ ABTI_thread_create_internal(ABTI_xstream *p_local_xstream, ABTI_pool *p_pool,
     ABTD_atomic_relaxed_store_ptr(&p_newthread->unit_def.p_keytable, NULL);
     p_newthread->unit_def.id = ABTI_THREAD_INIT_ID;
 
+    return abt_errno;
+}
+
+/* Release what ABTI_thread_init() has set up except for the descriptor. */
+static inline void ABTI_thread_fini(ABTI_xstream *p_local_xstream,
+                                    ABTI_thread *p_thread)
+{
+    /* Free the context */
+    ABTD_thread_context_free(&p_thread->ctx);
+
+    /* Free the payload */
+    size_t spare_size;
+    void *p_spare = ABTI_mem_get_thread_spare(p_thread, &spare_size);
+    ABTI_mem_free_payload(p_local_xstream, p_thread->unit_def.p_payload,
+                          p_spare);
+
+    /* Free the completion callback */
+    ABTI_mem_free_completion(p_local_xstream, p_thread->unit_def.p_completion);
+}
+
+static inline int
+ABTI_thread_create_internal(ABTI_xstream *p_local_xstream, ABTI_pool *p_pool,
+                            void (*thread_func)(void *), void *arg,
+                            size_t payload_size, ABTI_thread_attr *p_attr,
+                            ABTI_unit_type unit_type, ABTI_sched *p_sched,
+                            int refcount, ABTI_xstream *p_parent_xstream,
+                            ABT_bool push_pool, ABTI_thread **pp_newthread)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_thread *p_newthread;
+    ABT_thread h_newthread;
+
+    /* Allocate a ULT object and its stack, then create a thread context. */
+    p_newthread = ABTI_mem_alloc_thread(p_local_xstream, p_attr);
+    if (ABTU_unlikely(!p_newthread)) {
+        /* The reserved memory has been exhausted (see ABT_reserve()). */
+        abt_errno = ABT_ERR_MEM;
+        goto fn_fail;
+    }
+    abt_errno = ABTI_thread_init(p_local_xstream, p_newthread, p_pool,
+                                 thread_func, arg, payload_size, p_attr,
+                                 unit_type, p_sched, refcount);
+    if (ABTU_unlikely(abt_errno != ABT_SUCCESS)) {
+        ABTI_mem_free_thread(p_local_xstream, p_newthread);
+        goto fn_fail;
+    }
+
 #ifdef ABT_CONFIG_USE_DEBUG_LOG
     ABT_unit_id thread_id = ABTI_thread_get_id(p_newthread);
     if (unit_type == ABTI_UNIT_TYPE_THREAD_MAIN) {
@@ -1654,17 +1869,204 @@ fn_fail:
     goto fn_exit;
 }
 
+/* Create a user ULT and switch to it immediately (see
+ * ABT_thread_attr_set_work_first()).  p_self must be the calling ULT that is
+ * associated with p_pool. */
+static int ABTI_thread_create_work_first(ABTI_xstream *p_local_xstream,
+                                         ABTI_thread *p_self, ABTI_pool *p_pool,
+                                         void (*thread_func)(void *),
+                                         void *arg, ABTI_thread_attr *p_attr,
+                                         int refcount,
+                                         ABTI_thread **pp_newthread)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_thread *p_newthread;
+
+#ifndef ABT_CONFIG_DISABLE_POOL_PRODUCER_CHECK
+    /* The new ULT will push the caller to p_pool on this ES. */
+    abt_errno = ABTI_pool_set_producer(p_pool, ABTI_self_get_native_thread_id(
+                                                   p_local_xstream));
+    ABTI_CHECK_ERROR(abt_errno);
+#endif
+    abt_errno =
+        ABTI_thread_create_internal(p_local_xstream, p_pool, thread_func, arg,
+                                    0, p_attr, ABTI_UNIT_TYPE_THREAD_USER, NULL,
+                                    refcount, NULL, ABT_FALSE, &p_newthread);
+    ABTI_CHECK_ERROR(abt_errno);
+    p_newthread->unit_def.unit =
+        p_pool->u_create_from_thread(ABTI_thread_get_handle(p_newthread));
+    /* An unnamed ULT may be freed after the context switch. */
+    if (pp_newthread)
+        *pp_newthread = p_newthread;
+
+    /* The caller cannot be pushed to the pool before its context is saved, so
+     * the new ULT pushes it when it starts (see ABTD_thread_func_wrapper()).
+     * Nobody else knows the new ULT yet. */
+    ABTD_atomic_relaxed_store_uint32(&p_newthread->unit_def.request,
+                                     ABTI_UNIT_REQ_WORK_FIRST);
+    p_newthread->unit_def.p_last_xstream = p_local_xstream;
+    ABTD_atomic_release_store_int(&p_newthread->unit_def.state,
+                                  ABTI_UNIT_STATE_RUNNING);
+    ABTD_atomic_release_store_int(&p_self->unit_def.state,
+                                  ABTI_UNIT_STATE_READY);
+    LOG_DEBUG("[U%" PRIu64 ":E%d] work-first -> U%" PRIu64 "\n",
+              ABTI_thread_get_id(p_self), p_local_xstream->rank,
+              ABTI_thread_get_id(p_newthread));
+
+    /* This operation is corresponding to yield */
+    ABTI_tool_event_thread_yield(p_local_xstream, p_self,
+                                 p_self->unit_def.p_parent,
+                                 ABT_SYNC_EVENT_TYPE_USER, NULL);
+    ABTI_thread *p_prev =
+        ABTI_thread_context_switch_to_sibling(&p_local_xstream, p_self,
+                                              p_newthread);
+    ABTI_tool_event_thread_run(p_local_xstream, p_self, &p_prev->unit_def,
+                               p_self->unit_def.p_parent);
+
+fn_exit:
+    return abt_errno;
+
+fn_fail:
+    if (pp_newthread)
+        *pp_newthread = NULL;
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
+}
+
 int ABTI_thread_create(ABTI_xstream *p_local_xstream, ABTI_pool *p_pool,
                        void (*thread_func)(void *), void *arg,
                        ABTI_thread_attr *p_attr, ABTI_thread **pp_newthread)
 {
     int abt_errno = ABT_SUCCESS;
+    ABTI_thread *p_newthread;
     int refcount = (pp_newthread != NULL) ? 1 : 0;
+
+    /* Work-first creation needs a calling user ULT that can be resumed from
+     * p_pool.  The primary ULT must stay on the primary ES, and stack-copying
+     * ULTs must be scheduled by their parents. */
+    if (p_attr && p_attr->work_first && p_local_xstream &&
+        p_attr->stacktype != ABTI_STACK_TYPE_COPY) {
+        ABTI_unit *p_unit = p_local_xstream->p_unit;
+        if (p_unit && ABTI_unit_type_is_thread(p_unit->type) &&
+            p_unit->p_pool == p_pool) {
+            ABTI_thread *p_self = ABTI_unit_get_thread(p_unit);
+#ifndef ABT_CONFIG_DISABLE_STACKABLE_SCHED
+            ABT_bool is_sched = p_self->p_sched ? ABT_TRUE : ABT_FALSE;
+#else
+            ABT_bool is_sched = ABT_FALSE;
+#endif
+            if (p_unit->type == ABTI_UNIT_TYPE_THREAD_USER && !is_sched &&
+                !ABTI_thread_is_stack_copy(p_self)) {
+                return ABTI_thread_create_work_first(p_local_xstream, p_self,
+                                                     p_pool, thread_func, arg,
+                                                     p_attr, refcount,
+                                                     pp_newthread);
+            }
+        }
+    }
+
     abt_errno =
         ABTI_thread_create_internal(p_local_xstream, p_pool, thread_func, arg,
-                                    p_attr, ABTI_UNIT_TYPE_THREAD_USER, NULL,
-                                    refcount, NULL, ABT_TRUE, pp_newthread);
+                                    0, p_attr, ABTI_UNIT_TYPE_THREAD_USER, NULL,
+                                    refcount, NULL, ABT_TRUE, &p_newthread);
+    /* An unnamed ULT may have already been freed. */
+    if (pp_newthread)
+        *pp_newthread = p_newthread;
+    return abt_errno;
+}
+
+/* Create num user ULTs at once.  Their descriptors and stacks are taken from
+ * the memory pool in one go and the ULTs are pushed to each pool in a batch.
+ * Either all or none of the ULTs are created. */
+static int ABTI_thread_create_many(ABTI_xstream *p_local_xstream, int num,
+                                   ABTI_pool **pp_pools,
+                                   void (**thread_func_list)(void *),
+                                   void **arg_list, ABTI_thread_attr *p_attr,
+                                   ABT_thread *newthread_list)
+{
+    int abt_errno = ABT_SUCCESS;
+    int refcount = newthread_list ? 1 : 0;
+    int i, j, num_inits = 0;
+    ABT_bool is_allocated = ABT_FALSE;
+    ABTI_thread **p_threads;
+    ABT_unit *units, *batch;
+
+    p_threads = (ABTI_thread **)ABTU_malloc(num * sizeof(ABTI_thread *));
+    units = (ABT_unit *)ABTU_malloc(num * 2 * sizeof(ABT_unit));
+    batch = units + num;
+
+    if (!ABTI_mem_alloc_thread_many(p_local_xstream, p_attr, num, p_threads)) {
+        /* The reserved memory has been exhausted (see ABT_reserve()). */
+        abt_errno = ABT_ERR_MEM;
+        goto fn_fail;
+    }
+    is_allocated = ABT_TRUE;
+    for (i = 0; i < num; i++) {
+        void *arg = arg_list ? arg_list[i] : NULL;
+        abt_errno = ABTI_thread_init(p_local_xstream, p_threads[i], pp_pools[i],
+                                     thread_func_list[i], arg, 0, p_attr,
+                                     ABTI_UNIT_TYPE_THREAD_USER, NULL,
+                                     refcount);
+        if (ABTU_unlikely(abt_errno != ABT_SUCCESS))
+            goto fn_fail;
+        num_inits++;
+    }
+    ABTI_native_thread_id producer_id =
+        ABTI_self_get_native_thread_id(p_local_xstream);
+#ifndef ABT_CONFIG_DISABLE_POOL_PRODUCER_CHECK
+    /* Check the producer before any ULT becomes visible to the others. */
+    for (i = 0; i < num; i++) {
+        abt_errno = ABTI_pool_set_producer(pp_pools[i], producer_id);
+        if (ABTU_unlikely(abt_errno != ABT_SUCCESS))
+            goto fn_fail;
+    }
+#endif
+
+    for (i = 0; i < num; i++) {
+        ABTI_thread *p_newthread = p_threads[i];
+        ABT_thread h_newthread = ABTI_thread_get_handle(p_newthread);
+        LOG_DEBUG("[U%" PRIu64 "] created\n", ABTI_thread_get_id(p_newthread));
+        ABTI_tool_event_thread_create(p_local_xstream, p_newthread,
+                                      p_local_xstream ? p_local_xstream->p_unit
+                                                      : NULL,
+                                      pp_pools[i]);
+        p_newthread->unit_def.unit =
+            pp_pools[i]->u_create_from_thread(h_newthread);
+        units[i] = p_newthread->unit_def.unit;
+        if (newthread_list)
+            newthread_list[i] = h_newthread;
+    }
+
+    /* Push the ULTs to each pool in a batch.  Unnamed ULTs may be freed as
+     * soon as they are pushed, so only their units are accessed here. */
+    for (i = 0; i < num; i++) {
+        if (units[i] == ABT_UNIT_NULL)
+            continue;
+        size_t num_batch = 0;
+        for (j = i; j < num; j++) {
+            if (units[j] != ABT_UNIT_NULL && pp_pools[j] == pp_pools[i]) {
+                batch[num_batch++] = units[j];
+                units[j] = ABT_UNIT_NULL;
+            }
+        }
+        ABTI_pool_push_many(pp_pools[i], batch, num_batch, producer_id);
+    }
+
+fn_exit:
+    ABTU_free(p_threads);
+    ABTU_free(units);
     return abt_errno;
+
+fn_fail:
+    /* No ULT has been pushed yet, so all of them can be released. */
+    if (is_allocated) {
+        for (i = 0; i < num_inits; i++)
+            ABTI_thread_fini(p_local_xstream, p_threads[i]);
+        for (i = 0; i < num; i++)
+            ABTI_mem_free_thread(p_local_xstream, p_threads[i]);
+    }
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
 }
 
 int ABTI_thread_migrate_to_pool(ABTI_xstream **pp_local_xstream,
@@ -1739,8 +2141,8 @@ int ABTI_thread_create_main(ABTI_xstream *p_local_xstream,
      * context switched to the scheduler for the first time. */
     ABT_bool push_pool = ABT_TRUE;
     abt_errno =
-        ABTI_thread_create_internal(p_local_xstream, p_pool, NULL, NULL, &attr,
-                                    ABTI_UNIT_TYPE_THREAD_MAIN, NULL, 0,
+        ABTI_thread_create_internal(p_local_xstream, p_pool, NULL, NULL, 0,
+                                    &attr, ABTI_UNIT_TYPE_THREAD_MAIN, NULL, 0,
                                     p_xstream, push_pool, &p_newthread);
     ABTI_CHECK_ERROR(abt_errno);
 
@@ -1773,7 +2175,7 @@ int ABTI_thread_create_main_sched(ABTI_xstream *p_local_xstream,
         abt_errno =
             ABTI_thread_create_internal(p_local_xstream, NULL,
                                         ABTI_xstream_schedule,
-                                        (void *)p_xstream, &attr,
+                                        (void *)p_xstream, 0, &attr,
                                         ABTI_UNIT_TYPE_THREAD_MAIN_SCHED,
                                         p_sched, 0, p_xstream, ABT_FALSE,
                                         &p_newthread);
@@ -1790,7 +2192,7 @@ int ABTI_thread_create_main_sched(ABTI_xstream *p_local_xstream,
         abt_errno =
             ABTI_thread_create_internal(p_local_xstream, NULL,
                                         ABTI_xstream_schedule,
-                                        (void *)p_xstream, &attr,
+                                        (void *)p_xstream, 0, &attr,
                                         ABTI_UNIT_TYPE_THREAD_MAIN_SCHED,
                                         p_sched, 0, p_xstream, ABT_FALSE,
                                         &p_newthread);
@@ -1831,7 +2233,7 @@ int ABTI_thread_create_sched(ABTI_xstream *p_local_xstream, ABTI_pool *p_pool,
     abt_errno =
         ABTI_thread_create_internal(p_local_xstream, p_pool,
                                     (void (*)(void *))p_sched->run,
-                                    (void *)ABTI_sched_get_handle(p_sched),
+                                    (void *)ABTI_sched_get_handle(p_sched), 0,
                                     &attr, ABTI_UNIT_TYPE_THREAD_USER, p_sched,
                                     0, NULL, ABT_TRUE, &p_sched->p_thread);
     ABTI_CHECK_ERROR(abt_errno);
@@ -1851,9 +2253,6 @@ static inline void ABTI_thread_free_internal(ABTI_xstream *p_local_xstream,
     /* Free the unit */
     p_thread->unit_def.p_pool->u_free(&p_thread->unit_def.unit);
 
-    /* Free the context */
-    ABTD_thread_context_free(&p_thread->ctx);
-
     /* Free the key-value table */
     ABTI_ktable *p_ktable =
         ABTD_atomic_acquire_load_ptr(&p_thread->unit_def.p_keytable);
@@ -1862,6 +2261,9 @@ static inline void ABTI_thread_free_internal(ABTI_xstream *p_local_xstream,
     if (p_ktable) {
         ABTI_ktable_free(p_local_xstream, p_ktable);
     }
+
+    /* Free the context, the payload, and the completion callback */
+    ABTI_thread_fini(p_local_xstream, p_thread);
 }
 
 void ABTI_thread_free(ABTI_xstream *p_local_xstream, ABTI_thread *p_thread)
@@ -1960,6 +2362,34 @@ fn_fail:
     goto fn_exit;
 }
 
+/* Revert ABTI_thread_set_blocked() of the calling ULT when it turns out that
+ * the ULT does not need to be suspended.  Nobody must have been told to wake
+ * up the ULT. */
+void ABTI_thread_cancel_blocked(ABTI_thread *p_thread)
+{
+    ABTI_pool_dec_num_blocked(p_thread->unit_def.p_pool);
+    ABTD_atomic_release_store_int(&p_thread->unit_def.state,
+                                  ABTI_UNIT_STATE_RUNNING);
+    ABTI_thread_unset_request(p_thread, ABTI_UNIT_REQ_BLOCK);
+}
+
+/* Push p_creator, whose context has been saved, back to its pool. */
+void ABTI_thread_release_creator(ABTI_xstream *p_local_xstream,
+                                 ABTI_thread *p_thread, ABTI_unit *p_creator)
+{
+    ABTI_thread_unset_request(p_thread, ABTI_UNIT_REQ_WORK_FIRST);
+#ifdef ABT_CONFIG_DISABLE_POOL_PRODUCER_CHECK
+    ABTI_pool_push(p_creator->p_pool, p_creator->unit);
+#else
+    /* The producer has been checked by p_creator. */
+    int abt_errno =
+        ABTI_pool_push(p_creator->p_pool, p_creator->unit,
+                       ABTI_self_get_native_thread_id(p_local_xstream));
+    ABTI_ASSERT(abt_errno == ABT_SUCCESS);
+    ABTI_UNUSED(abt_errno);
+#endif
+}
+
 /* NOTE: This routine should be called after ABTI_thread_set_blocked. */
 void ABTI_thread_suspend(ABTI_xstream **pp_local_xstream, ABTI_thread *p_thread,
                          ABT_sync_event_type sync_event_type, void *p_sync)
@@ -2183,6 +2613,15 @@ ABT_unit_id ABTI_thread_get_id(ABTI_thread *p_thread)
     return p_thread->unit_def.id;
 }
 
+/* Called on the ES that ran p_thread right after p_thread terminates and
+ * before its state is set to TERMINATED. */
+void ABTI_thread_run_completion_cb(ABTI_thread *p_thread)
+{
+    ABTI_unit_completion *p_completion = p_thread->unit_def.p_completion;
+    p_completion->f_thread_cb(ABTI_thread_get_handle(p_thread),
+                              p_completion->p_cb_arg);
+}
+
 ABT_unit_id ABTI_thread_self_id(ABTI_xstream *p_local_xstream)
 {
     return ABTI_thread_get_id(ABTI_unit_get_thread(p_local_xstream->p_unit));
@@ -2222,9 +2661,25 @@ static int ABTI_thread_revive(ABTI_xstream *p_local_xstream, ABTI_pool *p_pool,
                     ABT_ERR_INV_THREAD);
 
     /* Create a ULT context */
-    stacksize = p_thread->stacksize;
-    abt_errno = ABTD_thread_context_create(NULL, stacksize, p_thread->p_stack,
-                                           &p_thread->ctx);
+#ifdef ABT_CONFIG_USE_FCONTEXT
+    if (ABTI_thread_is_stack_copy(p_thread)) {
+        /* A new shared stack is bound when it runs for the first time. */
+        ABTI_thread_stack_copy *p_copy = ABTI_thread_get_stack_copy(p_thread);
+        p_copy->p_copy_stack = NULL;
+        p_copy->is_started = ABT_FALSE;
+        p_copy->used = 0;
+        p_thread->p_stack = NULL;
+        abt_errno = ABTD_thread_context_invalidate(&p_thread->ctx);
+    } else
+#endif
+    {
+        if (ABTI_thread_is_stack_painted(p_thread))
+            ABTI_thread_paint_stack(p_thread);
+        stacksize = p_thread->stacksize;
+        abt_errno = ABTD_thread_context_create(NULL, stacksize,
+                                               p_thread->p_stack,
+                                               &p_thread->ctx);
+    }
     ABTI_CHECK_ERROR(abt_errno);
 
     p_thread->unit_def.f_unit = thread_func;
@@ -2302,23 +2757,55 @@ static inline int ABTI_thread_join(ABTI_xstream **pp_local_xstream,
                         "The target ULT should be different.");
     ABTI_thread *p_self = ABTI_unit_get_thread(p_self_unit);
     ABT_pool_access access = p_self->unit_def.p_pool->access;
+    ABTI_pool *p_pool = p_thread->unit_def.p_pool;
+    ABT_bool run_inline = ABT_FALSE;
 
-    if ((p_self->unit_def.p_pool == p_thread->unit_def.p_pool) &&
-        (access == ABT_POOL_ACCESS_PRIV || access == ABT_POOL_ACCESS_MPSC ||
-         access == ABT_POOL_ACCESS_SPSC) &&
+    if (!ABTI_thread_is_stack_copy(p_self) &&
+        !ABTI_thread_is_stack_copy(p_thread) &&
         (ABTD_atomic_acquire_load_int(&p_thread->unit_def.state) ==
          ABTI_UNIT_STATE_READY)) {
+        if ((p_self->unit_def.p_pool == p_pool) &&
+            (access == ABT_POOL_ACCESS_PRIV || access == ABT_POOL_ACCESS_MPSC ||
+             access == ABT_POOL_ACCESS_SPSC)) {
+            /* If other ES is calling ABTI_thread_set_ready(), p_thread may not
+             * have been added to the pool yet because ABTI_thread_set_ready()
+             * changes the state first followed by pushing p_thread to the
+             * pool.  Therefore, we have to check whether p_thread is in the
+             * pool, and if not, we need to wait until it is added. */
+            while (p_pool->u_is_in_pool(p_thread->unit_def.unit) != ABT_TRUE) {
+            }
 
-        ABTI_xstream *p_xstream = p_self->unit_def.p_last_xstream;
-
-        /* If other ES is calling ABTI_thread_set_ready(), p_thread may not
-         * have been added to the pool yet because ABTI_thread_set_ready()
-         * changes the state first followed by pushing p_thread to the pool.
-         * Therefore, we have to check whether p_thread is in the pool, and if
-         * not, we need to wait until it is added. */
-        while (p_thread->unit_def.p_pool->u_is_in_pool(
-                   p_thread->unit_def.unit) != ABT_TRUE) {
+            /* Increase the number of blocked units.  Be sure to execute
+             * ABTI_pool_inc_num_blocked before ABTI_POOL_REMOVE in order not
+             * to underestimate the number of units in a pool. */
+            ABTI_pool_inc_num_blocked(p_self->unit_def.p_pool);
+            /* Remove the target ULT from the pool */
+            ABTI_POOL_REMOVE(p_pool, p_thread->unit_def.unit,
+                             ABTI_self_get_native_thread_id(p_local_xstream));
+            run_inline = ABT_TRUE;
+
+        } else if (p_pool->access == ABT_POOL_ACCESS_MPMC &&
+                   p_pool->p_try_remove) {
+            /* Other ESs may pop p_thread in parallel, so p_thread can be run
+             * here only if this ES has removed it from the pool.
+             * p_try_remove() fails if p_thread is not in the pool.  User-
+             * defined pools do not have it since their p_remove() may not
+             * expect a unit that has been popped. */
+            ABTI_pool_inc_num_blocked(p_self->unit_def.p_pool);
+            if (p_pool->p_try_remove(ABTI_pool_get_handle(p_pool),
+                                     p_thread->unit_def.unit) == ABT_SUCCESS) {
+                LOG_DEBUG_POOL_REMOVE(p_pool, p_thread->unit_def.unit,
+                                      ABTI_self_get_native_thread_id(
+                                          p_local_xstream));
+                run_inline = ABT_TRUE;
+            } else {
+                ABTI_pool_dec_num_blocked(p_self->unit_def.p_pool);
+            }
         }
+    }
+
+    if (run_inline) {
+        ABTI_xstream *p_xstream = p_self->unit_def.p_last_xstream;
 
         /* This is corresponding to suspension. */
         ABTI_tool_event_thread_suspend(p_local_xstream, p_self,
@@ -2326,14 +2813,6 @@ static inline int ABTI_thread_join(ABTI_xstream **pp_local_xstream,
                                        ABT_SYNC_EVENT_TYPE_THREAD_JOIN,
                                        (void *)p_thread);
 
-        /* Increase the number of blocked units.  Be sure to execute
-         * ABTI_pool_inc_num_blocked before ABTI_POOL_REMOVE in order not to
-         * underestimate the number of units in a pool. */
-        ABTI_pool_inc_num_blocked(p_self->unit_def.p_pool);
-        /* Remove the target ULT from the pool */
-        ABTI_POOL_REMOVE(p_thread->unit_def.p_pool, p_thread->unit_def.unit,
-                         ABTI_self_get_native_thread_id(p_local_xstream));
-
         /* Set the link in the context for the target ULT.  Since p_link will be
          * referenced by p_self, this update does not require release store. */
         ABTD_atomic_relaxed_store_thread_context_ptr(&p_thread->ctx.p_link,
@@ -2372,6 +2851,14 @@ static inline int ABTI_thread_join(ABTI_xstream **pp_local_xstream,
         goto yield_based;
 
     } else {
+        /* p_thread may terminate soon, so spin for a while before
+         * suspending. */
+        double spin_start;
+        if (ABTI_spin_wait_begin(&p_thread->join_spin, p_local_xstream,
+                                 &p_thread->unit_def.state,
+                                 ABTI_UNIT_STATE_TERMINATED, &spin_start))
+            goto fn_exit;
+
         /* Tell p_thread that there has been a join request. */
         /* If request already has ABTI_UNIT_REQ_JOIN, p_thread is terminating.
          * We can't block p_self in this case. */
@@ -2396,6 +2883,7 @@ static inline int ABTI_thread_join(ABTI_xstream **pp_local_xstream,
         ABTI_thread_suspend(pp_local_xstream, p_self,
                             ABT_SYNC_EVENT_TYPE_THREAD_JOIN, (void *)p_thread);
         p_local_xstream = *pp_local_xstream;
+        ABTI_spin_wait_end(&p_thread->join_spin, spin_start);
     }
 
     /* Resume */
@@ -2426,11 +2914,8 @@ yield_based:
 
 #ifndef ABT_CONFIG_DISABLE_EXT_THREAD
 busywait_based:
+    ABTI_ext_waiter_join(&p_thread->unit_def);
 #endif
-    while (ABTD_atomic_acquire_load_int(&p_thread->unit_def.state) !=
-           ABTI_UNIT_STATE_TERMINATED) {
-        ABTD_atomic_pause();
-    }
 
 fn_exit:
     if (abt_errno == ABT_SUCCESS) {
@@ -2511,5 +2996,19 @@ fn_fail:
 
 static inline ABT_unit_id ABTI_thread_get_new_id(void)
 {
-    return (ABT_unit_id)ABTD_atomic_fetch_add_uint64(&g_thread_id, 1);
+    /* An ES takes IDs from its own block so that ESs do not contend on
+     * g_thread_id.  IDs are unique and monotonic per ES, but not dense. */
+    ABTI_xstream *p_local_xstream = ABTI_local_get_xstream_uninlined();
+    if (p_local_xstream == NULL) {
+        /* An external thread takes a single ID. */
+        return (ABT_unit_id)ABTD_atomic_fetch_add_uint64(&g_thread_id, 1);
+    }
+    if (p_local_xstream->thread_id_next == p_local_xstream->thread_id_end) {
+        p_local_xstream->thread_id_next = (ABT_unit_id)
+            ABTD_atomic_fetch_add_uint64(&g_thread_id,
+                                         ABTI_UNIT_ID_BLOCK_SIZE);
+        p_local_xstream->thread_id_end =
+            p_local_xstream->thread_id_next + ABTI_UNIT_ID_BLOCK_SIZE;
+    }
+    return p_local_xstream->thread_id_next++;
 }
@@ -33,6 +33,7 @@ int ABT_thread_attr_create(ABT_thread_attr *newattr)
     /* Default values */
     ABTI_thread_attr_init(p_newattr, NULL, ABTI_global_get_thread_stacksize(),
                           ABTI_STACK_TYPE_MEMPOOL, ABT_TRUE);
+    p_newattr->preserve_fpu = gp_ABTI_global->thread_preserve_fpu;
 
     /* Return value */
     *newattr = ABTI_thread_attr_get_handle(p_newattr);
@@ -296,6 +297,228 @@ fn_fail:
 #endif
 }
 
+/**
+ * @ingroup ULT_ATTR
+ * @brief   Set whether the ULT copies its stack in the attribute object.
+ *
+ * \c ABT_thread_attr_set_stack_copy() makes ULTs created with \c attr
+ * stack-copying ULTs if \c flag is \c ABT_TRUE.  A stack-copying ULT runs on
+ * a stack shared by ULTs of an ES, and only the used part of the stack is
+ * copied to a heap buffer while the ULT is suspended, so the memory footprint
+ * of a suspended ULT is proportional to its stack usage.  Instead, every
+ * context switch copies the stack, and ULTs sharing the same stack cannot run
+ * concurrently.  The size of the shared stack is set by \c ABT_COPY_STACKSIZE.
+ *
+ * A stack-copying ULT must be resumed on the stack on which it has started, so
+ * it keeps using the shared stack of the ES that first ran it even if another
+ * ES resumes it.  Other ULTs must not access the stack of a stack-copying ULT
+ * (e.g., via pointers to its local variables) while it is suspended.
+ *
+ * If \c flag is \c ABT_FALSE, the stack attributes are reset to the default.
+ *
+ * @param[in] attr  handle to the target attribute object
+ * @param[in] flag  stack-copying flag (<tt>ABT_TRUE</tt>: copy the stack,
+ *                  <tt>ABT_FALSE</tt>: not)
+ * @return Error code
+ * @retval ABT_SUCCESS        on success
+ * @retval ABT_ERR_FEATURE_NA stack-copying ULTs are not supported
+ */
+int ABT_thread_attr_set_stack_copy(ABT_thread_attr attr, ABT_bool flag)
+{
+#ifdef ABT_CONFIG_USE_FCONTEXT
+    int abt_errno = ABT_SUCCESS;
+    ABTI_thread_attr *p_attr = ABTI_thread_attr_get_ptr(attr);
+    ABTI_CHECK_NULL_THREAD_ATTR_PTR(p_attr);
+
+    /* Set the value */
+    p_attr->p_stack = NULL;
+    if (flag) {
+        p_attr->stacksize = gp_ABTI_global->copy_stacksize;
+        p_attr->stacktype = ABTI_STACK_TYPE_COPY;
+    } else {
+        p_attr->stacksize = ABTI_global_get_thread_stacksize();
+        p_attr->stacktype = ABTI_STACK_TYPE_MEMPOOL;
+    }
+
+fn_exit:
+    return abt_errno;
+
+fn_fail:
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
+#else
+    return ABT_ERR_FEATURE_NA;
+#endif
+}
+
+/**
+ * @ingroup ULT_ATTR
+ * @brief   Set whether the ULT preserves the FPU control state in the
+ *          attribute object.
+ *
+ * \c ABT_thread_attr_set_preserve_fpu() sets whether ULTs created with
+ * \c attr save and restore the FPU control state (e.g., MXCSR and the x87
+ * control word on x86) when they are switched.  If \c flag is \c ABT_FALSE,
+ * context switches from and to the ULT skip its FPU control state, which makes
+ * them cheaper.  Such a ULT runs with the FPU control state of the ULT or the
+ * scheduler that has run last on the ES, so it must not modify it (e.g., by
+ * \c fesetround() or \c fesetenv()).  ULTs that preserve the FPU control state
+ * are not affected by ULTs that do not.
+ *
+ * The default value is \c ABT_TRUE unless \c ABT_THREAD_PRESERVE_FPU is set
+ * to false.  This attribute is ignored if the FPU control state is not
+ * preserved at all (i.e., \c ABT_INFO_QUERY_KIND_ENABLED_PRESERVE_FPU is
+ * \c ABT_FALSE) or if context switches cannot skip it on this platform.
+ * Tasklets and schedulers do not have this attribute.
+ *
+ * @param[in] attr  handle to the target attribute object
+ * @param[in] flag  FPU preservation flag (<tt>ABT_TRUE</tt>: preserve,
+ *                  <tt>ABT_FALSE</tt>: not)
+ * @return Error code
+ * @retval ABT_SUCCESS on success
+ */
+int ABT_thread_attr_set_preserve_fpu(ABT_thread_attr attr, ABT_bool flag)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_thread_attr *p_attr = ABTI_thread_attr_get_ptr(attr);
+    ABTI_CHECK_NULL_THREAD_ATTR_PTR(p_attr);
+
+    /* Set the value */
+    p_attr->preserve_fpu = flag;
+
+fn_exit:
+    return abt_errno;
+
+fn_fail:
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
+}
+
+/**
+ * @ingroup ULT_ATTR
+ * @brief   Set whether the creator of the ULT switches to it immediately in
+ *          the attribute object.
+ *
+ * \c ABT_thread_attr_set_work_first() sets how ULTs created with \c attr
+ * start.  By default (\c ABT_FALSE), the creator pushes a new ULT to the pool
+ * and continues its execution (help-first).  If \c flag is \c ABT_TRUE, the
+ * creating ULT instead switches to the new ULT immediately and its own
+ * continuation is pushed to the pool, where it can be picked up by another ES
+ * that shares the pool (work-first).  In a recursive fork-join program, this
+ * runs children depth-first and bounds the number of ULTs that have been
+ * created but not started yet.
+ *
+ * Work-first creation applies only when \c ABT_thread_create() or
+ * \c ABT_thread_create_on_xstream() is called by a ULT other than the primary
+ * ULT and the new ULT is associated with the same pool as the caller.
+ * Otherwise, or if either ULT is a stack-copying ULT, the new ULT is pushed to
+ * its pool as usual.  Note that the caller may resume on another ES.
+ * \c ABT_thread_create_many() ignores this attribute.
+ *
+ * @param[in] attr  handle to the target attribute object
+ * @param[in] flag  work-first flag (<tt>ABT_TRUE</tt>: work-first,
+ *                  <tt>ABT_FALSE</tt>: help-first)
+ * @return Error code
+ * @retval ABT_SUCCESS on success
+ */
+int ABT_thread_attr_set_work_first(ABT_thread_attr attr, ABT_bool flag)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_thread_attr *p_attr = ABTI_thread_attr_get_ptr(attr);
+    ABTI_CHECK_NULL_THREAD_ATTR_PTR(p_attr);
+
+    /* Set the value */
+    p_attr->work_first = flag;
+
+fn_exit:
+    return abt_errno;
+
+fn_fail:
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
+}
+
+/**
+ * @ingroup ULT_ATTR
+ * @brief   Set the maximum spin time of joiners in the attribute object.
+ *
+ * \c ABT_thread_attr_set_join_spin_nsec() sets how long a ULT joining a ULT
+ * created with \c attr may spin at most before it suspends.  The spin time
+ * adapts to recent join durations of the joined ULT within this limit, so a
+ * join that ends shortly after it starts avoids context switches.
+ * \c max_nsec of zero disables spinning.  The default value is set by
+ * \c ABT_WAIT_SPIN_NSEC.
+ *
+ * @param[in] attr      handle to the target attribute object
+ * @param[in] max_nsec  maximum spin time in nanoseconds
+ * @return Error code
+ * @retval ABT_SUCCESS on success
+ */
+int ABT_thread_attr_set_join_spin_nsec(ABT_thread_attr attr, uint32_t max_nsec)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_thread_attr *p_attr = ABTI_thread_attr_get_ptr(attr);
+    ABTI_CHECK_NULL_THREAD_ATTR_PTR(p_attr);
+
+    /* Set the value */
+    p_attr->join_spin_nsec = max_nsec;
+
+fn_exit:
+    return abt_errno;
+
+fn_fail:
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
+}
+
+/**
+ * @ingroup ULT_ATTR
+ * @brief   Set the completion callback function and its argument in the
+ *          attribute object.
+ *
+ * \c ABT_thread_attr_set_completion_callback() sets the callback function
+ * that is invoked when a ULT created with \c attr terminates.  \c cb_func is
+ * called with the handle of the ULT and \c cb_arg on the ES that has run the
+ * ULT, right after the ULT finishes (or exits or is canceled) and before the
+ * ULT is regarded as terminated, so a joiner of the ULT returns after
+ * \c cb_func returns.  \c cb_func may create work units, but it must not block
+ * or yield.
+ *
+ * If the ULT is unnamed (i.e., created with a \c NULL handle pointer), the ULT
+ * is freed automatically after \c cb_func returns.  The handle given to
+ * \c cb_func is valid only until \c cb_func returns in this case.  This allows
+ * users to continue work when a ULT finishes without having another ULT join
+ * it.  A revived ULT keeps its completion callback.
+ *
+ * If \c cb_func is \c NULL, no callback is invoked, which is the default.
+ *
+ * @param[in] attr     handle to the target attribute object
+ * @param[in] cb_func  callback function pointer
+ * @param[in] cb_arg   argument for the callback function
+ * @return Error code
+ * @retval ABT_SUCCESS on success
+ */
+int ABT_thread_attr_set_completion_callback(ABT_thread_attr attr,
+                                            void (*cb_func)(ABT_thread thread,
+                                                            void *cb_arg),
+                                            void *cb_arg)
+{
+    int abt_errno = ABT_SUCCESS;
+    ABTI_thread_attr *p_attr = ABTI_thread_attr_get_ptr(attr);
+    ABTI_CHECK_NULL_THREAD_ATTR_PTR(p_attr);
+
+    /* Set the value */
+    p_attr->f_completion_cb = cb_func;
+    p_attr->p_completion_cb_arg = cb_arg;
+
+fn_exit:
+    return abt_errno;
+
+fn_fail:
+    HANDLE_ERROR_FUNC_WITH_CODE(abt_errno);
+    goto fn_exit;
+}
+
 /*****************************************************************************/
 /* Private APIs                                                              */
 /*****************************************************************************/
@@ -320,7 +543,7 @@ fn_fail:
 void ABTI_thread_attr_print(ABTI_thread_attr *p_attr, FILE *p_os, int indent)
 {
     char *prefix = ABTU_get_indent_str(indent);
-    char attr[100];
+    char attr[256];
 
     ABTI_thread_attr_get_str(p_attr, attr);
     fprintf(p_os, "%sULT attr: %s\n", prefix, attr);
@@ -349,6 +572,9 @@ void ABTI_thread_attr_get_str(ABTI_thread_attr *p_attr, char *p_buf)
         case ABTI_STACK_TYPE_MAIN:
             stacktype = "MAIN";
             break;
+        case ABTI_STACK_TYPE_COPY:
+            stacktype = "COPY";
+            break;
         default:
             stacktype = "UNKNOWN";
             break;
@@ -360,10 +586,16 @@ void ABTI_thread_attr_get_str(ABTI_thread_attr *p_attr, char *p_buf)
             "stack:%p "
             "stacksize:%zu "
             "stacktype:%s "
+            "preserve_fpu:%s "
+            "work_first:%s "
+            "join_spin_nsec:%u "
             "migratable:%s "
             "cb_arg:%p"
             "]",
             p_attr->p_stack, p_attr->stacksize, stacktype,
+            (p_attr->preserve_fpu == ABT_TRUE ? "TRUE" : "FALSE"),
+            (p_attr->work_first == ABT_TRUE ? "TRUE" : "FALSE"),
+            p_attr->join_spin_nsec,
             (p_attr->migratable == ABT_TRUE ? "TRUE" : "FALSE"),
             p_attr->p_cb_arg);
 #else
@@ -372,8 +604,14 @@ void ABTI_thread_attr_get_str(ABTI_thread_attr *p_attr, char *p_buf)
             "stack:%p "
             "stacksize:%zu "
             "stacktype:%s "
+            "preserve_fpu:%s "
+            "work_first:%s "
+            "join_spin_nsec:%u"
             "]",
-            p_attr->p_stack, p_attr->stacksize, stacktype);
+            p_attr->p_stack, p_attr->stacksize, stacktype,
+            (p_attr->preserve_fpu == ABT_TRUE ? "TRUE" : "FALSE"),
+            (p_attr->work_first == ABT_TRUE ? "TRUE" : "FALSE"),
+            p_attr->join_spin_nsec);
 #endif
 }
 
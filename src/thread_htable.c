@@ -18,9 +18,6 @@ ABTI_thread_htable *ABTI_thread_htable_create(uint32_t num_rows)
     lh_lock_init(&p_htable->mutex);
 #elif defined(HAVE_CLH_H)
     clh_init(&p_htable->mutex);
-#elif defined(USE_PTHREAD_MUTEX)
-    int ret = pthread_mutex_init(&p_htable->mutex, NULL);
-    assert(!ret);
 #else
     ABTI_spinlock_clear(&p_htable->mutex);
 #endif
@@ -42,9 +39,6 @@ void ABTI_thread_htable_free(ABTI_thread_htable *p_htable)
     lh_lock_destroy(&p_htable->mutex);
 #elif defined(HAVE_CLH_H)
     clh_destroy(&p_htable->mutex);
-#elif defined(USE_PTHREAD_MUTEX)
-    int ret = pthread_mutex_destroy(&p_htable->mutex);
-    assert(!ret);
 #else
     /* ABTI_spinlock needs no finalization. */
 #endif
@@ -230,8 +224,13 @@ ABT_bool ABTI_thread_htable_switch_low(ABTI_xstream **pp_local_xstream,
     ABTI_thread *p_target = NULL;
     ABTI_xstream *p_local_xstream = *pp_local_xstream;
 
+    /* A stack-copying ULT must be scheduled by its parent. */
+    if (ABTI_thread_is_stack_copy(p_thread))
+        return ABT_FALSE;
+
     ABTI_thread_queue_acquire_low_mutex(p_queue);
-    if (p_queue->low_head) {
+    if (p_queue->low_head &&
+        !ABTI_thread_is_stack_copy(p_queue->low_head)) {
         p_target = p_queue->low_head;
 
         /* Push p_thread to the queue */
@@ -171,6 +171,12 @@ int ABT_tool_register_task_callback(ABT_tool_task_callback_fn cb_func,
  *  - ABT_SYNC_EVENT_TYPE_BARRIER:
  *      Synchronization regarding a barrier (e.g., ABT_barrier_wait())
  *      The synchronization object is a barrier (ABT_barrier).
+ *  - ABT_SYNC_EVENT_TYPE_GROUP:
+ *      Synchronization regarding a group (e.g., ABT_group_wait())
+ *      The synchronization object is a group (ABT_group).
+ *  - ABT_SYNC_EVENT_TYPE_SEM:
+ *      Synchronization regarding a semaphore (e.g., ABT_sem_acquire())
+ *      The synchronization object is a semaphore (ABT_sem).
  *  - ABT_SYNC_EVENT_TYPE_OTHER:
  *      Unclassified synchronization (e.g., ABT_xstream_exit())
  *      The synchronization object is not set ((void *)NULL).
@@ -334,6 +340,14 @@ static inline int ABTI_tool_query(ABTI_tool_context *p_tctx,
                     *(ABT_barrier *)val = ABTI_barrier_get_handle(
                         (ABTI_barrier *)p_tctx->p_sync_object);
                     break;
+                case ABT_SYNC_EVENT_TYPE_GROUP:
+                    *(ABT_group *)val = ABTI_group_get_handle(
+                        (ABTI_group *)p_tctx->p_sync_object);
+                    break;
+                case ABT_SYNC_EVENT_TYPE_SEM:
+                    *(ABT_sem *)val = ABTI_sem_get_handle(
+                        (ABTI_sem *)p_tctx->p_sync_object);
+                    break;
                 default:
                     *(void **)val = NULL;
             }
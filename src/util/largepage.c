@@ -89,6 +89,12 @@ void *ABTU_alloc_largepage(size_t size, size_t alignment_hint,
                            int num_requested_types,
                            ABTU_MEM_LARGEPAGE_TYPE *p_actual)
 {
+    if (g_ABTU_allocator.alloc_largepage_f) {
+        /* The user-defined allocator overrides requested_types. */
+        *p_actual = ABTU_MEM_LARGEPAGE_USER;
+        return g_ABTU_allocator.alloc_largepage_f(size, alignment_hint,
+                                                  g_ABTU_allocator.arg);
+    }
     int i;
     for (i = 0; i < num_requested_types; i++) {
         ABTU_MEM_LARGEPAGE_TYPE requested = requested_types[i];
@@ -130,5 +136,7 @@ void ABTU_free_largepage(void *ptr, size_t size, ABTU_MEM_LARGEPAGE_TYPE type)
         ABTU_munmap(ptr, size);
     } else if (type == ABTU_MEM_LARGEPAGE_MMAP_HUGEPAGE) {
         ABTU_munmap(ptr, size);
+    } else if (type == ABTU_MEM_LARGEPAGE_USER) {
+        g_ABTU_allocator.free_largepage_f(ptr, size, g_ABTU_allocator.arg);
     }
 }
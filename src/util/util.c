@@ -7,6 +7,10 @@
 #include <math.h>
 #include <ctype.h>
 
+/* Allocator used by ABTU_malloc() and its family.  It is updated only while
+ * Argobots is not initialized. */
+ABTU_allocator g_ABTU_allocator = { NULL, NULL, NULL, NULL, NULL, NULL };
+
 /* \c ABTU_get_indent_str() returns a white-space string with the length of
  * \c indent.  The caller should free the memory returned. */
 char *ABTU_get_indent_str(int indent)
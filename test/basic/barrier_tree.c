@@ -0,0 +1,142 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "abt.h"
+#include "abttest.h"
+
+/* A barrier with many waiters wakes up its waiters in a tree manner.  This test
+ * checks that no waiter leaves a phase before all the waiters arrive, around
+ * the default threshold (32) and with external threads among the waiters. */
+
+#define DEFAULT_NUM_XSTREAMS 4
+#define DEFAULT_NUM_ITER 10
+#define NUM_EXT_THREADS 2
+
+int num_xstreams = DEFAULT_NUM_XSTREAMS;
+int num_iter = DEFAULT_NUM_ITER;
+int num_waiters;
+ABT_barrier barrier;
+volatile int g_counter = 0;
+
+static void barrier_loop(void)
+{
+    int i, ret;
+    for (i = 0; i < num_iter; i++) {
+        __sync_fetch_and_add(&g_counter, 1);
+        ret = ABT_barrier_wait(barrier);
+        ATS_ERROR(ret, "ABT_barrier_wait");
+        /* Every waiter has arrived at this phase, and nobody can increment
+         * g_counter until everyone passes the next barrier. */
+        assert(__sync_fetch_and_add(&g_counter, 0) == num_waiters * (i + 1));
+        ret = ABT_barrier_wait(barrier);
+        ATS_ERROR(ret, "ABT_barrier_wait");
+    }
+}
+
+void thread_func(void *arg)
+{
+    ATS_UNUSED(arg);
+    barrier_loop();
+}
+
+void *ext_thread_func(void *arg)
+{
+    ATS_UNUSED(arg);
+    barrier_loop();
+    return NULL;
+}
+
+static void run_test(ABT_pool *pools, int num_threads, int num_ext_threads)
+{
+    ABT_thread *threads;
+    pthread_t ext_threads[NUM_EXT_THREADS];
+    int i, ret;
+
+    threads = (ABT_thread *)malloc(num_threads * sizeof(ABT_thread));
+    num_waiters = num_threads + num_ext_threads;
+    g_counter = 0;
+    ret = ABT_barrier_reinit(barrier, num_waiters);
+    ATS_ERROR(ret, "ABT_barrier_reinit");
+
+    for (i = 0; i < num_threads; i++) {
+        ret = ABT_thread_create(pools[i % num_xstreams], thread_func, NULL,
+                                ABT_THREAD_ATTR_NULL, &threads[i]);
+        ATS_ERROR(ret, "ABT_thread_create");
+    }
+    for (i = 0; i < num_ext_threads; i++) {
+        ret = pthread_create(&ext_threads[i], NULL, ext_thread_func, NULL);
+        assert(ret == 0);
+    }
+    for (i = 0; i < num_threads; i++) {
+        ret = ABT_thread_free(&threads[i]);
+        ATS_ERROR(ret, "ABT_thread_free");
+    }
+    for (i = 0; i < num_ext_threads; i++) {
+        ret = pthread_join(ext_threads[i], NULL);
+        assert(ret == 0);
+    }
+    assert(g_counter == num_waiters * num_iter);
+    free(threads);
+}
+
+int main(int argc, char *argv[])
+{
+    ABT_xstream *xstreams;
+    ABT_pool *pools;
+    int i, ret;
+
+    /* Initialize */
+    ATS_read_args(argc, argv);
+    if (argc >= 2) {
+        num_xstreams = ATS_get_arg_val(ATS_ARG_N_ES);
+        num_iter = ATS_get_arg_val(ATS_ARG_N_ITER);
+    }
+    ATS_init(argc, argv, num_xstreams);
+
+    xstreams = (ABT_xstream *)malloc(num_xstreams * sizeof(ABT_xstream));
+    pools = (ABT_pool *)malloc(num_xstreams * sizeof(ABT_pool));
+
+    ret = ABT_xstream_self(&xstreams[0]);
+    ATS_ERROR(ret, "ABT_xstream_self");
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_create(ABT_SCHED_NULL, &xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_create");
+    }
+    for (i = 0; i < num_xstreams; i++) {
+        ret = ABT_xstream_get_main_pools(xstreams[i], 1, &pools[i]);
+        ATS_ERROR(ret, "ABT_xstream_get_main_pools");
+    }
+
+    ret = ABT_barrier_create(1, &barrier);
+    ATS_ERROR(ret, "ABT_barrier_create");
+
+    /* Below, at, and above the threshold */
+    run_test(pools, 31, 0);
+    run_test(pools, 32, 0);
+    run_test(pools, 200, 0);
+    /* External threads wake up ULTs and vice versa. */
+    run_test(pools, 62, NUM_EXT_THREADS);
+
+    ret = ABT_barrier_free(&barrier);
+    ATS_ERROR(ret, "ABT_barrier_free");
+
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_join(xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_join");
+        ret = ABT_xstream_free(&xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_free");
+    }
+
+    /* Finalize */
+    ret = ATS_finalize(0);
+
+    free(xstreams);
+    free(pools);
+
+    return ret;
+}
@@ -0,0 +1,164 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "abt.h"
+#include "abttest.h"
+
+/* ABT_cond_signal and ABT_cond_broadcast may move waiting ULTs to the waiter
+ * queue of the mutex instead of resuming them.  This test checks that all the
+ * waiters are resumed and own the mutex exclusively when they return from
+ * ABT_cond_wait, with signals and broadcasts issued while the mutex is locked
+ * and unlocked. */
+
+#define DEFAULT_NUM_XSTREAMS 4
+#define DEFAULT_NUM_THREADS 4
+#define DEFAULT_NUM_ITER 30
+
+int num_xstreams = DEFAULT_NUM_XSTREAMS;
+int num_threads = DEFAULT_NUM_THREADS;
+int num_iter = DEFAULT_NUM_ITER;
+int num_waiters;
+ABT_mutex g_mutex;
+ABT_cond g_cond;
+int g_generation = 0;
+int g_arrived = 0;
+volatile int g_in_cs = 0;
+
+static void enter_cs(void)
+{
+    assert(g_in_cs == 0);
+    g_in_cs = 1;
+}
+
+static void leave_cs(void)
+{
+    g_in_cs = 0;
+}
+
+void thread_func(void *arg)
+{
+    int i, j, ret;
+    ATS_UNUSED(arg);
+
+    for (i = 0; i < num_iter; i++) {
+        ret = ABT_mutex_lock(g_mutex);
+        ATS_ERROR(ret, "ABT_mutex_lock");
+        enter_cs();
+        int generation = g_generation;
+        if (++g_arrived < num_waiters) {
+            /* Wait for the last one. */
+            while (generation == g_generation) {
+                leave_cs();
+                ret = ABT_cond_wait(g_cond, g_mutex);
+                ATS_ERROR(ret, "ABT_cond_wait");
+                enter_cs();
+            }
+            leave_cs();
+            ret = ABT_mutex_unlock(g_mutex);
+            ATS_ERROR(ret, "ABT_mutex_unlock");
+            continue;
+        }
+
+        /* The last one wakes up the others, which are all waiting on g_cond
+         * in FIFO order. */
+        g_arrived = 0;
+        g_generation++;
+        if (i % 3 == 0) {
+            ret = ABT_cond_broadcast(g_cond);
+            ATS_ERROR(ret, "ABT_cond_broadcast");
+            leave_cs();
+            ret = ABT_mutex_unlock(g_mutex);
+            ATS_ERROR(ret, "ABT_mutex_unlock");
+        } else if (i % 3 == 1) {
+            for (j = 0; j < num_waiters - 1; j++) {
+                ret = ABT_cond_signal(g_cond);
+                ATS_ERROR(ret, "ABT_cond_signal");
+            }
+            leave_cs();
+            ret = ABT_mutex_unlock(g_mutex);
+            ATS_ERROR(ret, "ABT_mutex_unlock");
+        } else {
+            leave_cs();
+            ret = ABT_mutex_unlock(g_mutex);
+            ATS_ERROR(ret, "ABT_mutex_unlock");
+            for (j = 0; j < num_waiters - 1; j++) {
+                ret = ABT_cond_signal(g_cond);
+                ATS_ERROR(ret, "ABT_cond_signal");
+            }
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    ABT_xstream *xstreams;
+    ABT_pool *pools;
+    ABT_thread *threads;
+    int i, ret;
+
+    /* Initialize */
+    ATS_read_args(argc, argv);
+    if (argc >= 2) {
+        num_xstreams = ATS_get_arg_val(ATS_ARG_N_ES);
+        num_threads = ATS_get_arg_val(ATS_ARG_N_ULT);
+        num_iter = ATS_get_arg_val(ATS_ARG_N_ITER);
+    }
+    ATS_init(argc, argv, num_xstreams);
+
+    num_waiters = num_xstreams * num_threads;
+    xstreams = (ABT_xstream *)malloc(num_xstreams * sizeof(ABT_xstream));
+    pools = (ABT_pool *)malloc(num_xstreams * sizeof(ABT_pool));
+    threads = (ABT_thread *)malloc(num_waiters * sizeof(ABT_thread));
+
+    ret = ABT_xstream_self(&xstreams[0]);
+    ATS_ERROR(ret, "ABT_xstream_self");
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_create(ABT_SCHED_NULL, &xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_create");
+    }
+    for (i = 0; i < num_xstreams; i++) {
+        ret = ABT_xstream_get_main_pools(xstreams[i], 1, &pools[i]);
+        ATS_ERROR(ret, "ABT_xstream_get_main_pools");
+    }
+
+    ret = ABT_mutex_create(&g_mutex);
+    ATS_ERROR(ret, "ABT_mutex_create");
+    ret = ABT_cond_create(&g_cond);
+    ATS_ERROR(ret, "ABT_cond_create");
+
+    for (i = 0; i < num_waiters; i++) {
+        ret = ABT_thread_create(pools[i % num_xstreams], thread_func, NULL,
+                                ABT_THREAD_ATTR_NULL, &threads[i]);
+        ATS_ERROR(ret, "ABT_thread_create");
+    }
+    for (i = 0; i < num_waiters; i++) {
+        ret = ABT_thread_free(&threads[i]);
+        ATS_ERROR(ret, "ABT_thread_free");
+    }
+    assert(g_generation == num_iter && g_arrived == 0);
+
+    ret = ABT_cond_free(&g_cond);
+    ATS_ERROR(ret, "ABT_cond_free");
+    ret = ABT_mutex_free(&g_mutex);
+    ATS_ERROR(ret, "ABT_mutex_free");
+
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_join(xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_join");
+        ret = ABT_xstream_free(&xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_free");
+    }
+
+    /* Finalize */
+    ret = ATS_finalize(0);
+
+    free(xstreams);
+    free(pools);
+    free(threads);
+
+    return ret;
+}
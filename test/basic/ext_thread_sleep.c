@@ -0,0 +1,296 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+#include "abt.h"
+#include "abttest.h"
+
+/* External threads that wait in synchronization sleep after spinning for
+ * ABT_EXT_WAIT_SPINS iterations.  This test disables spinning so that every
+ * wait of external threads sleeps, and checks that work units wake them up
+ * in eventuals, futures, barriers, condition variables, groups, semaphores,
+ * and joins. */
+
+#define DEFAULT_NUM_XSTREAMS 2
+#define DEFAULT_NUM_ITER 10
+#define NUM_EXT_THREADS 2
+#define DELAY_SEC 1.0e-3
+
+int num_xstreams = DEFAULT_NUM_XSTREAMS;
+int num_iter = DEFAULT_NUM_ITER;
+ABT_pool *pools;
+ABT_barrier g_barrier;
+ABT_eventual g_eventual;
+ABT_future g_future;
+ABT_mutex g_mutex;
+ABT_cond g_cond;
+int g_num_cond_waiters = 0;
+int g_cond_flag = 0;
+volatile int g_counter = 0;
+
+static void delay(void)
+{
+    double start = ABT_get_wtime();
+    while (ABT_get_wtime() - start < DELAY_SEC)
+        ABT_thread_yield();
+}
+
+void eventual_setter(void *arg)
+{
+    ATS_UNUSED(arg);
+    delay();
+    int ret = ABT_eventual_set(g_eventual, NULL, 0);
+    ATS_ERROR(ret, "ABT_eventual_set");
+}
+
+void future_setter(void *arg)
+{
+    ATS_UNUSED(arg);
+    delay();
+    int ret = ABT_future_set(g_future, NULL);
+    ATS_ERROR(ret, "ABT_future_set");
+}
+
+void cond_signaler(void *arg)
+{
+    ATS_UNUSED(arg);
+    while (1) {
+        ABT_mutex_lock(g_mutex);
+        if (g_num_cond_waiters == NUM_EXT_THREADS) {
+            g_cond_flag = 1;
+            ABT_cond_broadcast(g_cond);
+            ABT_mutex_unlock(g_mutex);
+            break;
+        }
+        ABT_mutex_unlock(g_mutex);
+        ABT_thread_yield();
+    }
+}
+
+void sem_releaser(void *arg)
+{
+    delay();
+    int ret = ABT_sem_release((ABT_sem)arg, 2);
+    ATS_ERROR(ret, "ABT_sem_release");
+}
+
+void delayed_thread(void *arg)
+{
+    ATS_UNUSED(arg);
+    delay();
+    __sync_fetch_and_add(&g_counter, 1);
+}
+
+void delayed_task(void *arg)
+{
+    ATS_UNUSED(arg);
+    double start = ABT_get_wtime();
+    while (ABT_get_wtime() - start < DELAY_SEC)
+        ;
+    __sync_fetch_and_add(&g_counter, 1);
+}
+
+static void get_abstime(struct timespec *p_abstime, double sec)
+{
+    clock_gettime(CLOCK_REALTIME, p_abstime);
+    p_abstime->tv_sec += (time_t)sec;
+    p_abstime->tv_nsec += (long)((sec - (double)(time_t)sec) * 1.0e9);
+    if (p_abstime->tv_nsec >= 1000000000) {
+        p_abstime->tv_sec += 1;
+        p_abstime->tv_nsec -= 1000000000;
+    }
+}
+
+void *ext_thread_func(void *arg)
+{
+    int id = (int)(intptr_t)arg;
+    int i, ret;
+    ABT_pool pool = pools[id % num_xstreams];
+    struct timespec abstime;
+
+    for (i = 0; i < num_iter; i++) {
+        /* Eventual and future set by ULTs */
+        ret = ABT_eventual_wait(g_eventual, NULL);
+        ATS_ERROR(ret, "ABT_eventual_wait");
+        ret = ABT_future_wait(g_future);
+        ATS_ERROR(ret, "ABT_future_wait");
+        ret = ABT_barrier_wait(g_barrier);
+        ATS_ERROR(ret, "ABT_barrier_wait");
+
+        /* Timed wait that times out, and then one that is signaled */
+        ABT_mutex_lock(g_mutex);
+        get_abstime(&abstime, DELAY_SEC);
+        ret = ABT_cond_timedwait(g_cond, g_mutex, &abstime);
+        assert(ret == ABT_ERR_COND_TIMEDOUT);
+        g_num_cond_waiters++;
+        while (!g_cond_flag) {
+            get_abstime(&abstime, 60.0);
+            ret = ABT_cond_timedwait(g_cond, g_mutex, &abstime);
+            ATS_ERROR(ret, "ABT_cond_timedwait");
+        }
+        ABT_mutex_unlock(g_mutex);
+        ret = ABT_barrier_wait(g_barrier);
+        ATS_ERROR(ret, "ABT_barrier_wait");
+
+        /* Joins of a ULT and a tasklet */
+        ABT_thread thread;
+        ABT_task task;
+        ret = ABT_thread_create(pool, delayed_thread, NULL,
+                                ABT_THREAD_ATTR_NULL, &thread);
+        ATS_ERROR(ret, "ABT_thread_create");
+        ret = ABT_task_create(pool, delayed_task, NULL, &task);
+        ATS_ERROR(ret, "ABT_task_create");
+        ret = ABT_thread_free(&thread);
+        ATS_ERROR(ret, "ABT_thread_free");
+        ret = ABT_task_free(&task);
+        ATS_ERROR(ret, "ABT_task_free");
+
+        /* Group */
+        ABT_group group;
+        ret = ABT_group_create(&group);
+        ATS_ERROR(ret, "ABT_group_create");
+        ret = ABT_group_thread_create(group, pool, delayed_thread, NULL,
+                                      ABT_THREAD_ATTR_NULL);
+        ATS_ERROR(ret, "ABT_group_thread_create");
+        ret = ABT_group_wait(group);
+        ATS_ERROR(ret, "ABT_group_wait");
+        ret = ABT_group_free(&group);
+        ATS_ERROR(ret, "ABT_group_free");
+
+        /* Timed acquisition that times out, and then one that is woken up */
+        ABT_sem sem;
+        ret = ABT_sem_create(1, &sem);
+        ATS_ERROR(ret, "ABT_sem_create");
+        get_abstime(&abstime, DELAY_SEC);
+        ret = ABT_sem_timedacquire(sem, 2, &abstime);
+        assert(ret == ABT_ERR_SEM_TIMEDOUT);
+        ret = ABT_thread_create(pool, sem_releaser, (void *)sem,
+                                ABT_THREAD_ATTR_NULL, &thread);
+        ATS_ERROR(ret, "ABT_thread_create");
+        ret = ABT_sem_acquire(sem, 3);
+        ATS_ERROR(ret, "ABT_sem_acquire");
+        ret = ABT_thread_free(&thread);
+        ATS_ERROR(ret, "ABT_thread_free");
+        ret = ABT_sem_free(&sem);
+        ATS_ERROR(ret, "ABT_sem_free");
+
+        ret = ABT_barrier_wait(g_barrier);
+        ATS_ERROR(ret, "ABT_barrier_wait");
+    }
+    return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+    ABT_xstream *xstreams;
+    ABT_thread thread;
+    pthread_t ext_threads[NUM_EXT_THREADS];
+    int i, ret;
+
+    /* External threads sleep without spinning. */
+    setenv("ABT_EXT_WAIT_SPINS", "0", 1);
+
+    /* Initialize */
+    ATS_read_args(argc, argv);
+    if (argc >= 2) {
+        num_xstreams = ATS_get_arg_val(ATS_ARG_N_ES);
+        num_iter = ATS_get_arg_val(ATS_ARG_N_ITER);
+    }
+    ATS_init(argc, argv, num_xstreams);
+
+    xstreams = (ABT_xstream *)malloc(num_xstreams * sizeof(ABT_xstream));
+    pools = (ABT_pool *)malloc(num_xstreams * sizeof(ABT_pool));
+
+    ret = ABT_xstream_self(&xstreams[0]);
+    ATS_ERROR(ret, "ABT_xstream_self");
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_create(ABT_SCHED_NULL, &xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_create");
+    }
+    for (i = 0; i < num_xstreams; i++) {
+        ret = ABT_xstream_get_main_pools(xstreams[i], 1, &pools[i]);
+        ATS_ERROR(ret, "ABT_xstream_get_main_pools");
+    }
+
+    ret = ABT_barrier_create(NUM_EXT_THREADS + 1, &g_barrier);
+    ATS_ERROR(ret, "ABT_barrier_create");
+    ret = ABT_eventual_create(0, &g_eventual);
+    ATS_ERROR(ret, "ABT_eventual_create");
+    ret = ABT_future_create(1, NULL, &g_future);
+    ATS_ERROR(ret, "ABT_future_create");
+    ret = ABT_mutex_create(&g_mutex);
+    ATS_ERROR(ret, "ABT_mutex_create");
+    ret = ABT_cond_create(&g_cond);
+    ATS_ERROR(ret, "ABT_cond_create");
+
+    for (i = 0; i < NUM_EXT_THREADS; i++) {
+        ret = pthread_create(&ext_threads[i], NULL, ext_thread_func,
+                             (void *)(intptr_t)i);
+        assert(ret == 0);
+    }
+
+    for (i = 0; i < num_iter; i++) {
+        ret = ABT_thread_create(pools[i % num_xstreams], eventual_setter, NULL,
+                                ABT_THREAD_ATTR_NULL, NULL);
+        ATS_ERROR(ret, "ABT_thread_create");
+        ret = ABT_thread_create(pools[i % num_xstreams], future_setter, NULL,
+                                ABT_THREAD_ATTR_NULL, NULL);
+        ATS_ERROR(ret, "ABT_thread_create");
+        ret = ABT_barrier_wait(g_barrier);
+        ATS_ERROR(ret, "ABT_barrier_wait");
+        ret = ABT_eventual_reset(g_eventual);
+        ATS_ERROR(ret, "ABT_eventual_reset");
+        ret = ABT_future_reset(g_future);
+        ATS_ERROR(ret, "ABT_future_reset");
+
+        ret = ABT_thread_create(pools[i % num_xstreams], cond_signaler, NULL,
+                                ABT_THREAD_ATTR_NULL, &thread);
+        ATS_ERROR(ret, "ABT_thread_create");
+        ret = ABT_barrier_wait(g_barrier);
+        ATS_ERROR(ret, "ABT_barrier_wait");
+        ret = ABT_thread_free(&thread);
+        ATS_ERROR(ret, "ABT_thread_free");
+        g_num_cond_waiters = 0;
+        g_cond_flag = 0;
+
+        ret = ABT_barrier_wait(g_barrier);
+        ATS_ERROR(ret, "ABT_barrier_wait");
+    }
+
+    for (i = 0; i < NUM_EXT_THREADS; i++) {
+        ret = pthread_join(ext_threads[i], NULL);
+        assert(ret == 0);
+    }
+    assert(g_counter == 3 * NUM_EXT_THREADS * num_iter);
+
+    ret = ABT_barrier_free(&g_barrier);
+    ATS_ERROR(ret, "ABT_barrier_free");
+    ret = ABT_eventual_free(&g_eventual);
+    ATS_ERROR(ret, "ABT_eventual_free");
+    ret = ABT_future_free(&g_future);
+    ATS_ERROR(ret, "ABT_future_free");
+    ret = ABT_mutex_free(&g_mutex);
+    ATS_ERROR(ret, "ABT_mutex_free");
+    ret = ABT_cond_free(&g_cond);
+    ATS_ERROR(ret, "ABT_cond_free");
+
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_join(xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_join");
+        ret = ABT_xstream_free(&xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_free");
+    }
+
+    /* Finalize */
+    ret = ATS_finalize(0);
+
+    free(xstreams);
+    free(pools);
+
+    return ret;
+}
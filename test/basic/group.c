@@ -0,0 +1,290 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include "abt.h"
+#include "abttest.h"
+
+/* ABT_group_wait() must return after all the ULTs and tasklets in a group,
+ * including those added by the members themselves, have finished.  Members
+ * can also wait on their own nested groups.  When two ULTs wait on the same
+ * group at the same time, one of them fails and the other is woken up. */
+
+#define DEFAULT_NUM_XSTREAMS 4
+#define DEFAULT_NUM_UNITS 32
+#define NUM_ITER 4
+#define NESTED_DEPTH 3
+#define NESTED_WIDTH 3
+
+int num_xstreams = DEFAULT_NUM_XSTREAMS;
+int num_units = DEFAULT_NUM_UNITS;
+ABT_pool *pools;
+volatile int num_done = 0;
+volatile int is_released = 0;
+volatile int num_wait_errors = 0;
+volatile int num_wait_successes = 0;
+
+typedef struct {
+    ABT_group group;
+    int depth;
+    int idx;
+} nested_arg_t;
+
+void unit_func(void *arg)
+{
+    ATS_UNUSED(arg);
+    __sync_fetch_and_add(&num_done, 1);
+}
+
+void yield_func(void *arg)
+{
+    ATS_UNUSED(arg);
+    int ret = ABT_thread_yield();
+    ATS_ERROR(ret, "ABT_thread_yield");
+    __sync_fetch_and_add(&num_done, 1);
+}
+
+/* Adds a tasklet to the group this ULT belongs to. */
+void spawn_func(void *arg)
+{
+    ABT_group group = (ABT_group)arg;
+    int rank, ret;
+    ret = ABT_xstream_self_rank(&rank);
+    ATS_ERROR(ret, "ABT_xstream_self_rank");
+    ret = ABT_group_task_create(group, pools[(rank + 1) % num_xstreams],
+                                unit_func, NULL);
+    ATS_ERROR(ret, "ABT_group_task_create");
+    __sync_fetch_and_add(&num_done, 1);
+}
+
+/* Blocks the group until the main ULT releases it. */
+void blocker_func(void *arg)
+{
+    ATS_UNUSED(arg);
+    while (!is_released)
+        ABT_thread_yield();
+}
+
+void double_wait_func(void *arg)
+{
+    int ret = ABT_group_wait((ABT_group)arg);
+    if (ret == ABT_ERR_GROUP) {
+        __sync_fetch_and_add(&num_wait_errors, 1);
+    } else {
+        ATS_ERROR(ret, "ABT_group_wait");
+        __sync_fetch_and_add(&num_wait_successes, 1);
+    }
+}
+
+/* Forks a nested group of ULTs and tasklets and waits on it. */
+void nested_func(void *arg)
+{
+    nested_arg_t *p_arg = (nested_arg_t *)arg;
+    nested_arg_t child_args[NESTED_WIDTH];
+    ABT_group group;
+    int i, ret;
+
+    __sync_fetch_and_add(&num_done, 1);
+    if (p_arg->depth == NESTED_DEPTH)
+        return;
+
+    ret = ABT_group_create(&group);
+    ATS_ERROR(ret, "ABT_group_create");
+    for (i = 0; i < NESTED_WIDTH; i++) {
+        ABT_pool pool = pools[(p_arg->idx + i) % num_xstreams];
+        child_args[i].group = group;
+        child_args[i].depth = p_arg->depth + 1;
+        child_args[i].idx = p_arg->idx + i + 1;
+        ret = ABT_group_thread_create(group, pool, nested_func, &child_args[i],
+                                      ABT_THREAD_ATTR_NULL);
+        ATS_ERROR(ret, "ABT_group_thread_create");
+        ret = ABT_group_task_create(group, pool, unit_func, NULL);
+        ATS_ERROR(ret, "ABT_group_task_create");
+    }
+    ret = ABT_group_wait(group);
+    ATS_ERROR(ret, "ABT_group_wait");
+    ret = ABT_group_free(&group);
+    ATS_ERROR(ret, "ABT_group_free");
+}
+
+static int num_nested_units(int depth)
+{
+    /* A ULT at depth d creates NESTED_WIDTH ULTs and tasklets. */
+    if (depth == NESTED_DEPTH)
+        return 1;
+    return 1 + NESTED_WIDTH * (1 + num_nested_units(depth + 1));
+}
+
+static void double_wait(void)
+{
+    ABT_group group;
+    ABT_thread waiters[2];
+    int i, ret;
+
+    is_released = 0;
+    num_wait_errors = 0;
+    num_wait_successes = 0;
+    ret = ABT_group_create(&group);
+    ATS_ERROR(ret, "ABT_group_create");
+    ret = ABT_group_thread_create(group, pools[1 % num_xstreams], blocker_func,
+                                  NULL, ABT_THREAD_ATTR_NULL);
+    ATS_ERROR(ret, "ABT_group_thread_create");
+    for (i = 0; i < 2; i++) {
+        ret = ABT_thread_create(pools[(i + 2) % num_xstreams],
+                                double_wait_func, (void *)group,
+                                ABT_THREAD_ATTR_NULL, &waiters[i]);
+        ATS_ERROR(ret, "ABT_thread_create");
+    }
+    /* The group cannot finish until it is released, so one of the waiters
+     * must fail. */
+    while (num_wait_errors == 0)
+        ABT_thread_yield();
+    assert(num_wait_successes == 0);
+    is_released = 1;
+    for (i = 0; i < 2; i++) {
+        ret = ABT_thread_free(&waiters[i]);
+        ATS_ERROR(ret, "ABT_thread_free");
+    }
+    assert(num_wait_errors == 1 && num_wait_successes == 1);
+    ret = ABT_group_free(&group);
+    ATS_ERROR(ret, "ABT_group_free");
+}
+
+static void fork_join(ABT_group group, ABT_thread_attr attr)
+{
+    int i, ret, expected = 0;
+    size_t num;
+
+    num_done = 0;
+    for (i = 0; i < num_units; i++) {
+        ABT_pool pool = pools[i % num_xstreams];
+        ret = ABT_group_thread_create(group, pool, yield_func, NULL, attr);
+        ATS_ERROR(ret, "ABT_group_thread_create");
+        ret = ABT_group_task_create(group, pool, unit_func, NULL);
+        ATS_ERROR(ret, "ABT_group_task_create");
+        ret = ABT_group_thread_create(group, pool, spawn_func, (void *)group,
+                                      attr);
+        ATS_ERROR(ret, "ABT_group_thread_create");
+        expected += 4;
+    }
+    ret = ABT_group_wait(group);
+    ATS_ERROR(ret, "ABT_group_wait");
+    assert(num_done == expected);
+    ret = ABT_group_get_num_units(group, &num);
+    ATS_ERROR(ret, "ABT_group_get_num_units");
+    assert(num == 0);
+}
+
+void main_func(void *arg)
+{
+    ABT_group group;
+    ABT_thread_attr attr;
+    nested_arg_t nested_arg;
+    int i, ret;
+    ATS_UNUSED(arg);
+
+    ret = ABT_thread_attr_create(&attr);
+    ATS_ERROR(ret, "ABT_thread_attr_create");
+    ret = ABT_thread_attr_set_stacksize(attr, 32768);
+    ATS_ERROR(ret, "ABT_thread_attr_set_stacksize");
+
+    /* A group can be reused after waiting. */
+    ret = ABT_group_create(&group);
+    ATS_ERROR(ret, "ABT_group_create");
+    for (i = 0; i < NUM_ITER; i++)
+        fork_join(group, (i % 2) ? attr : ABT_THREAD_ATTR_NULL);
+
+    /* Waiting on an empty group returns immediately. */
+    ret = ABT_group_wait(group);
+    ATS_ERROR(ret, "ABT_group_wait");
+    ret = ABT_group_free(&group);
+    ATS_ERROR(ret, "ABT_group_free");
+
+    /* Nested groups */
+    num_done = 0;
+    nested_arg.group = ABT_GROUP_NULL;
+    nested_arg.depth = 0;
+    nested_arg.idx = 0;
+    nested_func(&nested_arg);
+    assert(num_done == num_nested_units(0));
+
+    ret = ABT_thread_attr_free(&attr);
+    ATS_ERROR(ret, "ABT_thread_attr_free");
+}
+
+int main(int argc, char *argv[])
+{
+    ABT_xstream *xstreams;
+    ABT_thread thread;
+    ABT_group group;
+    int i, ret;
+
+    /* Initialize */
+    ATS_read_args(argc, argv);
+    if (argc >= 2) {
+        num_xstreams = ATS_get_arg_val(ATS_ARG_N_ES);
+        num_units = ATS_get_arg_val(ATS_ARG_N_ULT);
+    }
+    ATS_init(argc, argv, num_xstreams);
+
+    xstreams = (ABT_xstream *)malloc(num_xstreams * sizeof(ABT_xstream));
+    pools = (ABT_pool *)malloc(num_xstreams * sizeof(ABT_pool));
+
+    ret = ABT_xstream_self(&xstreams[0]);
+    ATS_ERROR(ret, "ABT_xstream_self");
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_create(ABT_SCHED_NULL, &xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_create");
+    }
+    for (i = 0; i < num_xstreams; i++) {
+        ret = ABT_xstream_get_main_pools(xstreams[i], 1, &pools[i]);
+        ATS_ERROR(ret, "ABT_xstream_get_main_pools");
+    }
+
+    /* The primary ULT waits on a group. */
+    main_func(NULL);
+
+    /* A ULT on another ES waits on a group. */
+    ret = ABT_thread_create(pools[num_xstreams - 1], main_func, NULL,
+                            ABT_THREAD_ATTR_NULL, &thread);
+    ATS_ERROR(ret, "ABT_thread_create");
+    ret = ABT_thread_free(&thread);
+    ATS_ERROR(ret, "ABT_thread_free");
+
+    /* A group with outstanding work units cannot be freed.  The ULT cannot
+     * run on this ES until the primary ULT waits. */
+    ret = ABT_group_create(&group);
+    ATS_ERROR(ret, "ABT_group_create");
+    ret = ABT_group_thread_create(group, pools[0], unit_func, NULL,
+                                  ABT_THREAD_ATTR_NULL);
+    ATS_ERROR(ret, "ABT_group_thread_create");
+    ret = ABT_group_free(&group);
+    assert(ret == ABT_ERR_GROUP);
+    ret = ABT_group_wait(group);
+    ATS_ERROR(ret, "ABT_group_wait");
+    ret = ABT_group_free(&group);
+    ATS_ERROR(ret, "ABT_group_free");
+
+    /* Two ULTs wait on the same group concurrently. */
+    for (i = 0; i < NUM_ITER; i++)
+        double_wait();
+
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_join(xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_join");
+        ret = ABT_xstream_free(&xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_free");
+    }
+
+    /* Finalize */
+    ret = ATS_finalize(0);
+
+    free(xstreams);
+    free(pools);
+
+    return ret;
+}
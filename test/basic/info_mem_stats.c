@@ -0,0 +1,151 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include "abt.h"
+#include "abttest.h"
+
+#define DEFAULT_NUM_XSTREAMS 2
+#define DEFAULT_NUM_THREADS 64
+
+void thread_func(void *arg)
+{
+    ABT_thread_yield();
+}
+
+void task_func(void *arg)
+{
+    /* Do nothing. */
+}
+
+static uint64_t get_num_allocs(const ABT_mem_pool_stats *p_stats)
+{
+    return p_stats->num_local_hits + p_stats->num_local_misses;
+}
+
+static void print_stats(const char *name, const ABT_mem_pool_stats *p_stats)
+{
+    ATS_printf(1,
+               "[%s] pages (malloc/memalign/mmap/mmap_hp): "
+               "%llu/%llu/%llu/%llu, bytes: %llu, buckets: %llu, "
+               "hit/miss: %llu/%llu, remote frees: %llu, malloc: %llu\n",
+               name, (unsigned long long)p_stats->num_pages_malloc,
+               (unsigned long long)p_stats->num_pages_memalign,
+               (unsigned long long)p_stats->num_pages_mmap,
+               (unsigned long long)p_stats->num_pages_mmap_hugepage,
+               (unsigned long long)p_stats->num_bytes,
+               (unsigned long long)p_stats->num_buckets_in_flight,
+               (unsigned long long)p_stats->num_local_hits,
+               (unsigned long long)p_stats->num_local_misses,
+               (unsigned long long)p_stats->num_remote_frees,
+               (unsigned long long)p_stats->num_malloc_fallbacks);
+}
+
+int main(int argc, char *argv[])
+{
+    ABT_xstream *xstreams;
+    ABT_pool pool;
+    ABT_thread *threads;
+    ABT_task *tasks;
+    ABT_mem_stats global_stats, local_stats;
+    int num_xstreams, num_threads;
+    int i, ret;
+
+    /* Initialize */
+    ATS_read_args(argc, argv);
+    if (argc < 2) {
+        num_xstreams = DEFAULT_NUM_XSTREAMS;
+        num_threads = DEFAULT_NUM_THREADS;
+    } else {
+        num_xstreams = ATS_get_arg_val(ATS_ARG_N_ES);
+        num_threads = ATS_get_arg_val(ATS_ARG_N_ULT);
+    }
+    ATS_init(argc, argv, num_xstreams);
+
+    xstreams = (ABT_xstream *)malloc(num_xstreams * sizeof(ABT_xstream));
+    threads = (ABT_thread *)malloc(num_threads * sizeof(ABT_thread));
+    tasks = (ABT_task *)malloc(num_threads * sizeof(ABT_task));
+
+    /* Create execution streams */
+    ret = ABT_xstream_self(&xstreams[0]);
+    ATS_ERROR(ret, "ABT_xstream_self");
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_create(ABT_SCHED_NULL, &xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_create");
+    }
+    ret = ABT_xstream_get_main_pools(xstreams[0], 1, &pool);
+    ATS_ERROR(ret, "ABT_xstream_get_main_pools");
+
+    /* The primary ES allocates all the ULTs and tasklets. */
+    for (i = 0; i < num_threads; i++) {
+        ret = ABT_thread_create(pool, thread_func, NULL,
+                                ABT_THREAD_ATTR_NULL, &threads[i]);
+        ATS_ERROR(ret, "ABT_thread_create");
+        ret = ABT_task_create(pool, task_func, NULL, &tasks[i]);
+        ATS_ERROR(ret, "ABT_task_create");
+    }
+    for (i = 0; i < num_threads; i++) {
+        ret = ABT_thread_free(&threads[i]);
+        ATS_ERROR(ret, "ABT_thread_free");
+        ret = ABT_task_free(&tasks[i]);
+        ATS_ERROR(ret, "ABT_task_free");
+    }
+
+    ret = ABT_info_query_mem_stats(xstreams[0], &local_stats);
+    ATS_ERROR(ret, "ABT_info_query_mem_stats");
+    ret = ABT_info_query_mem_stats(ABT_XSTREAM_NULL, &global_stats);
+    ATS_ERROR(ret, "ABT_info_query_mem_stats");
+    print_stats("ES0 stack", &local_stats.stack);
+    print_stats("ES0 desc", &local_stats.desc);
+    print_stats("global stack", &global_stats.stack);
+    print_stats("global desc", &global_stats.desc);
+
+    /* The memory pool might be disabled. */
+    if (global_stats.stack.num_bytes != 0) {
+        /* Pages belong to the global pool. */
+        assert(local_stats.stack.num_pages_malloc == 0);
+        assert(local_stats.desc.num_pages_malloc == 0);
+        assert(local_stats.stack.num_buckets_in_flight > 0);
+        assert(get_num_allocs(&local_stats.stack) >= num_threads);
+        assert(get_num_allocs(&local_stats.desc) >= num_threads);
+        assert(get_num_allocs(&global_stats.stack) >=
+               get_num_allocs(&local_stats.stack));
+        assert(get_num_allocs(&global_stats.desc) >=
+               get_num_allocs(&local_stats.desc));
+        assert(global_stats.stack.num_pages_malloc +
+                   global_stats.stack.num_pages_memalign +
+                   global_stats.stack.num_pages_mmap +
+                   global_stats.stack.num_pages_mmap_hugepage >
+               0);
+    }
+
+    /* Join and free execution streams */
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_join(xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_join");
+        ret = ABT_xstream_free(&xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_free");
+    }
+
+    /* Counters of freed ESs must be kept. */
+    ABT_mem_stats retired_stats;
+    ret = ABT_info_query_mem_stats(ABT_XSTREAM_NULL, &retired_stats);
+    ATS_ERROR(ret, "ABT_info_query_mem_stats");
+    assert(get_num_allocs(&retired_stats.stack) >=
+           get_num_allocs(&global_stats.stack));
+    assert(get_num_allocs(&retired_stats.desc) >=
+           get_num_allocs(&global_stats.desc));
+
+    /* Finalize */
+    ret = ATS_finalize(0);
+
+    free(xstreams);
+    free(threads);
+    free(tasks);
+
+    return ret;
+}
@@ -0,0 +1,178 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include "abt.h"
+#include "abttest.h"
+
+/* External threads create and free ULTs and tasklets with their own local
+ * pools.  A long-lived external thread keeps working across ABT_finalize() and
+ * ABT_init(), while short-lived ones return their local pools at exit. */
+
+#define DEFAULT_NUM_PTHREADS 4
+#define DEFAULT_NUM_THREADS 64
+#define NUM_ROUNDS 2
+
+int num_pthreads = DEFAULT_NUM_PTHREADS;
+int num_threads = DEFAULT_NUM_THREADS;
+ABT_xstream xstream;
+ABT_pool pool;
+volatile int round_barrier_count = 0;
+volatile int round_barrier_sense = 0;
+
+/* A barrier for the main thread and the long-lived external thread.
+ * pthread_barrier_t is not available on all platforms. */
+void round_barrier_wait(void)
+{
+    int sense = round_barrier_sense;
+    if (__sync_add_and_fetch(&round_barrier_count, 1) == 2) {
+        round_barrier_count = 0;
+        __sync_synchronize();
+        round_barrier_sense = !sense;
+    } else {
+        while (round_barrier_sense == sense)
+            sched_yield();
+    }
+}
+
+void thread_func(void *arg)
+{
+    ABT_thread_yield();
+}
+
+void task_func(void *arg)
+{
+    /* Do nothing. */
+}
+
+void create_and_free(void)
+{
+    int i, ret;
+    ABT_thread *threads =
+        (ABT_thread *)malloc(num_threads * sizeof(ABT_thread));
+    ABT_task *tasks = (ABT_task *)malloc(num_threads * sizeof(ABT_task));
+    for (i = 0; i < num_threads; i++) {
+        ret = ABT_thread_create(pool, thread_func, NULL, ABT_THREAD_ATTR_NULL,
+                                &threads[i]);
+        ATS_ERROR(ret, "ABT_thread_create");
+        ret = ABT_task_create(pool, task_func, NULL, &tasks[i]);
+        ATS_ERROR(ret, "ABT_task_create");
+    }
+    for (i = 0; i < num_threads; i++) {
+        ret = ABT_thread_free(&threads[i]);
+        ATS_ERROR(ret, "ABT_thread_free");
+        ret = ABT_task_free(&tasks[i]);
+        ATS_ERROR(ret, "ABT_task_free");
+    }
+    free(threads);
+    free(tasks);
+}
+
+void *short_lived_func(void *arg)
+{
+    create_and_free();
+    return NULL;
+}
+
+void *long_lived_func(void *arg)
+{
+    int round;
+    for (round = 0; round < NUM_ROUNDS; round++) {
+        round_barrier_wait();
+        create_and_free();
+        round_barrier_wait();
+    }
+    return NULL;
+}
+
+void setup_xstream(void)
+{
+    int ret;
+    ret = ABT_xstream_create(ABT_SCHED_NULL, &xstream);
+    ATS_ERROR(ret, "ABT_xstream_create");
+    ret = ABT_xstream_get_main_pools(xstream, 1, &pool);
+    ATS_ERROR(ret, "ABT_xstream_get_main_pools");
+}
+
+void free_xstream(void)
+{
+    int ret;
+    ret = ABT_xstream_join(xstream);
+    ATS_ERROR(ret, "ABT_xstream_join");
+    ret = ABT_xstream_free(&xstream);
+    ATS_ERROR(ret, "ABT_xstream_free");
+}
+
+int main(int argc, char *argv[])
+{
+    pthread_t long_lived, *short_lived;
+    ABT_mem_stats stats;
+    int i, round, ret;
+
+    /* Initialize */
+    ATS_read_args(argc, argv);
+    if (argc >= 2) {
+        num_pthreads = ATS_get_arg_val(ATS_ARG_N_ES);
+        num_threads = ATS_get_arg_val(ATS_ARG_N_ULT);
+    }
+    ATS_init(argc, argv, 2);
+    setup_xstream();
+
+    short_lived = (pthread_t *)malloc(num_pthreads * sizeof(pthread_t));
+    ret = pthread_create(&long_lived, NULL, long_lived_func, NULL);
+    assert(ret == 0);
+
+    for (round = 0; round < NUM_ROUNDS; round++) {
+        if (round != 0) {
+            /* Restart Argobots while the long-lived external thread is
+             * alive. */
+            free_xstream();
+            ret = ABT_finalize();
+            ATS_ERROR(ret, "ABT_finalize");
+            setenv("ABT_MAX_NUM_XSTREAMS", "2", 1);
+            ret = ABT_init(argc, argv);
+            ATS_ERROR(ret, "ABT_init");
+            setup_xstream();
+        }
+        round_barrier_wait();
+        for (i = 0; i < num_pthreads; i++) {
+            ret = pthread_create(&short_lived[i], NULL, short_lived_func,
+                                 NULL);
+            assert(ret == 0);
+        }
+        for (i = 0; i < num_pthreads; i++) {
+            ret = pthread_join(short_lived[i], NULL);
+            assert(ret == 0);
+        }
+        round_barrier_wait();
+
+        ret = ABT_info_query_mem_stats(ABT_XSTREAM_NULL, &stats);
+        ATS_ERROR(ret, "ABT_info_query_mem_stats");
+        ATS_printf(1, "[round %d] stack: hit %llu, miss %llu, malloc %llu\n",
+                   round, (unsigned long long)stats.stack.num_local_hits,
+                   (unsigned long long)stats.stack.num_local_misses,
+                   (unsigned long long)stats.stack.num_malloc_fallbacks);
+        /* The memory pool might be disabled. */
+        if (stats.stack.num_bytes != 0) {
+            uint64_t num_allocs = (uint64_t)(num_pthreads + 1) * num_threads;
+            assert(stats.stack.num_local_hits + stats.stack.num_local_misses >=
+                   num_allocs);
+            assert(stats.desc.num_local_hits + stats.desc.num_local_misses >=
+                   num_allocs);
+            assert(stats.desc.num_malloc_fallbacks == 0);
+        }
+    }
+    ret = pthread_join(long_lived, NULL);
+    assert(ret == 0);
+    free(short_lived);
+
+    /* Finalize */
+    free_xstream();
+    return ATS_finalize(0);
+}
@@ -0,0 +1,121 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include "abt.h"
+#include "abttest.h"
+
+/* ULTs and tasklets are allocated by the producer ES and freed by the primary
+ * ES, so all of them are freed remotely and returned to the producer ES. */
+
+#define DEFAULT_NUM_THREADS 256
+#define DEFAULT_NUM_ITER 8
+
+int num_threads = DEFAULT_NUM_THREADS;
+ABT_thread *threads;
+ABT_task *tasks;
+ABT_pool consumer_pool;
+
+void thread_func(void *arg)
+{
+    ABT_thread_yield();
+}
+
+void task_func(void *arg)
+{
+    /* Do nothing. */
+}
+
+void producer_func(void *arg)
+{
+    int i, ret;
+    for (i = 0; i < num_threads; i++) {
+        ret = ABT_thread_create(consumer_pool, thread_func, NULL,
+                                ABT_THREAD_ATTR_NULL, &threads[i]);
+        ATS_ERROR(ret, "ABT_thread_create");
+        ret = ABT_task_create(consumer_pool, task_func, NULL, &tasks[i]);
+        ATS_ERROR(ret, "ABT_task_create");
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    ABT_xstream xstreams[2];
+    ABT_thread producer;
+    ABT_mem_stats stats;
+    int num_iter = DEFAULT_NUM_ITER;
+    int i, iter, ret;
+
+    setenv("ABT_MEM_REMOTE_RETURN", "1", 1);
+
+    /* Initialize */
+    ATS_read_args(argc, argv);
+    if (argc >= 2) {
+        num_threads = ATS_get_arg_val(ATS_ARG_N_ULT);
+        num_iter = ATS_get_arg_val(ATS_ARG_N_ITER);
+    }
+    ATS_init(argc, argv, 2);
+
+    threads = (ABT_thread *)malloc(num_threads * sizeof(ABT_thread));
+    tasks = (ABT_task *)malloc(num_threads * sizeof(ABT_task));
+
+    ret = ABT_xstream_self(&xstreams[0]);
+    ATS_ERROR(ret, "ABT_xstream_self");
+    ret = ABT_xstream_get_main_pools(xstreams[0], 1, &consumer_pool);
+    ATS_ERROR(ret, "ABT_xstream_get_main_pools");
+    ret = ABT_xstream_create(ABT_SCHED_NULL, &xstreams[1]);
+    ATS_ERROR(ret, "ABT_xstream_create");
+
+    for (iter = 0; iter < num_iter; iter++) {
+        ret = ABT_thread_create_on_xstream(xstreams[1], producer_func, NULL,
+                                           ABT_THREAD_ATTR_NULL, &producer);
+        ATS_ERROR(ret, "ABT_thread_create_on_xstream");
+        ret = ABT_thread_free(&producer);
+        ATS_ERROR(ret, "ABT_thread_free");
+        for (i = 0; i < num_threads; i++) {
+            ret = ABT_thread_free(&threads[i]);
+            ATS_ERROR(ret, "ABT_thread_free");
+            ret = ABT_task_free(&tasks[i]);
+            ATS_ERROR(ret, "ABT_task_free");
+        }
+    }
+
+    ret = ABT_info_query_mem_stats(xstreams[0], &stats);
+    ATS_ERROR(ret, "ABT_info_query_mem_stats");
+    ATS_printf(1, "ES0 remote frees: stack %llu, desc %llu\n",
+               (unsigned long long)stats.stack.num_remote_frees,
+               (unsigned long long)stats.desc.num_remote_frees);
+    /* The memory pool might be disabled. */
+    if (stats.stack.num_bytes != 0) {
+        assert(stats.stack.num_remote_frees >=
+               (uint64_t)num_threads * num_iter);
+        assert(stats.desc.num_remote_frees >=
+               (uint64_t)num_threads * num_iter);
+    }
+
+    /* Join and free the producer ES.  Its local pools take back the returned
+     * memory. */
+    ret = ABT_xstream_join(xstreams[1]);
+    ATS_ERROR(ret, "ABT_xstream_join");
+    ret = ABT_xstream_free(&xstreams[1]);
+    ATS_ERROR(ret, "ABT_xstream_free");
+
+    ret = ABT_info_query_mem_stats(ABT_XSTREAM_NULL, &stats);
+    ATS_ERROR(ret, "ABT_info_query_mem_stats");
+    if (stats.stack.num_bytes != 0) {
+        assert(stats.stack.num_remote_frees >=
+               (uint64_t)num_threads * num_iter);
+    }
+
+    /* Finalize */
+    ret = ATS_finalize(0);
+
+    free(threads);
+    free(tasks);
+
+    return ret;
+}
@@ -0,0 +1,144 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include "abt.h"
+#include "abttest.h"
+
+/* ABT_reserve() reserves memory for ULTs, tasklets, and synchronization
+ * objects.  With ABT_MEM_NO_ALLOC, creation fails with ABT_ERR_MEM once the
+ * reserved memory is exhausted instead of allocating more memory. */
+
+#define DEFAULT_NUM_THREADS 64
+#define NUM_SYNC_OBJECTS 4
+#define MAX_NUM_EXTRA 65536
+
+void thread_func(void *arg)
+{
+    ABT_thread_yield();
+}
+
+void task_func(void *arg)
+{
+    /* Do nothing. */
+}
+
+int main(int argc, char *argv[])
+{
+    ABT_xstream xstream;
+    ABT_pool pool;
+    ABT_thread *threads;
+    ABT_task *tasks;
+    ABT_mutex mutex;
+    ABT_cond cond;
+    ABT_eventual eventual;
+    ABT_future future;
+    ABT_mem_stats stats;
+    int num_threads = DEFAULT_NUM_THREADS;
+    int i, num_extra, ret;
+
+    setenv("ABT_MEM_NO_ALLOC", "1", 1);
+
+    /* Initialize */
+    ATS_read_args(argc, argv);
+    if (argc >= 2) {
+        num_threads = ATS_get_arg_val(ATS_ARG_N_ULT);
+    }
+    ATS_init(argc, argv, 1);
+
+    ret = ABT_reserve(num_threads, num_threads, NUM_SYNC_OBJECTS);
+    if (ret == ABT_ERR_FEATURE_NA) {
+        /* The memory pool is disabled. */
+        return ATS_finalize(0);
+    }
+    ATS_ERROR(ret, "ABT_reserve");
+    ret = ABT_reserve(-1, 0, 0);
+    assert(ret != ABT_SUCCESS);
+
+    threads = (ABT_thread *)malloc(MAX_NUM_EXTRA * sizeof(ABT_thread));
+    tasks = (ABT_task *)malloc(num_threads * sizeof(ABT_task));
+
+    ret = ABT_xstream_self(&xstream);
+    ATS_ERROR(ret, "ABT_xstream_self");
+    ret = ABT_xstream_get_main_pools(xstream, 1, &pool);
+    ATS_ERROR(ret, "ABT_xstream_get_main_pools");
+
+    /* Everything within the reservation must succeed. */
+    ret = ABT_mutex_create(&mutex);
+    ATS_ERROR(ret, "ABT_mutex_create");
+    ret = ABT_cond_create(&cond);
+    ATS_ERROR(ret, "ABT_cond_create");
+    ret = ABT_eventual_create(sizeof(int), &eventual);
+    ATS_ERROR(ret, "ABT_eventual_create");
+    ret = ABT_future_create(2, NULL, &future);
+    ATS_ERROR(ret, "ABT_future_create");
+    for (i = 0; i < num_threads; i++) {
+        ret = ABT_thread_create(pool, thread_func, NULL, ABT_THREAD_ATTR_NULL,
+                                &threads[i]);
+        ATS_ERROR(ret, "ABT_thread_create");
+        ret = ABT_task_create(pool, task_func, NULL, &tasks[i]);
+        ATS_ERROR(ret, "ABT_task_create");
+    }
+    for (i = 0; i < num_threads; i++) {
+        ret = ABT_thread_free(&threads[i]);
+        ATS_ERROR(ret, "ABT_thread_free");
+        ret = ABT_task_free(&tasks[i]);
+        ATS_ERROR(ret, "ABT_task_free");
+    }
+
+    ret = ABT_info_query_mem_stats(ABT_XSTREAM_NULL, &stats);
+    ATS_ERROR(ret, "ABT_info_query_mem_stats");
+    assert(stats.stack.num_reserved >= (uint64_t)num_threads);
+    assert(stats.desc.num_reserved >=
+           (uint64_t)(num_threads + NUM_SYNC_OBJECTS));
+    assert(stats.stack.num_alloc_failures == 0);
+    assert(stats.desc.num_alloc_failures == 0);
+
+    /* Exhaust the reserved stacks. */
+    for (num_extra = 0; num_extra < MAX_NUM_EXTRA; num_extra++) {
+        ret = ABT_thread_create(pool, thread_func, NULL, ABT_THREAD_ATTR_NULL,
+                                &threads[num_extra]);
+        if (ret == ABT_ERR_MEM)
+            break;
+        ATS_ERROR(ret, "ABT_thread_create");
+    }
+    assert(num_extra >= num_threads && num_extra < MAX_NUM_EXTRA);
+    ret = ABT_info_query_mem_stats(ABT_XSTREAM_NULL, &stats);
+    ATS_ERROR(ret, "ABT_info_query_mem_stats");
+    ATS_printf(1, "stack: reserved %llu, created %d, failures %llu\n",
+               (unsigned long long)stats.stack.num_reserved, num_extra,
+               (unsigned long long)stats.stack.num_alloc_failures);
+    assert(stats.stack.num_alloc_failures > 0);
+
+    /* Freed ULTs can be reused. */
+    for (i = 0; i < num_extra; i++) {
+        ret = ABT_thread_free(&threads[i]);
+        ATS_ERROR(ret, "ABT_thread_free");
+    }
+    ret = ABT_thread_create(pool, thread_func, NULL, ABT_THREAD_ATTR_NULL,
+                            &threads[0]);
+    ATS_ERROR(ret, "ABT_thread_create");
+    ret = ABT_thread_free(&threads[0]);
+    ATS_ERROR(ret, "ABT_thread_free");
+
+    ret = ABT_future_free(&future);
+    ATS_ERROR(ret, "ABT_future_free");
+    ret = ABT_eventual_free(&eventual);
+    ATS_ERROR(ret, "ABT_eventual_free");
+    ret = ABT_cond_free(&cond);
+    ATS_ERROR(ret, "ABT_cond_free");
+    ret = ABT_mutex_free(&mutex);
+    ATS_ERROR(ret, "ABT_mutex_free");
+
+    /* Finalize */
+    ret = ATS_finalize(0);
+
+    free(threads);
+    free(tasks);
+
+    return ret;
+}
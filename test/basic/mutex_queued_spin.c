@@ -0,0 +1,153 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "abt.h"
+#include "abttest.h"
+
+/* A mutex with the queued-spin attribute lets waiters spin in a FIFO queue
+ * before suspending.  This test checks mutual exclusion of ABT_mutex_lock,
+ * ABT_mutex_lock_low, ABT_mutex_spinlock, and a recursive mutex when ULTs on
+ * all the ESs contend for the mutexes. */
+
+#define DEFAULT_NUM_XSTREAMS 4
+#define DEFAULT_NUM_THREADS 4
+#define DEFAULT_NUM_ITER 100
+
+int num_xstreams = DEFAULT_NUM_XSTREAMS;
+int num_threads = DEFAULT_NUM_THREADS;
+int num_iter = DEFAULT_NUM_ITER;
+ABT_mutex g_mutex;
+ABT_mutex g_rec_mutex;
+int g_counter = 0;
+int g_rec_counter = 0;
+
+void thread_func(void *arg)
+{
+    int i, ret;
+    ATS_UNUSED(arg);
+
+    for (i = 0; i < num_iter; i++) {
+        ret = ABT_mutex_lock(g_mutex);
+        ATS_ERROR(ret, "ABT_mutex_lock");
+        g_counter++;
+        ret = ABT_mutex_unlock(g_mutex);
+        ATS_ERROR(ret, "ABT_mutex_unlock");
+
+        ret = ABT_mutex_lock_low(g_mutex);
+        ATS_ERROR(ret, "ABT_mutex_lock_low");
+        g_counter++;
+        ret = ABT_mutex_unlock(g_mutex);
+        ATS_ERROR(ret, "ABT_mutex_unlock");
+
+        ret = ABT_mutex_spinlock(g_mutex);
+        ATS_ERROR(ret, "ABT_mutex_spinlock");
+        g_counter++;
+        ret = ABT_mutex_unlock(g_mutex);
+        ATS_ERROR(ret, "ABT_mutex_unlock");
+
+        ret = ABT_mutex_lock(g_rec_mutex);
+        ATS_ERROR(ret, "ABT_mutex_lock");
+        ret = ABT_mutex_lock(g_rec_mutex);
+        ATS_ERROR(ret, "ABT_mutex_lock");
+        g_rec_counter++;
+        ret = ABT_mutex_unlock(g_rec_mutex);
+        ATS_ERROR(ret, "ABT_mutex_unlock");
+        ret = ABT_mutex_unlock(g_rec_mutex);
+        ATS_ERROR(ret, "ABT_mutex_unlock");
+
+        if (i % 10 == 0)
+            ABT_thread_yield();
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    ABT_xstream *xstreams;
+    ABT_pool *pools;
+    ABT_thread *threads;
+    ABT_mutex_attr attr;
+    int i, ret, expected;
+
+    /* Initialize */
+    ATS_read_args(argc, argv);
+    if (argc >= 2) {
+        num_xstreams = ATS_get_arg_val(ATS_ARG_N_ES);
+        num_threads = ATS_get_arg_val(ATS_ARG_N_ULT);
+        num_iter = ATS_get_arg_val(ATS_ARG_N_ITER);
+    }
+    ATS_init(argc, argv, num_xstreams);
+
+    xstreams = (ABT_xstream *)malloc(num_xstreams * sizeof(ABT_xstream));
+    pools = (ABT_pool *)malloc(num_xstreams * sizeof(ABT_pool));
+    threads =
+        (ABT_thread *)malloc(num_xstreams * num_threads * sizeof(ABT_thread));
+
+    ret = ABT_xstream_self(&xstreams[0]);
+    ATS_ERROR(ret, "ABT_xstream_self");
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_create(ABT_SCHED_NULL, &xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_create");
+    }
+    for (i = 0; i < num_xstreams; i++) {
+        ret = ABT_xstream_get_main_pools(xstreams[i], 1, &pools[i]);
+        ATS_ERROR(ret, "ABT_xstream_get_main_pools");
+    }
+
+    /* Create mutexes */
+    ret = ABT_mutex_attr_create(&attr);
+    ATS_ERROR(ret, "ABT_mutex_attr_create");
+    ret = ABT_mutex_attr_set_queued_spin(attr, ABT_TRUE);
+    ATS_ERROR(ret, "ABT_mutex_attr_set_queued_spin");
+    ret = ABT_mutex_create_with_attr(attr, &g_mutex);
+    ATS_ERROR(ret, "ABT_mutex_create_with_attr");
+    ret = ABT_mutex_attr_set_recursive(attr, ABT_TRUE);
+    ATS_ERROR(ret, "ABT_mutex_attr_set_recursive");
+    ret = ABT_mutex_create_with_attr(attr, &g_rec_mutex);
+    ATS_ERROR(ret, "ABT_mutex_create_with_attr");
+    ret = ABT_mutex_attr_free(&attr);
+    ATS_ERROR(ret, "ABT_mutex_attr_free");
+
+    /* Create and join ULTs */
+    for (i = 0; i < num_xstreams * num_threads; i++) {
+        ret = ABT_thread_create(pools[i % num_xstreams], thread_func, NULL,
+                                ABT_THREAD_ATTR_NULL, &threads[i]);
+        ATS_ERROR(ret, "ABT_thread_create");
+    }
+    for (i = 0; i < num_xstreams * num_threads; i++) {
+        ret = ABT_thread_free(&threads[i]);
+        ATS_ERROR(ret, "ABT_thread_free");
+    }
+
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_join(xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_join");
+        ret = ABT_xstream_free(&xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_free");
+    }
+
+    ret = ABT_mutex_free(&g_mutex);
+    ATS_ERROR(ret, "ABT_mutex_free");
+    ret = ABT_mutex_free(&g_rec_mutex);
+    ATS_ERROR(ret, "ABT_mutex_free");
+
+    /* Validation */
+    expected = num_xstreams * num_threads * num_iter;
+    if (g_counter != expected * 3 || g_rec_counter != expected) {
+        printf("g_counter = %d vs. expected = %d\n", g_counter, expected * 3);
+        printf("g_rec_counter = %d vs. expected = %d\n", g_rec_counter,
+               expected);
+    }
+
+    /* Finalize */
+    ret = ATS_finalize(g_counter != expected * 3 || g_rec_counter != expected);
+
+    free(xstreams);
+    free(pools);
+    free(threads);
+
+    return ret;
+}
@@ -0,0 +1,155 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include "abt.h"
+#include "abttest.h"
+
+/* A read-mostly rwlock must keep writers exclusive even though readers only
+ * touch per-ES indicators.  ULTs share one pool, so they may leave the critical
+ * section on a different ES than the one they entered on. */
+
+#define DEFAULT_NUM_XSTREAMS 4
+#define DEFAULT_NUM_THREADS 16
+#define DEFAULT_NUM_ITER 100
+
+int num_xstreams = DEFAULT_NUM_XSTREAMS;
+int num_threads = DEFAULT_NUM_THREADS;
+int num_iter = DEFAULT_NUM_ITER;
+ABT_rwlock rwlock;
+
+/* Writers update both values in their critical sections. */
+volatile int g_value1 = 0;
+volatile int g_value2 = 0;
+
+void thread_func(void *arg)
+{
+    int id = (int)(intptr_t)arg;
+    int i, ret;
+
+    for (i = 0; i < num_iter; i++) {
+        /* One in four ULTs is a writer. */
+        if (id % 4 == 0) {
+            ret = ABT_rwlock_wrlock(rwlock);
+            ATS_ERROR(ret, "ABT_rwlock_wrlock");
+            g_value1++;
+            ret = ABT_thread_yield();
+            ATS_ERROR(ret, "ABT_thread_yield");
+            g_value2++;
+        } else {
+            ret = ABT_rwlock_rdlock(rwlock);
+            ATS_ERROR(ret, "ABT_rwlock_rdlock");
+            int value1 = g_value1;
+            ret = ABT_thread_yield();
+            ATS_ERROR(ret, "ABT_thread_yield");
+            assert(value1 == g_value1);
+            assert(value1 == g_value2);
+        }
+        ret = ABT_rwlock_unlock(rwlock);
+        ATS_ERROR(ret, "ABT_rwlock_unlock");
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    ABT_xstream *xstreams;
+    ABT_thread *threads;
+    ABT_rwlock_attr attr;
+    ABT_pool pool;
+    int i, ret;
+
+    /* Initialize */
+    ATS_read_args(argc, argv);
+    if (argc >= 2) {
+        num_xstreams = ATS_get_arg_val(ATS_ARG_N_ES);
+        num_threads = ATS_get_arg_val(ATS_ARG_N_ULT);
+        num_iter = ATS_get_arg_val(ATS_ARG_N_ITER);
+    }
+    ATS_init(argc, argv, num_xstreams);
+
+    xstreams = (ABT_xstream *)malloc(num_xstreams * sizeof(ABT_xstream));
+    threads = (ABT_thread *)malloc(num_threads * sizeof(ABT_thread));
+
+    /* All the ESs share a pool. */
+    ret = ABT_pool_create_basic(ABT_POOL_FIFO, ABT_POOL_ACCESS_MPMC, ABT_TRUE,
+                                &pool);
+    ATS_ERROR(ret, "ABT_pool_create_basic");
+    ret = ABT_xstream_self(&xstreams[0]);
+    ATS_ERROR(ret, "ABT_xstream_self");
+    ret = ABT_xstream_set_main_sched_basic(xstreams[0], ABT_SCHED_DEFAULT, 1,
+                                           &pool);
+    ATS_ERROR(ret, "ABT_xstream_set_main_sched_basic");
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_create_basic(ABT_SCHED_DEFAULT, 1, &pool,
+                                       ABT_SCHED_CONFIG_NULL, &xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_create_basic");
+    }
+
+    ret = ABT_rwlock_attr_create(&attr);
+    ATS_ERROR(ret, "ABT_rwlock_attr_create");
+    ret = ABT_rwlock_attr_set_read_mostly(attr, ABT_TRUE);
+    ATS_ERROR(ret, "ABT_rwlock_attr_set_read_mostly");
+    ret = ABT_rwlock_create_with_attr(attr, &rwlock);
+    ATS_ERROR(ret, "ABT_rwlock_create_with_attr");
+    ret = ABT_rwlock_attr_free(&attr);
+    ATS_ERROR(ret, "ABT_rwlock_attr_free");
+
+    for (i = 0; i < num_threads; i++) {
+        ret = ABT_thread_create(pool, thread_func, (void *)(intptr_t)i,
+                                ABT_THREAD_ATTR_NULL, &threads[i]);
+        ATS_ERROR(ret, "ABT_thread_create");
+    }
+    /* The primary ULT reads as well. */
+    for (i = 0; i < num_iter; i++) {
+        ret = ABT_rwlock_rdlock(rwlock);
+        ATS_ERROR(ret, "ABT_rwlock_rdlock");
+        assert(g_value1 == g_value2);
+        ret = ABT_rwlock_unlock(rwlock);
+        ATS_ERROR(ret, "ABT_rwlock_unlock");
+        ret = ABT_thread_yield();
+        ATS_ERROR(ret, "ABT_thread_yield");
+    }
+    for (i = 0; i < num_threads; i++) {
+        ret = ABT_thread_free(&threads[i]);
+        ATS_ERROR(ret, "ABT_thread_free");
+    }
+    assert(g_value1 == ((num_threads + 3) / 4) * num_iter);
+    assert(g_value2 == g_value1);
+
+    /* A writer can take the lock without any reader. */
+    ret = ABT_rwlock_wrlock(rwlock);
+    ATS_ERROR(ret, "ABT_rwlock_wrlock");
+    ret = ABT_rwlock_unlock(rwlock);
+    ATS_ERROR(ret, "ABT_rwlock_unlock");
+    ret = ABT_rwlock_free(&rwlock);
+    ATS_ERROR(ret, "ABT_rwlock_free");
+
+    /* ABT_RWLOCK_ATTR_NULL gives the default rwlock. */
+    ret = ABT_rwlock_create_with_attr(ABT_RWLOCK_ATTR_NULL, &rwlock);
+    ATS_ERROR(ret, "ABT_rwlock_create_with_attr");
+    ret = ABT_rwlock_rdlock(rwlock);
+    ATS_ERROR(ret, "ABT_rwlock_rdlock");
+    ret = ABT_rwlock_unlock(rwlock);
+    ATS_ERROR(ret, "ABT_rwlock_unlock");
+    ret = ABT_rwlock_free(&rwlock);
+    ATS_ERROR(ret, "ABT_rwlock_free");
+
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_join(xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_join");
+        ret = ABT_xstream_free(&xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_free");
+    }
+
+    /* Finalize */
+    ret = ATS_finalize(0);
+
+    free(xstreams);
+    free(threads);
+
+    return ret;
+}
@@ -0,0 +1,261 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "abt.h"
+#include "abttest.h"
+
+/* This test checks that a semaphore never lets more holders in than its
+ * permits when ULTs on all the ESs acquire one or more permits, that waiters
+ * are served in FIFO order, and that a timed-out waiter lets the waiters
+ * queued behind it take the permits. */
+
+#define DEFAULT_NUM_XSTREAMS 4
+#define DEFAULT_NUM_THREADS 4
+#define DEFAULT_NUM_ITER 100
+#define NUM_PERMITS 3
+
+int num_xstreams = DEFAULT_NUM_XSTREAMS;
+int num_threads = DEFAULT_NUM_THREADS;
+int num_iter = DEFAULT_NUM_ITER;
+ABT_sem g_sem;
+ABT_mutex g_mutex;
+int g_in_use = 0;
+int g_order[2];
+int g_num_done = 0;
+volatile int g_is_started = 0;
+
+static void use_permits(int num)
+{
+    int ret = ABT_mutex_lock(g_mutex);
+    ATS_ERROR(ret, "ABT_mutex_lock");
+    g_in_use += num;
+    assert(0 <= g_in_use && g_in_use <= NUM_PERMITS);
+    ret = ABT_mutex_unlock(g_mutex);
+    ATS_ERROR(ret, "ABT_mutex_unlock");
+}
+
+static void get_abstime(struct timespec *p_abstime, long nsec)
+{
+    clock_gettime(CLOCK_REALTIME, p_abstime);
+    p_abstime->tv_nsec += nsec;
+    if (p_abstime->tv_nsec >= 1000000000) {
+        p_abstime->tv_sec += 1;
+        p_abstime->tv_nsec -= 1000000000;
+    }
+}
+
+void counting_func(void *arg)
+{
+    uint32_t num = (uint32_t)((intptr_t)arg % 2) + 1;
+    int i, ret;
+
+    for (i = 0; i < num_iter; i++) {
+        if (i % 4 == 3) {
+            ret = ABT_sem_tryacquire(g_sem, num);
+            if (ret == ABT_ERR_SEM_UNAVAILABLE)
+                continue;
+            ATS_ERROR(ret, "ABT_sem_tryacquire");
+        } else {
+            ret = ABT_sem_acquire(g_sem, num);
+            ATS_ERROR(ret, "ABT_sem_acquire");
+        }
+        use_permits((int)num);
+        if (i % 10 == 0)
+            ABT_thread_yield();
+        use_permits(-(int)num);
+        ret = ABT_sem_release(g_sem, num);
+        ATS_ERROR(ret, "ABT_sem_release");
+    }
+}
+
+void fifo_func(void *arg)
+{
+    uint32_t num = (uint32_t)(intptr_t)arg;
+    int ret = ABT_sem_acquire(g_sem, num);
+    ATS_ERROR(ret, "ABT_sem_acquire");
+    g_order[g_num_done++] = (int)num;
+}
+
+void timed_func(void *arg)
+{
+    struct timespec abstime;
+    ATS_UNUSED(arg);
+    get_abstime(&abstime, 50000000);
+    g_is_started = 1;
+    int ret = ABT_sem_timedacquire(g_sem, 2, &abstime);
+    assert(ret == ABT_ERR_SEM_TIMEDOUT);
+}
+
+static void wait_blocked(ABT_thread thread)
+{
+    ABT_thread_state state;
+    do {
+        ABT_thread_yield();
+        int ret = ABT_thread_get_state(thread, &state);
+        ATS_ERROR(ret, "ABT_thread_get_state");
+    } while (state != ABT_THREAD_STATE_BLOCKED &&
+             state != ABT_THREAD_STATE_TERMINATED);
+}
+
+/* All the ULTs run on the primary ES so that the order of waiters is
+ * deterministic. */
+static void test_fifo(ABT_pool pool)
+{
+    ABT_thread threads[2];
+    uint32_t value;
+    int i, ret;
+
+    ret = ABT_sem_create(0, &g_sem);
+    ATS_ERROR(ret, "ABT_sem_create");
+    g_num_done = 0;
+    ret = ABT_thread_create(pool, fifo_func, (void *)(intptr_t)2,
+                            ABT_THREAD_ATTR_NULL, &threads[0]);
+    ATS_ERROR(ret, "ABT_thread_create");
+    wait_blocked(threads[0]);
+    ret = ABT_thread_create(pool, fifo_func, (void *)(intptr_t)1,
+                            ABT_THREAD_ATTR_NULL, &threads[1]);
+    ATS_ERROR(ret, "ABT_thread_create");
+    wait_blocked(threads[1]);
+
+    /* A permit is not enough for the first waiter.  The second waiter and
+     * ABT_sem_tryacquire() may not take it over the first waiter. */
+    ret = ABT_sem_release(g_sem, 1);
+    ATS_ERROR(ret, "ABT_sem_release");
+    for (i = 0; i < 10; i++)
+        ABT_thread_yield();
+    assert(g_num_done == 0);
+    ret = ABT_sem_tryacquire(g_sem, 1);
+    assert(ret == ABT_ERR_SEM_UNAVAILABLE);
+    ret = ABT_sem_get_value(g_sem, &value);
+    ATS_ERROR(ret, "ABT_sem_get_value");
+    assert(value == 1);
+
+    ret = ABT_sem_release(g_sem, 2);
+    ATS_ERROR(ret, "ABT_sem_release");
+    for (i = 0; i < 2; i++) {
+        ret = ABT_thread_free(&threads[i]);
+        ATS_ERROR(ret, "ABT_thread_free");
+    }
+    assert(g_num_done == 2 && g_order[0] == 2 && g_order[1] == 1);
+    ret = ABT_sem_get_value(g_sem, &value);
+    ATS_ERROR(ret, "ABT_sem_get_value");
+    assert(value == 0);
+    ret = ABT_sem_free(&g_sem);
+    ATS_ERROR(ret, "ABT_sem_free");
+}
+
+static void test_timeout(ABT_pool pool)
+{
+    ABT_thread threads[2];
+    uint32_t value;
+    int i, ret;
+
+    ret = ABT_sem_create(1, &g_sem);
+    ATS_ERROR(ret, "ABT_sem_create");
+    g_num_done = 0;
+    g_is_started = 0;
+    ret = ABT_thread_create(pool, timed_func, NULL, ABT_THREAD_ATTR_NULL,
+                            &threads[0]);
+    ATS_ERROR(ret, "ABT_thread_create");
+    while (!g_is_started)
+        ABT_thread_yield();
+    /* The second waiter is queued behind the first one, which needs two
+     * permits.  It takes the permit when the first one times out. */
+    ret = ABT_thread_create(pool, fifo_func, (void *)(intptr_t)1,
+                            ABT_THREAD_ATTR_NULL, &threads[1]);
+    ATS_ERROR(ret, "ABT_thread_create");
+    wait_blocked(threads[1]);
+    for (i = 0; i < 2; i++) {
+        ret = ABT_thread_free(&threads[i]);
+        ATS_ERROR(ret, "ABT_thread_free");
+    }
+    assert(g_num_done == 1);
+    ret = ABT_sem_get_value(g_sem, &value);
+    ATS_ERROR(ret, "ABT_sem_get_value");
+    assert(value == 0);
+    ret = ABT_sem_free(&g_sem);
+    ATS_ERROR(ret, "ABT_sem_free");
+}
+
+int main(int argc, char *argv[])
+{
+    ABT_xstream *xstreams;
+    ABT_pool *pools;
+    ABT_thread *threads;
+    uint32_t value;
+    int i, ret;
+
+    /* Initialize */
+    ATS_read_args(argc, argv);
+    if (argc >= 2) {
+        num_xstreams = ATS_get_arg_val(ATS_ARG_N_ES);
+        num_threads = ATS_get_arg_val(ATS_ARG_N_ULT);
+        num_iter = ATS_get_arg_val(ATS_ARG_N_ITER);
+    }
+    ATS_init(argc, argv, num_xstreams);
+
+    xstreams = (ABT_xstream *)malloc(num_xstreams * sizeof(ABT_xstream));
+    pools = (ABT_pool *)malloc(num_xstreams * sizeof(ABT_pool));
+    threads =
+        (ABT_thread *)malloc(num_xstreams * num_threads * sizeof(ABT_thread));
+
+    ret = ABT_xstream_self(&xstreams[0]);
+    ATS_ERROR(ret, "ABT_xstream_self");
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_create(ABT_SCHED_NULL, &xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_create");
+    }
+    for (i = 0; i < num_xstreams; i++) {
+        ret = ABT_xstream_get_main_pools(xstreams[i], 1, &pools[i]);
+        ATS_ERROR(ret, "ABT_xstream_get_main_pools");
+    }
+
+    /* Counting */
+    ret = ABT_mutex_create(&g_mutex);
+    ATS_ERROR(ret, "ABT_mutex_create");
+    ret = ABT_sem_create(NUM_PERMITS, &g_sem);
+    ATS_ERROR(ret, "ABT_sem_create");
+    for (i = 0; i < num_xstreams * num_threads; i++) {
+        ret = ABT_thread_create(pools[i % num_xstreams], counting_func,
+                                (void *)(intptr_t)i, ABT_THREAD_ATTR_NULL,
+                                &threads[i]);
+        ATS_ERROR(ret, "ABT_thread_create");
+    }
+    for (i = 0; i < num_xstreams * num_threads; i++) {
+        ret = ABT_thread_free(&threads[i]);
+        ATS_ERROR(ret, "ABT_thread_free");
+    }
+    assert(g_in_use == 0);
+    ret = ABT_sem_get_value(g_sem, &value);
+    ATS_ERROR(ret, "ABT_sem_get_value");
+    assert(value == NUM_PERMITS);
+    ret = ABT_sem_free(&g_sem);
+    ATS_ERROR(ret, "ABT_sem_free");
+    ret = ABT_mutex_free(&g_mutex);
+    ATS_ERROR(ret, "ABT_mutex_free");
+
+    /* FIFO order and timeout */
+    test_fifo(pools[0]);
+    test_timeout(pools[0]);
+
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_join(xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_join");
+        ret = ABT_xstream_free(&xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_free");
+    }
+
+    /* Finalize */
+    ret = ATS_finalize(0);
+
+    free(xstreams);
+    free(pools);
+    free(threads);
+
+    return ret;
+}
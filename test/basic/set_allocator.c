@@ -0,0 +1,198 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <pthread.h>
+#include "abt.h"
+#include "abttest.h"
+
+/* All the memory that Argobots allocates must go through the user-defined
+ * allocator and must be returned by ABT_finalize(). */
+
+#define DEFAULT_NUM_XSTREAMS 2
+#define DEFAULT_NUM_THREADS 64
+
+pthread_mutex_t alloc_lock = PTHREAD_MUTEX_INITIALIZER;
+long num_allocs = 0, num_live_allocs = 0;
+long num_largepages = 0, num_live_largepages = 0;
+int allocator_arg;
+
+void *test_malloc(size_t size, void *arg)
+{
+    assert(arg == &allocator_arg);
+    void *ptr = malloc(size);
+    pthread_mutex_lock(&alloc_lock);
+    num_allocs++;
+    num_live_allocs++;
+    pthread_mutex_unlock(&alloc_lock);
+    return ptr;
+}
+
+void *test_memalign(size_t alignment, size_t size, void *arg)
+{
+    assert(arg == &allocator_arg);
+    void *ptr;
+    if (posix_memalign(&ptr, alignment, size) != 0)
+        return NULL;
+    pthread_mutex_lock(&alloc_lock);
+    num_allocs++;
+    num_live_allocs++;
+    pthread_mutex_unlock(&alloc_lock);
+    return ptr;
+}
+
+void test_free(void *ptr, void *arg)
+{
+    assert(arg == &allocator_arg);
+    if (!ptr)
+        return;
+    pthread_mutex_lock(&alloc_lock);
+    num_live_allocs--;
+    pthread_mutex_unlock(&alloc_lock);
+    free(ptr);
+}
+
+void *test_alloc_largepage(size_t size, size_t alignment_hint, void *arg)
+{
+    assert(arg == &allocator_arg);
+    void *ptr;
+    if (posix_memalign(&ptr, alignment_hint, size) != 0)
+        return NULL;
+    pthread_mutex_lock(&alloc_lock);
+    num_largepages++;
+    num_live_largepages++;
+    pthread_mutex_unlock(&alloc_lock);
+    return ptr;
+}
+
+void test_free_largepage(void *ptr, size_t size, void *arg)
+{
+    assert(arg == &allocator_arg);
+    pthread_mutex_lock(&alloc_lock);
+    num_live_largepages--;
+    pthread_mutex_unlock(&alloc_lock);
+    free(ptr);
+}
+
+void thread_func(void *arg)
+{
+    ABT_thread_yield();
+}
+
+void task_func(void *arg)
+{
+    /* Do nothing. */
+}
+
+int main(int argc, char *argv[])
+{
+    ABT_xstream *xstreams;
+    ABT_pool pool;
+    ABT_thread *threads;
+    ABT_task *tasks;
+    ABT_mutex mutex;
+    ABT_eventual eventual;
+    ABT_allocator allocator;
+    int num_xstreams, num_threads;
+    int i, ret;
+
+    ATS_read_args(argc, argv);
+    if (argc < 2) {
+        num_xstreams = DEFAULT_NUM_XSTREAMS;
+        num_threads = DEFAULT_NUM_THREADS;
+    } else {
+        num_xstreams = ATS_get_arg_val(ATS_ARG_N_ES);
+        num_threads = ATS_get_arg_val(ATS_ARG_N_ULT);
+    }
+
+    /* An incomplete allocator must be rejected. */
+    allocator.malloc_f = test_malloc;
+    allocator.memalign_f = NULL;
+    allocator.free_f = test_free;
+    allocator.alloc_largepage_f = NULL;
+    allocator.free_largepage_f = NULL;
+    allocator.arg = &allocator_arg;
+    ret = ABT_set_allocator(&allocator);
+    assert(ret != ABT_SUCCESS);
+
+    allocator.memalign_f = test_memalign;
+    allocator.alloc_largepage_f = test_alloc_largepage;
+    allocator.free_largepage_f = test_free_largepage;
+    ret = ABT_set_allocator(&allocator);
+    assert(ret == ABT_SUCCESS);
+
+    /* Initialize */
+    ATS_init(argc, argv, num_xstreams);
+
+    /* The allocator cannot be changed while Argobots is initialized. */
+    ret = ABT_set_allocator(NULL);
+    assert(ret != ABT_SUCCESS);
+
+    xstreams = (ABT_xstream *)malloc(num_xstreams * sizeof(ABT_xstream));
+    threads = (ABT_thread *)malloc(num_threads * sizeof(ABT_thread));
+    tasks = (ABT_task *)malloc(num_threads * sizeof(ABT_task));
+
+    ret = ABT_xstream_self(&xstreams[0]);
+    ATS_ERROR(ret, "ABT_xstream_self");
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_create(ABT_SCHED_NULL, &xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_create");
+    }
+    ret = ABT_xstream_get_main_pools(xstreams[num_xstreams - 1], 1, &pool);
+    ATS_ERROR(ret, "ABT_xstream_get_main_pools");
+    ret = ABT_mutex_create(&mutex);
+    ATS_ERROR(ret, "ABT_mutex_create");
+    ret = ABT_eventual_create(sizeof(int), &eventual);
+    ATS_ERROR(ret, "ABT_eventual_create");
+
+    for (i = 0; i < num_threads; i++) {
+        ret = ABT_thread_create(pool, thread_func, NULL, ABT_THREAD_ATTR_NULL,
+                                &threads[i]);
+        ATS_ERROR(ret, "ABT_thread_create");
+        ret = ABT_task_create(pool, task_func, NULL, &tasks[i]);
+        ATS_ERROR(ret, "ABT_task_create");
+    }
+    for (i = 0; i < num_threads; i++) {
+        ret = ABT_thread_free(&threads[i]);
+        ATS_ERROR(ret, "ABT_thread_free");
+        ret = ABT_task_free(&tasks[i]);
+        ATS_ERROR(ret, "ABT_task_free");
+    }
+
+    ret = ABT_eventual_free(&eventual);
+    ATS_ERROR(ret, "ABT_eventual_free");
+    ret = ABT_mutex_free(&mutex);
+    ATS_ERROR(ret, "ABT_mutex_free");
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_join(xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_join");
+        ret = ABT_xstream_free(&xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_free");
+    }
+
+    /* Finalize */
+    ret = ATS_finalize(0);
+
+    ATS_printf(1,
+               "allocations: %ld (live: %ld), "
+               "large pages: %ld (live: %ld)\n",
+               num_allocs, num_live_allocs, num_largepages,
+               num_live_largepages);
+    assert(num_allocs > 0);
+    assert(num_live_allocs == 0);
+    assert(num_live_largepages == 0);
+
+    /* The default allocator can be restored after ABT_finalize(). */
+    int ret2 = ABT_set_allocator(NULL);
+    assert(ret2 == ABT_SUCCESS);
+
+    free(xstreams);
+    free(threads);
+    free(tasks);
+
+    return ret;
+}
@@ -0,0 +1,173 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include "abt.h"
+#include "abttest.h"
+
+/* ULTs waiting on an eventual, a future, or a ULT to join may spin before
+ * suspending.  This test checks that they still observe the value, the
+ * callback, and the termination of the joined ULT, with and without spinning,
+ * when the other side runs on another ES or on the same ES. */
+
+#define DEFAULT_NUM_XSTREAMS 2
+#define DEFAULT_NUM_ITER 20
+#define NUM_COMPARTMENTS 4
+
+int num_xstreams = DEFAULT_NUM_XSTREAMS;
+int num_iter = DEFAULT_NUM_ITER;
+ABT_pool *pools;
+ABT_eventual g_eventual;
+ABT_future g_future;
+volatile int g_cb_done = 0;
+volatile int g_child_done = 0;
+
+void future_cb(void **args)
+{
+    int i;
+    for (i = 0; i < NUM_COMPARTMENTS; i++)
+        assert((intptr_t)args[i] == 1);
+    g_cb_done = 1;
+}
+
+void eventual_setter(void *arg)
+{
+    int value = (int)(intptr_t)arg;
+    int ret = ABT_eventual_set(g_eventual, &value, sizeof(int));
+    ATS_ERROR(ret, "ABT_eventual_set");
+}
+
+void future_setter(void *arg)
+{
+    ATS_UNUSED(arg);
+    int ret = ABT_future_set(g_future, (void *)(intptr_t)1);
+    ATS_ERROR(ret, "ABT_future_set");
+}
+
+void child_func(void *arg)
+{
+    ATS_UNUSED(arg);
+    g_child_done = 1;
+}
+
+void waiter_func(void *arg)
+{
+    /* Setters and children run on this ES or on another ES. */
+    ABT_pool pool = pools[(intptr_t)arg % num_xstreams];
+    uint32_t max_nsec = ((intptr_t)arg < num_xstreams) ? 100000 : 0;
+    ABT_thread_attr attr;
+    ABT_thread thread;
+    int i, j, ret;
+
+    ret = ABT_thread_attr_create(&attr);
+    ATS_ERROR(ret, "ABT_thread_attr_create");
+    ret = ABT_thread_attr_set_join_spin_nsec(attr, max_nsec);
+    ATS_ERROR(ret, "ABT_thread_attr_set_join_spin_nsec");
+
+    for (i = 0; i < num_iter; i++) {
+        /* Eventual */
+        void *value;
+        ret = ABT_eventual_create(sizeof(int), &g_eventual);
+        ATS_ERROR(ret, "ABT_eventual_create");
+        ret = ABT_eventual_set_wait_spin_nsec(g_eventual, max_nsec);
+        ATS_ERROR(ret, "ABT_eventual_set_wait_spin_nsec");
+        ret = ABT_thread_create(pool, eventual_setter, (void *)(intptr_t)i,
+                                ABT_THREAD_ATTR_NULL, NULL);
+        ATS_ERROR(ret, "ABT_thread_create");
+        ret = ABT_eventual_wait(g_eventual, &value);
+        ATS_ERROR(ret, "ABT_eventual_wait");
+        assert(*(int *)value == i);
+        ret = ABT_eventual_free(&g_eventual);
+        ATS_ERROR(ret, "ABT_eventual_free");
+
+        /* Future */
+        g_cb_done = 0;
+        ret = ABT_future_create(NUM_COMPARTMENTS, future_cb, &g_future);
+        ATS_ERROR(ret, "ABT_future_create");
+        ret = ABT_future_set_wait_spin_nsec(g_future, max_nsec);
+        ATS_ERROR(ret, "ABT_future_set_wait_spin_nsec");
+        for (j = 0; j < NUM_COMPARTMENTS; j++) {
+            ret = ABT_thread_create(pool, future_setter, NULL,
+                                    ABT_THREAD_ATTR_NULL, NULL);
+            ATS_ERROR(ret, "ABT_thread_create");
+        }
+        ret = ABT_future_wait(g_future);
+        ATS_ERROR(ret, "ABT_future_wait");
+        /* The callback has finished when ABT_future_wait returns. */
+        assert(g_cb_done == 1);
+        ret = ABT_future_free(&g_future);
+        ATS_ERROR(ret, "ABT_future_free");
+
+        /* Join */
+        g_child_done = 0;
+        ret = ABT_thread_create(pool, child_func, NULL, attr, &thread);
+        ATS_ERROR(ret, "ABT_thread_create");
+        ret = ABT_thread_free(&thread);
+        ATS_ERROR(ret, "ABT_thread_free");
+        assert(g_child_done == 1);
+    }
+
+    ret = ABT_thread_attr_free(&attr);
+    ATS_ERROR(ret, "ABT_thread_attr_free");
+}
+
+int main(int argc, char *argv[])
+{
+    ABT_xstream *xstreams;
+    ABT_thread *threads;
+    int i, num_threads, ret;
+
+    /* Initialize */
+    ATS_read_args(argc, argv);
+    if (argc >= 2) {
+        num_xstreams = ATS_get_arg_val(ATS_ARG_N_ES);
+        num_iter = ATS_get_arg_val(ATS_ARG_N_ITER);
+    }
+    ATS_init(argc, argv, num_xstreams);
+
+    xstreams = (ABT_xstream *)malloc(num_xstreams * sizeof(ABT_xstream));
+    pools = (ABT_pool *)malloc(num_xstreams * sizeof(ABT_pool));
+
+    ret = ABT_xstream_self(&xstreams[0]);
+    ATS_ERROR(ret, "ABT_xstream_self");
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_create(ABT_SCHED_NULL, &xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_create");
+    }
+    for (i = 0; i < num_xstreams; i++) {
+        ret = ABT_xstream_get_main_pools(xstreams[i], 1, &pools[i]);
+        ATS_ERROR(ret, "ABT_xstream_get_main_pools");
+    }
+
+    /* Waiters with spinning enabled and disabled are paired with setters on
+     * every ES.  The waiters run on the first ES one by one. */
+    num_threads = num_xstreams * 2;
+    threads = (ABT_thread *)malloc(num_threads * sizeof(ABT_thread));
+    for (i = 0; i < num_threads; i++) {
+        ret = ABT_thread_create(pools[0], waiter_func, (void *)(intptr_t)i,
+                                ABT_THREAD_ATTR_NULL, &threads[i]);
+        ATS_ERROR(ret, "ABT_thread_create");
+        ret = ABT_thread_free(&threads[i]);
+        ATS_ERROR(ret, "ABT_thread_free");
+    }
+
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_join(xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_join");
+        ret = ABT_xstream_free(&xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_free");
+    }
+
+    /* Finalize */
+    ret = ATS_finalize(0);
+
+    free(xstreams);
+    free(pools);
+    free(threads);
+
+    return ret;
+}
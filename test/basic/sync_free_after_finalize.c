@@ -0,0 +1,96 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "abt.h"
+#include "abttest.h"
+
+/* Synchronization objects that are created while Argobots is initialized can
+ * be freed after ABT_finalize(), and those created while it is not
+ * initialized can be freed after ABT_init().  This test checks both. */
+
+#define LARGE_VALUE_SIZE 4096
+
+int main(int argc, char *argv[])
+{
+    ABT_mutex mutex, attr_mutex;
+    ABT_mutex_attr mutex_attr;
+    ABT_cond cond, pre_init_cond;
+    ABT_rwlock rwlock;
+    ABT_eventual eventual, large_eventual;
+    ABT_future future;
+    ABT_barrier barrier;
+    ABT_group group;
+    ABT_sem sem;
+    int ret;
+
+    /* Initialize */
+    ATS_read_args(argc, argv);
+    ATS_init(argc, argv, 1);
+
+    ret = ABT_mutex_create(&mutex);
+    ATS_ERROR(ret, "ABT_mutex_create");
+    ret = ABT_mutex_attr_create(&mutex_attr);
+    ATS_ERROR(ret, "ABT_mutex_attr_create");
+    ret = ABT_mutex_attr_set_recursive(mutex_attr, ABT_TRUE);
+    ATS_ERROR(ret, "ABT_mutex_attr_set_recursive");
+    ret = ABT_mutex_create_with_attr(mutex_attr, &attr_mutex);
+    ATS_ERROR(ret, "ABT_mutex_create_with_attr");
+    ret = ABT_mutex_attr_free(&mutex_attr);
+    ATS_ERROR(ret, "ABT_mutex_attr_free");
+    ret = ABT_cond_create(&cond);
+    ATS_ERROR(ret, "ABT_cond_create");
+    ret = ABT_rwlock_create(&rwlock);
+    ATS_ERROR(ret, "ABT_rwlock_create");
+    ret = ABT_eventual_create(sizeof(int), &eventual);
+    ATS_ERROR(ret, "ABT_eventual_create");
+    ret = ABT_eventual_create(LARGE_VALUE_SIZE, &large_eventual);
+    ATS_ERROR(ret, "ABT_eventual_create");
+    ret = ABT_future_create(4, NULL, &future);
+    ATS_ERROR(ret, "ABT_future_create");
+    ret = ABT_barrier_create(2, &barrier);
+    ATS_ERROR(ret, "ABT_barrier_create");
+    ret = ABT_group_create(&group);
+    ATS_ERROR(ret, "ABT_group_create");
+    ret = ABT_sem_create(1, &sem);
+    ATS_ERROR(ret, "ABT_sem_create");
+
+    ret = ABT_finalize();
+    ATS_ERROR(ret, "ABT_finalize");
+
+    ret = ABT_mutex_free(&mutex);
+    ATS_ERROR(ret, "ABT_mutex_free");
+    ret = ABT_mutex_free(&attr_mutex);
+    ATS_ERROR(ret, "ABT_mutex_free");
+    ret = ABT_cond_free(&cond);
+    ATS_ERROR(ret, "ABT_cond_free");
+    ret = ABT_rwlock_free(&rwlock);
+    ATS_ERROR(ret, "ABT_rwlock_free");
+    ret = ABT_eventual_free(&eventual);
+    ATS_ERROR(ret, "ABT_eventual_free");
+    ret = ABT_eventual_free(&large_eventual);
+    ATS_ERROR(ret, "ABT_eventual_free");
+    ret = ABT_future_free(&future);
+    ATS_ERROR(ret, "ABT_future_free");
+    ret = ABT_barrier_free(&barrier);
+    ATS_ERROR(ret, "ABT_barrier_free");
+    ret = ABT_group_free(&group);
+    ATS_ERROR(ret, "ABT_group_free");
+    ret = ABT_sem_free(&sem);
+    ATS_ERROR(ret, "ABT_sem_free");
+
+    ret = ABT_cond_create(&pre_init_cond);
+    ATS_ERROR(ret, "ABT_cond_create");
+
+    /* ATS_finalize() calls ABT_finalize(). */
+    ret = ABT_init(argc, argv);
+    ATS_ERROR(ret, "ABT_init");
+    ret = ABT_cond_free(&pre_init_cond);
+    ATS_ERROR(ret, "ABT_cond_free");
+
+    /* Finalize */
+    return ATS_finalize(0);
+}
@@ -0,0 +1,145 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include "abt.h"
+#include "abttest.h"
+
+/* Joining a ULT in an MPMC pool may run it in place while other ESs try to
+ * steal it.  This test computes Fibonacci numbers with recursive fork-join
+ * under random work-stealing schedulers, and some ULTs yield after being run
+ * by their joiners. */
+
+#define DEFAULT_NUM_XSTREAMS 4
+#define DEFAULT_N 12
+#define NUM_REPEATS 4
+
+int num_xstreams = DEFAULT_NUM_XSTREAMS;
+ABT_pool *pools;
+
+typedef struct {
+    int n;
+    int result;
+} fib_arg_t;
+
+static int fib_seq(int n)
+{
+    return n < 2 ? n : fib_seq(n - 1) + fib_seq(n - 2);
+}
+
+void fib(void *arg)
+{
+    fib_arg_t *p_arg = (fib_arg_t *)arg;
+    int rank, i, ret;
+
+    if (p_arg->n < 2) {
+        if (p_arg->n == 1) {
+            ret = ABT_thread_yield();
+            ATS_ERROR(ret, "ABT_thread_yield");
+        }
+        p_arg->result = p_arg->n;
+        return;
+    }
+
+    fib_arg_t child_args[2] = { { p_arg->n - 1, 0 }, { p_arg->n - 2, 0 } };
+    ABT_thread threads[2];
+    ret = ABT_xstream_self_rank(&rank);
+    ATS_ERROR(ret, "ABT_xstream_self_rank");
+    for (i = 0; i < 2; i++) {
+        ret = ABT_thread_create(pools[rank], fib, &child_args[i],
+                                ABT_THREAD_ATTR_NULL, &threads[i]);
+        ATS_ERROR(ret, "ABT_thread_create");
+    }
+    /* Join the younger child first so that the other one is likely to be
+     * still in the pool. */
+    for (i = 1; i >= 0; i--) {
+        ret = ABT_thread_free(&threads[i]);
+        ATS_ERROR(ret, "ABT_thread_free");
+    }
+    p_arg->result = child_args[0].result + child_args[1].result;
+}
+
+int main(int argc, char *argv[])
+{
+    ABT_xstream *xstreams;
+    ABT_sched *scheds;
+    ABT_pool *my_pools;
+    ABT_thread *threads;
+    fib_arg_t *args;
+    int i, k, r, n = DEFAULT_N, ret;
+
+    /* Initialize */
+    ATS_read_args(argc, argv);
+    if (argc >= 2) {
+        num_xstreams = ATS_get_arg_val(ATS_ARG_N_ES);
+        n = ATS_get_arg_val(ATS_ARG_N_ULT);
+    }
+    ATS_init(argc, argv, num_xstreams);
+
+    xstreams = (ABT_xstream *)malloc(num_xstreams * sizeof(ABT_xstream));
+    scheds = (ABT_sched *)malloc(num_xstreams * sizeof(ABT_sched));
+    pools = (ABT_pool *)malloc(num_xstreams * sizeof(ABT_pool));
+    my_pools = (ABT_pool *)malloc(num_xstreams * sizeof(ABT_pool));
+    threads = (ABT_thread *)malloc(num_xstreams * sizeof(ABT_thread));
+    args = (fib_arg_t *)malloc(num_xstreams * sizeof(fib_arg_t));
+
+    /* Each ES steals ULTs from the pools of the others. */
+    for (i = 0; i < num_xstreams; i++) {
+        ret = ABT_pool_create_basic(ABT_POOL_FIFO, ABT_POOL_ACCESS_MPMC,
+                                    ABT_TRUE, &pools[i]);
+        ATS_ERROR(ret, "ABT_pool_create_basic");
+    }
+    for (i = 0; i < num_xstreams; i++) {
+        for (k = 0; k < num_xstreams; k++)
+            my_pools[k] = pools[(i + k) % num_xstreams];
+        ret = ABT_sched_create_basic(ABT_SCHED_RANDWS, num_xstreams, my_pools,
+                                     ABT_SCHED_CONFIG_NULL, &scheds[i]);
+        ATS_ERROR(ret, "ABT_sched_create_basic");
+    }
+    ret = ABT_xstream_self(&xstreams[0]);
+    ATS_ERROR(ret, "ABT_xstream_self");
+    ret = ABT_xstream_set_main_sched(xstreams[0], scheds[0]);
+    ATS_ERROR(ret, "ABT_xstream_set_main_sched");
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_create(scheds[i], &xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_create");
+    }
+
+    for (r = 0; r < NUM_REPEATS; r++) {
+        for (i = 0; i < num_xstreams; i++) {
+            args[i].n = n;
+            args[i].result = 0;
+            ret = ABT_thread_create(pools[i], fib, &args[i],
+                                    ABT_THREAD_ATTR_NULL, &threads[i]);
+            ATS_ERROR(ret, "ABT_thread_create");
+        }
+        for (i = 0; i < num_xstreams; i++) {
+            ret = ABT_thread_free(&threads[i]);
+            ATS_ERROR(ret, "ABT_thread_free");
+            assert(args[i].result == fib_seq(n));
+        }
+    }
+
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_join(xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_join");
+        ret = ABT_xstream_free(&xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_free");
+    }
+
+    /* Finalize */
+    ret = ATS_finalize(0);
+
+    free(xstreams);
+    free(scheds);
+    free(pools);
+    free(my_pools);
+    free(threads);
+    free(args);
+
+    return ret;
+}
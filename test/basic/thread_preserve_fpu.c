@@ -0,0 +1,126 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <fenv.h>
+#include "abt.h"
+#include "abttest.h"
+
+/* ULTs that preserve the FPU control state must keep their rounding modes even
+ * if they are interleaved with ULTs that do not preserve it. */
+
+#define DEFAULT_NUM_THREADS 4
+#define DEFAULT_NUM_ITER 100
+
+int num_threads = DEFAULT_NUM_THREADS;
+int num_iter = DEFAULT_NUM_ITER;
+ABT_bool check_round = ABT_FALSE;
+
+static const int rounds[] = { FE_TONEAREST, FE_UPWARD, FE_DOWNWARD,
+                              FE_TOWARDZERO };
+
+void preserving_func(void *arg)
+{
+    int i, ret, round = rounds[(size_t)arg % 4];
+
+    fesetround(round);
+    for (i = 0; i < num_iter; i++) {
+        ret = ABT_thread_yield();
+        ATS_ERROR(ret, "ABT_thread_yield");
+        if (check_round)
+            assert(fegetround() == round);
+    }
+    /* Do not leave a non-default rounding mode to non-preserving ULTs. */
+    fesetround(FE_TONEAREST);
+}
+
+void non_preserving_func(void *arg)
+{
+    int i, ret;
+    volatile double x = 1.0;
+
+    for (i = 0; i < num_iter; i++) {
+        x = x / 3.0 + 1.0;
+        ret = ABT_thread_yield();
+        ATS_ERROR(ret, "ABT_thread_yield");
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    ABT_xstream xstream;
+    ABT_pool pool;
+    ABT_thread_attr attrs[2];
+    ABT_thread *threads;
+    ABT_bool preserve_fpu;
+    int i, ret;
+
+    /* Initialize */
+    ATS_read_args(argc, argv);
+    if (argc >= 2) {
+        num_threads = ATS_get_arg_val(ATS_ARG_N_ULT);
+        num_iter = ATS_get_arg_val(ATS_ARG_N_ITER);
+    }
+    ATS_init(argc, argv, 1);
+
+    ret = ABT_info_query_config(ABT_INFO_QUERY_KIND_ENABLED_PRESERVE_FPU,
+                                &preserve_fpu);
+    ATS_ERROR(ret, "ABT_info_query_config");
+    check_round = preserve_fpu;
+
+    threads = (ABT_thread *)malloc(num_threads * 2 * sizeof(ABT_thread));
+
+    ret = ABT_xstream_self(&xstream);
+    ATS_ERROR(ret, "ABT_xstream_self");
+    ret = ABT_xstream_get_main_pools(xstream, 1, &pool);
+    ATS_ERROR(ret, "ABT_xstream_get_main_pools");
+
+    /* The default can be changed by ABT_THREAD_PRESERVE_FPU, so both are set
+     * explicitly. */
+    for (i = 0; i < 2; i++) {
+        ret = ABT_thread_attr_create(&attrs[i]);
+        ATS_ERROR(ret, "ABT_thread_attr_create");
+        ret = ABT_thread_attr_set_preserve_fpu(attrs[i],
+                                               i == 0 ? ABT_TRUE : ABT_FALSE);
+        ATS_ERROR(ret, "ABT_thread_attr_set_preserve_fpu");
+    }
+
+    for (i = 0; i < num_threads; i++) {
+        ret = ABT_thread_create(pool, preserving_func, (void *)(size_t)i,
+                                attrs[0], &threads[i * 2]);
+        ATS_ERROR(ret, "ABT_thread_create");
+        ret = ABT_thread_create(pool, non_preserving_func, NULL, attrs[1],
+                                &threads[i * 2 + 1]);
+        ATS_ERROR(ret, "ABT_thread_create");
+    }
+
+    /* The main ULT also preserves its rounding mode. */
+    fesetround(FE_UPWARD);
+    for (i = 0; i < num_iter; i++) {
+        ret = ABT_thread_yield();
+        ATS_ERROR(ret, "ABT_thread_yield");
+        if (check_round)
+            assert(fegetround() == FE_UPWARD);
+    }
+    fesetround(FE_TONEAREST);
+
+    for (i = 0; i < num_threads * 2; i++) {
+        ret = ABT_thread_free(&threads[i]);
+        ATS_ERROR(ret, "ABT_thread_free");
+    }
+    for (i = 0; i < 2; i++) {
+        ret = ABT_thread_attr_free(&attrs[i]);
+        ATS_ERROR(ret, "ABT_thread_attr_free");
+    }
+
+    /* Finalize */
+    ret = ATS_finalize(0);
+
+    free(threads);
+
+    return ret;
+}
@@ -0,0 +1,176 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+#include "abt.h"
+#include "abttest.h"
+
+/* Stack-copying ULTs share a pool among ESs so that they are suspended and
+ * resumed by different ESs.  Their stacks must be intact after yield, mutex
+ * handover, join, and eventual wait. */
+
+#define DEFAULT_NUM_XSTREAMS 2
+#define DEFAULT_NUM_THREADS 16
+#define DEFAULT_NUM_ITER 8
+#define BUF_SIZE 512
+
+int num_threads = DEFAULT_NUM_THREADS;
+int num_iter = DEFAULT_NUM_ITER;
+ABT_thread *threads;
+ABT_mutex mutex;
+ABT_eventual eventual;
+int g_counter = 0;
+
+int fill_and_yield(int id, int depth)
+{
+    volatile char buf[BUF_SIZE];
+    int i, ret, num_frames = 1;
+    for (i = 0; i < BUF_SIZE; i++)
+        buf[i] = (char)(id + depth + i);
+    if (depth > 0)
+        num_frames += fill_and_yield(id, depth - 1);
+    ret = ABT_thread_yield();
+    ATS_ERROR(ret, "ABT_thread_yield");
+    for (i = 0; i < BUF_SIZE; i++)
+        assert(buf[i] == (char)(id + depth + i));
+    return num_frames;
+}
+
+void thread_func(void *arg)
+{
+    int id = (int)(intptr_t)arg;
+    int i, ret;
+
+    ret = ABT_eventual_wait(eventual, NULL);
+    ATS_ERROR(ret, "ABT_eventual_wait");
+
+    for (i = 0; i < num_iter; i++) {
+        int depth = i % 4;
+        ret = fill_and_yield(id, depth);
+        assert(ret == depth + 1);
+
+        ret = ABT_mutex_lock(mutex);
+        ATS_ERROR(ret, "ABT_mutex_lock");
+        int counter = g_counter;
+        ret = ABT_thread_yield();
+        ATS_ERROR(ret, "ABT_thread_yield");
+        g_counter = counter + 1;
+        ret = ABT_mutex_unlock_se(mutex);
+        ATS_ERROR(ret, "ABT_mutex_unlock_se");
+    }
+
+    /* A stack-copying ULT joins another one. */
+    if (id % 2 == 1) {
+        ret = ABT_thread_join(threads[id - 1]);
+        ATS_ERROR(ret, "ABT_thread_join");
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    ABT_xstream *xstreams;
+    ABT_pool pool;
+    ABT_thread_attr attr;
+    int num_xstreams = DEFAULT_NUM_XSTREAMS;
+    int i, ret, expected;
+
+    /* Initialize */
+    ATS_read_args(argc, argv);
+    if (argc >= 2) {
+        num_xstreams = ATS_get_arg_val(ATS_ARG_N_ES);
+        num_threads = ATS_get_arg_val(ATS_ARG_N_ULT);
+        num_iter = ATS_get_arg_val(ATS_ARG_N_ITER);
+    }
+    ATS_init(argc, argv, num_xstreams);
+
+    ret = ABT_thread_attr_create(&attr);
+    ATS_ERROR(ret, "ABT_thread_attr_create");
+    ret = ABT_thread_attr_set_stack_copy(attr, ABT_TRUE);
+    if (ret == ABT_ERR_FEATURE_NA) {
+        /* Stack-copying ULTs are not supported. */
+        ret = ABT_thread_attr_free(&attr);
+        ATS_ERROR(ret, "ABT_thread_attr_free");
+        return ATS_finalize(0);
+    }
+    ATS_ERROR(ret, "ABT_thread_attr_set_stack_copy");
+
+    xstreams = (ABT_xstream *)malloc(num_xstreams * sizeof(ABT_xstream));
+    threads = (ABT_thread *)malloc(num_threads * sizeof(ABT_thread));
+
+    /* All the ESs share one pool. */
+    ret = ABT_pool_create_basic(ABT_POOL_FIFO, ABT_POOL_ACCESS_MPMC, ABT_TRUE,
+                                &pool);
+    ATS_ERROR(ret, "ABT_pool_create_basic");
+    ret = ABT_xstream_self(&xstreams[0]);
+    ATS_ERROR(ret, "ABT_xstream_self");
+    ret = ABT_xstream_set_main_sched_basic(xstreams[0], ABT_SCHED_DEFAULT, 1,
+                                           &pool);
+    ATS_ERROR(ret, "ABT_xstream_set_main_sched_basic");
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_create_basic(ABT_SCHED_DEFAULT, 1, &pool,
+                                       ABT_SCHED_CONFIG_NULL, &xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_create_basic");
+    }
+
+    ret = ABT_mutex_create(&mutex);
+    ATS_ERROR(ret, "ABT_mutex_create");
+    ret = ABT_eventual_create(0, &eventual);
+    ATS_ERROR(ret, "ABT_eventual_create");
+
+    for (i = 0; i < num_threads; i++) {
+        ret = ABT_thread_create(pool, thread_func, (void *)(intptr_t)i, attr,
+                                &threads[i]);
+        ATS_ERROR(ret, "ABT_thread_create");
+    }
+    ret = ABT_eventual_set(eventual, NULL, 0);
+    ATS_ERROR(ret, "ABT_eventual_set");
+
+    /* Join and revive the ULTs once. */
+    for (i = 0; i < num_threads; i++) {
+        ret = ABT_thread_join(threads[i]);
+        ATS_ERROR(ret, "ABT_thread_join");
+    }
+    for (i = 0; i < num_threads; i++) {
+        ret = ABT_thread_revive(pool, thread_func, (void *)(intptr_t)i,
+                                &threads[i]);
+        ATS_ERROR(ret, "ABT_thread_revive");
+    }
+    /* Free the ULTs in reverse order since ULTs refer to previous ones. */
+    for (i = num_threads - 1; i >= 0; i--) {
+        ret = ABT_thread_free(&threads[i]);
+        ATS_ERROR(ret, "ABT_thread_free");
+    }
+
+    ret = ABT_eventual_free(&eventual);
+    ATS_ERROR(ret, "ABT_eventual_free");
+    ret = ABT_mutex_free(&mutex);
+    ATS_ERROR(ret, "ABT_mutex_free");
+    ret = ABT_thread_attr_free(&attr);
+    ATS_ERROR(ret, "ABT_thread_attr_free");
+
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_join(xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_join");
+        ret = ABT_xstream_free(&xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_free");
+    }
+
+    /* Validation */
+    expected = num_threads * num_iter * 2;
+    if (g_counter != expected) {
+        printf("g_counter = %d vs. expected = %d\n", g_counter, expected);
+    }
+
+    /* Finalize */
+    ret = ATS_finalize(g_counter != expected);
+
+    free(xstreams);
+    free(threads);
+
+    return ret;
+}
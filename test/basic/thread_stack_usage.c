@@ -0,0 +1,188 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "abt.h"
+#include "abttest.h"
+
+/* With ABT_STACK_PAINT, the stack usage of a ULT must be at least what it has
+ * used and must be recorded to the histograms of its pool and its attribute
+ * when it terminates. */
+
+#define DEFAULT_NUM_THREADS 8
+#define SMALL_USAGE 2048
+
+int num_threads = DEFAULT_NUM_THREADS;
+
+void use_stack(size_t size)
+{
+    volatile char buf[256];
+    memset((char *)buf, 1, sizeof(buf));
+    if (size > sizeof(buf))
+        use_stack(size - sizeof(buf));
+    /* Keep buf alive to avoid a tail call. */
+    buf[0]++;
+}
+
+void thread_func(void *arg)
+{
+    size_t size = (size_t)arg, usage;
+    ABT_thread self;
+    int ret;
+
+    use_stack(size);
+    ret = ABT_thread_self(&self);
+    ATS_ERROR(ret, "ABT_thread_self");
+    ret = ABT_thread_get_stack_usage(self, &usage);
+    ATS_ERROR(ret, "ABT_thread_get_stack_usage");
+    assert(usage >= size);
+    ret = ABT_thread_yield();
+    ATS_ERROR(ret, "ABT_thread_yield");
+}
+
+void check_hist(const ABT_stack_usage_hist *hist, uint64_t num_threads,
+                size_t min_total, size_t min_max, size_t stacksize)
+{
+    uint64_t sum = 0;
+    int i;
+    for (i = 0; i < ABT_STACK_USAGE_NUM_BINS; i++)
+        sum += hist->bins[i];
+    assert(hist->num_threads == num_threads);
+    assert(sum == num_threads);
+    assert(hist->max_usage >= min_max && hist->max_usage <= stacksize);
+    assert(hist->total_usage >= min_total);
+}
+
+int main(int argc, char *argv[])
+{
+    ABT_xstream xstream;
+    ABT_pool pools[2];
+    ABT_thread_attr attr;
+    ABT_thread *threads;
+    ABT_stack_usage_hist hist;
+    ABT_bool stack_paint;
+    size_t stacksize, large_stacksize, large_usage, usage;
+    int i, ret;
+
+    /* Stack painting must be enabled before ABT_init(). */
+    setenv("ABT_STACK_PAINT", "1", 1);
+
+    /* Initialize */
+    ATS_read_args(argc, argv);
+    if (argc >= 2) {
+        num_threads = ATS_get_arg_val(ATS_ARG_N_ULT);
+    }
+    ATS_init(argc, argv, 1);
+
+    ret = ABT_info_query_config(ABT_INFO_QUERY_KIND_ENABLED_STACK_PAINT,
+                                &stack_paint);
+    ATS_ERROR(ret, "ABT_info_query_config");
+    assert(stack_paint == ABT_TRUE);
+    ret = ABT_info_query_config(ABT_INFO_QUERY_KIND_DEFAULT_THREAD_STACKSIZE,
+                                &stacksize);
+    ATS_ERROR(ret, "ABT_info_query_config");
+    large_stacksize = stacksize * 4;
+    large_usage = stacksize * 2;
+
+    threads = (ABT_thread *)malloc(num_threads * sizeof(ABT_thread));
+
+    ret = ABT_xstream_self(&xstream);
+    ATS_ERROR(ret, "ABT_xstream_self");
+    ret = ABT_xstream_get_main_pools(xstream, 1, &pools[0]);
+    ATS_ERROR(ret, "ABT_xstream_get_main_pools");
+    ret = ABT_pool_create_basic(ABT_POOL_FIFO, ABT_POOL_ACCESS_MPMC, ABT_TRUE,
+                                &pools[1]);
+    ATS_ERROR(ret, "ABT_pool_create_basic");
+    ret = ABT_xstream_set_main_sched_basic(xstream, ABT_SCHED_DEFAULT, 2,
+                                           pools);
+    ATS_ERROR(ret, "ABT_xstream_set_main_sched_basic");
+
+    ret = ABT_thread_attr_create(&attr);
+    ATS_ERROR(ret, "ABT_thread_attr_create");
+    ret = ABT_thread_attr_set_stacksize(attr, large_stacksize);
+    ATS_ERROR(ret, "ABT_thread_attr_set_stacksize");
+
+    /* ULTs with the default stack run in pools[0] and ULTs with a large stack
+     * run in pools[1]. */
+    for (i = 0; i < num_threads; i++) {
+        ret = ABT_thread_create(pools[0], thread_func, (void *)SMALL_USAGE,
+                                ABT_THREAD_ATTR_NULL, &threads[i]);
+        ATS_ERROR(ret, "ABT_thread_create");
+    }
+    for (i = 0; i < num_threads; i++) {
+        ret = ABT_thread_free(&threads[i]);
+        ATS_ERROR(ret, "ABT_thread_free");
+    }
+    for (i = 0; i < num_threads; i++) {
+        ret = ABT_thread_create(pools[1], thread_func, (void *)large_usage,
+                                attr, &threads[i]);
+        ATS_ERROR(ret, "ABT_thread_create");
+    }
+    for (i = 0; i < num_threads; i++) {
+        ret = ABT_thread_join(threads[i]);
+        ATS_ERROR(ret, "ABT_thread_join");
+        /* The usage can be obtained after termination. */
+        ret = ABT_thread_get_stack_usage(threads[i], &usage);
+        ATS_ERROR(ret, "ABT_thread_get_stack_usage");
+        assert(usage >= large_usage && usage <= large_stacksize);
+    }
+
+    /* A revived ULT must be painted again. */
+    ret = ABT_thread_revive(pools[1], thread_func, (void *)SMALL_USAGE,
+                            &threads[0]);
+    ATS_ERROR(ret, "ABT_thread_revive");
+    ret = ABT_thread_join(threads[0]);
+    ATS_ERROR(ret, "ABT_thread_join");
+    ret = ABT_thread_get_stack_usage(threads[0], &usage);
+    ATS_ERROR(ret, "ABT_thread_get_stack_usage");
+    assert(usage >= SMALL_USAGE && usage < large_usage);
+    for (i = 0; i < num_threads; i++) {
+        ret = ABT_thread_free(&threads[i]);
+        ATS_ERROR(ret, "ABT_thread_free");
+    }
+
+    /* Check the histograms. */
+    ret = ABT_info_query_pool_stack_usage(pools[0], &hist);
+    ATS_ERROR(ret, "ABT_info_query_pool_stack_usage");
+    check_hist(&hist, num_threads, SMALL_USAGE * num_threads, SMALL_USAGE,
+               stacksize);
+    ret = ABT_info_query_pool_stack_usage(pools[1], &hist);
+    ATS_ERROR(ret, "ABT_info_query_pool_stack_usage");
+    check_hist(&hist, num_threads + 1,
+               large_usage * num_threads + SMALL_USAGE, large_usage,
+               large_stacksize);
+    ret = ABT_info_query_thread_attr_stack_usage(ABT_THREAD_ATTR_NULL, &hist);
+    ATS_ERROR(ret, "ABT_info_query_thread_attr_stack_usage");
+    check_hist(&hist, num_threads, SMALL_USAGE * num_threads, SMALL_USAGE,
+               stacksize);
+    ret = ABT_info_query_thread_attr_stack_usage(attr, &hist);
+    ATS_ERROR(ret, "ABT_info_query_thread_attr_stack_usage");
+    check_hist(&hist, num_threads + 1,
+               large_usage * num_threads + SMALL_USAGE, large_usage,
+               large_stacksize);
+
+    /* The main ULT's stack is not painted. */
+    ABT_thread self;
+    ret = ABT_thread_self(&self);
+    ATS_ERROR(ret, "ABT_thread_self");
+    ret = ABT_thread_get_stack_usage(self, &usage);
+    assert(ret == ABT_ERR_FEATURE_NA);
+
+    ret = ABT_info_print_stack_usage(stdout);
+    ATS_ERROR(ret, "ABT_info_print_stack_usage");
+
+    ret = ABT_thread_attr_free(&attr);
+    ATS_ERROR(ret, "ABT_thread_attr_free");
+
+    /* Finalize */
+    ret = ATS_finalize(0);
+
+    free(threads);
+
+    return ret;
+}
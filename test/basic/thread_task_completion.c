@@ -0,0 +1,227 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include "abt.h"
+#include "abttest.h"
+
+/* A completion callback must be called exactly once after its ULT or tasklet
+ * finishes and before a joiner returns.  Unnamed work units are freed after
+ * their callbacks, which can create subsequent work units. */
+
+#define DEFAULT_NUM_XSTREAMS 4
+#define DEFAULT_NUM_UNITS 32
+#define NUM_CHAINED 4
+
+typedef struct {
+    int done;      /* Set by the work unit function */
+    int completed; /* Set by the completion callback */
+} unit_arg_t;
+
+int num_xstreams = DEFAULT_NUM_XSTREAMS;
+int num_units = DEFAULT_NUM_UNITS;
+ABT_pool *pools;
+volatile int num_unnamed_completed = 0;
+volatile int num_chained_completed = 0;
+
+void unit_func(void *arg)
+{
+    ((unit_arg_t *)arg)->done = 1;
+}
+
+void thread_cb(ABT_thread thread, void *cb_arg)
+{
+    unit_arg_t *p_arg = (unit_arg_t *)cb_arg;
+    void *thread_arg;
+    int ret = ABT_thread_get_arg(thread, &thread_arg);
+    ATS_ERROR(ret, "ABT_thread_get_arg");
+    assert(thread_arg == cb_arg && p_arg->done == 1 && p_arg->completed == 0);
+    p_arg->completed = 1;
+}
+
+void task_cb(ABT_task task, void *cb_arg)
+{
+    unit_arg_t *p_arg = (unit_arg_t *)cb_arg;
+    void *task_arg;
+    int ret = ABT_task_get_arg(task, &task_arg);
+    ATS_ERROR(ret, "ABT_task_get_arg");
+    assert(task_arg == cb_arg && p_arg->done == 1 && p_arg->completed == 0);
+    p_arg->completed = 1;
+}
+
+void unnamed_thread_cb(ABT_thread thread, void *cb_arg)
+{
+    thread_cb(thread, cb_arg);
+    __sync_fetch_and_add(&num_unnamed_completed, 1);
+}
+
+void unnamed_task_cb(ABT_task task, void *cb_arg)
+{
+    task_cb(task, cb_arg);
+    __sync_fetch_and_add(&num_unnamed_completed, 1);
+}
+
+/* Each completion creates the next tasklet of the chain. */
+void chained_func(void *arg)
+{
+    ATS_UNUSED(arg);
+}
+
+void chained_cb(ABT_task task, void *cb_arg)
+{
+    int depth = (int)(size_t)cb_arg;
+    ATS_UNUSED(task);
+    __sync_fetch_and_add(&num_chained_completed, 1);
+    if (depth + 1 < NUM_CHAINED) {
+        int ret = ABT_task_create_with_callback(pools[(depth + 1) %
+                                                      num_xstreams],
+                                                chained_func, NULL, chained_cb,
+                                                (void *)(size_t)(depth + 1),
+                                                NULL);
+        ATS_ERROR(ret, "ABT_task_create_with_callback");
+    }
+}
+
+static void wait_for(volatile int *p_counter, int target)
+{
+    while (__sync_fetch_and_add(p_counter, 0) != target) {
+        int ret = ABT_thread_yield();
+        ATS_ERROR(ret, "ABT_thread_yield");
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    ABT_xstream *xstreams;
+    ABT_thread_attr attr, unnamed_attr;
+    ABT_thread *threads;
+    ABT_task *tasks;
+    unit_arg_t *thread_args, *task_args, *unnamed_args;
+    int i, ret;
+
+    /* Initialize */
+    ATS_read_args(argc, argv);
+    if (argc >= 2) {
+        num_xstreams = ATS_get_arg_val(ATS_ARG_N_ES);
+        num_units = ATS_get_arg_val(ATS_ARG_N_ULT);
+    }
+    ATS_init(argc, argv, num_xstreams);
+
+    xstreams = (ABT_xstream *)malloc(num_xstreams * sizeof(ABT_xstream));
+    pools = (ABT_pool *)malloc(num_xstreams * sizeof(ABT_pool));
+    threads = (ABT_thread *)malloc(num_units * sizeof(ABT_thread));
+    tasks = (ABT_task *)malloc(num_units * sizeof(ABT_task));
+    thread_args = (unit_arg_t *)calloc(num_units, sizeof(unit_arg_t));
+    task_args = (unit_arg_t *)calloc(num_units, sizeof(unit_arg_t));
+    unnamed_args = (unit_arg_t *)calloc(num_units * 2, sizeof(unit_arg_t));
+
+    ret = ABT_xstream_self(&xstreams[0]);
+    ATS_ERROR(ret, "ABT_xstream_self");
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_create(ABT_SCHED_NULL, &xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_create");
+    }
+    for (i = 0; i < num_xstreams; i++) {
+        ret = ABT_xstream_get_main_pools(xstreams[i], 1, &pools[i]);
+        ATS_ERROR(ret, "ABT_xstream_get_main_pools");
+    }
+
+    ret = ABT_thread_attr_create(&attr);
+    ATS_ERROR(ret, "ABT_thread_attr_create");
+    ret = ABT_thread_attr_create(&unnamed_attr);
+    ATS_ERROR(ret, "ABT_thread_attr_create");
+    ret = ABT_thread_attr_set_completion_callback(unnamed_attr,
+                                                  unnamed_thread_cb, NULL);
+    ATS_ERROR(ret, "ABT_thread_attr_set_completion_callback");
+
+    /* Named work units: a callback must have been called when join returns. */
+    for (i = 0; i < num_units; i++) {
+        ABT_pool pool = pools[i % num_xstreams];
+        ret = ABT_thread_attr_set_completion_callback(attr, thread_cb,
+                                                      &thread_args[i]);
+        ATS_ERROR(ret, "ABT_thread_attr_set_completion_callback");
+        ret = ABT_thread_create(pool, unit_func, &thread_args[i], attr,
+                                &threads[i]);
+        ATS_ERROR(ret, "ABT_thread_create");
+        ret = ABT_task_create_with_callback(pool, unit_func, &task_args[i],
+                                            task_cb, &task_args[i], &tasks[i]);
+        ATS_ERROR(ret, "ABT_task_create_with_callback");
+    }
+    for (i = 0; i < num_units; i++) {
+        ret = ABT_thread_join(threads[i]);
+        ATS_ERROR(ret, "ABT_thread_join");
+        assert(thread_args[i].completed == 1);
+        ret = ABT_thread_free(&threads[i]);
+        ATS_ERROR(ret, "ABT_thread_free");
+        ret = ABT_task_join(tasks[i]);
+        ATS_ERROR(ret, "ABT_task_join");
+        assert(task_args[i].completed == 1);
+        ret = ABT_task_free(&tasks[i]);
+        ATS_ERROR(ret, "ABT_task_free");
+    }
+
+    /* A ULT joined on the same ES directly switches to its joiner. */
+    thread_args[0].done = thread_args[0].completed = 0;
+    ret = ABT_thread_attr_set_completion_callback(attr, thread_cb,
+                                                  &thread_args[0]);
+    ATS_ERROR(ret, "ABT_thread_attr_set_completion_callback");
+    ret = ABT_thread_create(pools[0], unit_func, &thread_args[0], attr,
+                            &threads[0]);
+    ATS_ERROR(ret, "ABT_thread_create");
+    ret = ABT_thread_free(&threads[0]);
+    ATS_ERROR(ret, "ABT_thread_free");
+    assert(thread_args[0].completed == 1);
+
+    /* Unnamed work units are freed after their callbacks. */
+    for (i = 0; i < num_units; i++) {
+        ABT_pool pool = pools[i % num_xstreams];
+        ret = ABT_thread_attr_set_completion_callback(unnamed_attr,
+                                                      unnamed_thread_cb,
+                                                      &unnamed_args[i * 2]);
+        ATS_ERROR(ret, "ABT_thread_attr_set_completion_callback");
+        ret = ABT_thread_create(pool, unit_func, &unnamed_args[i * 2],
+                                unnamed_attr, NULL);
+        ATS_ERROR(ret, "ABT_thread_create");
+        ret = ABT_task_create_with_callback(pool, unit_func,
+                                            &unnamed_args[i * 2 + 1],
+                                            unnamed_task_cb,
+                                            &unnamed_args[i * 2 + 1], NULL);
+        ATS_ERROR(ret, "ABT_task_create_with_callback");
+    }
+    wait_for(&num_unnamed_completed, num_units * 2);
+
+    /* Callbacks can chain work units. */
+    ret = ABT_task_create_with_callback(pools[0], chained_func, NULL,
+                                        chained_cb, (void *)(size_t)0, NULL);
+    ATS_ERROR(ret, "ABT_task_create_with_callback");
+    wait_for(&num_chained_completed, NUM_CHAINED);
+
+    ret = ABT_thread_attr_free(&attr);
+    ATS_ERROR(ret, "ABT_thread_attr_free");
+    ret = ABT_thread_attr_free(&unnamed_attr);
+    ATS_ERROR(ret, "ABT_thread_attr_free");
+
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_join(xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_join");
+        ret = ABT_xstream_free(&xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_free");
+    }
+
+    /* Finalize */
+    ret = ATS_finalize(0);
+
+    free(xstreams);
+    free(pools);
+    free(threads);
+    free(tasks);
+    free(thread_args);
+    free(task_args);
+    free(unnamed_args);
+
+    return ret;
+}
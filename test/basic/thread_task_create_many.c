@@ -0,0 +1,186 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include "abt.h"
+#include "abttest.h"
+
+/* ABT_thread_create_many() and ABT_task_create_many() must run every work
+ * unit exactly once with its own function and argument, whether the units are
+ * named or not and whether they share pools or not. */
+
+#define DEFAULT_NUM_XSTREAMS 4
+#define DEFAULT_NUM_UNITS 64
+
+int num_xstreams = DEFAULT_NUM_XSTREAMS;
+int num_units = DEFAULT_NUM_UNITS;
+volatile int num_done = 0;
+
+void unit_func(void *arg)
+{
+    /* Each unit must be executed only once. */
+    int *p_flag = (int *)arg;
+    assert(*p_flag == 0);
+    *p_flag = 1;
+    __sync_fetch_and_add(&num_done, 1);
+}
+
+void yield_func(void *arg)
+{
+    int ret = ABT_thread_yield();
+    ATS_ERROR(ret, "ABT_thread_yield");
+    unit_func(arg);
+}
+
+static void wait_for(int target)
+{
+    while (__sync_fetch_and_add(&num_done, 0) != target) {
+        int ret = ABT_thread_yield();
+        ATS_ERROR(ret, "ABT_thread_yield");
+    }
+}
+
+static void check_flags(int *flags, int num)
+{
+    int i;
+    for (i = 0; i < num; i++) {
+        assert(flags[i] == 1);
+        flags[i] = 0;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    ABT_xstream *xstreams;
+    ABT_pool *pools, *pool_list;
+    ABT_thread *threads;
+    ABT_task *tasks;
+    ABT_thread_attr attr;
+    void (**func_list)(void *);
+    void **arg_list;
+    int *flags;
+    int i, ret;
+
+    /* Initialize */
+    ATS_read_args(argc, argv);
+    if (argc >= 2) {
+        num_xstreams = ATS_get_arg_val(ATS_ARG_N_ES);
+        num_units = ATS_get_arg_val(ATS_ARG_N_ULT);
+    }
+    ATS_init(argc, argv, num_xstreams);
+
+    xstreams = (ABT_xstream *)malloc(num_xstreams * sizeof(ABT_xstream));
+    pools = (ABT_pool *)malloc(num_xstreams * sizeof(ABT_pool));
+    pool_list = (ABT_pool *)malloc(num_units * sizeof(ABT_pool));
+    threads = (ABT_thread *)malloc(num_units * sizeof(ABT_thread));
+    tasks = (ABT_task *)malloc(num_units * sizeof(ABT_task));
+    func_list = (void (**)(void *))malloc(num_units * sizeof(void (*)(void *)));
+    arg_list = (void **)malloc(num_units * sizeof(void *));
+    flags = (int *)calloc(num_units, sizeof(int));
+
+    ret = ABT_xstream_self(&xstreams[0]);
+    ATS_ERROR(ret, "ABT_xstream_self");
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_create(ABT_SCHED_NULL, &xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_create");
+    }
+    for (i = 0; i < num_xstreams; i++) {
+        ret = ABT_xstream_get_main_pools(xstreams[i], 1, &pools[i]);
+        ATS_ERROR(ret, "ABT_xstream_get_main_pools");
+    }
+
+    /* Pools are interleaved so that one call pushes several batches. */
+    for (i = 0; i < num_units; i++) {
+        pool_list[i] = pools[i % num_xstreams];
+        func_list[i] = (i % 2) ? yield_func : unit_func;
+        arg_list[i] = &flags[i];
+    }
+    ret = ABT_thread_attr_create(&attr);
+    ATS_ERROR(ret, "ABT_thread_attr_create");
+    ret = ABT_thread_attr_set_stacksize(attr, 32768);
+    ATS_ERROR(ret, "ABT_thread_attr_set_stacksize");
+
+    /* Named ULTs */
+    ret = ABT_thread_create_many(num_units, pool_list, func_list, arg_list,
+                                 ABT_THREAD_ATTR_NULL, threads);
+    ATS_ERROR(ret, "ABT_thread_create_many");
+    ret = ABT_thread_free_many(num_units, threads);
+    ATS_ERROR(ret, "ABT_thread_free_many");
+    check_flags(flags, num_units);
+
+    /* Unnamed ULTs with an attribute */
+    num_done = 0;
+    ret = ABT_thread_create_many(num_units, pool_list, func_list, arg_list,
+                                 attr, NULL);
+    ATS_ERROR(ret, "ABT_thread_create_many");
+    wait_for(num_units);
+    check_flags(flags, num_units);
+
+    /* All the ULTs go to a single pool. */
+    num_done = 0;
+    for (i = 0; i < num_units; i++)
+        pool_list[i] = pools[num_xstreams - 1];
+    ret = ABT_thread_create_many(num_units, pool_list, func_list, arg_list,
+                                 ABT_THREAD_ATTR_NULL, NULL);
+    ATS_ERROR(ret, "ABT_thread_create_many");
+    wait_for(num_units);
+    check_flags(flags, num_units);
+
+    /* Tasklets cannot yield. */
+    for (i = 0; i < num_units; i++) {
+        pool_list[i] = pools[(i / 3) % num_xstreams];
+        func_list[i] = unit_func;
+    }
+
+    /* Named tasklets */
+    ret = ABT_task_create_many(num_units, pool_list, func_list, arg_list,
+                               tasks);
+    ATS_ERROR(ret, "ABT_task_create_many");
+    for (i = 0; i < num_units; i++) {
+        ret = ABT_task_free(&tasks[i]);
+        ATS_ERROR(ret, "ABT_task_free");
+    }
+    check_flags(flags, num_units);
+
+    /* Unnamed tasklets */
+    num_done = 0;
+    ret = ABT_task_create_many(num_units, pool_list, func_list, arg_list, NULL);
+    ATS_ERROR(ret, "ABT_task_create_many");
+    wait_for(num_units);
+    check_flags(flags, num_units);
+
+    /* Creating no work unit is allowed. */
+    ret = ABT_thread_create_many(0, pool_list, func_list, arg_list,
+                                 ABT_THREAD_ATTR_NULL, threads);
+    ATS_ERROR(ret, "ABT_thread_create_many");
+    ret = ABT_task_create_many(0, pool_list, func_list, arg_list, tasks);
+    ATS_ERROR(ret, "ABT_task_create_many");
+
+    ret = ABT_thread_attr_free(&attr);
+    ATS_ERROR(ret, "ABT_thread_attr_free");
+
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_join(xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_join");
+        ret = ABT_xstream_free(&xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_free");
+    }
+
+    /* Finalize */
+    ret = ATS_finalize(0);
+
+    free(xstreams);
+    free(pools);
+    free(pool_list);
+    free(threads);
+    free(tasks);
+    free(func_list);
+    free(arg_list);
+    free(flags);
+
+    return ret;
+}
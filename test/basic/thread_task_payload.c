@@ -0,0 +1,173 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "abt.h"
+#include "abttest.h"
+
+/* ULTs and tasklets created with a payload must receive a copy of the payload
+ * that is not affected by later changes of the original data. */
+
+#define DEFAULT_NUM_XSTREAMS 2
+#define DEFAULT_NUM_UNITS 16
+
+typedef struct {
+    int id;
+    size_t size;
+    ABT_bool is_thread;
+    int *p_done;
+} payload_header_t;
+
+int num_units = DEFAULT_NUM_UNITS;
+
+static unsigned char get_byte(int id, size_t i)
+{
+    return (unsigned char)(id * 31 + i);
+}
+
+static void fill_payload(void *payload, int id, size_t size,
+                         ABT_bool is_thread, int *p_done)
+{
+    size_t i;
+    payload_header_t *p_header = (payload_header_t *)payload;
+    p_header->id = id;
+    p_header->size = size;
+    p_header->is_thread = is_thread;
+    p_header->p_done = p_done;
+    for (i = sizeof(payload_header_t); i < size; i++)
+        ((unsigned char *)payload)[i] = get_byte(id, i);
+}
+
+void unit_func(void *arg)
+{
+    size_t i;
+    payload_header_t *p_header = (payload_header_t *)arg;
+    /* The copy must be aligned as malloc() memory. */
+    assert(((uintptr_t)arg & (sizeof(void *) - 1)) == 0);
+    for (i = sizeof(payload_header_t); i < p_header->size; i++)
+        assert(((unsigned char *)arg)[i] == get_byte(p_header->id, i));
+    if (p_header->is_thread) {
+        int ret = ABT_thread_yield();
+        ATS_ERROR(ret, "ABT_thread_yield");
+        /* The payload must be kept while the ULT is suspended. */
+        for (i = sizeof(payload_header_t); i < p_header->size; i++)
+            assert(((unsigned char *)arg)[i] == get_byte(p_header->id, i));
+    }
+    p_header->p_done[p_header->id] = 1;
+}
+
+void empty_func(void *arg)
+{
+    assert(arg == NULL);
+}
+
+int main(int argc, char *argv[])
+{
+    int num_xstreams = DEFAULT_NUM_XSTREAMS;
+    ABT_xstream *xstreams;
+    ABT_pool *pools;
+    ABT_thread *threads;
+    ABT_task *tasks;
+    int *thread_done, *task_done;
+    unsigned char payload[ABT_PAYLOAD_MAX_SIZE + 1];
+    int i, ret;
+
+    /* Initialize */
+    ATS_read_args(argc, argv);
+    if (argc >= 2) {
+        num_xstreams = ATS_get_arg_val(ATS_ARG_N_ES);
+        num_units = ATS_get_arg_val(ATS_ARG_N_ULT);
+    }
+    ATS_init(argc, argv, num_xstreams);
+
+    xstreams = (ABT_xstream *)malloc(num_xstreams * sizeof(ABT_xstream));
+    pools = (ABT_pool *)malloc(num_xstreams * sizeof(ABT_pool));
+    threads = (ABT_thread *)malloc(num_units * sizeof(ABT_thread));
+    tasks = (ABT_task *)malloc(num_units * sizeof(ABT_task));
+    thread_done = (int *)calloc(num_units, sizeof(int));
+    task_done = (int *)calloc(num_units, sizeof(int));
+
+    ret = ABT_xstream_self(&xstreams[0]);
+    ATS_ERROR(ret, "ABT_xstream_self");
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_create(ABT_SCHED_NULL, &xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_create");
+    }
+    for (i = 0; i < num_xstreams; i++) {
+        ret = ABT_xstream_get_main_pools(xstreams[i], 1, &pools[i]);
+        ATS_ERROR(ret, "ABT_xstream_get_main_pools");
+    }
+
+    /* Payloads of various sizes, some of which do not fit in the spare area
+     * of descriptors.  The original payload is overwritten right after each
+     * creation. */
+    for (i = 0; i < num_units; i++) {
+        size_t size = sizeof(payload_header_t) +
+                      (i * 13) % (ABT_PAYLOAD_MAX_SIZE -
+                                  sizeof(payload_header_t) + 1);
+        ABT_pool pool = pools[i % num_xstreams];
+
+        fill_payload(payload, i, size, ABT_TRUE, thread_done);
+        ret = ABT_thread_create_with_payload(pool, unit_func, payload, size,
+                                             ABT_THREAD_ATTR_NULL,
+                                             &threads[i]);
+        ATS_ERROR(ret, "ABT_thread_create_with_payload");
+        memset(payload, 0, sizeof(payload));
+
+        fill_payload(payload, i, size, ABT_FALSE, task_done);
+        ret = ABT_task_create_with_payload(pool, unit_func, payload, size,
+                                           &tasks[i]);
+        ATS_ERROR(ret, "ABT_task_create_with_payload");
+        memset(payload, 0, sizeof(payload));
+    }
+
+    /* Unnamed work units and an empty payload */
+    ret = ABT_thread_create_with_payload(pools[0], empty_func, NULL, 0,
+                                         ABT_THREAD_ATTR_NULL, NULL);
+    ATS_ERROR(ret, "ABT_thread_create_with_payload");
+    ret = ABT_task_create_with_payload(pools[0], empty_func, NULL, 0, NULL);
+    ATS_ERROR(ret, "ABT_task_create_with_payload");
+    /* The payload pointer is ignored if the size is zero. */
+    ret = ABT_thread_create_with_payload(pools[0], empty_func, payload, 0,
+                                         ABT_THREAD_ATTR_NULL, NULL);
+    ATS_ERROR(ret, "ABT_thread_create_with_payload");
+    ret = ABT_task_create_with_payload(pools[0], empty_func, payload, 0, NULL);
+    ATS_ERROR(ret, "ABT_task_create_with_payload");
+
+    /* A too large payload is rejected. */
+    ret = ABT_task_create_with_payload(pools[0], unit_func, payload,
+                                       ABT_PAYLOAD_MAX_SIZE + 1, NULL);
+    assert(ret != ABT_SUCCESS);
+
+    for (i = 0; i < num_units; i++) {
+        ret = ABT_thread_free(&threads[i]);
+        ATS_ERROR(ret, "ABT_thread_free");
+        ret = ABT_task_free(&tasks[i]);
+        ATS_ERROR(ret, "ABT_task_free");
+        assert(thread_done[i] && task_done[i]);
+    }
+
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_join(xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_join");
+        ret = ABT_xstream_free(&xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_free");
+    }
+
+    /* Finalize */
+    ret = ATS_finalize(0);
+
+    free(xstreams);
+    free(pools);
+    free(threads);
+    free(tasks);
+    free(thread_done);
+    free(task_done);
+
+    return ret;
+}
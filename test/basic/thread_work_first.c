@@ -0,0 +1,226 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include "abt.h"
+#include "abttest.h"
+
+/* With ABT_thread_attr_set_work_first(), a ULT switches to a new ULT in the
+ * same pool immediately and its continuation can be taken by other ESs.  This
+ * test computes Fibonacci numbers with named and unnamed work-first ULTs on
+ * ESs that share a pool, and checks that work-first creation falls back to the
+ * normal one when the new ULT goes to another pool. */
+
+#define DEFAULT_NUM_XSTREAMS 4
+#define DEFAULT_N 13
+
+int num_xstreams = DEFAULT_NUM_XSTREAMS;
+ABT_pool pool, other_pool;
+ABT_thread_attr attr;
+
+typedef struct {
+    int n;
+    int result;
+} fib_arg_t;
+
+static int fib_seq(int n)
+{
+    return n < 2 ? n : fib_seq(n - 1) + fib_seq(n - 2);
+}
+
+/* Named children are joined. */
+void fib_named(void *arg)
+{
+    fib_arg_t *p_arg = (fib_arg_t *)arg;
+    if (p_arg->n < 2) {
+        p_arg->result = p_arg->n;
+    } else {
+        fib_arg_t child_args[2] = { { p_arg->n - 1, 0 }, { p_arg->n - 2, 0 } };
+        ABT_thread threads[2];
+        int i, ret;
+        for (i = 0; i < 2; i++) {
+            ret = ABT_thread_create(pool, fib_named, &child_args[i], attr,
+                                    &threads[i]);
+            ATS_ERROR(ret, "ABT_thread_create");
+        }
+        ret = ABT_thread_free_many(2, threads);
+        ATS_ERROR(ret, "ABT_thread_free_many");
+        p_arg->result = child_args[0].result + child_args[1].result;
+    }
+}
+
+typedef struct fib_unnamed_arg {
+    int n;
+    int result;
+    volatile int num_done;
+    struct fib_unnamed_arg *p_parent;
+} fib_unnamed_arg_t;
+
+static void fib_unnamed_done(fib_unnamed_arg_t *p_arg)
+{
+    fib_unnamed_arg_t *p_parent = p_arg->p_parent;
+    if (p_parent)
+        __sync_fetch_and_add(&p_parent->result, p_arg->result);
+    __sync_fetch_and_add(&p_arg->num_done, 1);
+}
+
+/* Unnamed children report their results to their parents. */
+void fib_unnamed(void *arg)
+{
+    fib_unnamed_arg_t *p_arg = (fib_unnamed_arg_t *)arg;
+    if (p_arg->n < 2) {
+        p_arg->result = p_arg->n;
+    } else {
+        fib_unnamed_arg_t child_args[2];
+        int i, ret;
+        p_arg->result = 0;
+        for (i = 0; i < 2; i++) {
+            child_args[i].n = p_arg->n - 1 - i;
+            child_args[i].num_done = 0;
+            child_args[i].p_parent = p_arg;
+        }
+        for (i = 0; i < 2; i++) {
+            ret = ABT_thread_create(pool, fib_unnamed, &child_args[i], attr,
+                                    NULL);
+            ATS_ERROR(ret, "ABT_thread_create");
+        }
+        /* child_args must be alive until the children finish. */
+        for (i = 0; i < 2; i++) {
+            while (__sync_fetch_and_add(&child_args[i].num_done, 0) == 0) {
+                ret = ABT_thread_yield();
+                ATS_ERROR(ret, "ABT_thread_yield");
+            }
+        }
+    }
+    fib_unnamed_done(p_arg);
+}
+
+volatile int flag = 0;
+
+void set_flag(void *arg)
+{
+    ATS_UNUSED(arg);
+    flag = 1;
+}
+
+void single_es_func(void *arg)
+{
+    ABT_thread thread;
+    int ret;
+    ATS_UNUSED(arg);
+
+    /* The new ULT runs to completion before this ULT resumes since no other
+     * ES can take this ULT. */
+    flag = 0;
+    ret = ABT_thread_create(other_pool, set_flag, NULL, attr, &thread);
+    ATS_ERROR(ret, "ABT_thread_create");
+    assert(flag == 1);
+    ret = ABT_thread_free(&thread);
+    ATS_ERROR(ret, "ABT_thread_free");
+}
+
+int main(int argc, char *argv[])
+{
+    ABT_xstream *xstreams, other_xstream;
+    ABT_thread thread;
+    fib_arg_t fib_arg;
+    fib_unnamed_arg_t fib_unnamed_arg;
+    int i, n = DEFAULT_N, ret;
+
+    /* Initialize */
+    ATS_read_args(argc, argv);
+    if (argc >= 2) {
+        num_xstreams = ATS_get_arg_val(ATS_ARG_N_ES);
+        n = ATS_get_arg_val(ATS_ARG_N_ULT);
+    }
+    ATS_init(argc, argv, num_xstreams);
+
+    xstreams = (ABT_xstream *)malloc(num_xstreams * sizeof(ABT_xstream));
+
+    ret = ABT_thread_attr_create(&attr);
+    ATS_ERROR(ret, "ABT_thread_attr_create");
+    ret = ABT_thread_attr_set_stacksize(attr, 32768);
+    ATS_ERROR(ret, "ABT_thread_attr_set_stacksize");
+    ret = ABT_thread_attr_set_work_first(attr, ABT_TRUE);
+    ATS_ERROR(ret, "ABT_thread_attr_set_work_first");
+
+    /* All the ESs share a pool. */
+    ret = ABT_pool_create_basic(ABT_POOL_FIFO, ABT_POOL_ACCESS_MPMC, ABT_TRUE,
+                                &pool);
+    ATS_ERROR(ret, "ABT_pool_create_basic");
+    ret = ABT_xstream_self(&xstreams[0]);
+    ATS_ERROR(ret, "ABT_xstream_self");
+    ret = ABT_xstream_set_main_sched_basic(xstreams[0], ABT_SCHED_DEFAULT, 1,
+                                           &pool);
+    ATS_ERROR(ret, "ABT_xstream_set_main_sched_basic");
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_create_basic(ABT_SCHED_DEFAULT, 1, &pool,
+                                       ABT_SCHED_CONFIG_NULL, &xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_create_basic");
+    }
+
+    /* The primary ULT is not switched since it must stay on this ES. */
+    fib_arg.n = n;
+    ret = ABT_thread_create(pool, fib_named, &fib_arg, attr, &thread);
+    ATS_ERROR(ret, "ABT_thread_create");
+    ret = ABT_thread_free(&thread);
+    ATS_ERROR(ret, "ABT_thread_free");
+    assert(fib_arg.result == fib_seq(n));
+
+    fib_unnamed_arg.n = n;
+    fib_unnamed_arg.num_done = 0;
+    fib_unnamed_arg.p_parent = NULL;
+    ret = ABT_thread_create(pool, fib_unnamed, &fib_unnamed_arg, attr, NULL);
+    ATS_ERROR(ret, "ABT_thread_create");
+    while (__sync_fetch_and_add(&fib_unnamed_arg.num_done, 0) == 0) {
+        ret = ABT_thread_yield();
+        ATS_ERROR(ret, "ABT_thread_yield");
+    }
+    assert(fib_unnamed_arg.result == fib_seq(n));
+
+    /* A ULT in a private pool of a single ES. */
+    ret = ABT_pool_create_basic(ABT_POOL_FIFO, ABT_POOL_ACCESS_MPSC, ABT_TRUE,
+                                &other_pool);
+    ATS_ERROR(ret, "ABT_pool_create_basic");
+    ret = ABT_xstream_create_basic(ABT_SCHED_DEFAULT, 1, &other_pool,
+                                   ABT_SCHED_CONFIG_NULL, &other_xstream);
+    ATS_ERROR(ret, "ABT_xstream_create_basic");
+    ret = ABT_thread_create(other_pool, single_es_func, NULL,
+                            ABT_THREAD_ATTR_NULL, &thread);
+    ATS_ERROR(ret, "ABT_thread_create");
+    ret = ABT_thread_free(&thread);
+    ATS_ERROR(ret, "ABT_thread_free");
+
+    /* A ULT in another pool is pushed as usual. */
+    flag = 0;
+    ret = ABT_thread_create(other_pool, set_flag, NULL, attr, &thread);
+    ATS_ERROR(ret, "ABT_thread_create");
+    ret = ABT_thread_free(&thread);
+    ATS_ERROR(ret, "ABT_thread_free");
+    assert(flag == 1);
+
+    ret = ABT_xstream_join(other_xstream);
+    ATS_ERROR(ret, "ABT_xstream_join");
+    ret = ABT_xstream_free(&other_xstream);
+    ATS_ERROR(ret, "ABT_xstream_free");
+    ret = ABT_thread_attr_free(&attr);
+    ATS_ERROR(ret, "ABT_thread_attr_free");
+
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_join(xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_join");
+        ret = ABT_xstream_free(&xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_free");
+    }
+
+    /* Finalize */
+    ret = ATS_finalize(0);
+
+    free(xstreams);
+
+    return ret;
+}
@@ -0,0 +1,131 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "abt.h"
+#include "abttest.h"
+
+/* ESs arrive at an ES barrier through a tree whose leaves have different
+ * numbers of ESs.  External threads also wait on the barrier, so some leaves
+ * overflow.  This test checks that nobody leaves a phase early. */
+
+#define DEFAULT_NUM_XSTREAMS 7
+#define DEFAULT_NUM_ITER 100
+#define NUM_EXT_THREADS 2
+
+int num_xstreams = DEFAULT_NUM_XSTREAMS;
+int num_iter = DEFAULT_NUM_ITER;
+int num_waiters;
+ABT_xstream_barrier barrier;
+volatile int g_counter = 0;
+
+static void barrier_loop(void)
+{
+    int i, ret;
+    for (i = 0; i < num_iter; i++) {
+        __sync_fetch_and_add(&g_counter, 1);
+        ret = ABT_xstream_barrier_wait(barrier);
+        ATS_ERROR(ret, "ABT_xstream_barrier_wait");
+        assert(__sync_fetch_and_add(&g_counter, 0) == num_waiters * (i + 1));
+        ret = ABT_xstream_barrier_wait(barrier);
+        ATS_ERROR(ret, "ABT_xstream_barrier_wait");
+    }
+}
+
+void thread_func(void *arg)
+{
+    ATS_UNUSED(arg);
+    barrier_loop();
+}
+
+void *ext_thread_func(void *arg)
+{
+    ATS_UNUSED(arg);
+    barrier_loop();
+    return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+    ABT_xstream *xstreams;
+    ABT_pool *pools;
+    ABT_thread *threads;
+    pthread_t ext_threads[NUM_EXT_THREADS];
+    int i, ret;
+
+    /* Every two ESs share a leaf, and the spin phase is short so that waiters
+     * also sleep. */
+    setenv("ABT_XSTREAM_BARRIER_RADIX", "2", 1);
+    setenv("ABT_XSTREAM_BARRIER_SPINS", "16", 1);
+
+    /* Initialize */
+    ATS_read_args(argc, argv);
+    if (argc >= 2) {
+        num_xstreams = ATS_get_arg_val(ATS_ARG_N_ES);
+        num_iter = ATS_get_arg_val(ATS_ARG_N_ITER);
+    }
+    ATS_init(argc, argv, num_xstreams);
+
+    xstreams = (ABT_xstream *)malloc(num_xstreams * sizeof(ABT_xstream));
+    pools = (ABT_pool *)malloc(num_xstreams * sizeof(ABT_pool));
+    threads = (ABT_thread *)malloc(num_xstreams * sizeof(ABT_thread));
+
+    num_waiters = num_xstreams + NUM_EXT_THREADS;
+    ret = ABT_xstream_barrier_create(num_waiters, &barrier);
+    ATS_ERROR(ret, "ABT_xstream_barrier_create");
+
+    ret = ABT_xstream_self(&xstreams[0]);
+    ATS_ERROR(ret, "ABT_xstream_self");
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_create(ABT_SCHED_NULL, &xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_create");
+    }
+    for (i = 0; i < num_xstreams; i++) {
+        ret = ABT_xstream_get_main_pools(xstreams[i], 1, &pools[i]);
+        ATS_ERROR(ret, "ABT_xstream_get_main_pools");
+    }
+
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_thread_create(pools[i], thread_func, NULL,
+                                ABT_THREAD_ATTR_NULL, &threads[i]);
+        ATS_ERROR(ret, "ABT_thread_create");
+    }
+    for (i = 0; i < NUM_EXT_THREADS; i++) {
+        ret = pthread_create(&ext_threads[i], NULL, ext_thread_func, NULL);
+        assert(ret == 0);
+    }
+    thread_func(NULL);
+
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_thread_free(&threads[i]);
+        ATS_ERROR(ret, "ABT_thread_free");
+    }
+    for (i = 0; i < NUM_EXT_THREADS; i++) {
+        ret = pthread_join(ext_threads[i], NULL);
+        assert(ret == 0);
+    }
+    assert(g_counter == num_waiters * num_iter);
+
+    ret = ABT_xstream_barrier_free(&barrier);
+    ATS_ERROR(ret, "ABT_xstream_barrier_free");
+
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_join(xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_join");
+        ret = ABT_xstream_free(&xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_free");
+    }
+
+    /* Finalize */
+    ret = ATS_finalize(0);
+
+    free(xstreams);
+    free(pools);
+    free(threads);
+
+    return ret;
+}
@@ -0,0 +1,123 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "abt.h"
+#include "abttest.h"
+
+/* This benchmark measures how ABT_future_set scales when many ULTs complete
+ * compartments of a single shared future at the same time.  Setter ULTs are
+ * evenly spread over the ESs, each of them sets num_iter compartments, and the
+ * primary ULT waits on the future until all the compartments are set. */
+
+static int num_xstreams, num_threads, num_iter;
+static ABT_future g_future;
+
+static void setter_func(void *arg)
+{
+    int i;
+    for (i = 0; i < num_iter; i++) {
+        ABT_future_set(g_future, arg);
+    }
+}
+
+static double run(int num_setters, ABT_pool *pools, ABT_thread *threads)
+{
+    int i;
+    double start, elapsed;
+
+    ABT_future_create((uint32_t)num_setters * num_iter, NULL, &g_future);
+    start = ABT_get_wtime();
+    for (i = 0; i < num_setters; i++) {
+        ABT_thread_create(pools[i % num_xstreams], setter_func, NULL,
+                          ABT_THREAD_ATTR_NULL, &threads[i]);
+    }
+    ABT_future_wait(g_future);
+    elapsed = ABT_get_wtime() - start;
+    for (i = 0; i < num_setters; i++) {
+        ABT_thread_free(&threads[i]);
+    }
+    ABT_future_free(&g_future);
+    /* Average time per set */
+    return elapsed / ((double)num_iter * num_setters);
+}
+
+int main(int argc, char *argv[])
+{
+    ABT_xstream *xstreams;
+    ABT_pool *pools;
+    ABT_thread *threads;
+    double *elapsed;
+    int i, ret;
+
+    /* initialize */
+    ATS_read_args(argc, argv);
+    num_xstreams = ATS_get_arg_val(ATS_ARG_N_ES);
+    num_threads = ATS_get_arg_val(ATS_ARG_N_ULT);
+    num_iter = ATS_get_arg_val(ATS_ARG_N_ITER);
+    ATS_init(argc, argv, num_xstreams);
+
+    xstreams = (ABT_xstream *)malloc(num_xstreams * sizeof(ABT_xstream));
+    pools = (ABT_pool *)malloc(num_xstreams * sizeof(ABT_pool));
+    threads = (ABT_thread *)malloc(num_xstreams * num_threads *
+                                   sizeof(ABT_thread));
+    elapsed = (double *)malloc(num_xstreams * sizeof(double));
+
+    ret = ABT_xstream_self(&xstreams[0]);
+    ATS_ERROR(ret, "ABT_xstream_self");
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_create(ABT_SCHED_NULL, &xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_create");
+    }
+    for (i = 0; i < num_xstreams; i++) {
+        ret = ABT_xstream_get_main_pools(xstreams[i], 1, &pools[i]);
+        ATS_ERROR(ret, "ABT_xstream_get_main_pools");
+    }
+
+    for (i = 1; i <= num_xstreams; i++) {
+        /* warm-up */
+        int iter = num_iter;
+        num_iter = 1;
+        run(i * num_threads, pools, threads);
+        num_iter = iter;
+        elapsed[i - 1] = run(i * num_threads, pools, threads);
+    }
+
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_join(xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_join");
+        ret = ABT_xstream_free(&xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_free");
+    }
+
+    /* finalize */
+    ret = ATS_finalize(0);
+
+    /* output */
+    int line_size = 48;
+    ATS_print_line(stdout, '-', line_size);
+    printf("%s\n", "Argobots");
+    ATS_print_line(stdout, '-', line_size);
+    printf("# of ESs        : %d\n", num_xstreams);
+    printf("# of ULTs       : %d per ES\n", num_threads);
+    printf("# of iterations : %d per ULT\n", num_iter);
+    ATS_print_line(stdout, '-', line_size);
+    printf("%-8s %-8s %30s\n", "ESs", "setters",
+           "time per ABT_future_set (us)");
+    ATS_print_line(stdout, '-', line_size);
+    for (i = 0; i < num_xstreams; i++) {
+        printf("%-8d %-8d %30.3f\n", i + 1, (i + 1) * num_threads,
+               elapsed[i] * 1.0e6);
+    }
+    ATS_print_line(stdout, '-', line_size);
+
+    free(xstreams);
+    free(pools);
+    free(threads);
+    free(elapsed);
+
+    return ret;
+}
@@ -0,0 +1,151 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "abt.h"
+#include "abttest.h"
+
+/* This benchmark compares fork-join with ABT_group against creating named work
+ * units and joining them with ABT_thread_join_many() (or ABT_task_join() for
+ * tasklets).  The primary ULT forks work units to the pools of all the ESs in
+ * a round-robin manner and waits for them. */
+
+#define DEFAULT_NUM_UNITS 256
+
+enum { JOIN_MANY_THREAD = 0, GROUP_THREAD, JOIN_TASK, GROUP_TASK, NUM_KINDS };
+static const char *kind_names[NUM_KINDS] = { "ULT (join_many)", "ULT (group)",
+                                             "tasklet (join)",
+                                             "tasklet (group)" };
+
+static int num_xstreams, num_units, num_iter;
+static ABT_pool *pools;
+
+static void unit_func(void *arg)
+{
+    ATS_UNUSED(arg);
+}
+
+static double fork_join(int kind, ABT_thread *threads, ABT_task *tasks,
+                        ABT_group group)
+{
+    int i, t;
+    double start = ABT_get_wtime();
+    for (i = 0; i < num_iter; i++) {
+        switch (kind) {
+            case JOIN_MANY_THREAD:
+                for (t = 0; t < num_units; t++)
+                    ABT_thread_create(pools[t % num_xstreams], unit_func, NULL,
+                                      ABT_THREAD_ATTR_NULL, &threads[t]);
+                ABT_thread_join_many(num_units, threads);
+                for (t = 0; t < num_units; t++)
+                    ABT_thread_free(&threads[t]);
+                break;
+            case GROUP_THREAD:
+                for (t = 0; t < num_units; t++)
+                    ABT_group_thread_create(group, pools[t % num_xstreams],
+                                            unit_func, NULL,
+                                            ABT_THREAD_ATTR_NULL);
+                ABT_group_wait(group);
+                break;
+            case JOIN_TASK:
+                for (t = 0; t < num_units; t++)
+                    ABT_task_create(pools[t % num_xstreams], unit_func, NULL,
+                                    &tasks[t]);
+                for (t = 0; t < num_units; t++)
+                    ABT_task_free(&tasks[t]);
+                break;
+            case GROUP_TASK:
+                for (t = 0; t < num_units; t++)
+                    ABT_group_task_create(group, pools[t % num_xstreams],
+                                          unit_func, NULL);
+                ABT_group_wait(group);
+                break;
+        }
+    }
+    return ABT_get_wtime() - start;
+}
+
+int main(int argc, char *argv[])
+{
+    ABT_xstream *xstreams;
+    ABT_thread *threads;
+    ABT_task *tasks;
+    ABT_group group;
+    double elapsed[NUM_KINDS];
+    int i, kind, ret;
+
+    /* initialize */
+    ATS_read_args(argc, argv);
+    num_xstreams = ATS_get_arg_val(ATS_ARG_N_ES);
+    num_units = ATS_get_arg_val(ATS_ARG_N_ULT);
+    if (num_units <= 1)
+        num_units = DEFAULT_NUM_UNITS;
+    num_iter = ATS_get_arg_val(ATS_ARG_N_ITER);
+    ATS_init(argc, argv, num_xstreams);
+
+    xstreams = (ABT_xstream *)malloc(num_xstreams * sizeof(ABT_xstream));
+    pools = (ABT_pool *)malloc(num_xstreams * sizeof(ABT_pool));
+    threads = (ABT_thread *)malloc(num_units * sizeof(ABT_thread));
+    tasks = (ABT_task *)malloc(num_units * sizeof(ABT_task));
+
+    ret = ABT_xstream_self(&xstreams[0]);
+    ATS_ERROR(ret, "ABT_xstream_self");
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_create(ABT_SCHED_NULL, &xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_create");
+    }
+    for (i = 0; i < num_xstreams; i++) {
+        ret = ABT_xstream_get_main_pools(xstreams[i], 1, &pools[i]);
+        ATS_ERROR(ret, "ABT_xstream_get_main_pools");
+    }
+    ret = ABT_group_create(&group);
+    ATS_ERROR(ret, "ABT_group_create");
+
+    for (kind = 0; kind < NUM_KINDS; kind++) {
+        /* warm-up */
+        int iter = num_iter;
+        num_iter = 1;
+        fork_join(kind, threads, tasks, group);
+        num_iter = iter;
+        elapsed[kind] = fork_join(kind, threads, tasks, group);
+    }
+
+    ret = ABT_group_free(&group);
+    ATS_ERROR(ret, "ABT_group_free");
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_join(xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_join");
+        ret = ABT_xstream_free(&xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_free");
+    }
+
+    /* finalize */
+    ret = ATS_finalize(0);
+
+    /* output */
+    int line_size = 48;
+    ATS_print_line(stdout, '-', line_size);
+    printf("%s\n", "Argobots");
+    ATS_print_line(stdout, '-', line_size);
+    printf("# of ESs        : %d\n", num_xstreams);
+    printf("# of units      : %d per fork-join\n", num_units);
+    printf("# of iterations : %d\n", num_iter);
+    ATS_print_line(stdout, '-', line_size);
+    printf("%-20s %27s\n", "fork-join", "time per unit (us)");
+    ATS_print_line(stdout, '-', line_size);
+    for (kind = 0; kind < NUM_KINDS; kind++) {
+        printf("%-20s %27.3f\n", kind_names[kind],
+               elapsed[kind] * 1.0e6 / ((double)num_iter * num_units));
+    }
+    ATS_print_line(stdout, '-', line_size);
+
+    free(xstreams);
+    free(pools);
+    free(threads);
+    free(tasks);
+
+    return ret;
+}
@@ -0,0 +1,159 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "abt.h"
+#include "abttest.h"
+
+/* This benchmark measures how rdlock/unlock of a single rwlock scales with the
+ * number of ESs that read it concurrently, for the default rwlock and for a
+ * read-mostly one.  One reader ULT runs on each participating ES, and every
+ * 1/write_ratio operation of the first reader is a write. */
+
+#define DEFAULT_WRITE_RATIO 0
+
+enum { RWLOCK_DEFAULT = 0, RWLOCK_READ_MOSTLY, NUM_KINDS };
+static const char *kind_names[NUM_KINDS] = { "default", "read-mostly" };
+
+static int num_xstreams, num_iter, write_ratio = DEFAULT_WRITE_RATIO;
+static ABT_rwlock g_rwlock;
+
+typedef struct {
+    int id;
+    double elapsed;
+} arg_t;
+
+static void reader_func(void *arg)
+{
+    arg_t *p_arg = (arg_t *)arg;
+    int i;
+    double start = ABT_get_wtime();
+    for (i = 0; i < num_iter; i++) {
+        if (p_arg->id == 0 && write_ratio > 0 && i % write_ratio == 0) {
+            ABT_rwlock_wrlock(g_rwlock);
+        } else {
+            ABT_rwlock_rdlock(g_rwlock);
+        }
+        ABT_rwlock_unlock(g_rwlock);
+    }
+    p_arg->elapsed = ABT_get_wtime() - start;
+}
+
+static double run(int num_readers, ABT_pool *pools, ABT_thread *threads,
+                  arg_t *args)
+{
+    int i;
+    double elapsed = 0.0;
+    for (i = 0; i < num_readers; i++) {
+        args[i].id = i;
+        ABT_thread_create(pools[i], reader_func, &args[i], ABT_THREAD_ATTR_NULL,
+                          &threads[i]);
+    }
+    for (i = 0; i < num_readers; i++) {
+        ABT_thread_free(&threads[i]);
+        elapsed += args[i].elapsed;
+    }
+    /* Average time per operation */
+    return elapsed / ((double)num_iter * num_readers);
+}
+
+int main(int argc, char *argv[])
+{
+    ABT_xstream *xstreams;
+    ABT_pool *pools;
+    ABT_thread *threads;
+    ABT_rwlock_attr attr;
+    arg_t *args;
+    double *elapsed;
+    int i, kind, ret;
+
+    /* initialize */
+    ATS_read_args(argc, argv);
+    num_xstreams = ATS_get_arg_val(ATS_ARG_N_ES);
+    num_iter = ATS_get_arg_val(ATS_ARG_N_ITER);
+    if (getenv("RWLOCK_WRITE_RATIO"))
+        write_ratio = atoi(getenv("RWLOCK_WRITE_RATIO"));
+    ATS_init(argc, argv, num_xstreams);
+
+    xstreams = (ABT_xstream *)malloc(num_xstreams * sizeof(ABT_xstream));
+    pools = (ABT_pool *)malloc(num_xstreams * sizeof(ABT_pool));
+    threads = (ABT_thread *)malloc(num_xstreams * sizeof(ABT_thread));
+    args = (arg_t *)malloc(num_xstreams * sizeof(arg_t));
+    elapsed = (double *)malloc(NUM_KINDS * num_xstreams * sizeof(double));
+
+    ret = ABT_xstream_self(&xstreams[0]);
+    ATS_ERROR(ret, "ABT_xstream_self");
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_create(ABT_SCHED_NULL, &xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_create");
+    }
+    for (i = 0; i < num_xstreams; i++) {
+        ret = ABT_xstream_get_main_pools(xstreams[i], 1, &pools[i]);
+        ATS_ERROR(ret, "ABT_xstream_get_main_pools");
+    }
+
+    ret = ABT_rwlock_attr_create(&attr);
+    ATS_ERROR(ret, "ABT_rwlock_attr_create");
+    for (kind = 0; kind < NUM_KINDS; kind++) {
+        ret = ABT_rwlock_attr_set_read_mostly(attr, kind == RWLOCK_READ_MOSTLY
+                                                        ? ABT_TRUE
+                                                        : ABT_FALSE);
+        ATS_ERROR(ret, "ABT_rwlock_attr_set_read_mostly");
+        ret = ABT_rwlock_create_with_attr(attr, &g_rwlock);
+        ATS_ERROR(ret, "ABT_rwlock_create_with_attr");
+        for (i = 1; i <= num_xstreams; i++) {
+            /* warm-up */
+            int iter = num_iter;
+            num_iter = 1;
+            run(i, pools, threads, args);
+            num_iter = iter;
+            elapsed[kind * num_xstreams + i - 1] =
+                run(i, pools, threads, args);
+        }
+        ret = ABT_rwlock_free(&g_rwlock);
+        ATS_ERROR(ret, "ABT_rwlock_free");
+    }
+    ret = ABT_rwlock_attr_free(&attr);
+    ATS_ERROR(ret, "ABT_rwlock_attr_free");
+
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_join(xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_join");
+        ret = ABT_xstream_free(&xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_free");
+    }
+
+    /* finalize */
+    ret = ATS_finalize(0);
+
+    /* output */
+    int line_size = 48;
+    ATS_print_line(stdout, '-', line_size);
+    printf("%s\n", "Argobots");
+    ATS_print_line(stdout, '-', line_size);
+    printf("# of ESs        : %d\n", num_xstreams);
+    printf("# of iterations : %d per ES\n", num_iter);
+    printf("write ratio     : %d (RWLOCK_WRITE_RATIO)\n", write_ratio);
+    ATS_print_line(stdout, '-', line_size);
+    printf("%-8s %38s\n", "readers", "time per rdlock/unlock (us)");
+    printf("%-8s %19s %18s\n", "", kind_names[RWLOCK_DEFAULT],
+           kind_names[RWLOCK_READ_MOSTLY]);
+    ATS_print_line(stdout, '-', line_size);
+    for (i = 0; i < num_xstreams; i++) {
+        printf("%-8d %19.3f %18.3f\n", i + 1,
+               elapsed[RWLOCK_DEFAULT * num_xstreams + i] * 1.0e6,
+               elapsed[RWLOCK_READ_MOSTLY * num_xstreams + i] * 1.0e6);
+    }
+    ATS_print_line(stdout, '-', line_size);
+
+    free(xstreams);
+    free(pools);
+    free(threads);
+    free(args);
+    free(elapsed);
+
+    return ret;
+}
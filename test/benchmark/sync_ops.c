@@ -17,6 +17,8 @@ enum {
     T_MUTEX_CREATE_FREE,
     T_MUTEX_LOCK_UNLOCK,
     T_MUTEX_LOCK_UNLOCK_ALL,
+    T_QSPIN_MUTEX_LOCK_UNLOCK,
+    T_QSPIN_MUTEX_LOCK_UNLOCK_ALL,
     T_LAST
 };
 static char *t_names[] = {
@@ -28,6 +30,8 @@ static char *t_names[] = {
     "mutex: create/free",
     "mutex: lock/unlock",
     "mutex: lock/unlock (all)",
+    "qspin mutex: lock/unlock",
+    "qspin mutex: lock/unlock (all)",
 };
 
 typedef struct {
@@ -38,6 +42,7 @@ typedef struct {
 typedef struct {
     int eid;
     int tid;
+    int test_kind;
 } arg_t;
 
 static int iter;
@@ -83,7 +88,7 @@ void mutex_lock_unlock(void *arg)
     /* stop timer */
     if (eid == 0 && tid == 0) {
         ABT_timer_stop_and_read(timer, &t_time);
-        t_timers[T_MUTEX_LOCK_UNLOCK] = (t_time - t_overhead) / iter;
+        t_timers[my_arg->test_kind] = (t_time - t_overhead) / iter;
         ABT_timer_free(&timer);
     }
 }
@@ -104,6 +109,7 @@ void launch_test(void *arg)
 
     switch (test_kind) {
         case T_MUTEX_LOCK_UNLOCK:
+        case T_QSPIN_MUTEX_LOCK_UNLOCK:
             test_fn = mutex_lock_unlock;
             break;
         default:
@@ -121,6 +127,7 @@ void launch_test(void *arg)
     for (i = 0; i < num_threads; i++) {
         args[i].eid = eid;
         args[i].tid = i;
+        args[i].test_kind = test_kind;
         ABT_thread_create(pool, test_fn, (void *)&args[i], ABT_THREAD_ATTR_NULL,
                           &threads[i]);
     }
@@ -133,14 +140,60 @@ void launch_test(void *arg)
     free(args);
 }
 
+/* Measure lock/unlock of g_mutex contended by all the ULTs on all the ESs. */
+static void measure_lock_unlock(ABT_xstream *xstreams, ABT_pool *pools,
+                                ABT_mutex_attr mattr, int test_kind,
+                                int test_kind_all)
+{
+    ABT_timer timer;
+    launch_t *largs;
+    double t_time;
+    int i;
+
+    ABT_timer_create(&timer);
+    ABT_timer_start(timer);
+
+    largs = (launch_t *)malloc(num_xstreams * sizeof(launch_t));
+    ABT_barrier_create(num_xstreams * num_threads, &g_barrier);
+    ABT_mutex_create_with_attr(mattr, &g_mutex);
+
+    ABT_xstream_self(&xstreams[0]);
+    for (i = 1; i < num_xstreams; i++) {
+        ABT_xstream_create(ABT_SCHED_NULL, &xstreams[i]);
+    }
+    for (i = 1; i < num_xstreams; i++) {
+        ABT_xstream_get_main_pools(xstreams[i], 1, &pools[i]);
+        largs[i].eid = i;
+        largs[i].test_kind = test_kind;
+        ABT_thread_create(pools[i], launch_test, (void *)&largs[i],
+                          ABT_THREAD_ATTR_NULL, NULL);
+    }
+
+    largs[0].eid = 0;
+    largs[0].test_kind = test_kind;
+    launch_test((void *)&largs[0]);
+
+    for (i = 1; i < num_xstreams; i++) {
+        ABT_xstream_join(xstreams[i]);
+        ABT_xstream_free(&xstreams[i]);
+    }
+    ABT_barrier_free(&g_barrier);
+    ABT_mutex_free(&g_mutex);
+    free(largs);
+
+    ABT_timer_stop_and_read(timer, &t_time);
+    t_timers[test_kind_all] = (t_time - t_overhead) / iter;
+    ABT_timer_free(&timer);
+}
+
 int main(int argc, char *argv[])
 {
     ABT_xstream *xstreams;
     ABT_pool *pools;
     ABT_thread *threads;
     ABT_mutex *mutexes;
+    ABT_mutex_attr mattr;
     ABT_timer timer;
-    launch_t *largs;
     double t_time;
     int i;
 
@@ -207,45 +260,22 @@ int main(int argc, char *argv[])
         t_timers[T_MUTEX_CREATE] + t_timers[T_MUTEX_FREE];
 
     /* mutex lock/unlock time */
-    ABT_timer_start(timer);
+    ABT_mutex_attr_create(&mattr);
+    measure_lock_unlock(xstreams, pools, mattr, T_MUTEX_LOCK_UNLOCK,
+                        T_MUTEX_LOCK_UNLOCK_ALL);
 
-    largs = (launch_t *)malloc(num_xstreams * sizeof(launch_t));
-    ABT_barrier_create(num_xstreams * num_threads, &g_barrier);
-    ABT_mutex_create(&g_mutex);
-
-    ABT_xstream_self(&xstreams[0]);
-    for (i = 1; i < num_xstreams; i++) {
-        ABT_xstream_create(ABT_SCHED_NULL, &xstreams[i]);
-    }
-    for (i = 1; i < num_xstreams; i++) {
-        ABT_xstream_get_main_pools(xstreams[i], 1, &pools[i]);
-        largs[i].eid = i;
-        largs[i].test_kind = T_MUTEX_LOCK_UNLOCK;
-        ABT_thread_create(pools[i], launch_test, (void *)&largs[i],
-                          ABT_THREAD_ATTR_NULL, NULL);
-    }
-
-    largs[0].eid = 0;
-    largs[0].test_kind = T_MUTEX_LOCK_UNLOCK;
-    launch_test((void *)&largs[0]);
-
-    for (i = 1; i < num_xstreams; i++) {
-        ABT_xstream_join(xstreams[i]);
-        ABT_xstream_free(&xstreams[i]);
-    }
-    ABT_barrier_free(&g_barrier);
-    ABT_mutex_free(&g_mutex);
-    free(largs);
-
-    ABT_timer_stop_and_read(timer, &t_time);
-    t_timers[T_MUTEX_LOCK_UNLOCK_ALL] = (t_time - t_overhead) / iter;
+    /* mutex lock/unlock time with the queued spin phase */
+    ABT_mutex_attr_set_queued_spin(mattr, ABT_TRUE);
+    measure_lock_unlock(xstreams, pools, mattr, T_QSPIN_MUTEX_LOCK_UNLOCK,
+                        T_QSPIN_MUTEX_LOCK_UNLOCK_ALL);
+    ABT_mutex_attr_free(&mattr);
 
     /* finalize */
     ABT_timer_free(&timer);
     ATS_finalize(0);
 
     /* output */
-    int line_size = 45;
+    int line_size = 50;
     ATS_print_line(stdout, '-', line_size);
     printf("# of ESs        : %d\n", num_xstreams);
     printf("# of ULTs per ES: %d\n", num_threads);
@@ -253,7 +283,7 @@ int main(int argc, char *argv[])
     printf("Avg. execution time (in seconds, %d times)\n", iter);
     ATS_print_line(stdout, '-', line_size);
     for (i = 0; i < T_LAST; i++) {
-        printf("%-25s  %.9f\n", t_names[i], t_timers[i]);
+        printf("%-30s  %.9f\n", t_names[i], t_timers[i]);
     }
     ATS_print_line(stdout, '-', line_size);
 
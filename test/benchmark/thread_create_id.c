@@ -0,0 +1,151 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "abt.h"
+#include "abttest.h"
+
+/* This benchmark measures the throughput of creating ULTs and tasklets that
+ * query their IDs on many ESs.  Each ES creates, runs, and frees work units in
+ * its own pool, so the only shared state is the generation of unit IDs.  Run it
+ * with many ESs (e.g., -e 64) to see how well ID generation scales. */
+
+#define DEFAULT_NUM_XSTREAMS 64
+
+static int num_xstreams, num_threads, num_tasks, num_iter;
+static ABT_pool *pools;
+static double *elapsed;
+static ABT_xstream_barrier g_xbarrier = ABT_XSTREAM_BARRIER_NULL;
+
+static void thread_func(void *arg)
+{
+    ABT_unit_id id;
+    ATS_UNUSED(arg);
+    ABT_thread_self_id(&id);
+}
+
+static void task_func(void *arg)
+{
+    ABT_unit_id id;
+    ATS_UNUSED(arg);
+    ABT_task_self_id(&id);
+}
+
+static void main_thread_func(void *arg)
+{
+    int rank = (int)(size_t)arg;
+    int i, t;
+    double start;
+    ABT_pool pool = pools[rank];
+    ABT_thread *threads =
+        (ABT_thread *)malloc(num_threads * sizeof(ABT_thread));
+    ABT_task *tasks = (ABT_task *)malloc(num_tasks * sizeof(ABT_task));
+
+    ABT_xstream_barrier_wait(g_xbarrier);
+    start = ABT_get_wtime();
+    for (i = 0; i < num_iter; i++) {
+        for (t = 0; t < num_threads; t++)
+            ABT_thread_create(pool, thread_func, NULL, ABT_THREAD_ATTR_NULL,
+                              &threads[t]);
+        for (t = 0; t < num_tasks; t++)
+            ABT_task_create(pool, task_func, NULL, &tasks[t]);
+        for (t = 0; t < num_threads; t++)
+            ABT_thread_free(&threads[t]);
+        for (t = 0; t < num_tasks; t++)
+            ABT_task_free(&tasks[t]);
+    }
+    elapsed[rank] = ABT_get_wtime() - start;
+
+    free(threads);
+    free(tasks);
+}
+
+int main(int argc, char *argv[])
+{
+    ABT_xstream *xstreams;
+    ABT_thread *main_threads;
+    double max_elapsed = 0.0;
+    int i, ret;
+
+    /* initialize */
+    ATS_read_args(argc, argv);
+    num_xstreams = ATS_get_arg_val(ATS_ARG_N_ES);
+    if (num_xstreams <= 1)
+        num_xstreams = DEFAULT_NUM_XSTREAMS;
+    num_threads = ATS_get_arg_val(ATS_ARG_N_ULT);
+    num_tasks = ATS_get_arg_val(ATS_ARG_N_TASK);
+    num_iter = ATS_get_arg_val(ATS_ARG_N_ITER);
+    ATS_init(argc, argv, num_xstreams);
+
+    xstreams = (ABT_xstream *)malloc(num_xstreams * sizeof(ABT_xstream));
+    pools = (ABT_pool *)malloc(num_xstreams * sizeof(ABT_pool));
+    main_threads = (ABT_thread *)malloc(num_xstreams * sizeof(ABT_thread));
+    elapsed = (double *)malloc(num_xstreams * sizeof(double));
+
+    ret = ABT_xstream_barrier_create(num_xstreams, &g_xbarrier);
+    ATS_ERROR(ret, "ABT_xstream_barrier_create");
+    ret = ABT_xstream_self(&xstreams[0]);
+    ATS_ERROR(ret, "ABT_xstream_self");
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_xstream_create(ABT_SCHED_NULL, &xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_create");
+    }
+    for (i = 0; i < num_xstreams; i++) {
+        ret = ABT_xstream_get_main_pools(xstreams[i], 1, &pools[i]);
+        ATS_ERROR(ret, "ABT_xstream_get_main_pools");
+    }
+
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_thread_create(pools[i], main_thread_func, (void *)(size_t)i,
+                                ABT_THREAD_ATTR_NULL, &main_threads[i]);
+        ATS_ERROR(ret, "ABT_thread_create");
+    }
+    main_thread_func((void *)(size_t)0);
+
+    for (i = 1; i < num_xstreams; i++) {
+        ret = ABT_thread_free(&main_threads[i]);
+        ATS_ERROR(ret, "ABT_thread_free");
+        ret = ABT_xstream_join(xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_join");
+        ret = ABT_xstream_free(&xstreams[i]);
+        ATS_ERROR(ret, "ABT_xstream_free");
+    }
+    ret = ABT_xstream_barrier_free(&g_xbarrier);
+    ATS_ERROR(ret, "ABT_xstream_barrier_free");
+
+    /* finalize */
+    ret = ATS_finalize(0);
+
+    for (i = 0; i < num_xstreams; i++) {
+        if (elapsed[i] > max_elapsed)
+            max_elapsed = elapsed[i];
+    }
+
+    /* output */
+    int line_size = 48;
+    ATS_print_line(stdout, '-', line_size);
+    printf("%s\n", "Argobots");
+    ATS_print_line(stdout, '-', line_size);
+    printf("# of ESs        : %d\n", num_xstreams);
+    printf("# of ULTs       : %d per ES\n", num_threads);
+    printf("# of tasklets   : %d per ES\n", num_tasks);
+    printf("# of iterations : %d\n", num_iter);
+    ATS_print_line(stdout, '-', line_size);
+    printf("%-20s %27s\n", "total time (s)", "creations/s");
+    ATS_print_line(stdout, '-', line_size);
+    printf("%-20.6f %27.1f\n", max_elapsed,
+           max_elapsed > 0.0 ? (double)num_xstreams * num_iter *
+                                   (num_threads + num_tasks) / max_elapsed
+                             : 0.0);
+    ATS_print_line(stdout, '-', line_size);
+
+    free(xstreams);
+    free(pools);
+    free(main_threads);
+    free(elapsed);
+
+    return ret;
+}
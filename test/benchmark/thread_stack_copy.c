@@ -0,0 +1,208 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include "abt.h"
+#include "abttest.h"
+
+/* This benchmark compares normal ULTs and stack-copying ULTs in terms of the
+ * memory footprint per suspended ULT and the cost of a yield.  Each ULT uses
+ * a given amount of its stack and then keeps yielding.  The memory footprint
+ * is the increase of the resident set size divided by the number of ULTs
+ * (N/A if it is not available). */
+
+#define NUM_DEPTHS 3
+static const size_t depths[NUM_DEPTHS] = { 0, 1024, 4096 };
+
+static int num_threads;
+static int iter;
+static volatile int g_num_suspended;
+static volatile int g_stop;
+
+static long get_rss(void)
+{
+    long size, resident;
+    FILE *fp = fopen("/proc/self/statm", "r");
+    if (!fp)
+        return -1;
+    if (fscanf(fp, "%ld %ld", &size, &resident) != 2)
+        resident = -1;
+    fclose(fp);
+    return resident < 0 ? -1 : resident * sysconf(_SC_PAGESIZE);
+}
+
+static void use_stack_and_yield(size_t depth)
+{
+    if (depth > 0) {
+        volatile char buf[512];
+        memset((char *)buf, 0, sizeof(buf));
+        use_stack_and_yield(depth > sizeof(buf) ? depth - sizeof(buf) : 0);
+        /* Keep buf alive to avoid a tail call. */
+        buf[0]++;
+        return;
+    }
+    __sync_fetch_and_add(&g_num_suspended, 1);
+    while (!g_stop)
+        ABT_thread_yield();
+}
+
+static void thread_func(void *arg)
+{
+    use_stack_and_yield((size_t)arg);
+}
+
+static void measure(int is_copy, size_t depth, double *p_bytes,
+                    double *p_cycles)
+{
+    int i, ret;
+    long rss_before, rss_after;
+    uint64_t start;
+    ABT_xstream xstream;
+    ABT_pool pool;
+    ABT_thread_attr attr = ABT_THREAD_ATTR_NULL;
+    ABT_thread *threads =
+        (ABT_thread *)malloc(num_threads * sizeof(ABT_thread));
+
+    ret = ABT_xstream_self(&xstream);
+    ATS_ERROR(ret, "ABT_xstream_self");
+    ret = ABT_xstream_get_main_pools(xstream, 1, &pool);
+    ATS_ERROR(ret, "ABT_xstream_get_main_pools");
+    if (is_copy) {
+        ret = ABT_thread_attr_create(&attr);
+        ATS_ERROR(ret, "ABT_thread_attr_create");
+        ret = ABT_thread_attr_set_stack_copy(attr, ABT_TRUE);
+        ATS_ERROR(ret, "ABT_thread_attr_set_stack_copy");
+    }
+
+    g_num_suspended = 0;
+    g_stop = 0;
+    rss_before = get_rss();
+    for (i = 0; i < num_threads; i++) {
+        ret = ABT_thread_create(pool, thread_func, (void *)depth, attr,
+                                &threads[i]);
+        ATS_ERROR(ret, "ABT_thread_create");
+    }
+    while (g_num_suspended < num_threads)
+        ABT_thread_yield();
+    rss_after = get_rss();
+    *p_bytes = (rss_before < 0 || rss_after < 0)
+                   ? -1.0
+                   : (double)(rss_after - rss_before) / num_threads;
+
+    /* Every ULT yields once while the main ULT yields once. */
+    start = ATS_get_cycles();
+    for (i = 0; i < iter; i++)
+        ABT_thread_yield();
+    *p_cycles = (double)(ATS_get_cycles() - start) / iter / (num_threads + 1);
+
+    g_stop = 1;
+    for (i = 0; i < num_threads; i++) {
+        ret = ABT_thread_free(&threads[i]);
+        ATS_ERROR(ret, "ABT_thread_free");
+    }
+    if (is_copy) {
+        ret = ABT_thread_attr_free(&attr);
+        ATS_ERROR(ret, "ABT_thread_attr_free");
+    }
+    free(threads);
+}
+
+/* Each configuration runs in a new process so that memory cached by the
+ * runtime or the allocator does not hide the footprint. */
+static void measure_in_child(int argc, char *argv[], int is_copy, size_t depth,
+                             double *p_bytes, double *p_cycles)
+{
+    int fds[2];
+    double results[2] = { -1.0, -1.0 };
+    pid_t pid;
+
+    if (pipe(fds) != 0)
+        goto fn_exit;
+    pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        int ret = ABT_init(argc, argv);
+        ATS_ERROR(ret, "ABT_init");
+        measure(is_copy, depth, &results[0], &results[1]);
+        ret = ABT_finalize();
+        ATS_ERROR(ret, "ABT_finalize");
+        if (write(fds[1], results, sizeof(results)) != sizeof(results))
+            _exit(EXIT_FAILURE);
+        _exit(EXIT_SUCCESS);
+    }
+    close(fds[1]);
+    if (pid > 0) {
+        if (read(fds[0], results, sizeof(results)) != sizeof(results))
+            results[0] = results[1] = -1.0;
+        waitpid(pid, NULL, 0);
+    }
+    close(fds[0]);
+
+fn_exit:
+    *p_bytes = results[0];
+    *p_cycles = results[1];
+}
+
+int main(int argc, char *argv[])
+{
+    static const char *names[2] = { "normal", "stack-copying" };
+    double bytes[2][NUM_DEPTHS], cycles[2][NUM_DEPTHS];
+    int num_types = 2;
+    int t, d, ret;
+
+    /* initialize */
+    ATS_read_args(argc, argv);
+    num_threads = ATS_get_arg_val(ATS_ARG_N_ULT);
+    iter = ATS_get_arg_val(ATS_ARG_N_ITER);
+
+    /* Check if stack-copying ULTs are supported. */
+    ATS_init(argc, argv, 1);
+    ABT_thread_attr attr;
+    ret = ABT_thread_attr_create(&attr);
+    ATS_ERROR(ret, "ABT_thread_attr_create");
+    if (ABT_thread_attr_set_stack_copy(attr, ABT_TRUE) != ABT_SUCCESS)
+        num_types = 1;
+    ret = ABT_thread_attr_free(&attr);
+    ATS_ERROR(ret, "ABT_thread_attr_free");
+    ATS_finalize(0);
+
+    for (t = 0; t < num_types; t++) {
+        for (d = 0; d < NUM_DEPTHS; d++) {
+            measure_in_child(argc, argv, t, depths[d], &bytes[t][d],
+                             &cycles[t][d]);
+        }
+    }
+
+    /* output */
+    int line_size = 66;
+    ATS_print_line(stdout, '-', line_size);
+    printf("%s\n", "Argobots");
+    ATS_print_line(stdout, '-', line_size);
+    printf("# of ULTs       : %d\n", num_threads);
+    printf("# of iterations : %d\n", iter);
+    ATS_print_line(stdout, '-', line_size);
+    printf("%-16s %12s %16s %16s\n", "ULT type", "stack usage", "bytes/ULT",
+           "cycles/yield");
+    ATS_print_line(stdout, '-', line_size);
+    for (t = 0; t < num_types; t++) {
+        for (d = 0; d < NUM_DEPTHS; d++) {
+            if (bytes[t][d] < 0) {
+                printf("%-16s %12zu %16s %16.1f\n", names[t], depths[d], "N/A",
+                       cycles[t][d]);
+            } else {
+                printf("%-16s %12zu %16.1f %16.1f\n", names[t], depths[d],
+                       bytes[t][d], cycles[t][d]);
+            }
+        }
+    }
+    ATS_print_line(stdout, '-', line_size);
+
+    return EXIT_SUCCESS;
+}
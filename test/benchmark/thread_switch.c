@@ -0,0 +1,113 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil ; -*- */
+/*
+ * See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "abt.h"
+#include "abttest.h"
+
+/* This benchmark measures the cost of a context switch of ULTs that preserve
+ * the FPU control state and ULTs that do not (see
+ * ABT_thread_attr_set_preserve_fpu()).  ULTs keep yielding in a single ES, so
+ * each yield consists of two context switches: one from the ULT to the
+ * scheduler and one from the scheduler to the next ULT. */
+
+static volatile int g_stop;
+
+static void thread_func(void *arg)
+{
+    while (!g_stop)
+        ABT_thread_yield();
+}
+
+static double measure(ABT_pool pool, int num_threads, int iter,
+                      ABT_bool preserve_fpu)
+{
+    int i, ret;
+    uint64_t start, cycles;
+    ABT_thread_attr attr;
+    ABT_thread *threads =
+        (ABT_thread *)malloc(num_threads * sizeof(ABT_thread));
+
+    ret = ABT_thread_attr_create(&attr);
+    ATS_ERROR(ret, "ABT_thread_attr_create");
+    ret = ABT_thread_attr_set_preserve_fpu(attr, preserve_fpu);
+    ATS_ERROR(ret, "ABT_thread_attr_set_preserve_fpu");
+
+    g_stop = 0;
+    for (i = 0; i < num_threads; i++) {
+        ret = ABT_thread_create(pool, thread_func, NULL, attr, &threads[i]);
+        ATS_ERROR(ret, "ABT_thread_create");
+    }
+    /* Warm up */
+    for (i = 0; i < iter / 10 + 1; i++)
+        ABT_thread_yield();
+
+    /* Every ULT yields once while the main ULT yields once. */
+    start = ATS_get_cycles();
+    for (i = 0; i < iter; i++)
+        ABT_thread_yield();
+    cycles = ATS_get_cycles() - start;
+
+    g_stop = 1;
+    for (i = 0; i < num_threads; i++) {
+        ret = ABT_thread_free(&threads[i]);
+        ATS_ERROR(ret, "ABT_thread_free");
+    }
+    ret = ABT_thread_attr_free(&attr);
+    ATS_ERROR(ret, "ABT_thread_attr_free");
+    free(threads);
+
+    return (double)cycles / iter / (num_threads + 1);
+}
+
+int main(int argc, char *argv[])
+{
+    static const char *names[2] = { "preserve FPU", "no FPU" };
+    double cycles[2];
+    int num_threads, iter, t, ret;
+    ABT_bool preserve_fpu;
+    ABT_xstream xstream;
+    ABT_pool pool;
+
+    /* initialize */
+    ATS_read_args(argc, argv);
+    num_threads = ATS_get_arg_val(ATS_ARG_N_ULT);
+    iter = ATS_get_arg_val(ATS_ARG_N_ITER);
+    ATS_init(argc, argv, 1);
+
+    ret = ABT_info_query_config(ABT_INFO_QUERY_KIND_ENABLED_PRESERVE_FPU,
+                                &preserve_fpu);
+    ATS_ERROR(ret, "ABT_info_query_config");
+    ret = ABT_xstream_self(&xstream);
+    ATS_ERROR(ret, "ABT_xstream_self");
+    ret = ABT_xstream_get_main_pools(xstream, 1, &pool);
+    ATS_ERROR(ret, "ABT_xstream_get_main_pools");
+
+    for (t = 0; t < 2; t++) {
+        cycles[t] = measure(pool, num_threads, iter, t == 0 ? ABT_TRUE
+                                                            : ABT_FALSE);
+    }
+
+    /* finalize */
+    ret = ATS_finalize(0);
+
+    /* output */
+    int line_size = 42;
+    ATS_print_line(stdout, '-', line_size);
+    printf("%s\n", "Argobots");
+    ATS_print_line(stdout, '-', line_size);
+    printf("# of ULTs       : %d\n", num_threads);
+    printf("# of iterations : %d\n", iter);
+    printf("FPU preservation: %s\n", preserve_fpu ? "enabled" : "disabled");
+    ATS_print_line(stdout, '-', line_size);
+    printf("%-16s %24s\n", "ULT type", "cycles/yield");
+    ATS_print_line(stdout, '-', line_size);
+    for (t = 0; t < 2; t++)
+        printf("%-16s %24.1f\n", names[t], cycles[t]);
+    ATS_print_line(stdout, '-', line_size);
+
+    return ret;
+}